@@ -105,7 +105,9 @@ struct linspaced_op_impl<Scalar,Packet,/*RandomAccess*/true,/*IsInteger*/true>
   template<typename Index>
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
   const Scalar operator() (Index i) const {
-    return m_low + (m_length*Scalar(i))/m_divisor;
+    // the product is computed in a wider type to not overflow for large sizes
+    typedef typename conditional<(sizeof(Scalar)<sizeof(Eigen::Index)),Eigen::Index,Scalar>::type WideScalar;
+    return m_low + Scalar((WideScalar(m_length)*WideScalar(i))/WideScalar(m_divisor));
   }
 
   template<typename Index>
@@ -0,0 +1,176 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BLOCKING_SIZES_TABLE_H
+#define EIGEN_BLOCKING_SIZES_TABLE_H
+
+namespace Eigen {
+
+namespace internal {
+
+template<typename Scalar> struct blocking_sizes_scalar_name { static const char* run() { return 0; } };
+template<> struct blocking_sizes_scalar_name<float> { static const char* run() { return "float"; } };
+template<> struct blocking_sizes_scalar_name<double> { static const char* run() { return "double"; } };
+template<> struct blocking_sizes_scalar_name<std::complex<float> > { static const char* run() { return "complex<float>"; } };
+template<> struct blocking_sizes_scalar_name<std::complex<double> > { static const char* run() { return "complex<double>"; } };
+
+/** \internal
+  * Table of blocking sizes measured for some regimes of matrix product sizes, typically by the
+  * \c autotune action of bench/benchmark-blocking-sizes.cpp.
+  *
+  * The file format is one entry per line: <tt>scalar k m n kc mc nc</tt>, where \c scalar is one of
+  * \c float, \c double, \c complex<float> or \c complex<double>, \c k, \c m and \c n are the sizes of
+  * the benchmarked product, and \c kc, \c mc and \c nc its best blocking sizes. Empty lines and lines
+  * starting with \c # are ignored.
+  */
+class blocking_sizes_table
+{
+  public:
+    struct Entry
+    {
+      std::string scalar;
+      int k, m, n;
+      int kc, mc, nc;
+    };
+
+    /** Loads the entries of \a filename in addition to the current ones. \returns false if the file cannot
+      * be read or is ill-formed, in which case the table is left unchanged. */
+    bool load(const char* filename)
+    {
+      std::FILE* file = std::fopen(filename, "r");
+      if(file==0)
+        return false;
+
+      std::vector<Entry> entries;
+      bool ok = true;
+      char line[256];
+      while(ok && std::fgets(line, sizeof(line), file))
+      {
+        const char* first = line;
+        while(*first==' ' || *first=='\t') ++first;
+        if(*first=='#' || *first=='\n' || *first=='\r' || *first==0)
+          continue;
+        char scalar[32];
+        Entry e;
+        ok = std::sscanf(first, "%31s %d %d %d %d %d %d", scalar, &e.k, &e.m, &e.n, &e.kc, &e.mc, &e.nc)==7
+          && e.k>0 && e.m>0 && e.n>0 && e.kc>0 && e.mc>0 && e.nc>0;
+        e.scalar = scalar;
+        entries.push_back(e);
+      }
+      std::fclose(file);
+
+      if(ok)
+        m_entries.insert(m_entries.end(), entries.begin(), entries.end());
+      return ok;
+    }
+
+    void clear() { m_entries.clear(); }
+
+    bool empty() const { return m_entries.empty(); }
+
+    /** Replaces \a k, \a m, \a n by the blocking sizes of the entry of the closest product size for the
+      * scalar type \a scalar, where sizes are compared by orders of magnitude.
+      * \returns false if there is no entry for \a scalar. */
+    template<typename Index>
+    bool lookup(const char* scalar, Index& k, Index& m, Index& n) const
+    {
+      const Entry* best = 0;
+      int best_distance = 0;
+      const int lk = log2(k), lm = log2(m), ln = log2(n);
+      for(std::size_t i = 0; i < m_entries.size(); ++i)
+      {
+        const Entry& e = m_entries[i];
+        if(e.scalar!=scalar)
+          continue;
+        const int distance = std::abs(log2(e.k)-lk) + std::abs(log2(e.m)-lm) + std::abs(log2(e.n)-ln);
+        if(best==0 || distance<best_distance)
+        {
+          best = &e;
+          best_distance = distance;
+        }
+      }
+      if(best==0)
+        return false;
+      k = numext::mini<Index>(k, best->kc);
+      m = numext::mini<Index>(m, best->mc);
+      n = numext::mini<Index>(n, best->nc);
+      return true;
+    }
+
+  protected:
+    template<typename Index>
+    static int log2(Index x)
+    {
+      int res = 0;
+      while(x >>= 1) ++res;
+      return res;
+    }
+
+    std::vector<Entry> m_entries;
+};
+
+/** \internal \returns the table used by the matrix products. It is initially loaded from the file
+  * named by the environment variable \c EIGEN_BLOCKING_SIZES_FILE, if any. */
+inline blocking_sizes_table& global_blocking_sizes_table()
+{
+  struct initializer
+  {
+    static blocking_sizes_table run()
+    {
+      blocking_sizes_table table;
+      const char* filename = std::getenv("EIGEN_BLOCKING_SIZES_FILE");
+      if(filename && *filename)
+        table.load(filename);
+      return table;
+    }
+  };
+  static blocking_sizes_table table = initializer::run();
+  return table;
+}
+
+template<typename LhsScalar, typename RhsScalar, typename Index>
+inline bool useBlockingSizesTable(Index& k, Index& m, Index& n)
+{
+  const char* scalar = blocking_sizes_scalar_name<LhsScalar>::run();
+  if(scalar==0 || !is_same<LhsScalar,RhsScalar>::value)
+    return false;
+  const blocking_sizes_table& table = global_blocking_sizes_table();
+  return !table.empty() && table.lookup(scalar, k, m, n);
+}
+
+} // end namespace internal
+
+/** Loads the matrix product blocking sizes of \a filename, in addition to the ones already loaded.
+  * This is only available if EIGEN_USE_BLOCKING_SIZES_TABLE is defined, in which case the table is
+  * initially loaded from the file named by the environment variable \c EIGEN_BLOCKING_SIZES_FILE.
+  *
+  * Such a file is generated for the host by the \c autotune action of bench/benchmark-blocking-sizes.cpp.
+  * Each sequential matrix product of float, double, or complex scalars then uses the blocking sizes of the
+  * closest benchmarked product size, instead of the ones derived from the cache sizes.
+  *
+  * This function is not reentrant, and must not be called while matrix products are computed.
+  *
+  * \returns false if the file cannot be read or is ill-formed, in which case nothing is loaded.
+  *
+  * \sa clearBlockingSizesTable(), setCpuCacheSizes()
+  */
+inline bool loadBlockingSizesTable(const char* filename)
+{
+  return internal::global_blocking_sizes_table().load(filename);
+}
+
+/** Removes all the blocking sizes loaded by loadBlockingSizesTable(), so that they are again derived
+  * from the cache sizes.
+  * \sa loadBlockingSizesTable() */
+inline void clearBlockingSizesTable()
+{
+  internal::global_blocking_sizes_table().clear();
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_BLOCKING_SIZES_TABLE_H
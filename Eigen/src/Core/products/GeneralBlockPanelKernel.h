@@ -289,14 +289,19 @@ inline bool useSpecificBlockingSizes(Index& k, Index& m, Index& n)
   *
   * The blocking size parameters may be evaluated:
   *   - either by a heuristic based on cache sizes;
+  *   - or from a table of measured blocking sizes, for sequential products if EIGEN_USE_BLOCKING_SIZES_TABLE is defined;
   *   - or using fixed prescribed values (for testing purposes).
   *
-  * \sa setCpuCacheSizes */
+  * \sa setCpuCacheSizes, loadBlockingSizesTable */
 
 template<typename LhsScalar, typename RhsScalar, int KcFactor, typename Index>
 void computeProductBlockingSizes(Index& k, Index& m, Index& n, Index num_threads = 1)
 {
   if (!useSpecificBlockingSizes(k, m, n)) {
+#ifdef EIGEN_USE_BLOCKING_SIZES_TABLE
+    // the table is measured for sequential general matrix products
+    if (KcFactor!=1 || num_threads>1 || !useBlockingSizesTable<LhsScalar, RhsScalar>(k, m, n))
+#endif
     evaluateProductBlockingSizesHeuristic<LhsScalar, RhsScalar, KcFactor, Index>(k, m, n, num_threads);
   }
 
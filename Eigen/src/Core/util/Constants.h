@@ -421,6 +421,16 @@ enum QRPreconditioners {
   FullPivHouseholderQRPreconditioner
 };
 
+/** \ingroup enums
+  * Possible values for the \p _Variant template parameter of ConjugateGradient. */
+enum ConjugateGradientVariants {
+  /** The standard preconditioned conjugate gradient iterations. */
+  StandardCG,
+  /** The pipelined conjugate gradient iterations of Ghysels and Vanroose, in which the reductions of an iteration
+    * do not depend on its matrix-vector product, and the vector updates are fused into a single pass. */
+  PipelinedCG
+};
+
 #ifdef Success
 #error The preprocessor symbol 'Success' is defined, possibly by the X11 header file X.h
 #endif
@@ -454,6 +464,22 @@ enum TransformTraits {
   Projective    = 0x20
 };
 
+/** \ingroup enums
+  * Flags of the x86 instruction set extensions, as returned by cpuFeatures() and compiledCpuFeatures().
+  * \sa class CpuDispatcher */
+enum CpuFeature {
+  CpuSSE2    = 0x1,
+  CpuSSE3    = 0x2,
+  CpuSSSE3   = 0x4,
+  CpuSSE4_1  = 0x8,
+  CpuSSE4_2  = 0x10,
+  CpuAVX     = 0x20,
+  CpuAVX2    = 0x40,
+  /** Fused multiply-add (FMA3). */
+  CpuFMA     = 0x80,
+  CpuAVX512F = 0x100
+};
+
 /** \internal \ingroup enums
   * Enum used to choose between implementation depending on the computer architecture. */
 namespace Architecture
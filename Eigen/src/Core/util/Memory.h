@@ -770,6 +770,17 @@ public:
 #  endif
 #endif
 
+// reads the extended control register XCR0, telling which register states are saved by the OS
+#ifdef EIGEN_CPUID
+#  if EIGEN_COMP_GNUC
+     // xgetbv is emitted as raw bytes so that it does not require -mxsave
+#    define EIGEN_XGETBV(xcr0) { unsigned int eax_, edx_; \
+       __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (eax_), "=d" (edx_) : "c" (0)); xcr0 = int(eax_); }
+#  elif defined(_MSC_FULL_VER) && (_MSC_FULL_VER >= 160040219)
+#    define EIGEN_XGETBV(xcr0) { xcr0 = int(_xgetbv(0)); }
+#  endif
+#endif
+
 namespace internal {
 
 #ifdef EIGEN_CPUID
@@ -967,8 +978,104 @@ inline int queryTopLevelCacheSize()
   return (std::max)(l2,l3);
 }
 
+/** \internal
+ * Queries and returns the instruction set extensions supported by both the CPU and the OS,
+ * as a combination of CpuFeature flags */
+inline int queryCpuFeatures()
+{
+  int features = 0;
+  #if defined(EIGEN_CPUID) && defined(EIGEN_XGETBV)
+  int abcd[4];
+  EIGEN_CPUID(abcd,0x0,0);
+  const int max_std_funcs = abcd[0];
+  if(max_std_funcs < 1)
+    return 0;
+
+  EIGEN_CPUID(abcd,0x1,0);
+  const int ecx = abcd[2], edx = abcd[3];
+  if(edx & (1<<26)) features |= CpuSSE2;
+  if(ecx & (1<< 0)) features |= CpuSSE3;
+  if(ecx & (1<< 9)) features |= CpuSSSE3;
+  if(ecx & (1<<19)) features |= CpuSSE4_1;
+  if(ecx & (1<<20)) features |= CpuSSE4_2;
+
+  // the AVX registers can only be used if the OS saves them (OSXSAVE and XCR0[2:1])
+  int xcr0 = 0;
+  if(ecx & (1<<27))
+    EIGEN_XGETBV(xcr0);
+  const bool os_avx = (xcr0 & 0x6) == 0x6;
+  const bool os_avx512 = (xcr0 & 0xE6) == 0xE6;
+  if(os_avx && (ecx & (1<<28))) features |= CpuAVX;
+  if(os_avx && (ecx & (1<<12))) features |= CpuFMA;
+
+  if(max_std_funcs >= 7)
+  {
+    EIGEN_CPUID(abcd,0x7,0);
+    if(os_avx && (abcd[1] & (1<< 5))) features |= CpuAVX2;
+    if(os_avx512 && (abcd[1] & (1<<16))) features |= CpuAVX512F;
+  }
+  #elif EIGEN_ARCH_x86_64
+  // SSE2 is part of x86-64
+  features = CpuSSE2;
+  #endif
+  return features;
+}
+
 } // end namespace internal
 
+/** \returns the instruction set extensions supported by the CPU and the OS running the program,
+  * as a combination of CpuFeature flags. The CPU is only queried once.
+  *
+  * On architectures other than x86 and x86-64, no feature is reported. If EIGEN_NO_CPUID is defined,
+  * or if the compiler offers no way to query the CPU, only the features implied by the architecture
+  * are reported, that is CpuSSE2 on x86-64 and nothing on x86.
+  *
+  * \sa compiledCpuFeatures(), class CpuDispatcher
+  */
+inline int cpuFeatures()
+{
+  static const int features = internal::queryCpuFeatures();
+  return features;
+}
+
+/** \returns the instruction set extensions the current translation unit has been compiled for,
+  * as a combination of CpuFeature flags.
+  *
+  * \sa cpuFeatures(), SimdInstructionSetsInUse()
+  */
+inline int compiledCpuFeatures()
+{
+  int features = 0;
+  #ifdef EIGEN_VECTORIZE_SSE2
+  features |= CpuSSE2;
+  #endif
+  #ifdef EIGEN_VECTORIZE_SSE3
+  features |= CpuSSE3;
+  #endif
+  #ifdef EIGEN_VECTORIZE_SSSE3
+  features |= CpuSSSE3;
+  #endif
+  #ifdef EIGEN_VECTORIZE_SSE4_1
+  features |= CpuSSE4_1;
+  #endif
+  #ifdef EIGEN_VECTORIZE_SSE4_2
+  features |= CpuSSE4_2;
+  #endif
+  #ifdef EIGEN_VECTORIZE_AVX
+  features |= CpuAVX;
+  #endif
+  #ifdef EIGEN_VECTORIZE_AVX2
+  features |= CpuAVX2;
+  #endif
+  #ifdef EIGEN_VECTORIZE_FMA
+  features |= CpuFMA;
+  #endif
+  #ifdef __AVX512F__
+  features |= CpuAVX512F;
+  #endif
+  return features;
+}
+
 } // end namespace Eigen
 
 #endif // EIGEN_MEMORY_H
@@ -0,0 +1,200 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCH_TRANSFORM_H
+#define EIGEN_BATCH_TRANSFORM_H
+
+namespace Eigen {
+
+namespace internal {
+
+// The batch operations process the points or quaternions by blocks of columns copied into small row-major arrays,
+// such that each coordinate is a contiguous row and the computations are vectorized across the points, whatever the
+// storage order of the input and output. This also makes the operations safe when the output aliases the input.
+enum { GeometryBatchSize = 128 };
+
+// computes the row k of the transformed points dst = m * src, as a single expression for the usual dimensions
+template<int Dim> struct transform_points_row
+{
+  template<typename MatrixType, typename SrcType, typename DstType>
+  static void run(const MatrixType& m, Index k, const SrcType& src, DstType dst)
+  {
+    dst.setConstant(m.coeff(k,Dim));
+    for(Index l = 0; l < Dim; ++l)
+      dst += m.coeff(k,l) * src.row(l);
+  }
+};
+
+template<> struct transform_points_row<2>
+{
+  template<typename MatrixType, typename SrcType, typename DstType>
+  static void run(const MatrixType& m, Index k, const SrcType& src, DstType dst)
+  { dst = m.coeff(k,0) * src.row(0) + m.coeff(k,1) * src.row(1) + m.coeff(k,2); }
+};
+
+template<> struct transform_points_row<3>
+{
+  template<typename MatrixType, typename SrcType, typename DstType>
+  static void run(const MatrixType& m, Index k, const SrcType& src, DstType dst)
+  { dst = m.coeff(k,0) * src.row(0) + m.coeff(k,1) * src.row(1) + m.coeff(k,2) * src.row(2) + m.coeff(k,3); }
+};
+
+template<int Dim, int Mode, typename MatrixType, typename SrcType, typename BlockType>
+void transform_points_block(const MatrixType& m, const SrcType& src, BlockType& dst)
+{
+  for(Index k = 0; k < Dim; ++k)
+    transform_points_row<Dim>::run(m, k, src, dst.row(k));
+  if(Mode==Projective)
+  {
+    Array<typename BlockType::Scalar,1,BlockType::ColsAtCompileTime,RowMajor,1,BlockType::MaxColsAtCompileTime> w(1, src.cols());
+    transform_points_row<Dim>::run(m, Dim, src, w.row(0));
+    dst.rowwise() /= w;
+  }
+}
+
+template<typename Scalar, int Dim, int Mode, typename MatrixType, typename InType, typename OutType>
+void transform_points_impl(const MatrixType& m, const InType& in, OutType& out)
+{
+  typedef Array<Scalar,Dim,GeometryBatchSize,RowMajor> BlockType;
+  typedef Array<Scalar,Dim,Dynamic,RowMajor,Dim,GeometryBatchSize> TailBlockType;
+  eigen_assert(in.rows()==Dim && out.rows()==Dim && out.cols()==in.cols());
+
+  // the coordinates of row-major points are already contiguous and can be read in place
+  enum { ReadInPlace = (int(traits<InType>::Flags) & (RowMajorBit|DirectAccessBit)) == (RowMajorBit|DirectAccessBit)
+                       && int(inner_stride_at_compile_time<InType>::ret) == 1 };
+  const Index n = in.cols(), fullBlocks = n - n % GeometryBatchSize;
+  BlockType src, dst;
+  for(Index j = 0; j < fullBlocks; j += GeometryBatchSize)
+  {
+    if(ReadInPlace)
+      transform_points_block<Dim,Mode>(m, in.template middleCols<GeometryBatchSize>(j).array(), dst);
+    else
+    {
+      src = in.template middleCols<GeometryBatchSize>(j);
+      transform_points_block<Dim,Mode>(m, src, dst);
+    }
+    out.template middleCols<GeometryBatchSize>(j) = dst.matrix();
+  }
+  if(fullBlocks < n)
+  {
+    TailBlockType tailSrc = in.middleCols(fullBlocks, n-fullBlocks), tailDst(Dim, n-fullBlocks);
+    transform_points_block<Dim,Mode>(m, tailSrc, tailDst);
+    out.middleCols(fullBlocks, n-fullBlocks) = tailDst.matrix();
+  }
+}
+
+template<typename Scalar, typename AType, typename BType, typename TType, typename OutType>
+void slerp_quaternions_impl(const AType& a, const BType& b, const TType& t, OutType& out)
+{
+  typedef Array<Scalar,4,Dynamic,RowMajor,4,GeometryBatchSize> BlockType;
+  typedef Array<Scalar,1,Dynamic,RowMajor,1,GeometryBatchSize> RowType;
+  eigen_assert(a.rows()==4 && b.rows()==4 && b.cols()==a.cols() && t.cols()==a.cols());
+  eigen_assert(out.rows()==4 && out.cols()==a.cols());
+  const Scalar one = Scalar(1) - NumTraits<Scalar>::epsilon();
+
+  // same as QuaternionBase::slerp
+  BlockType qa, qb;
+  RowType tt, d, absD, theta, sinTheta, scale0, scale1;
+  for(Index j = 0; j < a.cols(); j += GeometryBatchSize)
+  {
+    const Index size = (std::min)(Index(GeometryBatchSize), a.cols()-j);
+    qa = a.middleCols(j, size);
+    qb = b.middleCols(j, size);
+    tt = t.middleCols(j, size);
+    d = (qa * qb).colwise().sum();
+    absD = d.abs();
+    theta = (absD.min)(Scalar(1)).acos();
+    sinTheta = theta.sin();
+    scale0 = (absD >= one).select(Scalar(1) - tt, ((Scalar(1) - tt) * theta).sin() / sinTheta);
+    scale1 = (absD >= one).select(tt, (tt * theta).sin() / sinTheta);
+    scale1 = (d < Scalar(0)).select(-scale1, scale1);
+    qa.rowwise() *= scale0;
+    qa += qb.rowwise() * scale1;
+    out.middleCols(j, size) = qa.matrix();
+  }
+}
+
+} // end namespace internal
+
+/** \geometry_module
+  *
+  * Applies the transformation \a t to each column of the \c Dim x \c N matrix of points \a points, and stores
+  * the transformed points into \a result, which must have the same size and can be \a points itself.
+  *
+  * This is equivalent to, but much faster than, transforming the points one by one with <tt>t * points.col(j)</tt>,
+  * the points being processed by blocks with each coordinate vectorized across the points. Any storage order is
+  * supported: a column-major \c Dim x \c N matrix (array of structures), or a row-major one (structure of arrays,
+  * which avoids any shuffling).
+  *
+  * \sa Transform::operator*()
+  */
+template<typename Scalar, int Dim, int Mode, int Options, typename InDerived, typename OutDerived>
+void transformPoints(const Transform<Scalar,Dim,Mode,Options>& t, const MatrixBase<InDerived>& points,
+                     const MatrixBase<OutDerived>& result)
+{
+  // the matrix of an AffineCompact transformation has Dim rows only
+  Matrix<Scalar,Dim+1,Dim+1> m;
+  m.setIdentity();
+  m.topRows(t.matrix().rows()) = t.matrix();
+  internal::transform_points_impl<Scalar,Dim,int(Mode)==int(Projective)?Projective:Affine>(m, points.derived(), result.const_cast_derived());
+}
+
+/** \geometry_module
+  *
+  * Applies the rotation \a r, e.g., a Quaternion or an AngleAxis, to each column of the \c Dim x \c N matrix of
+  * points \a points, and stores the rotated points into \a result, which must have the same size and can be
+  * \a points itself. The rotation is converted once to a rotation matrix.
+  *
+  * \sa transformPoints(const Transform<Scalar,Dim,Mode,Options>&, const MatrixBase<InDerived>&, const MatrixBase<OutDerived>&)
+  */
+template<typename Derived, int Dim, typename InDerived, typename OutDerived>
+void transformPoints(const RotationBase<Derived,Dim>& r, const MatrixBase<InDerived>& points,
+                     const MatrixBase<OutDerived>& result)
+{
+  typedef typename RotationBase<Derived,Dim>::Scalar Scalar;
+  Matrix<Scalar,Dim+1,Dim+1> m;
+  m.setIdentity();
+  m.template topLeftCorner<Dim,Dim>() = r.toRotationMatrix();
+  internal::transform_points_impl<Scalar,Dim,Affine>(m, points.derived(), result.const_cast_derived());
+}
+
+/** \geometry_module
+  *
+  * Computes the spherical linear interpolations between the quaternions stored in the columns of \a a and \a b,
+  * at the parameters stored in the row vector \a t, and stores the interpolated quaternions into the columns of
+  * \a result. The quaternions are stored as their coefficients (x,y,z,w), as returned by QuaternionBase::coeffs().
+  *
+  * The result is the same as the one of QuaternionBase::slerp(), but the quaternions are processed by blocks with
+  * the computations vectorized across the quaternions.
+  *
+  * \sa QuaternionBase::slerp()
+  */
+template<typename ADerived, typename BDerived, typename TDerived, typename OutDerived>
+void slerpQuaternions(const MatrixBase<ADerived>& a, const MatrixBase<BDerived>& b, const MatrixBase<TDerived>& t,
+                      const MatrixBase<OutDerived>& result)
+{
+  typedef typename ADerived::Scalar Scalar;
+  internal::slerp_quaternions_impl<Scalar>(a.derived(), b.derived(), t.derived(), result.const_cast_derived());
+}
+
+/** \geometry_module
+  *
+  * Same as slerpQuaternions(const MatrixBase<ADerived>&, const MatrixBase<BDerived>&, const MatrixBase<TDerived>&, const MatrixBase<OutDerived>&)
+  * with the same parameter \a t for all the quaternions.
+  */
+template<typename ADerived, typename BDerived, typename OutDerived>
+void slerpQuaternions(const MatrixBase<ADerived>& a, const MatrixBase<BDerived>& b, const typename ADerived::Scalar& t,
+                      const MatrixBase<OutDerived>& result)
+{
+  typedef typename ADerived::Scalar Scalar;
+  internal::slerp_quaternions_impl<Scalar>(a.derived(), b.derived(), Matrix<Scalar,1,Dynamic>::Constant(a.cols(), t),
+                                           result.const_cast_derived());
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCH_TRANSFORM_H
@@ -12,6 +12,16 @@
 
 namespace Eigen { 
 
+namespace internal {
+
+/** \internal Tells whether the solve() method of a preconditioner accepts right hand sides of several columns.
+  * ConjugateGradient then applies it to the block of all its right hand sides at once, and otherwise solves
+  * them one after the other. Specialize it for a custom preconditioner to opt in.
+  */
+template<typename Preconditioner> struct preconditioner_solves_blocks { enum { value = false }; };
+
+}
+
 /** \ingroup IterativeLinearSolvers_Module
   * \brief A preconditioner based on the digonal entries
   *
@@ -88,7 +98,7 @@ class DiagonalPreconditioner
     template<typename Rhs, typename Dest>
     void _solve_impl(const Rhs& b, Dest& x) const
     {
-      x = m_invdiag.array() * b.array() ;
+      x = m_invdiag.asDiagonal() * b;
     }
 
     template<typename Rhs> inline const Solve<DiagonalPreconditioner, Rhs>
@@ -206,6 +216,14 @@ class IdentityPreconditioner
     ComputationInfo info() { return Success; }
 };
 
+namespace internal {
+
+template<typename Scalar> struct preconditioner_solves_blocks<DiagonalPreconditioner<Scalar> > { enum { value = true }; };
+template<typename Scalar> struct preconditioner_solves_blocks<LeastSquareDiagonalPreconditioner<Scalar> > { enum { value = true }; };
+template<> struct preconditioner_solves_blocks<IdentityPreconditioner> { enum { value = true }; };
+
+}
+
 } // end namespace Eigen
 
 #endif // EIGEN_BASIC_PRECONDITIONERS_H
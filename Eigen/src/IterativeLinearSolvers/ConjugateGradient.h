@@ -89,16 +89,352 @@ void conjugate_gradient(const MatrixType& mat, const Rhs& rhs, Dest& x,
   iters = i;
 }
 
+/** \internal \returns the dot products of the matching columns of \a a and \a b, computed in a single pass over their rows */
+template<typename BlockA, typename BlockB>
+Matrix<typename BlockA::Scalar,1,Dynamic> cg_columnwise_dot(const BlockA& a, const BlockB& b)
+{
+  Matrix<typename BlockA::Scalar,1,Dynamic> res = Matrix<typename BlockA::Scalar,1,Dynamic>::Zero(a.cols());
+  for(Index i=0; i<a.rows(); ++i)
+    res += a.row(i).conjugate().cwiseProduct(b.row(i));
+  return res;
+}
+
+/** \internal Low-level conjugate gradient algorithm for multiple right hand sides
+  *
+  * The columns of \a rhs are solved simultaneously: each of them follows its own conjugate gradient
+  * recurrence, but the products with \a mat and the preconditioner are performed on the block of all the
+  * columns that have not converged yet. The converged columns are removed from the block.
+  * The blocks are stored row-major, such that the sparse matrix products apply each entry of \a mat to a
+  * whole row of the block, and \a mat is thus streamed only once per iteration.
+  * \a precond.solve() is called on row-major matrices of several columns.
+  *
+  * \param iters On input the max number of iteration, on output the number of iterations of the slowest column.
+  * \param tol_error On input the tolerance error, on output an estimation of the largest relative error.
+  */
+template<typename MatrixType, typename Rhs, typename Dest, typename Preconditioner>
+EIGEN_DONT_INLINE
+void conjugate_gradient_multi(const MatrixType& mat, const Rhs& rhs, Dest& x,
+                              const Preconditioner& precond, Index& iters,
+                              typename Dest::RealScalar& tol_error)
+{
+  using std::sqrt;
+  typedef typename Dest::RealScalar RealScalar;
+  typedef typename Dest::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> BlockType;
+  typedef Matrix<Scalar,1,Dynamic> RowVectorType;
+  typedef Matrix<RealScalar,1,Dynamic> RealRowVectorType;
+
+  RealScalar tol = tol_error;
+  Index maxIters = iters;
+
+  Index n = mat.cols();
+  Index cols = rhs.cols();
+
+  RealRowVectorType rhsNorm2 = rhs.colwise().squaredNorm();
+  RealRowVectorType error2 = RealRowVectorType::Zero(cols);   // the squared relative residual of each column
+
+  // gather the columns which are not already solved by the initial guess into the working block
+  std::vector<Index> active;
+  Matrix<Scalar,Dynamic,Dynamic> residual = rhs - mat * x;    // initial residuals
+  for(Index j=0; j<cols; ++j)
+  {
+    if(rhsNorm2(j) == 0)
+    {
+      x.col(j).setZero();
+      continue;
+    }
+    error2(j) = residual.col(j).squaredNorm() / rhsNorm2(j);
+    if(error2(j) >= tol*tol)
+      active.push_back(j);
+  }
+  Index m = Index(active.size());
+  BlockType r(n,m);
+  for(Index k=0; k<m; ++k)
+    r.col(k) = residual.col(active[k]);
+  residual.resize(0,0);
+
+  BlockType p(n,m), z(n,m), tmp(n,m);
+  RealRowVectorType absNew(m), absOld(m), residualNorm2(m);
+  if(m>0)
+  {
+    p = precond.solve(r);                                     // initial search directions
+    absNew = cg_columnwise_dot(r, p).real();
+  }
+
+  Index i = 0;
+  while(m>0 && i < maxIters)
+  {
+    tmp.leftCols(m).noalias() = mat * p.leftCols(m);          // the bottleneck of the algorithm
+
+    RowVectorType alpha = absNew.head(m).template cast<Scalar>().cwiseQuotient(cg_columnwise_dot(p.leftCols(m), tmp.leftCols(m)));
+    for(Index l=0; l<n; ++l)
+      for(Index k=0; k<m; ++k)
+        x.coeffRef(l,active[k]) += alpha(k) * p.coeff(l,k);
+    r.leftCols(m) -= tmp.leftCols(m) * alpha.asDiagonal();
+
+    // remove the converged columns by swapping them with the last active ones
+    residualNorm2.head(m) = cg_columnwise_dot(r.leftCols(m), r.leftCols(m)).real();
+    for(Index k=0; k<m; )
+    {
+      Index j = active[k];
+      error2(j) = residualNorm2(k) / rhsNorm2(j);
+      if(error2(j) < tol*tol)
+      {
+        --m;
+        r.col(k).swap(r.col(m));
+        p.col(k).swap(p.col(m));
+        std::swap(absNew(k), absNew(m));
+        std::swap(residualNorm2(k), residualNorm2(m));
+        std::swap(active[k], active[m]);
+      }
+      else
+        ++k;
+    }
+    if(m==0)
+      break;
+
+    z.leftCols(m) = precond.solve(r.leftCols(m));            // approximately solve for "A z = residual"
+
+    absOld.head(m) = absNew.head(m);
+    absNew.head(m) = cg_columnwise_dot(r.leftCols(m), z.leftCols(m)).real();
+    RowVectorType beta = absNew.head(m).cwiseQuotient(absOld.head(m)).template cast<Scalar>();
+    p.leftCols(m) = z.leftCols(m) + p.leftCols(m) * beta.asDiagonal();
+    i++;
+  }
+  tol_error = cols>0 ? sqrt(error2.maxCoeff()) : RealScalar(0);
+  iters = i;
+}
+
+/** \internal Runs \a kernel on \a threads contiguous ranges of [0,size) */
+template<typename Kernel>
+void pipelined_cg_run(Kernel& kernel, Index size, Index threads)
+{
+#ifdef EIGEN_HAS_OPENMP
+  if(threads>1)
+  {
+    #pragma omp parallel for schedule(static,1) num_threads(threads)
+    for(Index t=0; t<threads; ++t)
+      kernel((size*t)/threads, (size*(t+1))/threads, t);
+    return;
+  }
+#endif
+  EIGEN_UNUSED_VARIABLE(threads);
+  kernel(0, size, 0);
+}
+
+/** \internal Computes the three reductions of an iteration of the pipelined conjugate gradient in a single pass */
+template<typename Scalar>
+struct pipelined_cg_dots
+{
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  pipelined_cg_dots(const Scalar* r, const Scalar* u, const Scalar* w, Index threads)
+    : m_r(r), m_u(u), m_w(w), m_ru(threads), m_wu(threads), m_rr(threads)
+  {}
+
+  void operator()(Index begin, Index end, Index t)
+  {
+    Scalar ru(0), wu(0);
+    RealScalar rr(0);
+    for(Index i=begin; i<end; ++i)
+    {
+      ru += numext::conj(m_r[i]) * m_u[i];
+      wu += numext::conj(m_w[i]) * m_u[i];
+      rr += numext::abs2(m_r[i]);
+    }
+    m_ru[t] = ru;
+    m_wu[t] = wu;
+    m_rr[t] = rr;
+  }
+
+  // sums the partial results of each range in a fixed order
+  void result(RealScalar& gamma, RealScalar& delta, RealScalar& residualNorm2) const
+  {
+    Scalar ru(0), wu(0);
+    residualNorm2 = RealScalar(0);
+    for(size_t t=0; t<m_rr.size(); ++t)
+    {
+      ru += m_ru[t];
+      wu += m_wu[t];
+      residualNorm2 += m_rr[t];
+    }
+    gamma = numext::real(ru);
+    delta = numext::real(wu);
+  }
+
+  const Scalar *m_r, *m_u, *m_w;
+  std::vector<Scalar> m_ru, m_wu;
+  std::vector<RealScalar> m_rr;
+};
+
+/** \internal Updates the eight vectors of an iteration of the pipelined conjugate gradient and the solution in a single pass */
+template<typename Scalar, typename Dest>
+struct pipelined_cg_update
+{
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  void operator()(Index begin, Index end, Index)
+  {
+    for(Index i=begin; i<end; ++i)
+    {
+      if(m_restart)
+      {
+        m_z[i] = m_nv[i];
+        m_q[i] = m_mv[i];
+        m_s[i] = m_w[i];
+        m_p[i] = m_u[i];
+      }
+      else
+      {
+        m_z[i] = m_nv[i] + m_beta * m_z[i];
+        m_q[i] = m_mv[i] + m_beta * m_q[i];
+        m_s[i] = m_w[i] + m_beta * m_s[i];
+        m_p[i] = m_u[i] + m_beta * m_p[i];
+      }
+      m_x->coeffRef(i) += m_alpha * m_p[i];
+      m_r[i] -= m_alpha * m_s[i];
+      m_u[i] -= m_alpha * m_q[i];
+      m_w[i] -= m_alpha * m_z[i];
+    }
+  }
+
+  Scalar *m_r, *m_u, *m_w, *m_p, *m_s, *m_q, *m_z;
+  const Scalar *m_mv, *m_nv;
+  Dest* m_x;
+  RealScalar m_alpha, m_beta;
+  bool m_restart;
+};
+
+/** \internal Low-level pipelined conjugate gradient algorithm
+  *
+  * This is the preconditioned pipelined conjugate gradient of P. Ghysels and W. Vanroose, "Hiding global
+  * synchronization latency in the preconditioned Conjugate Gradient algorithm", Parallel Computing, 2014.
+  * The three reductions of an iteration are computed together in a single pass, and do not depend on the
+  * preconditioner and matrix-vector product of the same iteration, which can run concurrently. All the vector
+  * updates are fused into a second pass. These passes are multithreaded for large problems.
+  *
+  * Since the rounding errors of the additional recurrences limit the attainable accuracy, the true residual
+  * is recomputed every 50 iterations and when the recurrences report the convergence, and the recurrences
+  * are then replaced by their true values (residual replacement).
+  *
+  * The parameters are the same as for conjugate_gradient().
+  */
+template<typename MatrixType, typename Rhs, typename Dest, typename Preconditioner>
+EIGEN_DONT_INLINE
+void conjugate_gradient_pipelined(const MatrixType& mat, const Rhs& rhs, Dest& x,
+                                  const Preconditioner& precond, Index& iters,
+                                  typename Dest::RealScalar& tol_error)
+{
+  using std::sqrt;
+  typedef typename Dest::RealScalar RealScalar;
+  typedef typename Dest::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+  RealScalar tol = tol_error;
+  Index maxIters = iters;
+
+  Index n = mat.cols();
+
+  VectorType r = rhs - mat * x; //initial residual
+
+  RealScalar rhsNorm2 = rhs.squaredNorm();
+  if(rhsNorm2 == 0)
+  {
+    x.setZero();
+    iters = 0;
+    tol_error = 0;
+    return;
+  }
+  RealScalar threshold = tol*tol*rhsNorm2;
+  RealScalar residualNorm2 = r.squaredNorm();
+  if (residualNorm2 < threshold)
+  {
+    iters = 0;
+    tol_error = sqrt(residualNorm2 / rhsNorm2);
+    return;
+  }
+
+  // the vector kernels are only worth being multithreaded for large problems
+  Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+  if(n >= 32768 && omp_get_num_threads()==1)
+    threads = nbThreads();
+#endif
+
+  VectorType u(n), w(n), m(n), nv(n), p(n), s(n), q(n), z(n);
+  u = precond.solve(r);
+  w.noalias() = mat * u;
+
+  pipelined_cg_dots<Scalar> dots(r.data(), u.data(), w.data(), threads);
+  pipelined_cg_update<Scalar,Dest> update;
+  update.m_r = r.data(); update.m_u = u.data(); update.m_w = w.data();
+  update.m_p = p.data(); update.m_s = s.data(); update.m_q = q.data(); update.m_z = z.data();
+  update.m_mv = m.data(); update.m_nv = nv.data();
+  update.m_x = &x;
+  update.m_restart = true;
+
+  RealScalar gamma(0), gammaOld(0), delta(0), alpha(0);
+  const Index replacementPeriod = 50;
+  Index i = 0;
+  while(i < maxIters)
+  {
+    pipelined_cg_run(dots, n, threads);
+    dots.result(gamma, delta, residualNorm2);
+
+    if(residualNorm2 < threshold || (i>0 && i%replacementPeriod==0))
+    {
+      r = rhs - mat * x;
+      residualNorm2 = r.squaredNorm();
+      if(residualNorm2 < threshold)
+        break;
+      // replace the recurrences by their true values, while keeping the search direction p
+      u = precond.solve(r);
+      w.noalias() = mat * u;
+      if(!update.m_restart)
+      {
+        s.noalias() = mat * p;
+        q = precond.solve(s);
+        z.noalias() = mat * q;
+      }
+      pipelined_cg_run(dots, n, threads);
+      dots.result(gamma, delta, residualNorm2);
+    }
+
+    m = precond.solve(w);
+    nv.noalias() = mat * m;                     // the bottleneck of the algorithm
+
+    if(update.m_restart)
+    {
+      update.m_beta = RealScalar(0);
+      alpha = gamma / delta;
+    }
+    else
+    {
+      update.m_beta = gamma / gammaOld;
+      alpha = gamma / (delta - update.m_beta * gamma / alpha);
+    }
+    update.m_alpha = alpha;
+    pipelined_cg_run(update, n, threads);
+    update.m_restart = false;
+
+    gammaOld = gamma;
+    i++;
+  }
+  tol_error = sqrt(residualNorm2 / rhsNorm2);
+  iters = i;
+}
+
 }
 
 template< typename _MatrixType, int _UpLo=Lower,
-          typename _Preconditioner = DiagonalPreconditioner<typename _MatrixType::Scalar> >
+          typename _Preconditioner = DiagonalPreconditioner<typename _MatrixType::Scalar>,
+          int _Variant = StandardCG >
 class ConjugateGradient;
 
 namespace internal {
 
-template< typename _MatrixType, int _UpLo, typename _Preconditioner>
-struct traits<ConjugateGradient<_MatrixType,_UpLo,_Preconditioner> >
+template< typename _MatrixType, int _UpLo, typename _Preconditioner, int _Variant>
+struct traits<ConjugateGradient<_MatrixType,_UpLo,_Preconditioner,_Variant> >
 {
   typedef _MatrixType MatrixType;
   typedef _Preconditioner Preconditioner;
@@ -117,6 +453,7 @@ struct traits<ConjugateGradient<_MatrixType,_UpLo,_Preconditioner> >
   *               \c Upper, or \c Lower|Upper in which the full matrix entries will be considered.
   *               Default is \c Lower, best performance is \c Lower|Upper.
   * \tparam _Preconditioner the type of the preconditioner. Default is DiagonalPreconditioner
+  * \tparam _Variant the variant of the iterations, either \c StandardCG (the default) or \c PipelinedCG.
   *
   * \implsparsesolverconcept
   *
@@ -148,13 +485,28 @@ struct traits<ConjugateGradient<_MatrixType,_UpLo,_Preconditioner> >
   * 
   * By default the iterations start with x=0 as an initial guess of the solution.
   * One can control the start using the solveWithGuess() method.
+  *
+  * When the right hand side has several columns and the preconditioner accepts blocks of right hand sides, as
+  * all the preconditioners provided by Eigen do, they are all solved simultaneously: the products with the
+  * matrix A and the preconditioner are performed on a row-major block of the columns that have not converged
+  * yet, such that a sparse matrix A is streamed only once per iteration for all the columns. In this case,
+  * iterations() and error() report the values of the slowest column. A custom preconditioner opts in by
+  * specializing internal::preconditioner_solves_blocks, otherwise the columns are solved one after the other.
+  * 
+  * The \c PipelinedCG variant performs the same number of matrix-vector products and preconditioner solves per
+  * iteration, but in a way that removes the dependency between the reductions (dot products) and the
+  * matrix-vector product of each iteration, and fuses all the vector operations of an iteration into two passes over
+  * memory, instead of a sequence of dependent dot products and AXPY operations. It is thus faster for large problems
+  * when multithreading is enabled, at the price of four additional vectors and of a slightly less stable recurrence
+  * for the residual: the true residual is periodically recomputed, and accuracies close to the machine precision
+  * may not be attainable. The right hand sides are then solved one after the other.
   * 
   * ConjugateGradient can also be used in a matrix-free context, see the following \link MatrixfreeSolverExample example \endlink.
   *
   * \sa class LeastSquaresConjugateGradient, class SimplicialCholesky, DiagonalPreconditioner, IdentityPreconditioner
   */
-template< typename _MatrixType, int _UpLo, typename _Preconditioner>
-class ConjugateGradient : public IterativeSolverBase<ConjugateGradient<_MatrixType,_UpLo,_Preconditioner> >
+template< typename _MatrixType, int _UpLo, typename _Preconditioner, int _Variant>
+class ConjugateGradient : public IterativeSolverBase<ConjugateGradient<_MatrixType,_UpLo,_Preconditioner,_Variant> >
 {
   typedef IterativeSolverBase<ConjugateGradient> Base;
   using Base::matrix;
@@ -169,7 +521,8 @@ public:
   typedef _Preconditioner Preconditioner;
 
   enum {
-    UpLo = _UpLo
+    UpLo = _UpLo,
+    Variant = _Variant
   };
 
 public:
@@ -210,18 +563,17 @@ public:
                                            RowMajorWrapper,
                                            typename MatrixWrapper::template ConstSelfAdjointViewReturnType<UpLo>::Type
                                           >::type SelfAdjointWrapper;
+    enum {
+      // the matrix-free operators are only required to implement matrix-vector products,
+      // and the custom preconditioners to solve for vectors
+      MultipleRhs = (!MatrixWrapper::MatrixFree) && (Dest::ColsAtCompileTime!=1) && (int(Variant)==int(StandardCG))
+                 && internal::preconditioner_solves_blocks<Preconditioner>::value
+    };
     m_iterations = Base::maxIterations();
     m_error = Base::m_tolerance;
 
-    for(Index j=0; j<b.cols(); ++j)
-    {
-      m_iterations = Base::maxIterations();
-      m_error = Base::m_tolerance;
-
-      typename Dest::ColXpr xj(x,j);
-      RowMajorWrapper row_mat(matrix());
-      internal::conjugate_gradient(SelfAdjointWrapper(row_mat), b.col(j), xj, Base::m_preconditioner, m_iterations, m_error);
-    }
+    RowMajorWrapper row_mat(matrix());
+    solve_columns(SelfAdjointWrapper(row_mat), b, x, typename internal::conditional<MultipleRhs,internal::true_type,internal::false_type>::type());
 
     m_isInitialized = true;
     m_info = m_error <= Base::m_tolerance ? Success : NoConvergence;
@@ -238,6 +590,40 @@ public:
 
 protected:
 
+  template<typename SelfAdjointWrapper, typename Rhs, typename Dest>
+  void solve_columns(const SelfAdjointWrapper& mat, const Rhs& b, Dest& x, internal::false_type) const
+  {
+    for(Index j=0; j<b.cols(); ++j)
+    {
+      m_iterations = Base::maxIterations();
+      m_error = Base::m_tolerance;
+
+      typename Dest::ColXpr xj(x,j);
+      solve_column(mat, b.col(j), xj, typename internal::conditional<int(Variant)==int(PipelinedCG),internal::true_type,internal::false_type>::type());
+    }
+  }
+
+  template<typename SelfAdjointWrapper, typename Rhs, typename Dest>
+  void solve_column(const SelfAdjointWrapper& mat, const Rhs& b, Dest& x, internal::false_type) const
+  {
+    internal::conjugate_gradient(mat, b, x, Base::m_preconditioner, m_iterations, m_error);
+  }
+
+  template<typename SelfAdjointWrapper, typename Rhs, typename Dest>
+  void solve_column(const SelfAdjointWrapper& mat, const Rhs& b, Dest& x, internal::true_type) const
+  {
+    internal::conjugate_gradient_pipelined(mat, b, x, Base::m_preconditioner, m_iterations, m_error);
+  }
+
+  template<typename SelfAdjointWrapper, typename Rhs, typename Dest>
+  void solve_columns(const SelfAdjointWrapper& mat, const Rhs& b, Dest& x, internal::true_type) const
+  {
+    if(b.cols()==1)
+      solve_columns(mat, b, x, internal::false_type());
+    else
+      internal::conjugate_gradient_multi(mat, b, x, Base::m_preconditioner, m_iterations, m_error);
+  }
+
 };
 
 } // end namespace Eigen
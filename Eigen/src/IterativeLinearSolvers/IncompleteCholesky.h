@@ -158,8 +158,16 @@ class IncompleteCholesky : public SparseSolverBase<IncompleteCholesky<Scalar,_Up
       if (m_perm.rows() == b.rows())  x = m_perm * b;
       else                            x = b;
       x = m_scale.asDiagonal() * x;
-      x = m_L.template triangularView<Lower>().solve(x);
-      x = m_L.adjoint().template triangularView<Upper>().solve(x);
+      if (m_lowerLevels.isParallelizable() && m_upperLevels.isParallelizable())
+      {
+        m_lowerLevels.template solveInPlace<Lower>(m_Lrow, x);
+        m_upperLevels.template solveInPlace<Upper>(m_L.adjoint(), x);
+      }
+      else
+      {
+        x = m_L.template triangularView<Lower>().solve(x);
+        x = m_L.adjoint().template triangularView<Upper>().solve(x);
+      }
       x = m_scale.asDiagonal() * x;
       if (m_perm.rows() == b.rows())
         x = m_perm.inverse() * x;
@@ -182,11 +190,19 @@ class IncompleteCholesky : public SparseSolverBase<IncompleteCholesky<Scalar,_Up
     bool m_factorizationIsOk; 
     ComputationInfo m_info;
     PermutationType m_perm; 
+    SparseMatrix<Scalar,RowMajor,StorageIndex> m_Lrow;                // Row-major copy of L for the multithreaded solves
+    internal::sparse_level_schedule<StorageIndex> m_lowerLevels;      // Level scheduling of the multithreaded solves
+    internal::sparse_level_schedule<StorageIndex> m_upperLevels;
 
   private:
     inline void updateList(Ref<const VectorIx> colPtr, Ref<VectorIx> rowIdx, Ref<VectorSx> vals, const Index& col, const Index& jk, VectorIx& firstElt, VectorList& listCol); 
 }; 
 
+namespace internal {
+template<typename Scalar, int UpLo, typename OrderingType>
+struct preconditioner_solves_blocks<IncompleteCholesky<Scalar,UpLo,OrderingType> > { enum { value = true }; };
+}
+
 // Based on the following paper:
 //   C-J. Lin and J. J. Moré, Incomplete Cholesky Factorizations with
 //   Limited memory, SIAM J. Sci. Comput.  21(1), pp. 24-45, 1999
@@ -197,6 +213,9 @@ void IncompleteCholesky<Scalar,_UpLo, OrderingType>::factorize(const _MatrixType
 {
   using std::sqrt;
   eigen_assert(m_analysisIsOk && "analyzePattern() should be called first"); 
+  m_lowerLevels.clear();
+  m_upperLevels.clear();
+  m_Lrow.resize(0,0);
     
   // Dropping strategy : Keep only the p largest elements per column, where p is the number of elements in the column of the original matrix. Other strategies will be added
   
@@ -373,6 +392,14 @@ void IncompleteCholesky<Scalar,_UpLo, OrderingType>::factorize(const _MatrixType
       m_info = Success;
     }
   } while(m_info!=Success);
+
+  // Analyze the dependencies of the triangular solves when they can run in parallel
+  if(nbThreads()>1)
+  {
+    m_Lrow = m_L;
+    m_lowerLevels.compute(m_Lrow, Lower);
+    m_upperLevels.compute(m_L.adjoint(), Upper);
+  }
 }
 
 template<typename Scalar, int _UpLo, typename OrderingType>
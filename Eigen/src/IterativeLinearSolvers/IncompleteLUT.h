@@ -171,8 +171,16 @@ class IncompleteLUT : public SparseSolverBase<IncompleteLUT<_Scalar, _StorageInd
     void _solve_impl(const Rhs& b, Dest& x) const
     {
       x = m_Pinv * b;
-      x = m_lu.template triangularView<UnitLower>().solve(x);
-      x = m_lu.template triangularView<Upper>().solve(x);
+      if(m_lowerLevels.isParallelizable() && m_upperLevels.isParallelizable())
+      {
+        m_lowerLevels.template solveInPlace<UnitLower>(m_lu, x);
+        m_upperLevels.template solveInPlace<Upper>(m_lu, x);
+      }
+      else
+      {
+        x = m_lu.template triangularView<UnitLower>().solve(x);
+        x = m_lu.template triangularView<Upper>().solve(x);
+      }
       x = m_P * x; 
     }
 
@@ -196,8 +204,15 @@ protected:
     ComputationInfo m_info;
     PermutationMatrix<Dynamic,Dynamic,StorageIndex> m_P;     // Fill-reducing permutation
     PermutationMatrix<Dynamic,Dynamic,StorageIndex> m_Pinv;  // Inverse permutation
+    internal::sparse_level_schedule<StorageIndex> m_lowerLevels; // Level scheduling of the multithreaded solves
+    internal::sparse_level_schedule<StorageIndex> m_upperLevels;
 };
 
+namespace internal {
+template<typename Scalar, typename StorageIndex>
+struct preconditioner_solves_blocks<IncompleteLUT<Scalar,StorageIndex> > { enum { value = true }; };
+}
+
 /**
  * Set control parameter droptol
  *  \param droptol   Drop any element whose magnitude is less than this tolerance 
@@ -453,6 +468,15 @@ void IncompleteLUT<Scalar,StorageIndex>::factorize(const _MatrixType& amat)
   m_lu.finalize();
   m_lu.makeCompressed();
 
+  // analyze the dependencies of the triangular solves when they can run in parallel
+  m_lowerLevels.clear();
+  m_upperLevels.clear();
+  if(nbThreads()>1)
+  {
+    m_lowerLevels.compute(m_lu, Lower);
+    m_upperLevels.compute(m_lu, Upper);
+  }
+
   m_factorizationIsOk = true;
   m_info = Success;
 }
@@ -48,6 +48,13 @@ template<typename _MatrixType> struct traits<FullPivLU<_MatrixType> >
   * The data of the LU decomposition can be directly accessed through the methods matrixLU(),
   * permutationP(), permutationQ().
   *
+  * For large matrices, the search for the biggest coefficient of the remaining corner makes complete
+  * pivoting inherently sequential and bound by memory bandwidth. Calling setRookPivoting() before compute()
+  * switches to a blocked variant using rook pivoting: the pivot is only required to be the biggest
+  * coefficient in both its row and its column. This is still rank-revealing in practice, and since
+  * the candidate rows and columns can be updated lazily, most of the work is done through
+  * matrix-matrix products. All the other methods (rank(), kernel(), image(), solve(), ...) work the same way.
+  *
   * As an exemple, here is how the original matrix can be retrieved:
   * \include class_FullPivLU.cpp
   * Output: \verbinclude class_FullPivLU.out
@@ -281,6 +288,28 @@ template<typename _MatrixType> class FullPivLU
       return *this;
     }
 
+    /** Allows to select the pivoting strategy used by the next call to compute().
+      *
+      * \param enable if true, use a blocked LU with rook pivoting. Each pivot is the biggest
+      *               coefficient in both its row and its column of the remaining corner, which allows
+      *               the trailing corner to be updated by blocks through matrix-matrix products. This is
+      *               much faster than complete pivoting for large matrices.
+      *               If false (the default), use complete pivoting.
+      *
+      * \sa usesRookPivoting()
+      */
+    FullPivLU& setRookPivoting(bool enable = true)
+    {
+      m_useRookPivoting = enable;
+      return *this;
+    }
+
+    /** \returns true if the blocked rook pivoting strategy is used.
+      *
+      * \sa setRookPivoting()
+      */
+    bool usesRookPivoting() const { return m_useRookPivoting; }
+
     /** Allows to come back to the default behavior, letting Eigen use its default formula for
       * determining the threshold.
       *
@@ -412,6 +441,8 @@ template<typename _MatrixType> class FullPivLU
     }
 
     void computeInPlace();
+    Index computeCompletePivoting();
+    Index computeBlockedRookPivoting();
 
     MatrixType m_lu;
     PermutationPType m_p;
@@ -422,12 +453,12 @@ template<typename _MatrixType> class FullPivLU
     RealScalar m_l1_norm;
     RealScalar m_maxpivot, m_prescribedThreshold;
     char m_det_pq;
-    bool m_isInitialized, m_usePrescribedThreshold;
+    bool m_isInitialized, m_usePrescribedThreshold, m_useRookPivoting;
 };
 
 template<typename MatrixType>
 FullPivLU<MatrixType>::FullPivLU()
-  : m_isInitialized(false), m_usePrescribedThreshold(false)
+  : m_isInitialized(false), m_usePrescribedThreshold(false), m_useRookPivoting(false)
 {
 }
 
@@ -439,7 +470,8 @@ FullPivLU<MatrixType>::FullPivLU(Index rows, Index cols)
     m_rowsTranspositions(rows),
     m_colsTranspositions(cols),
     m_isInitialized(false),
-    m_usePrescribedThreshold(false)
+    m_usePrescribedThreshold(false),
+    m_useRookPivoting(false)
 {
 }
 
@@ -452,7 +484,8 @@ FullPivLU<MatrixType>::FullPivLU(const EigenBase<InputType>& matrix)
     m_rowsTranspositions(matrix.rows()),
     m_colsTranspositions(matrix.cols()),
     m_isInitialized(false),
-    m_usePrescribedThreshold(false)
+    m_usePrescribedThreshold(false),
+    m_useRookPivoting(false)
 {
   compute(matrix.derived());
 }
@@ -486,7 +519,32 @@ void FullPivLU<MatrixType>::computeInPlace()
   // can't accumulate on-the-fly because that will be done in reverse order for the rows.
   m_rowsTranspositions.resize(m_lu.rows());
   m_colsTranspositions.resize(m_lu.cols());
-  Index number_of_transpositions = 0; // number of NONTRIVIAL transpositions, i.e. m_rowsTranspositions[i]!=i
+
+  // number of NONTRIVIAL transpositions, i.e. m_rowsTranspositions[i]!=i
+  Index number_of_transpositions = m_useRookPivoting ? computeBlockedRookPivoting()
+                                                     : computeCompletePivoting();
+
+  // the main loop is over, we still have to accumulate the transpositions to find the
+  // permutations P and Q
+
+  m_p.setIdentity(rows);
+  for(Index k = size-1; k >= 0; --k)
+    m_p.applyTranspositionOnTheRight(k, m_rowsTranspositions.coeff(k));
+
+  m_q.setIdentity(cols);
+  for(Index k = 0; k < size; ++k)
+    m_q.applyTranspositionOnTheRight(k, m_colsTranspositions.coeff(k));
+
+  m_det_pq = (number_of_transpositions%2) ? -1 : 1;
+}
+
+template<typename MatrixType>
+Index FullPivLU<MatrixType>::computeCompletePivoting()
+{
+  const Index size = m_lu.diagonalSize();
+  const Index rows = m_lu.rows();
+  const Index cols = m_lu.cols();
+  Index number_of_transpositions = 0;
 
   m_nonzero_pivots = size; // the generic case is that in which all pivots are nonzero (invertible case)
   m_maxpivot = RealScalar(0);
@@ -545,18 +603,131 @@ void FullPivLU<MatrixType>::computeInPlace()
       m_lu.block(k+1,k+1,rows-k-1,cols-k-1).noalias() -= m_lu.col(k).tail(rows-k-1) * m_lu.row(k).tail(cols-k-1);
   }
 
-  // the main loop is over, we still have to accumulate the transpositions to find the
-  // permutations P and Q
+  return number_of_transpositions;
+}
 
-  m_p.setIdentity(rows);
-  for(Index k = size-1; k >= 0; --k)
-    m_p.applyTranspositionOnTheRight(k, m_rowsTranspositions.coeff(k));
+/* Blocked LU with rook pivoting.
+ *
+ * Within a panel of bs columns, the trailing corner is not updated: the pending rank-bs update is
+ * applied lazily, one candidate column or row at a time, while searching for a coefficient which
+ * is the biggest of both its row and its column. Once the pivot is found, its updated row and column
+ * directly become the k-th row of U and the k-th column of L. At the end of the panel, the trailing
+ * corner is updated at once by a matrix-matrix product.
+ */
+template<typename MatrixType>
+Index FullPivLU<MatrixType>::computeBlockedRookPivoting()
+{
+  typedef internal::scalar_score_coeff_op<Scalar> Scoring;
+  typedef typename Scoring::result_type Score;
+  typedef typename internal::plain_col_type<MatrixType>::type ColVectorType;
+  typedef typename internal::plain_row_type<MatrixType>::type RowVectorType;
 
-  m_q.setIdentity(cols);
-  for(Index k = 0; k < size; ++k)
-    m_q.applyTranspositionOnTheRight(k, m_colsTranspositions.coeff(k));
+  const Index size = m_lu.diagonalSize();
+  const Index rows = m_lu.rows();
+  const Index cols = m_lu.cols();
+  Index number_of_transpositions = 0;
 
-  m_det_pq = (number_of_transpositions%2) ? -1 : 1;
+  m_nonzero_pivots = size;
+  m_maxpivot = RealScalar(0);
+
+  // same heuristic as in the blocked partial pivoting, but with a smaller upper bound because
+  // the cost of the lazy updates of the candidate rows and columns grows with the panel width.
+  Index blockSize = size/8;
+  blockSize = (blockSize/16)*16;
+  blockSize = (std::min)((std::max)(blockSize,Index(8)), Index(64));
+
+  ColVectorType colv(rows);
+  RowVectorType rowv(cols);
+
+  for(Index k0 = 0; k0 < size; k0 += blockSize)
+  {
+    const Index bs = (std::min)(size-k0, blockSize);
+
+    for(Index k = k0; k < k0+bs; ++k)
+    {
+      // number of pending updates of the trailing corner
+      const Index pk = k-k0;
+
+      // find the first column of the remaining corner which is not zero
+      Index r = k, c = k;
+      Score col_score = Score(0);
+      for(; c < cols; ++c)
+      {
+        colv.tail(rows-k) = m_lu.col(c).tail(rows-k);
+        colv.tail(rows-k).noalias() -= m_lu.block(k,k0,rows-k,pk) * m_lu.col(c).segment(k0,pk);
+        col_score = colv.tail(rows-k).unaryExpr(Scoring()).maxCoeff(&r);
+        if(col_score!=Score(0))
+          break;
+      }
+
+      if(col_score==Score(0))
+      {
+        // the remaining corner is exactly zero, there is no pending update to apply
+        m_nonzero_pivots = k;
+        m_lu.bottomRightCorner(rows-k, cols-k).setZero();
+        for(Index i = k; i < size; ++i)
+        {
+          m_rowsTranspositions.coeffRef(i) = i;
+          m_colsTranspositions.coeffRef(i) = i;
+        }
+        return number_of_transpositions;
+      }
+      r += k;
+
+      // alternate between rows and columns until (r,c) is the biggest in both
+      while(true)
+      {
+        Index c2;
+        rowv.tail(cols-k) = m_lu.row(r).tail(cols-k);
+        rowv.tail(cols-k).noalias() -= m_lu.row(r).segment(k0,pk) * m_lu.block(k0,k,pk,cols-k);
+        Score row_score = rowv.tail(cols-k).unaryExpr(Scoring()).maxCoeff(&c2);
+        if(row_score <= col_score)
+          break;
+        c = c2 + k;
+        col_score = row_score;
+
+        Index r2;
+        colv.tail(rows-k) = m_lu.col(c).tail(rows-k);
+        colv.tail(rows-k).noalias() -= m_lu.block(k,k0,rows-k,pk) * m_lu.col(c).segment(k0,pk);
+        Score score = colv.tail(rows-k).unaryExpr(Scoring()).maxCoeff(&r2);
+        if(score <= col_score)
+          break;
+        r = r2 + k;
+        col_score = score;
+      }
+
+      m_rowsTranspositions.coeffRef(k) = r;
+      m_colsTranspositions.coeffRef(k) = c;
+      if(k != r) {
+        m_lu.row(k).swap(m_lu.row(r));
+        std::swap(colv.coeffRef(k), colv.coeffRef(r));
+        ++number_of_transpositions;
+      }
+      if(k != c) {
+        m_lu.col(k).swap(m_lu.col(c));
+        std::swap(rowv.coeffRef(k), rowv.coeffRef(c));
+        ++number_of_transpositions;
+      }
+
+      // the updated column and row are the k-th column of L and the k-th row of U
+      m_lu.col(k).tail(rows-k) = colv.tail(rows-k);
+      m_lu.row(k).tail(cols-k-1) = rowv.tail(cols-k-1);
+
+      RealScalar abs_pivot = internal::abs_knowing_score<Scalar>()(m_lu.coeff(k,k), col_score);
+      if(abs_pivot > m_maxpivot) m_maxpivot = abs_pivot;
+
+      if(k<rows-1)
+        m_lu.col(k).tail(rows-k-1) /= m_lu.coeff(k,k);
+    }
+
+    // apply the pending updates to the trailing corner
+    const Index kend = k0+bs;
+    if(kend<rows && kend<cols)
+      m_lu.bottomRightCorner(rows-kend, cols-kend).noalias()
+        -= m_lu.block(kend,k0,rows-kend,bs) * m_lu.block(k0,kend,bs,cols-kend);
+  }
+
+  return number_of_transpositions;
 }
 
 template<typename MatrixType>
@@ -56,6 +56,10 @@ struct traits<BDCSVD<_MatrixType> >
  * For small matrice (<16), it is thus preferable to directly use JacobiSVD. For larger ones, BDCSVD is highly
  * recommended and can several order of magnitude faster.
  *
+ * If OpenMP is enabled, the two halves of the subproblems larger than setTaskSize() are diagonalized by concurrent
+ * tasks of nbThreads() threads, and the secular equations and singular vectors of the final merge are computed in
+ * parallel, its matrix products being parallelized as usual.
+ *
  * \warning this algorithm is unlikely to provide accurate result when compiled with unsafe math optimizations.
  * For instance, this concerns Intel's compiler (ICC), which perfroms such optimization by default unless
  * you compile with the \c -fp-model \c precise option. Likewise, the \c -ffast-math option of GCC or clang will
@@ -104,7 +108,7 @@ public:
    * The default constructor is useful in cases in which the user intends to
    * perform decompositions via BDCSVD::compute(const MatrixType&).
    */
-  BDCSVD() : m_algoswap(16), m_numIters(0)
+  BDCSVD() : m_algoswap(16), m_taskSize(128), m_inTasks(false), m_numIters(0)
   {}
 
 
@@ -115,7 +119,7 @@ public:
    * \sa BDCSVD()
    */
   BDCSVD(Index rows, Index cols, unsigned int computationOptions = 0)
-    : m_algoswap(16), m_numIters(0)
+    : m_algoswap(16), m_taskSize(128), m_inTasks(false), m_numIters(0)
   {
     allocate(rows, cols, computationOptions);
   }
@@ -131,7 +135,7 @@ public:
    * available with the (non - default) FullPivHouseholderQR preconditioner.
    */
   BDCSVD(const MatrixType& matrix, unsigned int computationOptions = 0)
-    : m_algoswap(16), m_numIters(0)
+    : m_algoswap(16), m_taskSize(128), m_inTasks(false), m_numIters(0)
   {
     compute(matrix, computationOptions);
   }
@@ -168,29 +172,44 @@ public:
     eigen_assert(s>3 && "BDCSVD the size of the algo switch has to be greater than 3");
     m_algoswap = s;
   }
+
+  /** Sets the size of the subproblems whose two halves are diagonalized by concurrent OpenMP tasks, default is 128.
+    * The merges of at least this size outside of the tasks also solve their secular equations in parallel. */
+  void setTaskSize(int s)
+  {
+    eigen_assert(s>0 && "BDCSVD the task size has to be positive");
+    m_taskSize = s;
+  }
+
+  /** \returns the size of the subproblems diagonalized by concurrent tasks */
+  int taskSize() const { return m_taskSize; }
  
 private:
   void allocate(Index rows, Index cols, unsigned int computationOptions);
   void divide(Index firstCol, Index lastCol, Index firstRowW, Index firstColW, Index shift);
-  void computeSVDofM(Index firstCol, Index n, MatrixXr& U, VectorType& singVals, MatrixXr& V);
-  void computeSingVals(const ArrayRef& col0, const ArrayRef& diag, const IndicesRef& perm, VectorType& singVals, ArrayRef shifts, ArrayRef mus);
+  void computeSVDofM(Index firstCol, Index n, MatrixXr& U, VectorType& singVals, MatrixXr& V, ArrayRef workspace, IndicesRef workspaceI);
+  void computeSingVals(const ArrayRef& col0, const ArrayRef& diag, const IndicesRef& perm, VectorType& singVals, ArrayRef shifts, ArrayRef mus, ArrayRef workspace);
   void perturbCol0(const ArrayRef& col0, const ArrayRef& diag, const IndicesRef& perm, const VectorType& singVals, const ArrayRef& shifts, const ArrayRef& mus, ArrayRef zhat);
   void computeSingVecs(const ArrayRef& zhat, const ArrayRef& diag, const IndicesRef& perm, const VectorType& singVals, const ArrayRef& shifts, const ArrayRef& mus, MatrixXr& U, MatrixXr& V);
   void deflation43(Index firstCol, Index shift, Index i, Index size);
   void deflation44(Index firstColu , Index firstColm, Index firstRowW, Index firstColW, Index i, Index j, Index size);
-  void deflation(Index firstCol, Index lastCol, Index k, Index firstRowW, Index firstColW, Index shift);
+  void deflation(Index firstCol, Index lastCol, Index k, Index firstRowW, Index firstColW, Index shift, IndicesRef workspaceI);
   template<typename HouseholderU, typename HouseholderV, typename NaiveU, typename NaiveV>
   void copyUV(const HouseholderU &householderU, const HouseholderV &householderV, const NaiveU &naiveU, const NaiveV &naivev);
-  void structured_update(Block<MatrixXr,Dynamic,Dynamic> A, const MatrixXr &B, Index n1);
+  void structured_update(Block<MatrixXr,Dynamic,Dynamic> A, const MatrixXr &B, Index n1, ArrayRef workspace);
+  Index mergeThreads(Index n) const;
   static RealScalar secularEq(RealScalar x, const ArrayRef& col0, const ArrayRef& diag, const IndicesRef &perm, const ArrayRef& diagShifted, RealScalar shift);
 
 protected:
   MatrixXr m_naiveU, m_naiveV;
   MatrixXr m_computed;
+  ArrayXr m_diagonal, m_superdiagonal;
   Index m_nRec;
   ArrayXr m_workspace;
   ArrayXi m_workspaceI;
   int m_algoswap;
+  int m_taskSize;
+  bool m_inTasks;
   bool m_isTranspose, m_compU, m_compV;
   
   using Base::m_singularValues;
@@ -228,6 +247,9 @@ void BDCSVD<MatrixType>::allocate(Index rows, Index cols, unsigned int computati
   else         m_naiveU = MatrixXr::Zero(2, m_diagSize + 1 );
   
   if (m_compV) m_naiveV = MatrixXr::Zero(m_diagSize, m_diagSize);
+
+  m_diagonal.resize(m_diagSize);
+  m_superdiagonal.resize(m_diagSize);
   
   m_workspace.resize((m_diagSize+1)*(m_diagSize+1)*3);
   m_workspaceI.resize(3*m_diagSize);
@@ -271,9 +293,11 @@ BDCSVD<MatrixType>& BDCSVD<MatrixType>::compute(const MatrixType& matrix, unsign
   //**** step 2 - Divide & Conquer
   m_naiveU.setZero();
   m_naiveV.setZero();
-  // FIXME this line involves a temporary matrix
-  m_computed.topRows(m_diagSize) = bid.bidiagonal().toDenseMatrix().transpose();
-  m_computed.template bottomRows<1>().setZero();
+  // the bidiagonal is only read by divide, which writes its results to m_computed
+  m_diagonal = bid.bidiagonal().diagonal().transpose();
+  m_superdiagonal.head(m_diagSize-1) = bid.bidiagonal().diagonal(1).transpose();
+  m_superdiagonal(m_diagSize-1) = 0;
+  m_computed.setZero();
   divide(0, m_diagSize - 1, 0, 0, 0);
 
   //**** step 3 - Copy singular values and vectors
@@ -333,10 +357,10 @@ void BDCSVD<MatrixType>::copyUV(const HouseholderU &householderU, const Househol
   *      [A2]
   * such that A1.rows()==n1, then we assume that at least half of the columns of A1 and A2 are zeros.
   * We can thus pack them prior to the the matrix product. However, this is only worth the effort if the matrix is large
-  * enough.
+  * enough. The packed matrices are stored in \a workspace, of size at least 3 n^2.
   */
 template<typename MatrixType>
-void BDCSVD<MatrixType>::structured_update(Block<MatrixXr,Dynamic,Dynamic> A, const MatrixXr &B, Index n1)
+void BDCSVD<MatrixType>::structured_update(Block<MatrixXr,Dynamic,Dynamic> A, const MatrixXr &B, Index n1, ArrayRef workspace)
 {
   Index n = A.rows();
   if(n>100)
@@ -344,10 +368,10 @@ void BDCSVD<MatrixType>::structured_update(Block<MatrixXr,Dynamic,Dynamic> A, co
     // If the matrices are large enough, let's exploit the sparse structure of A by
     // splitting it in half (wrt n1), and packing the non-zero columns.
     Index n2 = n - n1;
-    Map<MatrixXr> A1(m_workspace.data()      , n1, n);
-    Map<MatrixXr> A2(m_workspace.data()+ n1*n, n2, n);
-    Map<MatrixXr> B1(m_workspace.data()+  n*n, n,  n);
-    Map<MatrixXr> B2(m_workspace.data()+2*n*n, n,  n);
+    Map<MatrixXr> A1(workspace.data()      , n1, n);
+    Map<MatrixXr> A2(workspace.data()+ n1*n, n2, n);
+    Map<MatrixXr> B1(workspace.data()+  n*n, n,  n);
+    Map<MatrixXr> B2(workspace.data()+2*n*n, n,  n);
     Index k1=0, k2=0;
     for(Index j=0; j<n; ++j)
     {
@@ -370,12 +394,27 @@ void BDCSVD<MatrixType>::structured_update(Block<MatrixXr,Dynamic,Dynamic> A, co
   }
   else
   {
-    Map<MatrixXr,Aligned> tmp(m_workspace.data(),n,n);
+    Map<MatrixXr> tmp(workspace.data(),n,n);
     tmp.noalias() = A*B;
     A = tmp;
   }
 }
 
+// Returns the number of threads solving the secular equations and computing the singular vectors of a merged problem
+// of size n: the merges performed by the tasks of divide, or by a parallel region of the user, are sequential.
+template<typename MatrixType>
+Index BDCSVD<MatrixType>::mergeThreads(Index n) const
+{
+  Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+  if(n >= m_taskSize && omp_get_num_threads()==1)
+    threads = (std::min)(Index(nbThreads()), n);
+#else
+  EIGEN_UNUSED_VARIABLE(n);
+#endif
+  return threads;
+}
+
 // The divide algorithm is done "in place", we are always working on subsets of the same matrix. The divide methods takes as argument the 
 // place of the submatrix we are currently working on.
 
@@ -386,6 +425,8 @@ void BDCSVD<MatrixType>::structured_update(Block<MatrixXr,Dynamic,Dynamic> A, co
 //@param firstRowW : Same as firstRowW with the column.
 //@param shift : Each time one takes the left submatrix, one must add 1 to the shift. Why? Because! We actually want the last column of the U submatrix 
 // to become the first column (*coeff) and to shift all the other columns to the right. There are more details on the reference paper.
+// The input bidiagonal is read from m_diagonal and m_superdiagonal, and the two halves of a submatrix write to disjoint blocks of
+// m_computed, m_naiveU, m_naiveV, and of the workspaces, so that they can be divided concurrently.
 template<typename MatrixType>
 void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW, Index firstColW, Index shift)
 {
@@ -401,12 +442,18 @@ void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW,
   RealScalar r0; 
   RealScalar lambda, phi, c0, s0;
   VectorType l, f;
+  // The subproblems of the left and right halves use the parts of the workspaces starting at their first column
+  ArrayRef workspace = m_workspace.segment(3*firstCol*(m_diagSize+1), 3*(n+1)*(n+1));
+  IndicesRef workspaceI = m_workspaceI.segment(3*firstCol, 3*n);
   // We use the other algorithm which is more efficient for small 
   // matrices.
   if (n < m_algoswap)
   {
     // FIXME this line involves temporaries
-    JacobiSVD<MatrixXr> b(m_computed.block(firstCol, firstCol, n + 1, n), ComputeFullU | (m_compV ? ComputeFullV : 0));
+    MatrixXr bidiagonal = MatrixXr::Zero(n + 1, n);
+    bidiagonal.diagonal() = m_diagonal.segment(firstCol, n);
+    bidiagonal.diagonal(-1) = m_superdiagonal.segment(firstCol, n);
+    JacobiSVD<MatrixXr> b(bidiagonal, ComputeFullU | (m_compV ? ComputeFullV : 0));
     if (m_compU)
       m_naiveU.block(firstCol, firstCol, n + 1, n + 1).real() = b.matrixU();
     else 
@@ -420,13 +467,34 @@ void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW,
     return;
   }
   // We use the divide and conquer algorithm
-  alphaK =  m_computed(firstCol + k, firstCol + k);
-  betaK = m_computed(firstCol + k + 1, firstCol + k);
-  // The divide must be done in that order in order to have good results. Divide change the data inside the submatrices
-  // and the divide of the right submatrice reads one column of the left submatrice. That's why we need to treat the 
-  // right submatrix before the left one. 
+  alphaK =  m_diagonal(firstCol + k);
+  betaK = m_superdiagonal(firstCol + k);
+#ifdef EIGEN_HAS_OPENMP
+  if (n >= m_taskSize && !m_inTasks && nbThreads() > 1 && omp_get_num_threads() == 1)
+  {
+    // The halves of the largest submatrix are divided by the tasks of a new parallel region, so that its merge below,
+    // outside of the region, is parallelized as well.
+    m_inTasks = true;
+    #pragma omp parallel num_threads(nbThreads())
+    #pragma omp single
+    {
+      #pragma omp task
+      divide(k + 1 + firstCol, lastCol, k + 1 + firstRowW, k + 1 + firstColW, shift);
+      divide(firstCol, k - 1 + firstCol, firstRowW, firstColW + 1, shift + 1);
+    }
+    m_inTasks = false;
+  }
+  else
+  {
+    #pragma omp task if(m_inTasks && n >= m_taskSize)
+    divide(k + 1 + firstCol, lastCol, k + 1 + firstRowW, k + 1 + firstColW, shift);
+    divide(firstCol, k - 1 + firstCol, firstRowW, firstColW + 1, shift + 1);
+    #pragma omp taskwait
+  }
+#else
   divide(k + 1 + firstCol, lastCol, k + 1 + firstRowW, k + 1 + firstColW, shift);
   divide(firstCol, k - 1 + firstCol, firstRowW, firstColW + 1, shift + 1);
+#endif
 
   if (m_compU)
   {
@@ -514,7 +582,7 @@ void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW,
   ArrayXr tmp1 = (m_computed.block(firstCol+shift, firstCol+shift, n, n)).jacobiSvd().singularValues();
 #endif
   // Second part: try to deflate singular values in combined matrix
-  deflation(firstCol, lastCol, k, firstRowW, firstColW, shift);
+  deflation(firstCol, lastCol, k, firstRowW, firstColW, shift, workspaceI);
 #ifdef EIGEN_BDCSVD_DEBUG_VERBOSE
   ArrayXr tmp2 = (m_computed.block(firstCol+shift, firstCol+shift, n, n)).jacobiSvd().singularValues();
   std::cout << "\n\nj1 = " << tmp1.transpose().format(bdcsvdfmt) << "\n";
@@ -530,7 +598,7 @@ void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW,
   // Third part: compute SVD of combined matrix
   MatrixXr UofSVD, VofSVD;
   VectorType singVals;
-  computeSVDofM(firstCol + shift, n, UofSVD, singVals, VofSVD);
+  computeSVDofM(firstCol + shift, n, UofSVD, singVals, VofSVD, workspace, workspaceI);
   
 #ifdef EIGEN_BDCSVD_SANITY_CHECKS
   assert(UofSVD.allFinite());
@@ -538,15 +606,15 @@ void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW,
 #endif
   
   if (m_compU)
-    structured_update(m_naiveU.block(firstCol, firstCol, n + 1, n + 1), UofSVD, (n+2)/2);
+    structured_update(m_naiveU.block(firstCol, firstCol, n + 1, n + 1), UofSVD, (n+2)/2, workspace);
   else
   {
-    Map<Matrix<RealScalar,2,Dynamic>,Aligned> tmp(m_workspace.data(),2,n+1);
+    Map<Matrix<RealScalar,2,Dynamic> > tmp(workspace.data(),2,n+1);
     tmp.noalias() = m_naiveU.middleCols(firstCol, n+1) * UofSVD;
     m_naiveU.middleCols(firstCol, n + 1) = tmp;
   }
   
-  if (m_compV)  structured_update(m_naiveV.block(firstRowW, firstColW, n, n), VofSVD, (n+1)/2);
+  if (m_compV)  structured_update(m_naiveV.block(firstRowW, firstColW, n, n), VofSVD, (n+1)/2, workspace);
   
 #ifdef EIGEN_BDCSVD_SANITY_CHECKS
   assert(m_naiveU.allFinite());
@@ -562,18 +630,19 @@ void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW,
 // the first column and on the diagonal and has undergone deflation, so diagonal is in increasing
 // order except for possibly the (0,0) entry. The computed SVD is stored U, singVals and V, except
 // that if m_compV is false, then V is not computed. Singular values are sorted in decreasing order.
+// The temporaries are stored in workspace and workspaceI, of respective sizes at least (4+threads)*n and n.
 //
 // TODO Opportunities for optimization: better root finding algo, better stopping criterion, better
 // handling of round-off errors, be consistent in ordering
 // For instance, to solve the secular equation using FMM, see http://www.stat.uchicago.edu/~lekheng/courses/302/classics/greengard-rokhlin.pdf
 template <typename MatrixType>
-void BDCSVD<MatrixType>::computeSVDofM(Index firstCol, Index n, MatrixXr& U, VectorType& singVals, MatrixXr& V)
+void BDCSVD<MatrixType>::computeSVDofM(Index firstCol, Index n, MatrixXr& U, VectorType& singVals, MatrixXr& V, ArrayRef workspace, IndicesRef workspaceI)
 {
   const RealScalar considerZero = (std::numeric_limits<RealScalar>::min)();
   using std::abs;
   ArrayRef col0 = m_computed.col(firstCol).segment(firstCol, n);
-  m_workspace.head(n) =  m_computed.block(firstCol, firstCol, n, n).diagonal();
-  ArrayRef diag = m_workspace.head(n);
+  workspace.head(n) =  m_computed.block(firstCol, firstCol, n, n).diagonal();
+  ArrayRef diag = workspace.head(n);
   diag(0) = 0;
 
   // Allocate space for singular values and vectors
@@ -594,12 +663,12 @@ void BDCSVD<MatrixType>::computeSVDofM(Index firstCol, Index n, MatrixXr& U, Vec
   Index m = 0; // size of the deflated problem
   for(Index k=0;k<actual_n;++k)
     if(abs(col0(k))>considerZero)
-      m_workspaceI(m++) = k;
-  Map<ArrayXi> perm(m_workspaceI.data(),m);
+      workspaceI(m++) = k;
+  Map<ArrayXi> perm(workspaceI.data(),m);
   
-  Map<ArrayXr> shifts(m_workspace.data()+1*n, n);
-  Map<ArrayXr> mus(m_workspace.data()+2*n, n);
-  Map<ArrayXr> zhat(m_workspace.data()+3*n, n);
+  Map<ArrayXr> shifts(workspace.data()+1*n, n);
+  Map<ArrayXr> mus(workspace.data()+2*n, n);
+  Map<ArrayXr> zhat(workspace.data()+3*n, n);
 
 #ifdef EIGEN_BDCSVD_DEBUG_VERBOSE
   std::cout << "computeSVDofM using:\n";
@@ -608,7 +677,7 @@ void BDCSVD<MatrixType>::computeSVDofM(Index firstCol, Index n, MatrixXr& U, Vec
 #endif
   
   // Compute singVals, shifts, and mus
-  computeSingVals(col0, diag, perm, singVals, shifts, mus);
+  computeSingVals(col0, diag, perm, singVals, shifts, mus, workspace.tail(workspace.size()-4*n));
   
 #ifdef EIGEN_BDCSVD_DEBUG_VERBOSE
   std::cout << "  j:        " << (m_computed.block(firstCol, firstCol, n, n)).jacobiSvd().singularValues().transpose().reverse() << "\n\n";
@@ -701,9 +770,11 @@ typename BDCSVD<MatrixType>::RealScalar BDCSVD<MatrixType>::secularEq(RealScalar
 
 }
 
+// The singular values are independent, and are computed by mergeThreads(n) threads, each using a part of size n of
+// the workspace.
 template <typename MatrixType>
 void BDCSVD<MatrixType>::computeSingVals(const ArrayRef& col0, const ArrayRef& diag, const IndicesRef &perm,
-                                         VectorType& singVals, ArrayRef shifts, ArrayRef mus)
+                                         VectorType& singVals, ArrayRef shifts, ArrayRef mus, ArrayRef workspace)
 {
   using std::abs;
   using std::swap;
@@ -712,6 +783,11 @@ void BDCSVD<MatrixType>::computeSingVals(const ArrayRef& col0, const ArrayRef& d
   Index actual_n = n;
   while(actual_n>1 && col0(actual_n-1)==0) --actual_n;
 
+  Index threads = mergeThreads(n);
+  EIGEN_UNUSED_VARIABLE(threads);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(dynamic,16) num_threads(threads) if(threads>1)
+#endif
   for (Index k = 0; k < n; ++k)
   {
     if (col0(k) == 0 || actual_n==1)
@@ -758,7 +834,11 @@ void BDCSVD<MatrixType>::computeSingVals(const ArrayRef& col0, const ArrayRef& d
     RealScalar shift = (k == actual_n-1 || fMid > 0) ? left : right;
     
     // measure everything relative to shift
-    Map<ArrayXr> diagShifted(m_workspace.data()+4*n, n);
+    Index tid = 0;
+#ifdef EIGEN_HAS_OPENMP
+    tid = omp_get_thread_num();
+#endif
+    Map<ArrayXr> diagShifted(workspace.data()+tid*n, n);
     diagShifted = diag - shift;
     
     // initial guess
@@ -788,6 +868,9 @@ void BDCSVD<MatrixType>::computeSingVals(const ArrayRef& col0, const ArrayRef& d
     bool useBisection = fPrev*fCur>0;
     while (fCur!=0 && abs(muCur - muPrev) > 8 * NumTraits<RealScalar>::epsilon() * numext::maxi<RealScalar>(abs(muCur), abs(muPrev)) && abs(fCur - fPrev)>NumTraits<RealScalar>::epsilon() && !useBisection)
     {
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp atomic
+#endif
       ++m_numIters;
 
       // Find a and b such that the function f(mu) = a / mu + b matches the current and previous samples.
@@ -889,7 +972,12 @@ void BDCSVD<MatrixType>::perturbCol0
     return;
   }
   Index last = perm(m-1);
+  Index threads = mergeThreads(n);
+  EIGEN_UNUSED_VARIABLE(threads);
   // The offset permits to skip deflated entries while computing zhat
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(static) num_threads(threads) if(threads>1)
+#endif
   for (Index k = 0; k < n; ++k)
   {
     if (col0(k) == 0) // deflated
@@ -931,7 +1019,12 @@ void BDCSVD<MatrixType>::computeSingVecs
 {
   Index n = zhat.size();
   Index m = perm.size();
+  Index threads = mergeThreads(n);
+  EIGEN_UNUSED_VARIABLE(threads);
   
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(static) num_threads(threads) if(threads>1)
+#endif
   for (Index k = 0; k < n; ++k)
   {
     if (zhat(k) == 0)
@@ -1040,7 +1133,7 @@ void BDCSVD<MatrixType>::deflation44(Index firstColu , Index firstColm, Index fi
 
 // acts on block from (firstCol+shift, firstCol+shift) to (lastCol+shift, lastCol+shift) [inclusive]
 template <typename MatrixType>
-void BDCSVD<MatrixType>::deflation(Index firstCol, Index lastCol, Index k, Index firstRowW, Index firstColW, Index shift)
+void BDCSVD<MatrixType>::deflation(Index firstCol, Index lastCol, Index k, Index firstRowW, Index firstColW, Index shift, IndicesRef workspaceI)
 {
   using std::sqrt;
   using std::abs;
@@ -1109,7 +1202,7 @@ void BDCSVD<MatrixType>::deflation(Index firstCol, Index lastCol, Index k, Index
     
     // Sort the diagonal entries, since diag(1:k-1) and diag(k:length) are already sorted, let's do a sorted merge.
     // First, compute the respective permutation.
-    Index *permutation = m_workspaceI.data();
+    Index *permutation = workspaceI.data();
     {
       permutation[0] = 0;
       Index p = 1;
@@ -1146,8 +1239,8 @@ void BDCSVD<MatrixType>::deflation(Index firstCol, Index lastCol, Index k, Index
     }
     
     // Current index of each col, and current column of each index
-    Index *realInd = m_workspaceI.data()+length;
-    Index *realCol = m_workspaceI.data()+2*length;
+    Index *realInd = workspaceI.data()+length;
+    Index *realCol = workspaceI.data()+2*length;
     
     for(int pos = 0; pos< length; pos++)
     {
@@ -0,0 +1,277 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_RANDOMIZEDSVD_H
+#define EIGEN_RANDOMIZEDSVD_H
+
+namespace Eigen {
+
+template<typename _MatrixType> class RandomizedSVD;
+
+namespace internal {
+
+template<typename _MatrixType>
+struct traits<RandomizedSVD<_MatrixType> >
+{
+  typedef _MatrixType MatrixType;
+};
+
+// dst = mat * rhs, or mat^* * rhs, for a dense matrix: the matrix product is already parallelized
+template<typename MatrixType, typename Rhs, typename Dest>
+void randomized_svd_apply(const MatrixBase<MatrixType>& mat, bool adjoint, const Rhs& rhs, Dest& dst, Index)
+{
+  if(adjoint)
+    dst.noalias() = mat.adjoint() * rhs;
+  else
+    dst.noalias() = mat * rhs;
+}
+
+// dst = op * rhs, or op^* * rhs, for a sparse matrix or an operator: the columns of rhs are split in contiguous
+// blocks multiplied concurrently
+template<typename OperatorType, typename Rhs, typename Dest>
+void randomized_svd_apply(const EigenBase<OperatorType>& op, bool adjoint, const Rhs& rhs, Dest& dst, Index threads)
+{
+  dst.resize(adjoint ? op.cols() : op.rows(), rhs.cols());
+  const Index blocks = (std::max)(Index(1), (std::min)(threads, rhs.cols()));
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(static) num_threads(blocks) if(blocks>1)
+#endif
+  for(Index b = 0; b < blocks; ++b)
+  {
+    const Index start = (rhs.cols()*b)/blocks, size = (rhs.cols()*(b+1))/blocks - start;
+    if(adjoint)
+      dst.middleCols(start, size).noalias() = op.derived().adjoint() * rhs.middleCols(start, size);
+    else
+      dst.middleCols(start, size).noalias() = op.derived() * rhs.middleCols(start, size);
+  }
+}
+
+} // end namespace internal
+
+/** \ingroup SVD_Module
+ *
+ *
+ * \class RandomizedSVD
+ *
+ * \brief Randomized truncated SVD for low-rank approximations
+ *
+ * \tparam _MatrixType the type of the computed factors, e.g., MatrixXd, whatever the type of the decomposed matrix
+ *
+ * This class computes the \a k largest singular values, and the corresponding thin \a U and \a V, of a large matrix
+ * \a A, such that \f$ U S V^* \f$ is a rank \a k approximation of \a A. It implements the randomized range finder of
+ * Halko, Martinsson and Tropp (2011): \a A is multiplied by a random matrix of \a k + oversampling() columns, the range
+ * of the product is refined by powerIterations() iterations with \a A and its adjoint, each orthonormalized by a
+ * Cholesky QR, or by a HouseholderQR when it is ill-conditioned, and the small projected problem is finally decomposed
+ * by BDCSVD. The cost is a few products of \a A by thin matrices, plus \f$ O((m+n)k^2) \f$, instead of the
+ * \f$ O(mn \min(m,n)) \f$ of a full SVD.
+ *
+ * The decomposed matrix can be:
+ *  - a dense matrix or expression, multiplied by the usual, parallelized, matrix product;
+ *  - a sparse matrix;
+ *  - a matrix-free operator inheriting EigenBase and providing \c op*X and \c op.adjoint()*X for a dense matrix \c X.
+ * In the last two cases, if OpenMP is enabled, the columns of \c X are split in blocks multiplied concurrently by
+ * threads() threads, so that the products of the operator must be thread safe.
+ *
+ * The approximation is accurate when the singular values decay quickly beyond the \a k-th one. Otherwise, more
+ * power iterations improve the accuracy of the singular vectors. The random matrix comes from the internal::random
+ * generator, so that the results depend on its state.
+ *
+ * Only thin unitaries (#ComputeThinU, #ComputeThinV) can be computed, having \a k columns. solve() returns the
+ * solution of minimal norm of the least squares problem with the rank \a k approximation.
+ *
+ * Example:
+ * \code
+ * SparseMatrix<double> A = ...;  // 1000000 x 10000
+ * RandomizedSVD<MatrixXd> svd;
+ * svd.setPowerIterations(3).compute(A, 50, ComputeThinU | ComputeThinV);
+ * MatrixXd U = svd.matrixU();  // 1000000 x 50
+ * \endcode
+ *
+ * \sa class BDCSVD, class JacobiSVD
+ */
+template<typename _MatrixType>
+class RandomizedSVD : public SVDBase<RandomizedSVD<_MatrixType> >
+{
+  typedef SVDBase<RandomizedSVD> Base;
+
+public:
+  using Base::rows;
+  using Base::cols;
+  using Base::computeU;
+  using Base::computeV;
+
+  typedef _MatrixType MatrixType;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<typename MatrixType::Scalar>::Real RealScalar;
+  typedef Matrix<Scalar, Dynamic, Dynamic, ColMajor> MatrixX;
+
+  /** \brief Default Constructor.
+   *
+   * The default constructor is useful in cases in which the user intends to
+   * perform decompositions via RandomizedSVD::compute().
+   */
+  RandomizedSVD() : m_oversampling(10), m_powerIterations(2), m_threads(0)
+  {}
+
+  /** \brief Constructor performing the decomposition of given matrix.
+   *
+   * \sa compute()
+   */
+  template<typename InputType>
+  RandomizedSVD(const EigenBase<InputType>& matrix, Index rank, unsigned int computationOptions = 0)
+    : m_oversampling(10), m_powerIterations(2), m_threads(0)
+  {
+    compute(matrix, rank, computationOptions);
+  }
+
+  /** \brief Method computing the \a rank largest singular values of given matrix.
+   *
+   * \param matrix the matrix to decompose: a dense or sparse matrix, or a matrix-free operator
+   * \param rank the number of singular values to compute, at most the smallest dimension of \a matrix
+   * \param computationOptions optional parameter allowing to specify if you want the thin U or V unitaries to be
+   *                           computed. By default, none is computed. The possible bits are #ComputeThinU and
+   *                           #ComputeThinV.
+   */
+  template<typename InputType>
+  RandomizedSVD& compute(const EigenBase<InputType>& matrix, Index rank, unsigned int computationOptions = 0);
+
+  /** Sets the number of random samples in addition to the rank, 10 by default */
+  RandomizedSVD& setOversampling(Index oversampling)
+  {
+    eigen_assert(oversampling >= 0);
+    m_oversampling = oversampling;
+    return *this;
+  }
+
+  /** \returns the number of random samples in addition to the rank */
+  Index oversampling() const { return m_oversampling; }
+
+  /** Sets the number of power iterations, 2 by default */
+  RandomizedSVD& setPowerIterations(Index iterations)
+  {
+    eigen_assert(iterations >= 0);
+    m_powerIterations = iterations;
+    return *this;
+  }
+
+  /** \returns the number of power iterations */
+  Index powerIterations() const { return m_powerIterations; }
+
+  /** Sets the number of threads multiplying a sparse matrix or an operator. The default value 0 uses nbThreads().
+    * The dense matrices use the multithreading of the matrix product. */
+  RandomizedSVD& setThreads(Index threads)
+  {
+    eigen_assert(threads >= 0);
+    m_threads = threads;
+    return *this;
+  }
+
+  /** \returns the number of threads set by setThreads() */
+  Index threads() const { return m_threads; }
+
+private:
+  void orthonormalize(MatrixX& Y);
+
+protected:
+  MatrixX m_gram;
+  LLT<MatrixX> m_llt;
+  HouseholderQR<MatrixX> m_qr;
+  Index m_oversampling;
+  Index m_powerIterations;
+  Index m_threads;
+
+  using Base::m_singularValues;
+  using Base::m_diagSize;
+  using Base::m_rows;
+  using Base::m_cols;
+  using Base::m_computationOptions;
+  using Base::m_computeFullU;
+  using Base::m_computeFullV;
+  using Base::m_computeThinU;
+  using Base::m_computeThinV;
+  using Base::m_matrixU;
+  using Base::m_matrixV;
+  using Base::m_isInitialized;
+  using Base::m_nonzeroSingularValues;
+};
+
+// Replaces the columns of Y by an orthonormal basis of their span. Two passes of Cholesky QR (CholeskyQR2) only
+// involve products with the tall matrix Y, and are much faster than the memory bound panels of HouseholderQR, which
+// is used when Y is too ill-conditioned for the Cholesky factorization of its Gram matrix.
+template<typename MatrixType>
+void RandomizedSVD<MatrixType>::orthonormalize(MatrixX& Y)
+{
+  using std::pow;
+  const RealScalar threshold = pow(NumTraits<RealScalar>::epsilon(), RealScalar(1)/RealScalar(3));
+  for(int pass = 0; pass < 2; ++pass)
+  {
+    m_gram.setZero(Y.cols(), Y.cols());
+    m_gram.template selfadjointView<Lower>().rankUpdate(Y.adjoint());
+    m_llt.compute(m_gram);
+    if(m_llt.info() != Success || !(m_llt.matrixLLT().diagonal().real().minCoeff()
+                                    > threshold * m_llt.matrixLLT().diagonal().real().maxCoeff()))
+    {
+      m_qr.compute(Y);
+      Y.setIdentity();
+      Y.applyOnTheLeft(m_qr.householderQ());
+      return;
+    }
+    m_llt.matrixU().template solveInPlace<OnTheRight>(Y);
+  }
+}
+
+template<typename MatrixType>
+template<typename InputType>
+RandomizedSVD<MatrixType>&
+RandomizedSVD<MatrixType>::compute(const EigenBase<InputType>& matrix, Index rank, unsigned int computationOptions)
+{
+  EIGEN_STATIC_ASSERT(int(MatrixType::RowsAtCompileTime)==int(Dynamic) && int(MatrixType::ColsAtCompileTime)==int(Dynamic),
+                      THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+  const Index diagSize = (std::min)(matrix.rows(), matrix.cols());
+  eigen_assert(rank >= 0 && rank <= diagSize && "RandomizedSVD: the rank must be at most the smallest dimension of the matrix");
+  eigen_assert(!(computationOptions & (ComputeFullU|ComputeFullV)) && "RandomizedSVD: only thin U and V can be computed");
+
+  m_rows = matrix.rows();
+  m_cols = matrix.cols();
+  m_diagSize = rank;
+  m_computationOptions = computationOptions;
+  m_computeFullU = m_computeFullV = false;
+  m_computeThinU = (computationOptions & ComputeThinU) != 0;
+  m_computeThinV = (computationOptions & ComputeThinV) != 0;
+
+  const Index threads = m_threads==0 ? Index(nbThreads()) : m_threads;
+  const Index samples = (std::min)(rank + m_oversampling, diagSize);
+
+  // Q is an orthonormal basis of the range of A*Omega, refined by the power iterations
+  MatrixX Q, Z = MatrixX::Random(m_cols, samples);
+  internal::randomized_svd_apply(matrix.derived(), false, Z, Q, threads);
+  orthonormalize(Q);
+  for(Index i = 0; i < m_powerIterations; ++i)
+  {
+    internal::randomized_svd_apply(matrix.derived(), true, Q, Z, threads);
+    orthonormalize(Z);
+    internal::randomized_svd_apply(matrix.derived(), false, Z, Q, threads);
+    orthonormalize(Q);
+  }
+
+  // A ~ Q*Q^*A = Q*Z^*, where Z = A^*Q = W S X^* gives A ~ (Q X) S W^*
+  internal::randomized_svd_apply(matrix.derived(), true, Q, Z, threads);
+  BDCSVD<MatrixX> svd(Z, (computeU() ? ComputeThinV : 0) | (computeV() ? ComputeThinU : 0));
+
+  m_singularValues = svd.singularValues().head(rank);
+  if(computeU())
+    m_matrixU.noalias() = Q * svd.matrixV().leftCols(rank);
+  if(computeV())
+    m_matrixV = svd.matrixU().leftCols(rank);
+  m_nonzeroSingularValues = (std::min)(rank, svd.nonzeroSingularValues());
+  m_isInitialized = true;
+  return *this;
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_RANDOMIZEDSVD_H
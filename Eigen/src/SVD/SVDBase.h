@@ -42,7 +42,7 @@ namespace Eigen {
  *  
  * If the input matrix has inf or nan coefficients, the result of the computation is undefined, but the computation is guaranteed to
  * terminate in finite (and reasonable) time.
- * \sa class BDCSVD, class JacobiSVD
+ * \sa class BDCSVD, class JacobiSVD, class RandomizedSVD
  */
 template<typename Derived>
 class SVDBase
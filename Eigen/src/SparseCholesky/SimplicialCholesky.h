@@ -166,14 +166,28 @@ class SimplicialCholeskyBase : public SparseSolverBase<Derived>
       else
         dest = b;
 
+      typedef typename internal::traits<Derived>::MatrixL MatrixL;
+      typedef typename internal::traits<Derived>::MatrixU MatrixU;
+      const bool useLevels = m_lowerLevels.isParallelizable() && m_upperLevels.isParallelizable();
+
       if(m_matrix.nonZeros()>0) // otherwise L==I
-        derived().matrixL().solveInPlace(dest);
+      {
+        if(useLevels)
+          m_lowerLevels.template solveInPlace<MatrixL::Mode>(m_matrixRowMajor, dest.derived());
+        else
+          derived().matrixL().solveInPlace(dest);
+      }
 
       if(m_diag.size()>0)
         dest = m_diag.asDiagonal().inverse() * dest;
 
       if (m_matrix.nonZeros()>0) // otherwise U==I
-        derived().matrixU().solveInPlace(dest);
+      {
+        if(useLevels)
+          m_upperLevels.template solveInPlace<MatrixU::Mode>(m_matrix.adjoint(), dest.derived());
+        else
+          derived().matrixU().solveInPlace(dest);
+      }
 
       if(m_P.size()>0)
         dest = m_Pinv * dest;
@@ -240,6 +254,21 @@ class SimplicialCholeskyBase : public SparseSolverBase<Derived>
     
     void ordering(const MatrixType& a, ConstCholMatrixPtr &pmat, CholMatrixType& ap);
 
+    /** \internal Analyzes the dependencies of the triangular solves when they can run in parallel. It is called
+      * after each factorization by SimplicialLLT and SimplicialLDLT, whose solves use the levels. */
+    void computeLevelSchedules()
+    {
+      m_lowerLevels.clear();
+      m_upperLevels.clear();
+      m_matrixRowMajor.resize(0,0);
+      if(m_info==Success && nbThreads()>1)
+      {
+        m_matrixRowMajor = m_matrix;
+        m_lowerLevels.compute(m_matrixRowMajor, Lower);
+        m_upperLevels.compute(m_matrix.adjoint(), Upper);
+      }
+    }
+
     /** keeps off-diagonal entries; drops diagonal entries */
     struct keep_diag {
       inline bool operator() (const Index& row, const Index& col, const Scalar&) const
@@ -258,6 +287,9 @@ class SimplicialCholeskyBase : public SparseSolverBase<Derived>
     VectorI m_nonZerosPerCol;
     PermutationMatrix<Dynamic,Dynamic,StorageIndex> m_P;     // the permutation
     PermutationMatrix<Dynamic,Dynamic,StorageIndex> m_Pinv;  // the inverse permutation
+    SparseMatrix<Scalar,RowMajor,StorageIndex> m_matrixRowMajor;  // row-major copy of L for the multithreaded solves
+    internal::sparse_level_schedule<StorageIndex> m_lowerLevels;  // level scheduling of the multithreaded solves
+    internal::sparse_level_schedule<StorageIndex> m_upperLevels;
 
     RealScalar m_shiftOffset;
     RealScalar m_shiftScale;
@@ -364,6 +396,7 @@ public:
     SimplicialLLT& compute(const MatrixType& matrix)
     {
       Base::template compute<false>(matrix);
+      Base::computeLevelSchedules();
       return *this;
     }
 
@@ -387,6 +420,7 @@ public:
     void factorize(const MatrixType& a)
     {
       Base::template factorize<false>(a);
+      Base::computeLevelSchedules();
     }
 
     /** \returns the determinant of the underlying matrix from the current factorization */
@@ -461,6 +495,7 @@ public:
     SimplicialLDLT& compute(const MatrixType& matrix)
     {
       Base::template compute<true>(matrix);
+      Base::computeLevelSchedules();
       return *this;
     }
     
@@ -484,6 +519,7 @@ public:
     void factorize(const MatrixType& a)
     {
       Base::template factorize<true>(a);
+      Base::computeLevelSchedules();
     }
 
     /** \returns the determinant of the underlying matrix from the current factorization */
@@ -0,0 +1,70 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_COLORING_H
+#define EIGEN_SPARSE_COLORING_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal
+  * Greedy coloring of \a nbItems items, each of them referencing some of \a nbKeys keys, such that two items
+  * of the same color never share a key. The items of a color can then be processed concurrently, or, for the
+  * columns of a jacobian, estimated by the same functor evaluation.
+  *
+  * The keys of the item \c i are <tt>keys[keyPtr[i]]</tt> to <tt>keys[keyPtr[i+1]-1]</tt>, as the inner indices
+  * of a compressed sparse matrix, or, if \a keyPtr is null, the \a keysPerItem keys starting at
+  * <tt>keys[i*keysPerItem]</tt>. Negative keys are ignored.
+  *
+  * On output, the items of the color \c c are <tt>colorItems[colorPtr[c]]</tt> to
+  * <tt>colorItems[colorPtr[c+1]-1]</tt>, in increasing order.
+  *
+  * The colors are built one at a time: an item gets the current color if none of its keys has already been
+  * marked by an item of this color.
+  */
+template<typename KeyIndex, typename StorageIndex>
+void greedy_coloring(Index nbItems, Index nbKeys, const KeyIndex* keys, const KeyIndex* keyPtr, Index keysPerItem,
+                     std::vector<StorageIndex>& colorPtr, std::vector<StorageIndex>& colorItems)
+{
+  std::vector<StorageIndex> mark(nbKeys, -1);
+  std::vector<bool> colored(nbItems, false);
+  colorPtr.assign(1, 0);
+  colorItems.clear();
+  colorItems.reserve(nbItems);
+  Index remaining = nbItems, first = 0;
+  for(StorageIndex color = 0; remaining > 0; ++color)
+  {
+    while(colored[first])
+      ++first;
+    for(Index i = first; i < nbItems; ++i)
+    {
+      if(colored[i])
+        continue;
+      const Index begin = keyPtr ? Index(keyPtr[i]) : i*keysPerItem;
+      const Index end = keyPtr ? Index(keyPtr[i+1]) : begin+keysPerItem;
+      bool free = true;
+      for(Index k = begin; k < end && free; ++k)
+        free = keys[k] < 0 || mark[keys[k]] != color;
+      if(!free)
+        continue;
+      for(Index k = begin; k < end; ++k)
+        if(keys[k] >= 0)
+          mark[keys[k]] = color;
+      colored[i] = true;
+      colorItems.push_back(StorageIndex(i));
+      --remaining;
+    }
+    colorPtr.push_back(StorageIndex(colorItems.size()));
+  }
+}
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_COLORING_H
@@ -112,15 +112,32 @@ struct sparse_time_dense_product_impl<SparseLhsType,DenseRhsType,DenseResType, t
   typedef typename internal::remove_all<DenseRhsType>::type Rhs;
   typedef typename internal::remove_all<DenseResType>::type Res;
   typedef typename evaluator<Lhs>::InnerIterator LhsInnerIterator;
+  typedef evaluator<Lhs> LhsEval;
   static void run(const SparseLhsType& lhs, const DenseRhsType& rhs, DenseResType& res, const typename Res::Scalar& alpha)
   {
-    evaluator<Lhs> lhsEval(lhs);
-    for(Index j=0; j<lhs.outerSize(); ++j)
+    LhsEval lhsEval(lhs);
+    Index n = lhs.outerSize();
+#ifdef EIGEN_HAS_OPENMP
+    Eigen::initParallel();
+    Index threads = Eigen::nbThreads();
+    // same threshold as for a single column, each row of the result is computed by a single thread
+    if(threads>1 && lhsEval.nonZerosEstimate() > 20000)
     {
-      typename Res::RowXpr res_j(res.row(j));
-      for(LhsInnerIterator it(lhsEval,j); it ;++it)
-        res_j += (alpha*it.value()) * rhs.row(it.index());
+      #pragma omp parallel for schedule(dynamic,(n+threads*4-1)/(threads*4)) num_threads(threads)
+      for(Index j=0; j<n; ++j)
+        processRow(lhsEval,rhs,res,alpha,j);
+      return;
     }
+#endif
+    for(Index j=0; j<n; ++j)
+      processRow(lhsEval,rhs,res,alpha,j);
+  }
+
+  static void processRow(const LhsEval& lhsEval, const DenseRhsType& rhs, DenseResType& res, const typename Res::Scalar& alpha, Index j)
+  {
+    typename Res::RowXpr res_j(res.row(j));
+    for(LhsInnerIterator it(lhsEval,j); it ;++it)
+      res_j += (alpha*it.value()) * rhs.row(it.index());
   }
 };
 
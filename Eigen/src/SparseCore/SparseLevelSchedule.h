@@ -0,0 +1,181 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_LEVEL_SCHEDULE_H
+#define EIGEN_SPARSE_LEVEL_SCHEDULE_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal
+  * \brief Level scheduling of the substitutions with a sparse triangular matrix
+  *
+  * The rows of the triangular matrix are grouped into levels, such that the unknowns of a level only depend
+  * on the unknowns of the previous levels. All the rows of a level can then be solved in parallel, the levels
+  * being processed one after the other.
+  *
+  * The analysis only depends on the sparsity pattern, and is meant to be computed once by the sparse
+  * decompositions and reused by all their solves. The matrix must give access to its rows, i.e., be a row-major
+  * matrix or the transpose or adjoint of a column-major one. Its coefficients in the other triangular part
+  * are ignored, so that the L and U factors stored in a single matrix are supported.
+  */
+template<typename StorageIndex>
+class sparse_level_schedule
+{
+  public:
+    sparse_level_schedule() {}
+
+    /** Computes the levels of the rows of the triangular part \a UpLo (Lower or Upper) of \a mat */
+    template<typename MatrixType>
+    void compute(const MatrixType& mat, int UpLo);
+
+    void clear()
+    {
+      m_levelPtr.clear();
+      m_order.clear();
+    }
+
+    /** \returns the number of levels, 0 if not computed */
+    Index levels() const { return m_levelPtr.empty() ? 0 : Index(m_levelPtr.size())-1; }
+
+    /** \returns the number of rows */
+    Index size() const { return Index(m_order.size()); }
+
+    /** \returns whether the levels are large enough for the solves to be worth being parallelized */
+    bool isParallelizable() const
+    {
+      return levels() > 0 && nbThreads() > 1 && size() >= MinAverageLevelSize * levels();
+    }
+
+    /** Solves in place \a other with the triangular part of \a mat described by \a Mode, which must have the
+      * pattern given to compute(). */
+    template<int Mode, typename MatrixType, typename Rhs>
+    void solveInPlace(const MatrixType& mat, Rhs& other) const;
+
+  protected:
+    enum { MinAverageLevelSize = 64 };
+
+    template<int Mode, typename Evaluator, typename Rhs>
+    static void solveRows(const Evaluator& matEval, const StorageIndex* first, const StorageIndex* last, Rhs& other, Index col);
+
+    std::vector<StorageIndex> m_levelPtr;  // start of each level in m_order
+    std::vector<StorageIndex> m_order;     // the rows sorted by level
+};
+
+template<typename StorageIndex>
+template<typename MatrixType>
+void sparse_level_schedule<StorageIndex>::compute(const MatrixType& mat, int UpLo)
+{
+  typedef evaluator<MatrixType> MatEval;
+  typedef typename MatEval::InnerIterator MatIterator;
+  EIGEN_STATIC_ASSERT((int(evaluator<MatrixType>::Flags)&RowMajorBit), THIS_METHOD_IS_ONLY_FOR_ROW_MAJOR_MATRICES)
+  eigen_assert(mat.rows()==mat.cols() && (UpLo==Lower || UpLo==Upper));
+
+  const Index n = mat.rows();
+  MatEval matEval(mat);
+  std::vector<StorageIndex> level(n, 0);
+  StorageIndex count = 0;
+  for(Index k = 0; k < n; ++k)
+  {
+    const Index i = UpLo==Lower ? k : n-1-k;
+    StorageIndex l = 0;
+    for(MatIterator it(matEval, i); it; ++it)
+    {
+      const Index j = it.index();
+      if(UpLo==Lower ? j<i : j>i)
+        l = (std::max)(l, StorageIndex(level[j]+1));
+    }
+    level[i] = l;
+    count = (std::max)(count, StorageIndex(l+1));
+  }
+
+  // counting sort of the rows by level, keeping the order of the substitution within each level
+  m_levelPtr.assign(count+1, 0);
+  for(Index i = 0; i < n; ++i)
+    ++m_levelPtr[level[i]+1];
+  for(Index l = 0; l < count; ++l)
+    m_levelPtr[l+1] += m_levelPtr[l];
+  m_order.resize(n);
+  std::vector<StorageIndex> pos(m_levelPtr.begin(), m_levelPtr.end()-1);
+  for(Index k = 0; k < n; ++k)
+  {
+    const Index i = UpLo==Lower ? k : n-1-k;
+    m_order[pos[level[i]]++] = StorageIndex(i);
+  }
+}
+
+template<typename StorageIndex>
+template<int Mode, typename Evaluator, typename Rhs>
+void sparse_level_schedule<StorageIndex>::solveRows(const Evaluator& matEval, const StorageIndex* first, const StorageIndex* last, Rhs& other, Index col)
+{
+  typedef typename Rhs::Scalar Scalar;
+  for(; first != last; ++first)
+  {
+    const Index i = *first;
+    Scalar tmp = other.coeff(i,col);
+    Scalar diag(1);
+    for(typename Evaluator::InnerIterator it(matEval, i); it; ++it)
+    {
+      const Index j = it.index();
+      if(j==i)
+        diag = it.value();
+      else if((Mode & Lower) ? j<i : j>i)
+        tmp -= it.value() * other.coeff(j,col);
+    }
+    if(Mode & UnitDiag)
+      other.coeffRef(i,col) = tmp;
+    else
+      other.coeffRef(i,col) = tmp/diag;
+  }
+}
+
+template<typename StorageIndex>
+template<int Mode, typename MatrixType, typename Rhs>
+void sparse_level_schedule<StorageIndex>::solveInPlace(const MatrixType& mat, Rhs& other) const
+{
+  typedef evaluator<MatrixType> MatEval;
+  EIGEN_STATIC_ASSERT((int(evaluator<MatrixType>::Flags)&RowMajorBit), THIS_METHOD_IS_ONLY_FOR_ROW_MAJOR_MATRICES)
+  eigen_assert(mat.rows()==size() && other.rows()==size());
+
+  MatEval matEval(mat);
+  const StorageIndex* order = m_order.empty() ? 0 : &m_order[0];
+  const Index nbLevels = levels();
+
+#ifdef EIGEN_HAS_OPENMP
+  Index threads = nbThreads();
+  if(isParallelizable() && omp_get_num_threads()==1)
+  {
+    // a single parallel region, in which each thread solves a contiguous range of each level
+    #pragma omp parallel num_threads(threads)
+    {
+      const Index tid = omp_get_thread_num();
+      const Index actual_threads = omp_get_num_threads();
+      for(Index col = 0; col < other.cols(); ++col)
+      {
+        for(Index l = 0; l < nbLevels; ++l)
+        {
+          const Index begin = m_levelPtr[l], levelSize = m_levelPtr[l+1] - begin;
+          solveRows<Mode>(matEval, order + begin + (levelSize*tid)/actual_threads,
+                                   order + begin + (levelSize*(tid+1))/actual_threads, other, col);
+          #pragma omp barrier
+        }
+      }
+    }
+    return;
+  }
+#endif
+
+  for(Index col = 0; col < other.cols(); ++col)
+    solveRows<Mode>(matEval, order, order + m_levelPtr[nbLevels], other, col);
+}
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_LEVEL_SCHEDULE_H
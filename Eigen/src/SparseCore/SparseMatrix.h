@@ -440,6 +440,18 @@ class SparseMatrix
     template<typename InputIterators,typename DupFunctor>
     void setFromTriplets(const InputIterators& begin, const InputIterators& end, DupFunctor dup_func);
 
+    template<typename InputIterators>
+    void setFromTriplets(const InputIterators& begin, const InputIterators& end, IndexVector& positions);
+
+    template<typename InputIterators,typename DupFunctor>
+    void setFromTriplets(const InputIterators& begin, const InputIterators& end, DupFunctor dup_func, IndexVector& positions);
+
+    template<typename InputIterators>
+    void updateFromTriplets(const InputIterators& begin, const InputIterators& end, const IndexVector& positions);
+
+    template<typename InputIterators,typename DupFunctor>
+    void updateFromTriplets(const InputIterators& begin, const InputIterators& end, const IndexVector& positions, DupFunctor dup_func);
+
     void sumupDuplicates() { collapseDuplicates(internal::scalar_sum_op<Scalar>()); }
 
     template<typename DupFunctor>
@@ -903,36 +915,265 @@ private:
 
 namespace internal {
 
+/** \internal Sorts the \a size entries of an inner vector by inner index and collapses the duplicates with \a dup_func,
+  * in the order of the triplets. If \a ids is not null, the position in the collapsed inner vector of the triplet ids[j]
+  * is stored in \a positions, as p for the first occurrence of an entry and -p-1 for its duplicates.
+  * \returns the number of entries after collapsing */
+template<typename Scalar, typename StorageIndex, typename DupFunctor>
+StorageIndex set_from_triplets_collapse(StorageIndex* inner, Scalar* values, StorageIndex* ids, Index size,
+                                        DupFunctor& dup_func, StorageIndex* positions,
+                                        std::vector<std::pair<StorageIndex,StorageIndex> >& order, std::vector<Scalar>& valueBuffer)
+{
+  bool sorted = true;
+  for(Index j = 1; j < size && sorted; ++j)
+    sorted = inner[j-1] <= inner[j];
+  if(!sorted && size <= 16)
+  {
+    // stable insertion sort of the short inner vectors
+    for(Index j = 1; j < size; ++j)
+    {
+      StorageIndex i = inner[j], id = ids ? ids[j] : 0;
+      Scalar v = values[j];
+      Index k = j;
+      for(; k > 0 && inner[k-1] > i; --k)
+      {
+        inner[k] = inner[k-1];
+        values[k] = values[k-1];
+        if(ids) ids[k] = ids[k-1];
+      }
+      inner[k] = i;
+      values[k] = v;
+      if(ids) ids[k] = id;
+    }
+  }
+  else if(!sorted)
+  {
+    // sorting the pairs (inner index, position) keeps the order of the duplicates
+    order.resize(size);
+    valueBuffer.resize(size);
+    for(Index j = 0; j < size; ++j)
+    {
+      order[j] = std::make_pair(inner[j], StorageIndex(j));
+      valueBuffer[j] = values[j];
+    }
+    std::sort(order.begin(), order.end());
+    for(Index j = 0; j < size; ++j)
+    {
+      inner[j] = order[j].first;
+      values[j] = valueBuffer[order[j].second];
+    }
+    if(ids)
+    {
+      for(Index j = 0; j < size; ++j)
+        order[j].first = ids[order[j].second];
+      for(Index j = 0; j < size; ++j)
+        ids[j] = order[j].first;
+    }
+  }
+
+  StorageIndex count = 0;
+  for(Index j = 0; j < size; ++j)
+  {
+    if(count > 0 && inner[count-1] == inner[j])
+    {
+      values[count-1] = dup_func(values[count-1], values[j]);
+      if(ids) positions[ids[j]] = -count;
+    }
+    else
+    {
+      inner[count] = inner[j];
+      values[count] = values[j];
+      if(ids) positions[ids[j]] = count;
+      ++count;
+    }
+  }
+  return count;
+}
+
+/** \internal Fills \a mat with the triplets [begin,end), the duplicates being collapsed with \a dup_func.
+  *
+  * The triplets are partitioned by outer index directly into the storage of \a mat, with per thread counts such that
+  * the order of the triplets is preserved within each inner vector. The inner vectors are then sorted and their
+  * duplicates collapsed in place, before removing the gaps left by the duplicates. If OpenMP is enabled and the
+  * iterators are random access, all the passes are performed in parallel but the last one.
+  *
+  * If \a positions is not null, the position in valuePtr() of each triplet is stored in it, as p for the first
+  * occurrence of an entry and -p-1 for its duplicates, see update_from_triplets().
+  */
 template<typename InputIterator, typename SparseMatrixType, typename DupFunctor>
-void set_from_triplets(const InputIterator& begin, const InputIterator& end, SparseMatrixType& mat, DupFunctor dup_func)
+void set_from_triplets(const InputIterator& begin, const InputIterator& end, SparseMatrixType& mat, DupFunctor dup_func,
+                       typename SparseMatrixType::StorageIndex* positions = 0)
 {
   enum { IsRowMajor = SparseMatrixType::IsRowMajor };
   typedef typename SparseMatrixType::Scalar Scalar;
   typedef typename SparseMatrixType::StorageIndex StorageIndex;
-  SparseMatrix<Scalar,IsRowMajor?ColMajor:RowMajor,StorageIndex> trMat(mat.rows(),mat.cols());
+  const Index outerSize = mat.outerSize();
+  mat.resize(mat.rows(), mat.cols());
 
-  if(begin!=end)
+  Index threads = 1, size = 0;
+#ifdef EIGEN_HAS_OPENMP
+  if(is_same<typename std::iterator_traits<InputIterator>::iterator_category, std::random_access_iterator_tag>::value
+     && omp_get_num_threads()==1)
+  {
+    size = Index(std::distance(begin, end));
+    threads = (std::min)(Index(nbThreads()), size/(Index(1)<<14) + 1);
+  }
+#endif
+
+  // pass 1: count the entries per outer vector and per range of triplets
+  std::vector<StorageIndex> counts(threads*outerSize, 0);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(static,1) num_threads(threads) if(threads>1)
+#endif
+  for(Index t = 0; t < threads; ++t)
   {
-    // pass 1: count the nnz per inner-vector
-    typename SparseMatrixType::IndexVector wi(trMat.outerSize());
-    wi.setZero();
-    for(InputIterator it(begin); it!=end; ++it)
+    InputIterator first(begin), last(end);
+    if(threads > 1)
+    {
+      std::advance(first, (size*t)/threads);
+      last = begin;
+      std::advance(last, (size*(t+1))/threads);
+    }
+    StorageIndex* threadCounts = outerSize > 0 ? &counts[t*outerSize] : 0;
+    for(InputIterator it(first); it!=last; ++it)
     {
       eigen_assert(it->row()>=0 && it->row()<mat.rows() && it->col()>=0 && it->col()<mat.cols());
-      wi(IsRowMajor ? it->col() : it->row())++;
+      ++threadCounts[IsRowMajor ? it->row() : it->col()];
     }
+  }
 
-    // pass 2: insert all the elements into trMat
-    trMat.reserve(wi);
-    for(InputIterator it(begin); it!=end; ++it)
-      trMat.insertBackUncompressed(it->row(),it->col()) = it->value();
+  // the start of each outer vector, and of each range within it
+  StorageIndex* outerIndex = mat.outerIndexPtr();
+  StorageIndex total = 0;
+  for(Index j = 0; j < outerSize; ++j)
+  {
+    outerIndex[j] = total;
+    for(Index t = 0; t < threads; ++t)
+    {
+      StorageIndex count = counts[t*outerSize+j];
+      counts[t*outerSize+j] = total;
+      total += count;
+    }
+  }
+  outerIndex[outerSize] = total;
+  if(total == 0)
+    return;
+
+  // pass 2: scatter the triplets into their outer vector
+  mat.resizeNonZeros(total);
+  StorageIndex* inner = mat.innerIndexPtr();
+  Scalar* values = mat.valuePtr();
+  std::vector<StorageIndex> ids(positions ? total : 0);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(static,1) num_threads(threads) if(threads>1)
+#endif
+  for(Index t = 0; t < threads; ++t)
+  {
+    InputIterator first(begin), last(end);
+    StorageIndex k = 0;
+    if(threads > 1)
+    {
+      k = StorageIndex((size*t)/threads);
+      std::advance(first, k);
+      last = begin;
+      std::advance(last, (size*(t+1))/threads);
+    }
+    StorageIndex* threadPositions = &counts[t*outerSize];
+    for(InputIterator it(first); it!=last; ++it, ++k)
+    {
+      StorageIndex p = threadPositions[IsRowMajor ? it->row() : it->col()]++;
+      inner[p] = StorageIndex(IsRowMajor ? it->col() : it->row());
+      values[p] = it->value();
+      if(positions) ids[p] = k;
+    }
+  }
 
-    // pass 3:
-    trMat.collapseDuplicates(dup_func);
+  // pass 3: sort each outer vector and collapse its duplicates in place
+  std::vector<StorageIndex> nonZeros(outerSize);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel num_threads(threads) if(threads>1)
+#endif
+  {
+    std::vector<std::pair<StorageIndex,StorageIndex> > order;
+    std::vector<Scalar> valueBuffer;
+    DupFunctor func(dup_func);
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp for schedule(dynamic,256)
+#endif
+    for(Index j = 0; j < outerSize; ++j)
+    {
+      const StorageIndex start = outerIndex[j];
+      nonZeros[j] = set_from_triplets_collapse(inner+start, values+start, positions ? &ids[start] : (StorageIndex*)0,
+                                               outerIndex[j+1]-start, func, positions, order, valueBuffer);
+    }
+  }
+
+  // pass 4: remove the gaps left by the duplicates, and make the positions, relative to each outer vector, global
+  StorageIndex count = 0;
+  for(Index j = 0; j < outerSize; ++j)
+    count += nonZeros[j];
+  const bool compress = count != total;
+  std::vector<StorageIndex> oldOuterIndex(outerIndex, outerIndex+outerSize+1);
+  if(compress)
+  {
+    count = 0;
+    for(Index j = 0; j < outerSize; ++j)
+    {
+      const StorageIndex start = oldOuterIndex[j];
+      for(StorageIndex k = 0; k < nonZeros[j]; ++k)
+      {
+        inner[count+k] = inner[start+k];
+        values[count+k] = values[start+k];
+      }
+      outerIndex[j] = count;
+      count += nonZeros[j];
+    }
+    outerIndex[outerSize] = count;
+  }
+  if(positions)
+  {
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for schedule(static) num_threads(threads) if(threads>1)
+#endif
+    for(Index j = 0; j < outerSize; ++j)
+    {
+      const StorageIndex shift = outerIndex[j];
+      for(StorageIndex k = oldOuterIndex[j]; k < oldOuterIndex[j+1]; ++k)
+      {
+        StorageIndex& p = positions[ids[k]];
+        p = p >= 0 ? p + shift : p - shift;
+      }
+    }
   }
+  if(compress)
+  {
+    mat.resizeNonZeros(count);
+    mat.data().squeeze();
+  }
+}
 
-  // pass 4: transposed copy -> implicit sorting
-  mat = trMat;
+/** \internal Updates the values of \a mat, filled by set_from_triplets() with the same sequence of (row,col) pairs,
+  * from the values of the triplets [begin,end) and the positions computed by set_from_triplets(). */
+template<typename InputIterator, typename SparseMatrixType, typename IndexVector, typename DupFunctor>
+void update_from_triplets(const InputIterator& begin, const InputIterator& end, SparseMatrixType& mat,
+                          const IndexVector& positions, DupFunctor dup_func)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef typename SparseMatrixType::StorageIndex StorageIndex;
+  eigen_assert(mat.isCompressed());
+  Scalar* values = mat.valuePtr();
+  Index k = 0;
+  for(InputIterator it(begin); it!=end; ++it, ++k)
+  {
+    eigen_assert(k < positions.size());
+    const StorageIndex p = positions.coeff(k);
+    eigen_assert(p < mat.nonZeros() && -p-1 < mat.nonZeros());
+    if(p >= 0)
+      values[p] = it->value();
+    else
+      values[-p-1] = dup_func(values[-p-1], it->value());
+  }
+  eigen_assert(k == positions.size() && "the number of triplets does not match the positions");
 }
 
 }
@@ -943,7 +1184,9 @@ void set_from_triplets(const InputIterator& begin, const InputIterator& end, Spa
   * A \em triplet is a tuple (i,j,value) defining a non-zero element.
   * The input list of triplets does not have to be sorted, and can contains duplicated elements.
   * In any case, the result is a \b sorted and \b compressed sparse matrix where the duplicates have been summed up.
-  * This is a \em O(n) operation, with \em n the number of triplet elements.
+  * This is a \em O(n) operation, with \em n the number of triplet elements, as long as the inner vectors are short,
+  * since each inner vector is sorted independently. If OpenMP is enabled and the iterators are random access,
+  * the triplets are processed in parallel.
   * The initial contents of \c *this is destroyed.
   * The matrix \c *this must be properly resized beforehand using the SparseMatrix(Index,Index) constructor,
   * or the resize(Index,Index) method. The sizes are not extracted from the triplet list.
@@ -998,6 +1241,57 @@ void SparseMatrix<Scalar,_Options,_Index>::setFromTriplets(const InputIterators&
   internal::set_from_triplets<InputIterators, SparseMatrix<Scalar,_Options,_Index>, DupFunctor>(begin, end, *this, dup_func);
 }
 
+/** The same as setFromTriplets but also computes in \a positions the position in valuePtr() of each triplet,
+  * such that the values of a matrix assembled again from triplets with the same sequence of row and column indices
+  * can then be updated in a single pass by updateFromTriplets(), without analyzing the triplets again:
+  * \code
+    SparseMatrixType::IndexVector positions;
+    m.setFromTriplets(tripletList.begin(), tripletList.end(), positions);
+    // ... new values, same rows and columns
+    m.updateFromTriplets(tripletList.begin(), tripletList.end(), positions);
+  * \endcode
+  *
+  * \sa updateFromTriplets()
+  */
+template<typename Scalar, int _Options, typename _Index>
+template<typename InputIterators>
+void SparseMatrix<Scalar,_Options,_Index>::setFromTriplets(const InputIterators& begin, const InputIterators& end, IndexVector& positions)
+{
+  setFromTriplets(begin, end, internal::scalar_sum_op<Scalar>(), positions);
+}
+
+/** The same as setFromTriplets(const InputIterators&, const InputIterators&, IndexVector&) but when duplicates
+  * are met the functor \a dup_func is applied. */
+template<typename Scalar, int _Options, typename _Index>
+template<typename InputIterators,typename DupFunctor>
+void SparseMatrix<Scalar,_Options,_Index>::setFromTriplets(const InputIterators& begin, const InputIterators& end, DupFunctor dup_func, IndexVector& positions)
+{
+  positions.resize(std::distance(begin, end));
+  internal::set_from_triplets<InputIterators, SparseMatrix<Scalar,_Options,_Index>, DupFunctor>(begin, end, *this, dup_func, positions.data());
+}
+
+/** Updates the values of \c *this from the triplets [\a begin, \a end) and the \a positions computed by a previous
+  * call to setFromTriplets(const InputIterators&, const InputIterators&, IndexVector&). The triplets must have the
+  * same row and column indices, in the same order, as the ones given to setFromTriplets(), and \c *this must not
+  * have been modified in between but for its values.
+  * This is a single pass over the triplets, the duplicates being summed up.
+  */
+template<typename Scalar, int _Options, typename _Index>
+template<typename InputIterators>
+void SparseMatrix<Scalar,_Options,_Index>::updateFromTriplets(const InputIterators& begin, const InputIterators& end, const IndexVector& positions)
+{
+  internal::update_from_triplets(begin, end, *this, positions, internal::scalar_sum_op<Scalar>());
+}
+
+/** The same as updateFromTriplets(const InputIterators&, const InputIterators&, const IndexVector&) but when
+  * duplicates are met the functor \a dup_func is applied, which must be the one given to setFromTriplets(). */
+template<typename Scalar, int _Options, typename _Index>
+template<typename InputIterators,typename DupFunctor>
+void SparseMatrix<Scalar,_Options,_Index>::updateFromTriplets(const InputIterators& begin, const InputIterators& end, const IndexVector& positions, DupFunctor dup_func)
+{
+  internal::update_from_triplets(begin, end, *this, positions, dup_func);
+}
+
 /** \internal */
 template<typename Scalar, int _Options, typename _Index>
 template<typename DupFunctor>
@@ -0,0 +1,141 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Compares the computation of a small dense jacobian by finite differences (NumericalDiff) and by forward mode
+// automatic differentiation (AutoDiffJacobian) with dynamic, fixed-capacity, and fixed size derivatives.
+//
+// g++ -O3 -DNDEBUG -I.. -I../.. benchAutoDiff.cpp -o benchAutoDiff
+
+#include <iostream>
+#include <bench/BenchTimer.h>
+#include <Eigen/Core>
+#include <unsupported/Eigen/AutoDiff>
+#include <unsupported/Eigen/NumericalDiff>
+
+using namespace Eigen;
+using namespace std;
+
+#ifndef SIZE
+#define SIZE 8
+#endif
+
+#ifndef REPEAT
+#define REPEAT 20000
+#endif
+
+// a nonlinear function with a dense jacobian, accumulating its values with compound assignments
+template<int N>
+struct BenchFunctor
+{
+  typedef double Scalar;
+  enum {
+    InputsAtCompileTime = N,
+    ValuesAtCompileTime = N
+  };
+  typedef Matrix<Scalar,InputsAtCompileTime,1> InputType;
+  typedef Matrix<Scalar,ValuesAtCompileTime,1> ValueType;
+  typedef Matrix<Scalar,ValuesAtCompileTime,InputsAtCompileTime> JacobianType;
+
+  int m_n;
+  BenchFunctor(int n) : m_n(n) {}
+
+  int inputs() const { return m_n; }
+  int values() const { return m_n; }
+
+  template<typename T>
+  int operator()(const Matrix<T,N,1>& x, Matrix<T,N,1>& v) const
+  {
+    using std::sin;
+    using std::exp;
+    for(int i = 0; i < m_n; ++i)
+    {
+      T vi = x[i] * x[i];
+      for(int j = 0; j < m_n; ++j)
+      {
+        T t = x[j];
+        t *= x[i];
+        t += sin(x[j]);
+        t /= double(i+j+2);
+        vi += t;
+      }
+      vi -= exp(-x[i]);
+      v[i] = vi;
+    }
+    return 0;
+  }
+
+  template<typename T>
+  void operator()(const Matrix<T,N,1>& x, Matrix<T,N,1>* v) const
+  {
+    (*this)(x, *v);
+  }
+};
+
+template<typename Jacobian>
+EIGEN_DONT_INLINE void autodiff(const Jacobian& f, const typename Jacobian::InputType& x,
+                                typename Jacobian::ValueType& v, typename Jacobian::JacobianType& jac)
+{
+  f(x, &v, &jac);
+}
+
+template<typename Functor, NumericalDiffMode mode>
+EIGEN_DONT_INLINE void numdiff(const NumericalDiff<Functor,mode>& f, const typename Functor::InputType& x,
+                               typename Functor::JacobianType& jac)
+{
+  f.df(x, jac);
+}
+
+template<typename Functor>
+typename Functor::JacobianType reference(const Functor& f, const typename Functor::InputType& x)
+{
+  typename Functor::JacobianType jac(f.values(), f.inputs());
+  typename Functor::ValueType v(f.values());
+  AutoDiffJacobian<Functor> ad(f);
+  ad(x, &v, &jac);
+  return jac;
+}
+
+int main()
+{
+  typedef BenchFunctor<Dynamic> DynamicFunctor;
+  typedef BenchFunctor<SIZE> FixedFunctor;
+  const int n = SIZE;
+  VectorXd x = VectorXd::Random(n);
+  Matrix<double,SIZE,1> xf = x;
+  MatrixXd jref = reference(DynamicFunctor(n), x);
+  MatrixXd jac(n,n);
+  Matrix<double,SIZE,SIZE> jacf;
+  VectorXd v(n);
+  Matrix<double,SIZE,1> vf;
+  DynamicFunctor func(n);
+  FixedFunctor funcf(n);
+  BenchTimer t;
+
+  cout << "jacobian of size " << n << "x" << n << ", " << REPEAT << " evaluations\n";
+
+  NumericalDiff<DynamicFunctor,Forward> numForward(func);
+  BENCH(t, 4, REPEAT, numdiff(numForward, x, jac));
+  cout << "  NumericalDiff<Forward>           " << t.best() << "s \terror " << (jac-jref).norm() << "\n";
+
+  NumericalDiff<DynamicFunctor,Central> numCentral(func);
+  BENCH(t, 4, REPEAT, numdiff(numCentral, x, jac));
+  cout << "  NumericalDiff<Central>           " << t.best() << "s \terror " << (jac-jref).norm() << "\n";
+
+  AutoDiffJacobian<DynamicFunctor> adDynamic(func);
+  BENCH(t, 4, REPEAT, autodiff(adDynamic, x, v, jac));
+  cout << "  AutoDiffJacobian, dynamic        " << t.best() << "s \terror " << (jac-jref).norm() << "\n";
+
+  AutoDiffJacobian<DynamicFunctor,SIZE> adBounded(func);
+  BENCH(t, 4, REPEAT, autodiff(adBounded, x, v, jac));
+  cout << "  AutoDiffJacobian, fixed-capacity " << t.best() << "s \terror " << (jac-jref).norm() << "\n";
+
+  AutoDiffJacobian<FixedFunctor> adFixed(funcf);
+  BENCH(t, 4, REPEAT, autodiff(adFixed, xf, vf, jacf));
+  cout << "  AutoDiffJacobian, fixed          " << t.best() << "s \terror " << (MatrixXd(jacf)-jref).norm() << "\n";
+
+  return 0;
+}
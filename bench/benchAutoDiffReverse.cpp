@@ -0,0 +1,104 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Measures the cost of a gradient computed by reverse mode automatic differentiation (AutoDiffTape), relative to the
+// cost of the function itself, for a scalar-level function with many parameters and for a matrix-level function.
+//
+// g++ -O3 -DNDEBUG -I.. -I../.. benchAutoDiffReverse.cpp -o benchAutoDiffReverse
+
+#include <iostream>
+#include <bench/BenchTimer.h>
+#include <Eigen/Core>
+#include <unsupported/Eigen/AutoDiff>
+
+using namespace Eigen;
+using namespace std;
+
+#ifndef SIZE
+#define SIZE 100000
+#endif
+
+// extended Rosenbrock function
+template<typename T>
+EIGEN_DONT_INLINE T rosenbrock(const Matrix<T,Dynamic,1>& x)
+{
+  T f(0);
+  for(Index i = 0; i+1 < x.size(); ++i)
+  {
+    T a = T(1) - x[i], b = x[i+1] - x[i]*x[i];
+    f += a*a + 100*b*b;
+  }
+  return f;
+}
+
+EIGEN_DONT_INLINE void rosenbrock_gradient(AutoDiffTape<double>& tape, const VectorXd& x, VectorXd& g)
+{
+  typedef AutoDiffTape<double>::ActiveScalar AD;
+  tape.clear();
+  Matrix<AD,Dynamic,1> ax = tape.variables(x);
+  g = tape.gradient(rosenbrock(ax), ax);
+}
+
+EIGEN_DONT_INLINE double least_squares(const MatrixXd& A, const VectorXd& x, const VectorXd& b)
+{
+  // A*x is ambiguous once the AutoDiff module is included, because of its
+  // scalar_product_traits<Matrix<S>,S> specialization
+  return (Product<MatrixXd,VectorXd>(A,x) - b).squaredNorm();
+}
+
+EIGEN_DONT_INLINE void least_squares_gradient(AutoDiffTape<double>& tape, const MatrixXd& A, const VectorXd& x,
+                                              const VectorXd& b, VectorXd& g)
+{
+  typedef AutoDiffTape<double>::ActiveScalar AD;
+  tape.clear();
+  Matrix<AD,Dynamic,1> ax = tape.variables(x);
+  Matrix<AD,Dynamic,1> r = tape.product(A, ax) - b.cast<AD>();
+  g = tape.gradient(tape.squaredNorm(r), ax);
+}
+
+EIGEN_DONT_INLINE void least_squares_gradient_scalar(AutoDiffTape<double>& tape, const MatrixXd& A, const VectorXd& x,
+                                                     const VectorXd& b, VectorXd& g)
+{
+  typedef AutoDiffTape<double>::ActiveScalar AD;
+  tape.clear();
+  Matrix<AD,Dynamic,1> ax = tape.variables(x);
+  Matrix<AD,Dynamic,1> r = A.cast<AD>().lazyProduct(ax) - b.cast<AD>();
+  g = tape.gradient(r.squaredNorm(), ax);
+}
+
+int main()
+{
+  BenchTimer t;
+  AutoDiffTape<double> tape;
+  double f = 0;
+
+  {
+    VectorXd x = VectorXd::Random(SIZE), g;
+    BENCH(t, 5, 10, x(0) += 1e-9; f += rosenbrock(x));
+    const double tf = t.best();
+    BENCH(t, 5, 10, x(0) += 1e-9; rosenbrock_gradient(tape, x, g));
+    cout << "rosenbrock, " << SIZE << " parameters\n";
+    cout << "  function  " << tf << "s\n";
+    cout << "  gradient  " << t.best() << "s\t(" << t.best()/tf << "x, " << tape.nodeCount() << " nodes)\n";
+  }
+
+  {
+    const Index m = 400, n = 600;
+    MatrixXd A = MatrixXd::Random(m, n);
+    VectorXd x = VectorXd::Random(n), b = VectorXd::Random(m), g;
+    BENCH(t, 5, 10, x(0) += 1e-9; f += least_squares(A, x, b));
+    const double tf = t.best();
+    cout << "least squares ||A*x-b||^2, A of size " << m << "x" << n << "\n";
+    cout << "  function                        " << tf << "s\n";
+    BENCH(t, 5, 10, least_squares_gradient(tape, A, x, b, g));
+    cout << "  gradient, matrix-level product  " << t.best() << "s\t(" << t.best()/tf << "x, " << tape.nodeCount() << " nodes)\n";
+    BENCH(t, 5, 10, least_squares_gradient_scalar(tape, A, x, b, g));
+    cout << "  gradient, scalar-level product  " << t.best() << "s\t(" << t.best()/tf << "x, " << tape.nodeCount() << " nodes)\n";
+  }
+
+  return f == 0;
+}
@@ -0,0 +1,46 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Reports the scaling of BDCSVD of a SIZE x SIZE matrix with the number of threads, whose divide and conquer
+// recursion runs on OpenMP tasks.
+//
+// g++ -O3 -DNDEBUG -fopenmp -I.. benchBDCSVD.cpp -o benchBDCSVD
+// (add -DSIZE=5000 for the largest problems)
+
+#include <iostream>
+#include <bench/BenchTimer.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+using namespace std;
+
+#ifndef SIZE
+#define SIZE 2000
+#endif
+
+EIGEN_DONT_INLINE void bdcsvd(BDCSVD<MatrixXd>& svd, const MatrixXd& A, unsigned int options)
+{
+  svd.compute(A, options);
+}
+
+int main()
+{
+  BenchTimer t;
+  MatrixXd A = MatrixXd::Random(SIZE, SIZE);
+  BDCSVD<MatrixXd> svd;
+  const int maxThreads = nbThreads();
+  cout << SIZE << "x" << SIZE << "\n";
+  for(int threads = 1; threads <= maxThreads; threads *= 2)
+  {
+    setNbThreads(threads);
+    BENCH(t, 2, 1, bdcsvd(svd, A, 0));
+    cout << "  " << threads << " threads, singular values  " << t.best() << "s\n";
+    BENCH(t, 2, 1, bdcsvd(svd, A, ComputeThinU | ComputeThinV));
+    cout << "  " << threads << " threads, with U and V      " << t.best() << "s\n";
+  }
+  return 0;
+}
@@ -0,0 +1,84 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Compares the exponentials of many small matrices computed one at a time by MatrixBase::exp(), with the Pade
+// approximant or the closed forms, and by the batched matrixExpBatch() and so3ExpBatch().
+//
+// g++ -O3 -DNDEBUG -I.. -I../.. benchMatrixExpBatch.cpp -o benchMatrixExpBatch
+// (add -fopenmp to process the batches in parallel)
+
+#include <iostream>
+#include <bench/BenchTimer.h>
+#include <unsupported/Eigen/MatrixFunctions>
+
+using namespace Eigen;
+using namespace std;
+
+#ifndef SIZE
+#define SIZE 100000
+#endif
+
+typedef Stride<Dynamic,Dynamic> BatchStride;
+
+// the matrix stored in the row i of a batch
+template<int K>
+Map<Matrix<double,K,K>, 0, BatchStride> batch_matrix(ArrayXXd& batch, Index i)
+{
+  return Map<Matrix<double,K,K>, 0, BatchStride>(&batch(i,0), BatchStride(batch.rows()*K, batch.rows()));
+}
+
+template<int K>
+EIGEN_DONT_INLINE void exp_one_at_a_time(ArrayXXd& args, ArrayXXd& result)
+{
+  for(Index i = 0; i < args.rows(); ++i)
+  {
+    const Matrix<double,K,K> A = batch_matrix<K>(args, i);
+    batch_matrix<K>(result, i) = A.exp();
+  }
+}
+
+EIGEN_DONT_INLINE void so3_exp_one_at_a_time(const ArrayXXd& omegas, ArrayXXd& result, double diagonal)
+{
+  Matrix3d W;
+  for(Index i = 0; i < omegas.rows(); ++i)
+  {
+    W << diagonal, -omegas(i,2), omegas(i,1), omegas(i,2), 0, -omegas(i,0), -omegas(i,1), omegas(i,0), 0;
+    batch_matrix<3>(result, i) = W.exp();
+  }
+}
+
+template<int K>
+void bench_general()
+{
+  ArrayXXd args = ArrayXXd::Random(SIZE, K*K), result(SIZE, K*K);
+  BenchTimer t;
+  BENCH(t, 2, 3, exp_one_at_a_time<K>(args, result));
+  cout << K << "x" << K << ", one at a time         " << t.best() << "s\n";
+  BENCH(t, 2, 3, matrixExpBatch(args, result));
+  cout << K << "x" << K << ", matrixExpBatch        " << t.best() << "s\n";
+}
+
+int main()
+{
+  cout << SIZE << " matrices\n";
+  BenchTimer t;
+
+  const ArrayXXd omegas = ArrayXXd::Random(SIZE, 3);
+  ArrayXXd rotations(SIZE, 9);
+  // a tiny diagonal coefficient makes the matrices not skew-symmetric, and exp() then uses the Pade approximant
+  BENCH(t, 2, 3, so3_exp_one_at_a_time(omegas, rotations, 1e-300));
+  cout << "so(3), Pade approximant    " << t.best() << "s\n";
+  BENCH(t, 2, 3, so3_exp_one_at_a_time(omegas, rotations, 0));
+  cout << "so(3), Rodrigues formula   " << t.best() << "s\n";
+  BENCH(t, 2, 3, so3ExpBatch(omegas, rotations));
+  cout << "so(3), so3ExpBatch         " << t.best() << "s\n";
+
+  bench_general<3>();
+  bench_general<4>();
+  bench_general<6>();
+  return 0;
+}
@@ -0,0 +1,95 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Compares the normal equations and the QR factorization of a tall matrix computed in memory, and streamed by
+// TileStream and TallSkinnyQR from a memory-mapped file. The file is written once, then the timings include reading
+// it from the page cache or from the storage, depending on the available memory.
+//
+// g++ -O3 -DNDEBUG -I.. -I../.. benchOutOfCore.cpp -o benchOutOfCore
+// (add -fopenmp to process the tiles in parallel)
+
+#include <iostream>
+#include <cstdio>
+#include <bench/BenchTimer.h>
+#include <Eigen/Dense>
+#include <unsupported/Eigen/OutOfCore>
+#include <unsupported/Eigen/SparseExtra>
+
+using namespace Eigen;
+using namespace std;
+
+#ifndef ROWS
+#define ROWS 1000000
+#endif
+
+#ifndef COLS
+#define COLS 32
+#endif
+
+EIGEN_DONT_INLINE void normal_equations(const MatrixXd& A, const VectorXd& b, MatrixXd& AtA, VectorXd& Atb)
+{
+  AtA.setZero(A.cols(), A.cols());
+  AtA.selfadjointView<Lower>().rankUpdate(A.transpose());
+  Atb.noalias() = A.transpose() * b;
+}
+
+EIGEN_DONT_INLINE void streamed_normal_equations(const TileStream& stream, const Map<const MatrixXd>& A,
+                                                 const VectorXd& b, MatrixXd& AtA, VectorXd& Atb)
+{
+  stream.normalEquations(A, b, AtA, Atb);
+}
+
+EIGEN_DONT_INLINE void householder_solve(const MatrixXd& A, const VectorXd& b, VectorXd& x)
+{
+  x = A.householderQr().solve(b);
+}
+
+EIGEN_DONT_INLINE void tsqr_solve(TallSkinnyQR<MatrixXd>& qr, const Map<const MatrixXd>& A, const VectorXd& b,
+                                  VectorXd& x)
+{
+  x = qr.compute(A, b).leastSquaresSolution();
+}
+
+int main()
+{
+  const char* filename = "benchOutOfCore.bin";
+  BenchTimer t;
+  VectorXd b = VectorXd::Random(ROWS), x, Atb;
+  MatrixXd AtA;
+  double in_memory_normal, in_memory_qr;
+  {
+    MatrixXd A = MatrixXd::Random(ROWS, COLS);
+    saveBinary(A, filename);
+    BENCH(t, 2, 1, normal_equations(A, b, AtA, Atb));
+    in_memory_normal = t.best();
+    BENCH(t, 2, 1, householder_solve(A, b, x));
+    in_memory_qr = t.best();
+  }
+
+  MappedBinaryFile file(filename);
+  Map<const MatrixXd> A = file.denseMap<MatrixXd>();
+  cout << ROWS << "x" << COLS << " matrix, " << double(ROWS)*COLS*sizeof(double)/(1<<20) << "MB\n";
+
+  cout << "normal equations\n";
+  cout << "  in memory              " << in_memory_normal << "s\n";
+  TileStream stream;
+  BENCH(t, 2, 1, streamed_normal_equations(stream, A, b, AtA, Atb));
+  cout << "  mapped, TileStream     " << t.best() << "s\n";
+  stream.setReadAhead(0);
+  BENCH(t, 2, 1, streamed_normal_equations(stream, A, b, AtA, Atb));
+  cout << "  without read-ahead     " << t.best() << "s\n";
+
+  cout << "least squares by QR\n";
+  cout << "  in memory, HouseholderQR  " << in_memory_qr << "s\n";
+  TallSkinnyQR<MatrixXd> qr;
+  BENCH(t, 2, 1, tsqr_solve(qr, A, b, x));
+  cout << "  mapped, TallSkinnyQR      " << t.best() << "s\n";
+
+  file.close();
+  std::remove(filename);
+  return 0;
+}
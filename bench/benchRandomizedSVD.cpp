@@ -0,0 +1,85 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Compares the cost of the RANK largest singular triplets computed by RandomizedSVD with the full BDCSVD of a dense
+// matrix, and reports the cost of RandomizedSVD on a large sparse matrix.
+//
+// g++ -O3 -DNDEBUG -I.. benchRandomizedSVD.cpp -o benchRandomizedSVD
+// (add -fopenmp to parallelize the products)
+
+#include <iostream>
+#include <bench/BenchTimer.h>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+using namespace Eigen;
+using namespace std;
+
+#ifndef ROWS
+#define ROWS 4000
+#endif
+
+#ifndef COLS
+#define COLS 1000
+#endif
+
+#ifndef RANK
+#define RANK 50
+#endif
+
+EIGEN_DONT_INLINE void full_svd(const MatrixXd& A, VectorXd& s)
+{
+  BDCSVD<MatrixXd> svd(A, ComputeThinU | ComputeThinV);
+  s = svd.singularValues().head(RANK);
+}
+
+template<typename MatrixType>
+EIGEN_DONT_INLINE void randomized_svd(RandomizedSVD<MatrixXd>& svd, const MatrixType& A, VectorXd& s)
+{
+  svd.compute(A, RANK, ComputeThinU | ComputeThinV);
+  s = svd.singularValues();
+}
+
+int main()
+{
+  BenchTimer t;
+  VectorXd s, sref;
+  RandomizedSVD<MatrixXd> svd;
+
+  {
+    // singular values decaying as 1/i
+    MatrixXd A = HouseholderQR<MatrixXd>(MatrixXd::Random(ROWS, COLS)).householderQ() * MatrixXd::Identity(ROWS, COLS)
+               * VectorXd::LinSpaced(COLS, 1, COLS).cwiseInverse().asDiagonal()
+               * HouseholderQR<MatrixXd>(MatrixXd::Random(COLS, COLS)).householderQ();
+    cout << "dense " << ROWS << "x" << COLS << ", rank " << RANK << "\n";
+    BENCH(t, 2, 1, full_svd(A, sref));
+    cout << "  BDCSVD          " << t.best() << "s\n";
+    for(int q = 0; q <= 4; q += 2)
+    {
+      svd.setPowerIterations(q);
+      BENCH(t, 2, 1, randomized_svd(svd, A, s));
+      cout << "  RandomizedSVD, " << q << " power iterations  " << t.best() << "s\t(relative error of the singular values "
+           << (s - sref).norm() / sref.norm() << ")\n";
+    }
+  }
+
+  {
+    const int rows = 100*ROWS, cols = 10*COLS, perCol = 100;
+    std::vector<Triplet<double> > triplets;
+    for(int j = 0; j < cols; ++j)
+      for(int k = 0; k < perCol; ++k)
+        triplets.push_back(Triplet<double>(internal::random<int>(0, rows-1), j, internal::random<double>()));
+    SparseMatrix<double> A(rows, cols);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    svd.setPowerIterations(2);
+    BENCH(t, 2, 1, randomized_svd(svd, A, s));
+    cout << "sparse " << rows << "x" << cols << " with " << A.nonZeros() << " non zeros, rank " << RANK << "\n";
+    cout << "  RandomizedSVD   " << t.best() << "s\n";
+  }
+
+  return 0;
+}
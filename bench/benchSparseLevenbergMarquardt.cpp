@@ -0,0 +1,73 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Solves the Broyden tridiagonal problem with LevenbergMarquardt, the jacobian being estimated by finite differences
+// on the colored columns, with SparseQR and with the Cholesky factorization of the normal equations.
+//
+// g++ -O3 -DNDEBUG -I.. -I../.. benchSparseLevenbergMarquardt.cpp -o benchSparseLevenbergMarquardt
+// (add -fopenmp to evaluate the functor concurrently)
+
+#include <iostream>
+#include <bench/BenchTimer.h>
+#include <unsupported/Eigen/LevenbergMarquardt>
+
+using namespace Eigen;
+using namespace std;
+
+#ifndef SIZE
+#define SIZE 20000
+#endif
+
+struct broyden : SparseFunctor<double,int>
+{
+  broyden(int n) : SparseFunctor<double,int>(n,n) {}
+  int operator()(const VectorXd& x, VectorXd& fvec) const
+  {
+    const int n = values();
+    for(int i = 0; i < n; ++i)
+    {
+      fvec(i) = (3-2*x(i))*x(i) + 1;
+      if(i > 0) fvec(i) -= x(i-1);
+      if(i+1 < n) fvec(i) -= 2*x(i+1);
+    }
+    return 0;
+  }
+};
+
+struct broyden_cholesky : broyden
+{
+  typedef SparseNormalCholesky<JacobianType> QRSolver;
+  broyden_cholesky(int n) : broyden(n) {}
+};
+
+template<typename Functor>
+void run(const char* name)
+{
+  const int n = SIZE;
+  NumericalDiff<Functor> functor(n);
+  SparseMatrix<double> pattern(n, n);
+  for(int i = 0; i < n; ++i)
+    for(int j = (std::max)(i-1,0); j <= (std::min)(i+1,n-1); ++j)
+      pattern.insert(i, j) = 1;
+  functor.setSparsityPattern(pattern);
+  functor.setThreads(0);
+
+  BenchTimer t;
+  VectorXd x, fvec(n);
+  int info = 0;
+  BENCH(t, 1, 3, x = VectorXd::Constant(n, -1.); LevenbergMarquardt<NumericalDiff<Functor> > lm(functor); info = lm.minimize(x));
+  functor(x, fvec);
+  cout << name << "  " << t.best() << "s\t" << functor.colors() << " colors, status " << info << ", |f| " << fvec.norm() << "\n";
+}
+
+int main()
+{
+  cout << SIZE << " parameters\n";
+  run<broyden>("SparseQR            ");
+  run<broyden_cholesky>("SparseNormalCholesky");
+  return 0;
+}
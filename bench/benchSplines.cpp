@@ -0,0 +1,57 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Compares the evaluation of a cubic spline at many sorted sites, one site at a time and by the batch evaluation.
+//
+// g++ -O3 -DNDEBUG -I.. -I../.. benchSplines.cpp -o benchSplines
+// (add -fopenmp to split the sites across threads)
+
+#include <iostream>
+#include <bench/BenchTimer.h>
+#include <Eigen/Core>
+#include <unsupported/Eigen/Splines>
+
+using namespace Eigen;
+using namespace std;
+
+#ifndef SIZE
+#define SIZE 1000000
+#endif
+
+#ifndef CTRLS
+#define CTRLS 1000
+#endif
+
+template<typename SplineType>
+void bench(const SplineType& spline, const char* name)
+{
+  typedef typename SplineType::ControlPointVectorType ControlPointVectorType;
+  const ArrayXd u = ArrayXd::LinSpaced(SIZE, 0, 1);
+  ControlPointVectorType pts(3, SIZE), ders;
+  BenchTimer t;
+
+  cout << name << ", " << SIZE << " sites\n";
+  BENCH(t, 2, 3, for(Index i = 0; i < SIZE; ++i) pts.col(i) = spline(u(i)));
+  cout << "  one site at a time     " << t.best() << "s\n";
+  BENCH(t, 2, 3, pts = spline(u));
+  cout << "  batch                  " << t.best() << "s\n";
+  BENCH(t, 2, 3, for(Index i = 0; i < SIZE; ++i) pts.col(i) = spline.derivatives(u(i), 1).col(1));
+  cout << "  derivatives, one site  " << t.best() << "s\n";
+  BENCH(t, 2, 3, ders = spline.derivatives(u, 1));
+  cout << "  derivatives, batch     " << t.best() << "s\n";
+}
+
+int main()
+{
+  ArrayXd knots(CTRLS+4);
+  knots << 0, 0, 0, ArrayXd::LinSpaced(CTRLS-2, 0, 1), 1, 1, 1;
+  const Array3Xd ctrls = Array3Xd::Random(3, CTRLS);
+
+  bench(Spline3d(knots.transpose(), ctrls), "dynamic degree 3");
+  bench(Spline<double,3,3>(knots.transpose(), ctrls), "fixed degree 3");
+  return 0;
+}
@@ -43,6 +43,9 @@ const float min_accurate_time = 1e-2f;
 // See --min-working-set-size command line parameter.
 size_t min_working_set_size = 0;
 
+// See --output command line parameter.
+string autotune_output = "eigen-blocking-sizes.txt";
+
 float max_clock_speed = 0.0f;
 
 // range of sizes that we will benchmark (in all 3 K,M,N dimensions)
@@ -291,6 +294,10 @@ void show_usage_and_exit(int /*argc*/, char* argv[],
   cerr << "       set to likely outsize caches." << endl;
   cerr << "       A value of 1 (that is, 1 byte) would mean don't do anything to" << endl;
   cerr << "       avoid warm caches." << endl;
+  cerr << "  --output=FILE:" << endl;
+  cerr << "       File written by the autotune action, default " << autotune_output << "." << endl;
+  cerr << "       It can be loaded by programs compiled with EIGEN_USE_BLOCKING_SIZES_TABLE," << endl;
+  cerr << "       see Eigen::loadBlockingSizesTable() and the EIGEN_BLOCKING_SIZES_FILE variable." << endl;
   exit(1);
 }
      
@@ -618,6 +625,76 @@ struct measure_default_sizes_action_t : action_t
   }
 };
 
+// product sizes benchmarked, in each of the K,M,N dimensions, by the autotune action
+const size_t autotune_sizes[] = { 64, 256, 1024 };
+
+// Runs the default and all POT blocking sizes on a few product sizes, and writes the best ones
+// as a table which programs can load at runtime.
+struct autotune_action_t : action_t
+{
+  virtual const char* invokation_name() const { return "autotune"; }
+  virtual void run() const
+  {
+    const size_t num_sizes = sizeof(autotune_sizes) / sizeof(autotune_sizes[0]);
+    vector<benchmark_t> benchmarks;
+    for (int repetition = 0; repetition < measurement_repetitions; repetition++) {
+      for (size_t ki = 0; ki < num_sizes; ki++) {
+        for (size_t mi = 0; mi < num_sizes; mi++) {
+          for (size_t ni = 0; ni < num_sizes; ni++) {
+            const size_t ksize = autotune_sizes[ki], msize = autotune_sizes[mi], nsize = autotune_sizes[ni];
+            benchmarks.emplace_back(ksize, msize, nsize);
+            for (size_t kblock = minsize; kblock <= ksize; kblock *= 2) {
+              for (size_t mblock = minsize; mblock <= msize; mblock *= 2) {
+                for (size_t nblock = minsize; nblock <= nsize; nblock *= 2) {
+                  benchmarks.emplace_back(ksize, msize, nsize, kblock, mblock, nblock);
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+
+    run_benchmarks(benchmarks);
+
+    // keep the fastest blocking sizes of each product size
+    vector<benchmark_t> best;
+    for (auto it = benchmarks.begin(); it != benchmarks.end(); ++it) {
+      if (best.empty() || best.back().compact_product_size != it->compact_product_size) {
+        best.push_back(*it);
+      } else if (it->gflops > best.back().gflops) {
+        best.back() = *it;
+      }
+    }
+
+    ofstream file(autotune_output.c_str());
+    if (!file.is_open()) {
+      cerr << "Could not open file " << autotune_output << " for writing." << endl;
+      exit(1);
+    }
+    file << "# blocking sizes measured by benchmark-blocking-sizes autotune, see Eigen::loadBlockingSizesTable()" << endl;
+    file << "# scalar k m n kc mc nc" << endl;
+    cout << "BEGIN MEASUREMENTS AUTOTUNE" << endl;
+    for (auto it = best.begin(); it != best.end(); ++it) {
+      cout << *it << endl;
+      size_triple_t product_size(it->compact_product_size);
+      Index k = product_size.k, m = product_size.m, n = product_size.n;
+      if (it->use_default_block_size) {
+        internal::computeProductBlockingSizes<Scalar, Scalar>(k, m, n);
+      } else {
+        size_triple_t block_size(it->compact_block_size);
+        k = block_size.k;
+        m = block_size.m;
+        n = block_size.n;
+      }
+      file << type_name<Scalar>() << " "
+           << product_size.k << " " << product_size.m << " " << product_size.n << " "
+           << k << " " << m << " " << n << endl;
+    }
+    cerr << "Wrote the blocking sizes table to " << autotune_output << endl;
+  }
+};
+
 int main(int argc, char* argv[])
 {
   double time_start = timer.getRealTime();
@@ -627,6 +704,7 @@ int main(int argc, char* argv[])
   vector<unique_ptr<action_t>> available_actions;
   available_actions.emplace_back(new measure_all_pot_sizes_action_t);
   available_actions.emplace_back(new measure_default_sizes_action_t);
+  available_actions.emplace_back(new autotune_action_t);
 
   auto action = available_actions.end();
 
@@ -648,6 +726,8 @@ int main(int argc, char* argv[])
     if (argv[i] == strstr(argv[i], "--min-working-set-size=")) {
       const char* equals_sign = strchr(argv[i], '=');
       min_working_set_size = strtoul(equals_sign+1, nullptr, 10);
+    } else if (argv[i] == strstr(argv[i], "--output=")) {
+      autotune_output = strchr(argv[i], '=') + 1;
     } else {
       cerr << "unrecognized option: " << argv[i] << endl << endl;
       show_usage_and_exit(argc, argv, available_actions);
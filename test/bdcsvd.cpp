@@ -62,6 +62,23 @@ void compare_bdc_jacobi(const MatrixType& a = MatrixType(), unsigned int computa
   if(computationOptions & ComputeThinV) VERIFY_IS_APPROX(bdc_svd.matrixV(), jacobi_svd.matrixV());
 }
 
+// the results do not depend on the size of the subproblems divided by concurrent tasks; the tasks
+// and the parallel merges only run when the test is built with OpenMP (EIGEN_TEST_OPENMP), otherwise
+// this only checks that the task size does not change the sequential results
+template<typename MatrixType>
+void bdcsvd_task_size(Index rows, Index cols)
+{
+  MatrixType m = MatrixType::Random(rows, cols);
+  BDCSVD<MatrixType> ref(m, ComputeThinU | ComputeThinV), svd;
+  int taskSize = internal::random<int>(16, 64);
+  svd.setTaskSize(taskSize);
+  VERIFY_IS_EQUAL(svd.taskSize(), taskSize);
+  svd.compute(m, ComputeThinU | ComputeThinV);
+  VERIFY_IS_APPROX(svd.singularValues(), ref.singularValues());
+  VERIFY_IS_APPROX(svd.matrixU(), ref.matrixU());
+  VERIFY_IS_APPROX(svd.matrixV(), ref.matrixV());
+}
+
 void test_bdcsvd()
 {
   CALL_SUBTEST_3(( svd_verify_assert<BDCSVD<Matrix3f>  >(Matrix3f()) ));
@@ -96,6 +113,9 @@ void test_bdcsvd()
     CALL_SUBTEST_10( (svd_inf_nan<BDCSVD<MatrixXd>, MatrixXd>()) );
   }
 
+  CALL_SUBTEST_11(( bdcsvd_task_size<MatrixXd>(internal::random<int>(100,300), internal::random<int>(100,300)) ));
+  CALL_SUBTEST_11(( bdcsvd_task_size<MatrixXcf>(internal::random<int>(100,200), internal::random<int>(100,200)) ));
+
   // test matrixbase method
   CALL_SUBTEST_1(( bdcsvd_method<Matrix2cd>() ));
   CALL_SUBTEST_3(( bdcsvd_method<Matrix3f>() ));
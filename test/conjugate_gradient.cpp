@@ -18,12 +18,101 @@ template<typename T, typename I> void test_conjugate_gradient_T()
   ConjugateGradient<SparseMatrixType, Lower|Upper> cg_colmajor_loup_diag;
   ConjugateGradient<SparseMatrixType, Lower, IdentityPreconditioner> cg_colmajor_lower_I;
   ConjugateGradient<SparseMatrixType, Upper, IdentityPreconditioner> cg_colmajor_upper_I;
+  ConjugateGradient<SparseMatrixType, Lower, DiagonalPreconditioner<T>, PipelinedCG> cg_colmajor_lower_diag_pipelined;
+  ConjugateGradient<SparseMatrixType, Lower|Upper, DiagonalPreconditioner<T>, PipelinedCG> cg_colmajor_loup_diag_pipelined;
+
+  // the pipelined recurrences cannot reach the default tolerance (the machine precision)
+  cg_colmajor_lower_diag_pipelined.setTolerance(NumTraits<T>::dummy_precision());
+  cg_colmajor_loup_diag_pipelined.setTolerance(NumTraits<T>::dummy_precision());
 
   CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_diag)  );
   CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_upper_diag)  );
   CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_loup_diag)   );
   CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_I)     );
   CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_upper_I)     );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_diag_pipelined) );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_loup_diag_pipelined)  );
+}
+
+// a preconditioner whose solve() only accepts vectors, and which does not opt in for blocks of right hand sides
+template<typename T> class VectorOnlyPreconditioner : public DiagonalPreconditioner<T>
+{
+  public:
+    template<typename Rhs>
+    const Solve<DiagonalPreconditioner<T>,Rhs> solve(const MatrixBase<Rhs>& b) const
+    {
+      EIGEN_STATIC_ASSERT_VECTOR_ONLY(Rhs);
+      return DiagonalPreconditioner<T>::solve(b);
+    }
+};
+
+template<typename Solver, typename SparseMatrixType, typename DenseMatrix>
+void check_multiple_rhs_columns(Solver& solver, const SparseMatrixType& A, const DenseMatrix& B)
+{
+  typedef typename DenseMatrix::RealScalar RealScalar;
+  solver.setTolerance(RealScalar(1e-8));
+  solver.compute(A);
+  DenseMatrix X = solver.solve(B);
+  VERIFY(solver.info()==Success);
+  VERIFY((A*X-B).norm() <= RealScalar(2)*solver.tolerance() * B.norm());
+  for(Index j=0; j<B.cols(); ++j)
+    VERIFY_IS_APPROX(X.col(j), (Matrix<typename DenseMatrix::Scalar,Dynamic,1>(solver.solve(B.col(j)))));
+}
+
+template<typename T> void test_conjugate_gradient_multiple_rhs()
+{
+  typedef SparseMatrix<T> SparseMatrixType;
+  typedef Matrix<T,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<T,Dynamic,1> DenseVector;
+  typedef typename NumTraits<T>::Real RealScalar;
+
+  ConjugateGradient<SparseMatrixType, Lower|Upper> cg;
+  SparseMatrixType A, halfA;
+  DenseMatrix dA;
+  Index size = generate_sparse_spd_problem(cg, A, halfA, dA);
+  Index rhsCols = internal::random<Index>(2,20);
+  DenseMatrix B = DenseMatrix::Random(size, rhsCols);
+  B.col(0).setZero();
+
+  cg.setTolerance(RealScalar(1e-8));
+  cg.compute(A);
+  DenseMatrix X = cg.solve(B);
+  VERIFY(cg.info()==Success);
+  Index iterations = cg.iterations();
+  RealScalar error = cg.error();
+  VERIFY(error <= cg.tolerance());
+  VERIFY_IS_MUCH_SMALLER_THAN(X.col(0).norm(), RealScalar(1));
+
+  // each column is as accurate as its independent solve, the slowest one giving the number of iterations
+  Index maxIterations = 0;
+  for(Index j=1; j<rhsCols; ++j)
+  {
+    DenseVector xj = cg.solve(B.col(j));
+    VERIFY(cg.info()==Success);
+    maxIterations = (std::max)(maxIterations, cg.iterations());
+    VERIFY((A*X.col(j)-B.col(j)).norm() <= cg.tolerance() * B.col(j).norm());
+    VERIFY_IS_APPROX(X.col(j), xj);
+  }
+  VERIFY_IS_EQUAL(iterations, maxIterations);
+
+  // with a guess solving some of the columns
+  DenseMatrix X0 = X;
+  X0.rightCols(rhsCols/2).setZero();
+  X = cg.solveWithGuess(B, X0);
+  VERIFY(cg.info()==Success);
+  VERIFY((A*X-B).norm() <= RealScalar(2)*cg.tolerance() * B.norm());
+
+  // the other storage orders and triangular parts, a factorized preconditioner applied to blocks,
+  // and a custom preconditioner restricted to vectors, which solves the columns one after the other
+  SparseMatrix<T,RowMajor> rowA(A);
+  ConjugateGradient<SparseMatrix<T,RowMajor>, Lower|Upper> cg_rowmajor;
+  ConjugateGradient<SparseMatrixType, Lower> cg_lower;
+  ConjugateGradient<SparseMatrixType, Lower|Upper, IncompleteCholesky<T> > cg_ichol;
+  ConjugateGradient<SparseMatrixType, Lower|Upper, VectorOnlyPreconditioner<T> > cg_vector_only;
+  CALL_SUBTEST( check_multiple_rhs_columns(cg_rowmajor, rowA, B) );
+  CALL_SUBTEST( check_multiple_rhs_columns(cg_lower, A, B) );
+  CALL_SUBTEST( check_multiple_rhs_columns(cg_ichol, A, B) );
+  CALL_SUBTEST( check_multiple_rhs_columns(cg_vector_only, A, B) );
 }
 
 void test_conjugate_gradient()
@@ -31,4 +120,6 @@ void test_conjugate_gradient()
   CALL_SUBTEST_1(( test_conjugate_gradient_T<double,int>() ));
   CALL_SUBTEST_2(( test_conjugate_gradient_T<std::complex<double>, int>() ));
   CALL_SUBTEST_3(( test_conjugate_gradient_T<double,long int>() ));
+  CALL_SUBTEST_4(( test_conjugate_gradient_multiple_rhs<double>() ));
+  CALL_SUBTEST_4(( test_conjugate_gradient_multiple_rhs<std::complex<double> >() ));
 }
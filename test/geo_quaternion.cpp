@@ -272,6 +272,36 @@ template<typename PlainObjectType> void check_const_correctness(const PlainObjec
   VERIFY( !(Map<ConstPlainObjectType, Aligned>::Flags & LvalueBit) );
 }
 
+template<typename Scalar> void quaternion_batch_slerp()
+{
+  typedef Quaternion<Scalar> Quaternionx;
+  typedef Matrix<Scalar,4,Dynamic> Quaternions;
+  const Index n = internal::random<Index>(1,500);
+  Quaternions a(4,n), b(4,n), result(4,n), ref(4,n);
+  Matrix<Scalar,1,Dynamic> t = (Matrix<Scalar,1,Dynamic>::Random(n).array() + Scalar(1)) / Scalar(2);
+  for(Index j = 0; j < n; ++j)
+  {
+    a.col(j) = Quaternionx::UnitRandom().coeffs();
+    b.col(j) = Quaternionx::UnitRandom().coeffs();
+  }
+  // nearly equal and opposite quaternions
+  b.col(0) = a.col(0);
+  if(n > 1)
+    b.col(1) = -a.col(1);
+
+  for(Index j = 0; j < n; ++j)
+    ref.col(j) = Quaternionx(a.col(j)).slerp(t(j), Quaternionx(b.col(j))).coeffs();
+  slerpQuaternions(a, b, t, result);
+  VERIFY_IS_APPROX(result, ref);
+
+  Scalar t0 = t(0);
+  for(Index j = 0; j < n; ++j)
+    ref.col(j) = Quaternionx(a.col(j)).slerp(t0, Quaternionx(b.col(j))).coeffs();
+  Matrix<Scalar,Dynamic,4> soa = a.transpose();
+  slerpQuaternions(soa.transpose(), b, t0, soa.transpose());
+  VERIFY_IS_APPROX(Quaternions(soa.transpose()), ref);
+}
+
 void test_geo_quaternion()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -285,5 +315,7 @@ void test_geo_quaternion()
     CALL_SUBTEST_6(( quaternionAlignment<double>() ));
     CALL_SUBTEST_1( mapQuaternion<float>() );
     CALL_SUBTEST_2( mapQuaternion<double>() );
+    CALL_SUBTEST_1( quaternion_batch_slerp<float>() );
+    CALL_SUBTEST_2( quaternion_batch_slerp<double>() );
   }
 }
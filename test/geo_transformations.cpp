@@ -536,6 +536,51 @@ template<typename Scalar, int Dim, int Options> void transform_products()
   VERIFY_IS_APPROX((ac*p).matrix(), a_m*p_m);
 }
 
+template<typename Scalar, int Mode, int Options> void transform_points()
+{
+  typedef Transform<Scalar,3,Mode,Options> TransformType;
+  typedef Matrix<Scalar,3,Dynamic> Points;
+  typedef Matrix<Scalar,3,Dynamic,RowMajor> PointsSoA;
+  typedef Matrix<Scalar,3,1> Vector3;
+  const Index n = internal::random<Index>(1,1000);
+
+  TransformType t;
+  t.matrix().setRandom();
+  if(Mode==Projective)
+    t.matrix().row(3) << Vector3::Random().transpose() * Scalar(0.1), Scalar(1);
+  else
+    t.makeAffine();
+  Points points = Points::Random(3,n), ref(3,n), result(3,n);
+  Matrix<Scalar,4,4> m = Matrix<Scalar,4,4>::Identity();
+  m.topRows(t.matrix().rows()) = t.matrix();
+  for(Index j = 0; j < n; ++j)
+  {
+    Matrix<Scalar,4,1> h;
+    h << points.col(j), Scalar(1);
+    h = m * h;
+    ref.col(j) = h.template head<3>() / h(3);
+  }
+
+  transformPoints(t, points, result);
+  VERIFY_IS_APPROX(result, ref);
+  PointsSoA soa = points, soaResult(3,n);
+  transformPoints(t, soa, soaResult);
+  VERIFY_IS_APPROX(Points(soaResult), ref);
+  transformPoints(t, soa, soa);
+  VERIFY_IS_APPROX(Points(soa), ref);
+
+  Quaternion<Scalar> q = Quaternion<Scalar>::UnitRandom();
+  AngleAxis<Scalar> aa(q);
+  for(Index j = 0; j < n; ++j)
+    ref.col(j) = q * Vector3(points.col(j));
+  transformPoints(q, points, result);
+  VERIFY_IS_APPROX(result, ref);
+  transformPoints(aa, points.leftCols(n), soaResult);
+  VERIFY_IS_APPROX(Points(soaResult), ref);
+  transformPoints(q, points, points);
+  VERIFY_IS_APPROX(points, ref);
+}
+
 void test_geo_transformations()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -562,5 +607,10 @@ void test_geo_transformations()
 
     CALL_SUBTEST_7(( transform_products<double,3,RowMajor|AutoAlign>() ));
     CALL_SUBTEST_7(( transform_products<float,2,AutoAlign>() ));
+
+    CALL_SUBTEST_8(( transform_points<float,Affine,AutoAlign>() ));
+    CALL_SUBTEST_8(( transform_points<double,Isometry,AutoAlign>() ));
+    CALL_SUBTEST_8(( transform_points<float,AffineCompact,RowMajor>() ));
+    CALL_SUBTEST_8(( transform_points<double,Projective,AutoAlign>() ));
   }
 }
@@ -176,6 +176,53 @@ template<typename MatrixType> void lu_invertible()
   VERIFY_IS_APPROX(lu.solve(m3*m4), lu.solve(m3)*m4);
 }
 
+template<typename MatrixType> void lu_rook_piv()
+{
+  /* this test covers the blocked rook pivoting path of FullPivLU.h
+  */
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::RealScalar RealScalar;
+  Index rows = internal::random<Index>(2,200);
+  Index cols = internal::random<Index>(2,200);
+  Index rank = internal::random<Index>(1, (std::min)(rows, cols)-1);
+
+  MatrixType m1(rows, cols);
+  createRandomPIMatrixOfRank(rank, rows, cols, m1);
+
+  FullPivLU<MatrixType> lu;
+  VERIFY(!lu.usesRookPivoting());
+  lu.setThreshold(RealScalar(0.01));
+  lu.setRookPivoting().compute(m1);
+  VERIFY(lu.usesRookPivoting());
+
+  VERIFY_IS_APPROX(m1, lu.reconstructedMatrix());
+  VERIFY(rank == lu.rank());
+  VERIFY(cols - rank == lu.dimensionOfKernel());
+  MatrixType m1kernel = lu.kernel();
+  MatrixType m1image = lu.image(m1);
+  VERIFY(m1kernel.cols() == cols - rank);
+  VERIFY((m1 * m1kernel).isMuchSmallerThan(m1));
+  VERIFY(m1image.fullPivLu().rank() == rank);
+
+  MatrixType m2 = MatrixType::Random(cols, 3);
+  MatrixType m3 = m1*m2;
+  m2 = lu.solve(m3);
+  VERIFY_IS_APPROX(m3, m1*m2);
+
+  // exactly zero remaining corner
+  VERIFY(lu.compute(MatrixType::Zero(rows,cols)).rank() == 0);
+  VERIFY(lu.nonzeroPivots() == 0);
+
+  // invertible case
+  Index size = internal::random<Index>(1,200);
+  MatrixType m4 = MatrixType::Random(size, size);
+  lu.setThreshold(Default).compute(m4);
+  VERIFY(lu.isInvertible());
+  VERIFY_IS_APPROX(m4, lu.reconstructedMatrix());
+  VERIFY_IS_APPROX(lu.determinant(), m4.fullPivLu().determinant());
+  VERIFY_IS_APPROX(m4 * lu.inverse(), MatrixType::Identity(size, size));
+}
+
 template<typename MatrixType> void lu_partial_piv()
 {
   /* this test covers the following files:
@@ -261,6 +308,7 @@ void test_lu()
     CALL_SUBTEST_4( lu_non_invertible<MatrixXd>() );
     CALL_SUBTEST_4( lu_invertible<MatrixXd>() );
     CALL_SUBTEST_4( lu_partial_piv<MatrixXd>() );
+    CALL_SUBTEST_4( lu_rook_piv<MatrixXd>() );
     CALL_SUBTEST_4( lu_verify_assert<MatrixXd>() );
 
     CALL_SUBTEST_5( lu_non_invertible<MatrixXcf>() );
@@ -270,6 +318,7 @@ void test_lu()
     CALL_SUBTEST_6( lu_non_invertible<MatrixXcd>() );
     CALL_SUBTEST_6( lu_invertible<MatrixXcd>() );
     CALL_SUBTEST_6( lu_partial_piv<MatrixXcd>() );
+    CALL_SUBTEST_6( lu_rook_piv<MatrixXcd>() );
     CALL_SUBTEST_6( lu_verify_assert<MatrixXcd>() );
 
     CALL_SUBTEST_7(( lu_non_invertible<Matrix<float,Dynamic,16> >() ));
@@ -137,4 +137,16 @@ void test_nullary()
   // Assignment of a RowVectorXd to a MatrixXd (regression test for bug #79).
   VERIFY( (MatrixXd(RowVectorXd::LinSpaced(3, 0, 1)) - RowVector3d(0, 0.5, 1)).norm() < std::numeric_limits<double>::epsilon() );
 #endif
+
+#ifdef EIGEN_TEST_PART_9
+  // Integer LinSpaced of more than 46341 entries, (high-low)*i not fitting in an int.
+  {
+    const int size = internal::random<int>(46342,100000);
+    VectorXi ref(size);
+    for(int i = 0; i < size; ++i)
+      ref(i) = 2*i;
+    VERIFY_IS_EQUAL( VectorXi::LinSpaced(size, 0, 2*(size-1)), ref );
+    VERIFY_IS_EQUAL( VectorXi::LinSpaced(size, 0, size-1), (ref/2).eval() );
+  }
+#endif
 }
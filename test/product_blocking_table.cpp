@@ -0,0 +1,82 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// This test is compiled with EIGEN_USE_BLOCKING_SIZES_TABLE
+#include "main.h"
+#include <cstdio>
+
+static const char* table_filename = "product_blocking_table.txt";
+
+static void write_table(const char* contents)
+{
+  std::FILE* file = std::fopen(table_filename, "w");
+  VERIFY(file != 0);
+  std::fputs(contents, file);
+  std::fclose(file);
+}
+
+template<typename Scalar>
+void blocking_sizes_from_table()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  clearBlockingSizesTable();
+
+  Index k0 = 1000, m0 = 1000, n0 = 1000;
+  internal::computeProductBlockingSizes<Scalar,Scalar>(k0, m0, n0, Index(1));
+
+  VERIFY(!loadBlockingSizesTable("this_file_does_not_exist.txt"));
+  write_table("# ill-formed\nfloat 16 16\n");
+  VERIFY(!loadBlockingSizesTable(table_filename));
+  write_table("# scalar k m n kc mc nc\n"
+              "float 1024 1024 1024 192 96 48\n"
+              "\n"
+              "double 1024 1024 1024 192 96 48\n"
+              "complex<float> 1024 1024 1024 192 96 48\n"
+              "complex<double> 1024 1024 1024 192 96 48\n"
+              "  float 16 16 16 8 8 8\n"
+              "double 16 16 16 8 8 8\n");
+  VERIFY(loadBlockingSizesTable(table_filename));
+  std::remove(table_filename);
+
+  // the closest entry is used
+  Index k = 1000, m = 1200, n = 800;
+  internal::computeProductBlockingSizes<Scalar,Scalar>(k, m, n, Index(1));
+  VERIFY_IS_EQUAL(k, 192);
+  VERIFY_IS_EQUAL(m, 96);
+  VERIFY_IS_EQUAL(n, 48);
+
+  // the blocking sizes are bounded by the product sizes
+  k = 100; m = 30; n = 20;
+  internal::computeProductBlockingSizes<Scalar,Scalar>(k, m, n, Index(1));
+  VERIFY(k <= 100 && m <= 30 && n <= 20);
+
+  // parallel products still use the heuristic
+  Index kp = 1000, mp = 1000, np = 1000, kh = 1000, mh = 1000, nh = 1000;
+  internal::computeProductBlockingSizes<Scalar,Scalar>(kp, mp, np, Index(4));
+  internal::evaluateProductBlockingSizesHeuristic<Scalar,Scalar,1>(kh, mh, nh, Index(4));
+  VERIFY(kp <= kh && mp <= mh && np <= nh);
+
+  MatrixType a = MatrixType::Random(internal::random<int>(100,300), internal::random<int>(100,300));
+  MatrixType b = MatrixType::Random(a.cols(), internal::random<int>(100,300));
+  MatrixType c = a * b;
+  VERIFY_IS_APPROX(c, a.lazyProduct(b));
+
+  clearBlockingSizesTable();
+  k = 1000; m = 1000; n = 1000;
+  internal::computeProductBlockingSizes<Scalar,Scalar>(k, m, n, Index(1));
+  VERIFY_IS_EQUAL(k, k0);
+  VERIFY_IS_EQUAL(m, m0);
+  VERIFY_IS_EQUAL(n, n0);
+}
+
+void test_product_blocking_table()
+{
+  CALL_SUBTEST_1( blocking_sizes_from_table<float>() );
+  CALL_SUBTEST_2( blocking_sizes_from_table<double>() );
+  CALL_SUBTEST_3( blocking_sizes_from_table<std::complex<float> >() );
+  CALL_SUBTEST_4( blocking_sizes_from_table<std::complex<double> >() );
+}
@@ -0,0 +1,141 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/SVD>
+#include <Eigen/Sparse>
+
+template<typename MatrixType> class MatrixFreeOperator;
+
+namespace Eigen {
+namespace internal {
+template<typename MatrixType>
+struct traits<MatrixFreeOperator<MatrixType> > : traits<SparseMatrix<typename MatrixType::Scalar> >
+{};
+}
+}
+
+// a matrix-free operator applying a dense matrix or its adjoint
+template<typename MatrixType>
+class MatrixFreeOperator : public EigenBase<MatrixFreeOperator<MatrixType> >
+{
+  public:
+    MatrixFreeOperator(const MatrixType& mat, bool adjoint) : m_mat(mat), m_adjoint(adjoint) {}
+    Index rows() const { return m_adjoint ? m_mat.cols() : m_mat.rows(); }
+    Index cols() const { return m_adjoint ? m_mat.rows() : m_mat.cols(); }
+    MatrixFreeOperator adjoint() const { return MatrixFreeOperator(m_mat, !m_adjoint); }
+
+    template<typename Rhs>
+    MatrixType operator*(const MatrixBase<Rhs>& x) const
+    {
+      if(m_adjoint)
+        return m_mat.adjoint() * x;
+      return m_mat * x;
+    }
+
+  protected:
+    const MatrixType& m_mat;
+    bool m_adjoint;
+};
+
+// checks the rank k decomposition of a matrix of rank at most k + oversampling
+template<typename MatrixType, typename InputType>
+void check_randomized_svd(const InputType& input, const MatrixType& ref, Index rank)
+{
+  typedef typename MatrixType::RealScalar RealScalar;
+  BDCSVD<MatrixType> full(ref, ComputeThinU | ComputeThinV);
+
+  RandomizedSVD<MatrixType> svd;
+  svd.setThreads(internal::random<Index>(0, 3)).setPowerIterations(internal::random<Index>(0, 2));
+  svd.compute(input, rank, ComputeThinU | ComputeThinV);
+  VERIFY_IS_EQUAL(svd.rows(), ref.rows());
+  VERIFY_IS_EQUAL(svd.cols(), ref.cols());
+  VERIFY_IS_EQUAL(svd.singularValues().size(), rank);
+  VERIFY_IS_EQUAL(svd.matrixU().cols(), rank);
+  VERIFY_IS_EQUAL(svd.matrixV().cols(), rank);
+
+  const RealScalar scale = full.singularValues()(0);
+  VERIFY_IS_APPROX_OR_LESS_THAN((svd.singularValues() - full.singularValues().head(rank)).norm(), test_precision<RealScalar>() * scale);
+  VERIFY_IS_APPROX(svd.matrixU().adjoint() * svd.matrixU(), MatrixType::Identity(rank, rank));
+  VERIFY_IS_APPROX(svd.matrixV().adjoint() * svd.matrixV(), MatrixType::Identity(rank, rank));
+
+  // same best rank k approximation
+  MatrixType approx = svd.matrixU() * svd.singularValues().asDiagonal() * svd.matrixV().adjoint();
+  MatrixType best = full.matrixU().leftCols(rank) * full.singularValues().head(rank).asDiagonal()
+                  * full.matrixV().leftCols(rank).adjoint();
+  VERIFY_IS_APPROX_OR_LESS_THAN((approx - best).norm(), test_precision<RealScalar>() * scale);
+
+  // only the singular values
+  RandomizedSVD<MatrixType> values(input, rank);
+  VERIFY_RAISES_ASSERT(values.matrixU());
+  VERIFY_IS_APPROX_OR_LESS_THAN((values.singularValues() - full.singularValues().head(rank)).norm(), test_precision<RealScalar>() * scale);
+}
+
+template<typename MatrixType>
+void randomized_svd_dense(Index rows, Index cols)
+{
+  Index rank = internal::random<Index>(1, (std::min)(rows, cols));
+  Index trueRank = (std::min)(rank + 5, (std::min)(rows, cols));
+  MatrixType A = MatrixType::Random(rows, trueRank) * MatrixType::Random(trueRank, cols);
+  check_randomized_svd(A, A, rank);
+
+  // expressions are accepted
+  RandomizedSVD<MatrixType> svd(A.adjoint(), rank);
+  VERIFY_IS_APPROX(svd.singularValues(), BDCSVD<MatrixType>(A).singularValues().head(rank));
+
+  // low-rank least squares
+  if(trueRank == rank)
+  {
+    MatrixType b = A * MatrixType::Random(cols, 2);
+    svd.compute(A, rank, ComputeThinU | ComputeThinV);
+    VERIFY_IS_APPROX(A * svd.solve(b), b);
+  }
+}
+
+template<typename Scalar>
+void randomized_svd_sparse(Index rows, Index cols)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  // the non zeros are in a few columns, which bounds the rank
+  Index rank = internal::random<Index>(1, (std::min)(rows, cols)/2);
+  std::vector<Triplet<Scalar> > triplets;
+  for(Index j = 0; j < rank + 3; ++j)
+  {
+    Index col = internal::random<Index>(0, cols-1);
+    for(Index i = 0; i < rows; ++i)
+      if(internal::random<int>(0, 3) == 0)
+        triplets.push_back(Triplet<Scalar>(int(i), int(col), internal::random<Scalar>()));
+  }
+  SparseMatrix<Scalar> A(rows, cols);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  MatrixType dense = A;
+  check_randomized_svd(A, dense, rank);
+
+  SparseMatrix<Scalar,RowMajor> B = A;
+  check_randomized_svd(B, dense, rank);
+}
+
+template<typename MatrixType>
+void randomized_svd_matrix_free(Index rows, Index cols)
+{
+  Index rank = internal::random<Index>(1, (std::min)(rows, cols));
+  Index trueRank = (std::min)(rank + internal::random<Index>(0, 10), (std::min)(rows, cols));
+  MatrixType A = MatrixType::Random(rows, trueRank) * MatrixType::Random(trueRank, cols);
+  check_randomized_svd(MatrixFreeOperator<MatrixType>(A, false), A, rank);
+}
+
+void test_randomized_svd()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(( randomized_svd_dense<MatrixXd>(internal::random<int>(1,200), internal::random<int>(1,200)) ));
+    CALL_SUBTEST_2(( randomized_svd_dense<MatrixXf>(internal::random<int>(1,100), internal::random<int>(1,100)) ));
+    CALL_SUBTEST_3(( randomized_svd_dense<MatrixXcd>(internal::random<int>(1,100), internal::random<int>(1,100)) ));
+    CALL_SUBTEST_4(( randomized_svd_sparse<double>(internal::random<int>(2,300), internal::random<int>(2,300)) ));
+    CALL_SUBTEST_5(( randomized_svd_matrix_free<MatrixXd>(internal::random<int>(1,200), internal::random<int>(1,200)) ));
+  }
+  CALL_SUBTEST_1(( randomized_svd_dense<MatrixXd>(1000, 300) ));
+}
@@ -12,6 +12,7 @@
 static long g_realloc_count = 0;
 #define EIGEN_SPARSE_COMPRESSED_STORAGE_REALLOCATE_PLUGIN g_realloc_count++;
 
+#include <list>
 #include "sparse.h"
 
 template<typename SparseMatrixType> void sparse_basic(const SparseMatrixType& ref)
@@ -297,6 +298,52 @@ template<typename SparseMatrixType> void sparse_basic(const SparseMatrixType& re
     m.setFromTriplets(triplets.begin(), triplets.end(), [] (Scalar,Scalar b) { return b; });
     VERIFY_IS_APPROX(m, refMat_last);
 #endif
+
+    // reuse of the pattern to assemble new values
+    typename SparseMatrixType::IndexVector positions;
+    m.setFromTriplets(triplets.begin(), triplets.end(), positions);
+    VERIFY_IS_APPROX(m, refMat_sum);
+    VERIFY_IS_EQUAL(positions.size(), ntriplets);
+    const Index nnz = m.nonZeros();
+    for(Index i=0;i<ntriplets;++i)
+      triplets[i] = TripletType(triplets[i].row(), triplets[i].col(), Scalar(2)*triplets[i].value());
+    m.updateFromTriplets(triplets.begin(), triplets.end(), positions);
+    VERIFY_IS_EQUAL(m.nonZeros(), nnz);
+    VERIFY_IS_APPROX(m, Scalar(2)*refMat_sum);
+    m.setFromTriplets(triplets.begin(), triplets.end(), std::multiplies<Scalar>(), positions);
+    for(Index i=0;i<ntriplets;++i)
+      triplets[i] = TripletType(triplets[i].row(), triplets[i].col(), triplets[i].value()/Scalar(2));
+    m.updateFromTriplets(triplets.begin(), triplets.end(), positions, std::multiplies<Scalar>());
+    VERIFY_IS_APPROX(m, refMat_prod);
+
+    // forward iterators
+    std::list<TripletType> tripletList(triplets.begin(), triplets.end());
+    m.setFromTriplets(tripletList.begin(), tripletList.end());
+    VERIFY_IS_APPROX(m, refMat_sum);
+
+    // reuse of a pattern without duplicates
+    std::vector<TripletType> unique;
+    DenseMatrix refMat_unique = DenseMatrix::Zero(rows,cols);
+    for(Index j=0;j<cols;++j)
+      for(Index i=0;i<rows;++i)
+        if(internal::random<int>(0,2)==0)
+        {
+          unique.push_back(TripletType(StorageIndex(i),StorageIndex(j),internal::random<Scalar>()));
+          refMat_unique(i,j) = unique.back().value();
+        }
+    // Fisher-Yates shuffle, std::random_shuffle being removed in C++17
+    for(Index k=Index(unique.size())-1; k>0; --k)
+      std::swap(unique[k], unique[internal::random<Index>(0,k)]);
+    m.setFromTriplets(unique.begin(), unique.end(), positions);
+    VERIFY_IS_APPROX(m, refMat_unique);
+    for(size_t k=0;k<unique.size();++k)
+    {
+      VERIFY(positions(k) >= 0);
+      VERIFY_IS_EQUAL(m.valuePtr()[positions(k)], unique[k].value());
+      unique[k] = TripletType(unique[k].row(), unique[k].col(), Scalar(10)*unique[k].value());
+    }
+    m.updateFromTriplets(unique.begin(), unique.end(), positions);
+    VERIFY_IS_APPROX(m, Scalar(10)*refMat_unique);
   }
   
   // test Map
@@ -99,6 +99,111 @@ template<typename Scalar> void sparse_solvers(int rows, int cols)
     VERIFY_IS_APPROX(refMat2.template triangularView<Lower>().solve(vec2),
                      m2.template triangularView<Lower>().solve(vec3));
   }
+
+  // test level scheduled triangular solver
+  {
+    SparseMatrix<Scalar> m2(rows, cols);
+    DenseMatrix refMat2 = DenseMatrix::Zero(rows, cols);
+    initSparse<Scalar>(density, refMat2, m2, ForceNonZeroDiag);
+    SparseMatrix<Scalar,RowMajor> rm2(m2);
+    DenseMatrix rhs = DenseMatrix::Random(rows, 3), x;
+
+    internal::sparse_level_schedule<typename SparseMatrix<Scalar>::StorageIndex> lower, upper;
+    lower.compute(rm2, Lower);
+    upper.compute(rm2, Upper);
+    VERIFY(lower.levels()>=1 && lower.levels()<=rows);
+    VERIFY(upper.levels()>=1 && upper.levels()<=rows);
+
+    x = rhs; lower.template solveInPlace<Lower>(rm2, x);
+    VERIFY_IS_APPROX(x, refMat2.template triangularView<Lower>().solve(rhs));
+    x = rhs; lower.template solveInPlace<UnitLower>(rm2, x);
+    VERIFY_IS_APPROX(x, refMat2.template triangularView<UnitLower>().solve(rhs));
+    x = rhs; upper.template solveInPlace<Upper>(rm2, x);
+    VERIFY_IS_APPROX(x, refMat2.template triangularView<Upper>().solve(rhs));
+    x = rhs; upper.template solveInPlace<UnitUpper>(rm2, x);
+    VERIFY_IS_APPROX(x, refMat2.template triangularView<UnitUpper>().solve(rhs));
+
+    // rows of a column-major matrix through its adjoint
+    upper.compute(m2.adjoint(), Upper);
+    x = rhs; upper.template solveInPlace<Upper>(m2.adjoint(), x);
+    VERIFY_IS_APPROX(x, refMat2.adjoint().template triangularView<Upper>().solve(rhs));
+
+    // a diagonal matrix has a single level
+    SparseMatrix<Scalar,RowMajor> diag(rows, rows);
+    diag.setIdentity();
+    lower.compute(diag, Lower);
+    VERIFY_IS_EQUAL(lower.levels(), Index(1));
+  }
+}
+
+// Solves with nbThreads()>1 and compares against the serial solves. The matrix couples the rows in chains of three,
+// so that its triangular parts have only a few levels, wide enough to be parallelizable. The parallel paths are only
+// exercised when the test is built with EIGEN_TEST_OPENMP, otherwise nbThreads() is always 1.
+template<typename Scalar> void sparse_solvers_threaded(Index chains)
+{
+  typedef SparseMatrix<Scalar> SpMat;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  const Index size = 3*chains;
+  std::vector<Triplet<Scalar> > triplets;
+  for(Index i = 0; i < size; ++i)
+  {
+    triplets.push_back(Triplet<Scalar>(i, i, Scalar(4)));
+    if(i >= chains)
+    {
+      Scalar v = internal::random<Scalar>();
+      triplets.push_back(Triplet<Scalar>(i, i-chains, v));
+      triplets.push_back(Triplet<Scalar>(i-chains, i, numext::conj(v)));
+    }
+  }
+  SpMat A(size, size);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  DenseMatrix b = DenseMatrix::Random(size, 3);
+  DenseMatrix x, ref;
+
+  const int prevThreads = nbThreads();
+
+  // the level-scheduled triangular solves against the serial ones
+  SparseMatrix<Scalar,RowMajor> rowA = A;
+  internal::sparse_level_schedule<typename SpMat::StorageIndex> lower, upper;
+  lower.compute(rowA, Lower);
+  upper.compute(rowA, Upper);
+  VERIFY_IS_EQUAL(lower.levels(), Index(3));
+  VERIFY_IS_EQUAL(upper.levels(), Index(3));
+  setNbThreads(4);
+#ifdef EIGEN_HAS_OPENMP
+  VERIFY(lower.isParallelizable() && upper.isParallelizable());
+#endif
+  ref = b; rowA.template triangularView<Lower>().solveInPlace(ref);
+  x = b; lower.template solveInPlace<Lower>(rowA, x);
+  VERIFY_IS_APPROX(x, ref);
+  ref = b; rowA.template triangularView<Upper>().solveInPlace(ref);
+  x = b; upper.template solveInPlace<Upper>(rowA, x);
+  VERIFY_IS_APPROX(x, ref);
+
+  // the decompositions factorized and solved with several threads against a single thread
+  SimplicialLLT<SpMat> llt;
+  SimplicialLDLT<SpMat> ldlt;
+  SimplicialCholesky<SpMat> chol;
+  IncompleteCholesky<Scalar> ic;
+  IncompleteLUT<Scalar> ilut;
+
+  setNbThreads(1);
+  DenseMatrix refLLT = llt.compute(A).solve(b);
+  DenseMatrix refLDLT = ldlt.compute(A).solve(b);
+  ic.compute(A);
+  DenseMatrix refIC = ic.solve(b);
+  DenseMatrix refILUT = ilut.compute(A).solve(b);
+  VERIFY_IS_APPROX(A*refLLT, b);
+
+  setNbThreads(4);
+  x = llt.compute(A).solve(b);    VERIFY_IS_APPROX(x, refLLT);
+  x = ldlt.compute(A).solve(b);   VERIFY_IS_APPROX(x, refLDLT);
+  x = chol.compute(A).solve(b);   VERIFY_IS_APPROX(x, refLLT);
+  ic.compute(A);
+  x = ic.solve(b);                VERIFY_IS_APPROX(x, refIC);
+  x = ilut.compute(A).solve(b);   VERIFY_IS_APPROX(x, refILUT);
+
+  setNbThreads(prevThreads);
 }
 
 void test_sparse_solvers()
@@ -108,5 +213,7 @@ void test_sparse_solvers()
     int s = internal::random<int>(1,300);
     CALL_SUBTEST_2(sparse_solvers<std::complex<double> >(s,s) );
     CALL_SUBTEST_1(sparse_solvers<double>(s,s) );
+    CALL_SUBTEST_3(sparse_solvers_threaded<double>(internal::random<int>(100,400)) );
+    CALL_SUBTEST_3(sparse_solvers_threaded<std::complex<double> >(internal::random<int>(100,400)) );
   }
 }
@@ -13,7 +13,15 @@
 namespace Eigen
 {
 
-template<typename Functor> class AutoDiffJacobian : public Functor
+/** \class AutoDiffJacobian
+  * \brief Computes the jacobian of a functor using forward mode automatic differentiation
+  *
+  * \tparam Functor the functor, whose operator() is templated on the scalar type
+  * \tparam MaxInputsAtCompileTime an upper bound on the number of inputs, defaulting to Functor::InputsAtCompileTime.
+  *         When the number of inputs is only known at runtime, a bound makes the derivatives fixed-capacity
+  *         vectors stored on the stack, such that evaluating the functor does not perform any heap allocation.
+  */
+template<typename Functor, int MaxInputsAtCompileTime = Functor::InputsAtCompileTime> class AutoDiffJacobian : public Functor
 {
 public:
   AutoDiffJacobian() : Functor() {}
@@ -38,7 +46,7 @@ public:
   typedef typename JacobianType::Scalar Scalar;
   typedef typename JacobianType::Index Index;
 
-  typedef Matrix<Scalar,InputsAtCompileTime,1> DerivativeType;
+  typedef Matrix<Scalar,InputsAtCompileTime,1,0,MaxInputsAtCompileTime,1> DerivativeType;
   typedef AutoDiffScalar<DerivativeType> ActiveScalar;
 
 
@@ -55,6 +63,7 @@ public:
     }
 
     JacobianType& jac = *_jac;
+    eigen_assert(MaxInputsAtCompileTime==Dynamic || this->inputs()<=MaxInputsAtCompileTime);
 
     ActiveInput ax = x.template cast<ActiveScalar>();
     ActiveValue av(jac.rows());
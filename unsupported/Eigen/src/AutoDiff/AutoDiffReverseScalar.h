@@ -0,0 +1,251 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_AUTODIFF_REVERSE_SCALAR_H
+#define EIGEN_AUTODIFF_REVERSE_SCALAR_H
+
+namespace Eigen {
+
+template<typename _Scalar> class AutoDiffTape;
+
+/** \class AutoDiffReverseScalar
+  * \ingroup AutoDiff_Module
+  *
+  * \brief A scalar type replacement recording its operations on a tape for reverse mode automatic differentiation
+  *
+  * \tparam _Scalar the underlying scalar type, e.g., \c double
+  *
+  * An AutoDiffReverseScalar is either a constant, or a variable of an AutoDiffTape identified by its index on the
+  * tape. Each operation involving variables creates a new variable and records on the tape the partial derivatives
+  * of its result with respect to its operands, such that AutoDiffTape::computeAdjoints() can later compute the
+  * derivatives of a scalar result with respect to all the variables in a single reverse sweep. Contrary to
+  * AutoDiffScalar, the cost of a gradient does not depend on the number of inputs.
+  *
+  * The variables are created by AutoDiffTape::variable() or AutoDiffTape::variables(). AutoDiffReverseScalar can be
+  * used as the scalar type of Matrix and Array objects, in which case each scalar operation is recorded. The
+  * matrix-level operations of AutoDiffTape record a product, a solve, or a coefficient-wise operation as a single
+  * node instead.
+  *
+  * It supports the following global math functions: abs, abs2, sqrt, exp, log, sin, cos, tan, asin, acos, atan,
+  * sinh, cosh, tanh, pow, atan2, min and max.
+  *
+  * \sa AutoDiffTape, AutoDiffScalar
+  */
+template<typename _Scalar>
+class AutoDiffReverseScalar
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef AutoDiffTape<Scalar> Tape;
+
+    /** Default constructor, creating the constant zero */
+    AutoDiffReverseScalar() : m_value(0), m_tape(0), m_index(-1) {}
+
+    /** Conversion from a scalar constant */
+    AutoDiffReverseScalar(const Scalar& value) : m_value(value), m_tape(0), m_index(-1) {}
+
+    /** Constructs the variable \a index of the tape \a tape with the value \a value */
+    AutoDiffReverseScalar(const Scalar& value, Tape* tape, Index index) : m_value(value), m_tape(tape), m_index(index) {}
+
+    inline const Scalar& value() const { return m_value; }
+
+    /** \returns the tape recording this variable, or a null pointer for a constant */
+    inline Tape* tape() const { return m_tape; }
+    /** \returns the index of this variable on its tape, or -1 for a constant */
+    inline Index index() const { return m_index; }
+    /** \returns true if this scalar does not depend on any variable */
+    inline bool isConstant() const { return m_tape==0; }
+
+    friend inline AutoDiffReverseScalar operator+(const AutoDiffReverseScalar& a, const AutoDiffReverseScalar& b)
+    { return Tape::record(a.m_value + b.m_value, a, Scalar(1), b, Scalar(1)); }
+
+    friend inline AutoDiffReverseScalar operator-(const AutoDiffReverseScalar& a, const AutoDiffReverseScalar& b)
+    { return Tape::record(a.m_value - b.m_value, a, Scalar(1), b, Scalar(-1)); }
+
+    friend inline AutoDiffReverseScalar operator*(const AutoDiffReverseScalar& a, const AutoDiffReverseScalar& b)
+    { return Tape::record(a.m_value * b.m_value, a, b.m_value, b, a.m_value); }
+
+    friend inline AutoDiffReverseScalar operator/(const AutoDiffReverseScalar& a, const AutoDiffReverseScalar& b)
+    {
+      const Scalar invb = Scalar(1) / b.m_value, q = a.m_value * invb;
+      return Tape::record(q, a, invb, b, -q * invb);
+    }
+
+    inline AutoDiffReverseScalar operator-() const
+    { return Tape::record(-m_value, *this, Scalar(-1)); }
+
+    inline const AutoDiffReverseScalar& operator+() const { return *this; }
+
+    inline AutoDiffReverseScalar& operator+=(const AutoDiffReverseScalar& other) { return *this = *this + other; }
+    inline AutoDiffReverseScalar& operator-=(const AutoDiffReverseScalar& other) { return *this = *this - other; }
+    inline AutoDiffReverseScalar& operator*=(const AutoDiffReverseScalar& other) { return *this = *this * other; }
+    inline AutoDiffReverseScalar& operator/=(const AutoDiffReverseScalar& other) { return *this = *this / other; }
+
+    // adding a constant does not change the derivatives, the variable is kept as is
+    inline AutoDiffReverseScalar& operator+=(const Scalar& other) { m_value += other; return *this; }
+    inline AutoDiffReverseScalar& operator-=(const Scalar& other) { m_value -= other; return *this; }
+
+    friend inline bool operator< (const AutoDiffReverseScalar& a, const AutoDiffReverseScalar& b) { return a.m_value <  b.m_value; }
+    friend inline bool operator<=(const AutoDiffReverseScalar& a, const AutoDiffReverseScalar& b) { return a.m_value <= b.m_value; }
+    friend inline bool operator> (const AutoDiffReverseScalar& a, const AutoDiffReverseScalar& b) { return a.m_value >  b.m_value; }
+    friend inline bool operator>=(const AutoDiffReverseScalar& a, const AutoDiffReverseScalar& b) { return a.m_value >= b.m_value; }
+    friend inline bool operator==(const AutoDiffReverseScalar& a, const AutoDiffReverseScalar& b) { return a.m_value == b.m_value; }
+    friend inline bool operator!=(const AutoDiffReverseScalar& a, const AutoDiffReverseScalar& b) { return a.m_value != b.m_value; }
+
+  protected:
+    Scalar m_value;
+    Tape* m_tape;
+    Index m_index;
+};
+
+#define EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(FUNC,CODE) \
+  template<typename Scalar> \
+  inline AutoDiffReverseScalar<Scalar> FUNC(const AutoDiffReverseScalar<Scalar>& x) { \
+    typedef AutoDiffTape<Scalar> Tape; \
+    CODE; \
+  }
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(abs,
+  using std::abs;
+  return Tape::record(abs(x.value()), x, x.value()<0 ? Scalar(-1) : Scalar(1));)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(abs2,
+  return Tape::record(x.value()*x.value(), x, Scalar(2)*x.value());)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(sqrt,
+  using std::sqrt;
+  Scalar sqrtx = sqrt(x.value());
+  return Tape::record(sqrtx, x, Scalar(0.5)/sqrtx);)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(exp,
+  using std::exp;
+  Scalar expx = exp(x.value());
+  return Tape::record(expx, x, expx);)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(log,
+  using std::log;
+  return Tape::record(log(x.value()), x, Scalar(1)/x.value());)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(sin,
+  using std::sin;
+  using std::cos;
+  return Tape::record(sin(x.value()), x, cos(x.value()));)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(cos,
+  using std::sin;
+  using std::cos;
+  return Tape::record(cos(x.value()), x, -sin(x.value()));)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(tan,
+  using std::tan;
+  Scalar tanx = tan(x.value());
+  return Tape::record(tanx, x, Scalar(1) + tanx*tanx);)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(asin,
+  using std::sqrt;
+  using std::asin;
+  return Tape::record(asin(x.value()), x, Scalar(1)/sqrt(Scalar(1) - x.value()*x.value()));)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(acos,
+  using std::sqrt;
+  using std::acos;
+  return Tape::record(acos(x.value()), x, Scalar(-1)/sqrt(Scalar(1) - x.value()*x.value()));)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(atan,
+  using std::atan;
+  return Tape::record(atan(x.value()), x, Scalar(1)/(Scalar(1) + x.value()*x.value()));)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(sinh,
+  using std::sinh;
+  using std::cosh;
+  return Tape::record(sinh(x.value()), x, cosh(x.value()));)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(cosh,
+  using std::sinh;
+  using std::cosh;
+  return Tape::record(cosh(x.value()), x, sinh(x.value()));)
+
+EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY(tanh,
+  using std::tanh;
+  Scalar tanhx = tanh(x.value());
+  return Tape::record(tanhx, x, Scalar(1) - tanhx*tanhx);)
+
+#undef EIGEN_AUTODIFF_REVERSE_DECLARE_GLOBAL_UNARY
+
+template<typename Scalar>
+inline const AutoDiffReverseScalar<Scalar>& conj(const AutoDiffReverseScalar<Scalar>& x) { return x; }
+template<typename Scalar>
+inline const AutoDiffReverseScalar<Scalar>& real(const AutoDiffReverseScalar<Scalar>& x) { return x; }
+template<typename Scalar>
+inline Scalar imag(const AutoDiffReverseScalar<Scalar>&) { return Scalar(0); }
+
+template<typename Scalar>
+inline AutoDiffReverseScalar<Scalar> pow(const AutoDiffReverseScalar<Scalar>& x, const typename AutoDiffReverseScalar<Scalar>::Scalar& y)
+{
+  using std::pow;
+  return AutoDiffTape<Scalar>::record(pow(x.value(), y), x, y * pow(x.value(), y-Scalar(1)));
+}
+
+template<typename Scalar>
+inline AutoDiffReverseScalar<Scalar> pow(const AutoDiffReverseScalar<Scalar>& x, const AutoDiffReverseScalar<Scalar>& y)
+{
+  using std::pow;
+  using std::log;
+  const Scalar p = pow(x.value(), y.value());
+  return AutoDiffTape<Scalar>::record(p, x, y.value() * pow(x.value(), y.value()-Scalar(1)), y,
+                                      y.isConstant() ? Scalar(0) : p * log(x.value()));
+}
+
+template<typename Scalar>
+inline AutoDiffReverseScalar<Scalar> atan2(const AutoDiffReverseScalar<Scalar>& a, const AutoDiffReverseScalar<Scalar>& b)
+{
+  using std::atan2;
+  // if (squared_hypot==0) the derivation is undefined and the following results in a NaN:
+  const Scalar squared_hypot = a.value() * a.value() + b.value() * b.value();
+  return AutoDiffTape<Scalar>::record(atan2(a.value(), b.value()), a, b.value() / squared_hypot,
+                                      b, -a.value() / squared_hypot);
+}
+
+template<typename Scalar>
+inline AutoDiffReverseScalar<Scalar> (min)(const AutoDiffReverseScalar<Scalar>& x, const AutoDiffReverseScalar<Scalar>& y)
+{ return x <= y ? x : y; }
+template<typename Scalar>
+inline AutoDiffReverseScalar<Scalar> (max)(const AutoDiffReverseScalar<Scalar>& x, const AutoDiffReverseScalar<Scalar>& y)
+{ return x >= y ? x : y; }
+
+namespace internal {
+
+template<typename Scalar>
+struct scalar_product_traits<AutoDiffReverseScalar<Scalar>,Scalar>
+{
+  enum { Defined = 1 };
+  typedef AutoDiffReverseScalar<Scalar> ReturnType;
+};
+
+template<typename Scalar>
+struct scalar_product_traits<Scalar,AutoDiffReverseScalar<Scalar> >
+{
+  enum { Defined = 1 };
+  typedef AutoDiffReverseScalar<Scalar> ReturnType;
+};
+
+} // end namespace internal
+
+template<typename Scalar> struct NumTraits<AutoDiffReverseScalar<Scalar> >
+  : NumTraits<Scalar>
+{
+  typedef AutoDiffReverseScalar<Scalar> Real;
+  typedef AutoDiffReverseScalar<Scalar> NonInteger;
+  typedef AutoDiffReverseScalar<Scalar> Nested;
+  enum{
+    RequireInitialization = 1
+  };
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_AUTODIFF_REVERSE_SCALAR_H
@@ -37,7 +37,9 @@ template<typename _DerType, bool Enable> struct auto_diff_special_op;
   *                 as well as the number of derivatives to compute are determined from this type.
   *                 Typical choices include, e.g., \c Vector4f for 4 derivatives, or \c VectorXf
   *                 if the number of derivatives is not known at compile time, and/or, the number
-  *                 of derivatives is large.
+  *                 of derivatives is large. When the number of derivatives is only bounded at compile
+  *                 time, a fixed-capacity vector such as \c Matrix<float,Dynamic,1,0,8,1> avoids any
+  *                 heap allocation while keeping a runtime size.
   *                 Note that _DerType can also be a reference (e.g., \c VectorXf&) to wrap a
   *                 existing vector into an AutoDiffScalar.
   *                 Finally, _DerType can also be any Eigen compatible expression.
@@ -209,7 +211,9 @@ class AutoDiffScalar
     inline AutoDiffScalar&
     operator+=(const AutoDiffScalar<OtherDerType>& other)
     {
-      (*this) = (*this) + other;
+      internal::make_coherent(m_derivatives, other.derivatives());
+      m_value += other.value();
+      m_derivatives += other.derivatives();
       return *this;
     }
 
@@ -245,7 +249,9 @@ class AutoDiffScalar
     inline AutoDiffScalar&
     operator-=(const AutoDiffScalar<OtherDerType>& other)
     {
-      *this = *this - other;
+      internal::make_coherent(m_derivatives, other.derivatives());
+      m_value -= other.value();
+      m_derivatives -= other.derivatives();
       return *this;
     }
 
@@ -352,29 +358,40 @@ class AutoDiffScalar
         (m_derivatives * other.value()) + (m_value * other.derivatives()));
     }
 
+    // The compound assignments update the derivatives in place, in a single vectorized pass reading the
+    // derivatives of other, which can refer to the derivatives of *this.
+
     inline AutoDiffScalar& operator*=(const Scalar& other)
     {
-      *this = *this * other;
+      m_value *= other;
+      m_derivatives *= other;
       return *this;
     }
 
     template<typename OtherDerType>
     inline AutoDiffScalar& operator*=(const AutoDiffScalar<OtherDerType>& other)
     {
-      *this = *this * other;
+      internal::make_coherent(m_derivatives, other.derivatives());
+      const Scalar a = m_value, b = other.value();
+      m_derivatives = m_derivatives * b + a * other.derivatives();
+      m_value = a * b;
       return *this;
     }
 
     inline AutoDiffScalar& operator/=(const Scalar& other)
     {
-      *this = *this / other;
+      m_value /= other;
+      m_derivatives *= Scalar(1)/other;
       return *this;
     }
 
     template<typename OtherDerType>
     inline AutoDiffScalar& operator/=(const AutoDiffScalar<OtherDerType>& other)
     {
-      *this = *this / other;
+      internal::make_coherent(m_derivatives, other.derivatives());
+      const Scalar a = m_value, b = other.value();
+      m_derivatives = (m_derivatives * b - a * other.derivatives()) * (Scalar(1)/(b*b));
+      m_value = a / b;
       return *this;
     }
 
@@ -614,12 +631,12 @@ pow(const Eigen::AutoDiffScalar<DerType>& x, const typename internal::traits<typ
 
 
 template<typename DerTypeA,typename DerTypeB>
-inline const AutoDiffScalar<Matrix<typename internal::traits<typename internal::remove_all<DerTypeA>::type>::Scalar,Dynamic,1> >
+inline const AutoDiffScalar<typename internal::remove_all<DerTypeA>::type::PlainObject>
 atan2(const AutoDiffScalar<DerTypeA>& a, const AutoDiffScalar<DerTypeB>& b)
 {
   using std::atan2;
   typedef typename internal::traits<typename internal::remove_all<DerTypeA>::type>::Scalar Scalar;
-  typedef AutoDiffScalar<Matrix<Scalar,Dynamic,1> > PlainADS;
+  typedef AutoDiffScalar<typename internal::remove_all<DerTypeA>::type::PlainObject> PlainADS;
   PlainADS ret;
   ret.value() = atan2(a.value(), b.value());
   
@@ -0,0 +1,621 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_AUTODIFF_TAPE_H
+#define EIGEN_AUTODIFF_TAPE_H
+
+namespace Eigen {
+
+namespace internal {
+
+// Bump allocator storing the nodes of a tape and their arrays. The memory is released all at once, and kept for
+// reuse by clear(), such that recording a function a second time does not allocate anything.
+class ad_arena
+{
+  public:
+    enum { BlockSize = 1<<16, Alignment = EIGEN_MAX_ALIGN_BYTES > 16 ? EIGEN_MAX_ALIGN_BYTES : 16 };
+
+    ad_arena() : m_current(0), m_used(0) {}
+    ~ad_arena()
+    {
+      for(std::size_t k = 0; k < m_blocks.size(); ++k)
+        aligned_free(m_blocks[k].first);
+    }
+
+    void* allocate(std::size_t size)
+    {
+      size = (size + Alignment - 1) & ~std::size_t(Alignment - 1);
+      while(m_current < m_blocks.size() && m_used + size > m_blocks[m_current].second)
+      {
+        ++m_current;
+        m_used = 0;
+      }
+      if(m_current == m_blocks.size())
+      {
+        const std::size_t capacity = (std::max)(std::size_t(BlockSize), size);
+        m_blocks.push_back(std::make_pair(static_cast<char*>(aligned_malloc(capacity)), capacity));
+      }
+      void* ptr = m_blocks[m_current].first + m_used;
+      m_used += size;
+      return ptr;
+    }
+
+    template<typename T> T* allocate(Index n) { return static_cast<T*>(allocate(sizeof(T)*std::size_t(n))); }
+
+    void clear()
+    {
+      m_current = 0;
+      m_used = 0;
+    }
+
+  protected:
+    std::vector<std::pair<char*,std::size_t> > m_blocks;
+    std::size_t m_current, m_used;
+
+  private:
+    ad_arena(const ad_arena&);
+    ad_arena& operator=(const ad_arena&);
+};
+
+// The nodes of the matrix-level operations live in the arena and are released without running their destructor:
+// they must not own any other memory.
+template<typename Scalar> struct ad_node
+{
+  virtual ~ad_node() {}
+  // adds the contributions of the result of the node to the adjoints of its operands
+  virtual void propagate(Scalar* adjoints) const = 0;
+};
+
+// Up to two operands of a given size, stored as the indices of their coefficients (-1 for the constant ones, or a
+// null array if the operand is constant), and the partial derivatives with respect to them.
+template<typename Scalar> struct ad_array_operands
+{
+  ad_array_operands() : m_size(0) { m_indices[0] = m_indices[1] = 0; m_partials[0] = m_partials[1] = 0; }
+  Index m_size;
+  const Index* m_indices[2];
+  const Scalar* m_partials[2];
+};
+
+// the coefficient k of the result, of index result+k, depends on the coefficients k of the operands
+template<typename Scalar> struct ad_cwise_node : ad_node<Scalar>, ad_array_operands<Scalar>
+{
+  void propagate(Scalar* adjoints) const
+  {
+    const Scalar* g = adjoints + m_result;
+    for(int o = 0; o < 2; ++o)
+      if(this->m_indices[o])
+        for(Index k = 0; k < this->m_size; ++k)
+          if(this->m_indices[o][k] >= 0)
+            adjoints[this->m_indices[o][k]] += this->m_partials[o][k] * g[k];
+  }
+  Index m_result;
+};
+
+// the scalar result depends on all the coefficients of the operands
+template<typename Scalar> struct ad_reduction_node : ad_node<Scalar>, ad_array_operands<Scalar>
+{
+  void propagate(Scalar* adjoints) const
+  {
+    const Scalar g = adjoints[m_result];
+    for(int o = 0; o < 2; ++o)
+      if(this->m_indices[o])
+        for(Index k = 0; k < this->m_size; ++k)
+          if(this->m_indices[o][k] >= 0)
+            adjoints[this->m_indices[o][k]] += this->m_partials[o][k] * g;
+  }
+  Index m_result;
+};
+
+template<typename Scalar>
+void ad_scatter_adjoints(Scalar* adjoints, const Index* indices, const Matrix<Scalar,Dynamic,Dynamic>& values)
+{
+  for(Index k = 0; k < values.size(); ++k)
+    if(indices[k] >= 0)
+      adjoints[indices[k]] += values.data()[k];
+}
+
+// result = lhs * rhs, with adj(lhs) += adj(result) * rhs^T and adj(rhs) += lhs^T * adj(result)
+template<typename Scalar> struct ad_product_node : ad_node<Scalar>
+{
+  typedef Map<const Matrix<Scalar,Dynamic,Dynamic> > MapType;
+  void propagate(Scalar* adjoints) const
+  {
+    MapType g(adjoints + m_result, m_rows, m_cols);
+    if(m_lhsIndices)
+      ad_scatter_adjoints(adjoints, m_lhsIndices, Matrix<Scalar,Dynamic,Dynamic>(g * MapType(m_rhs, m_depth, m_cols).transpose()));
+    // a matrix-vector product is not detected at runtime
+    if(m_rhsIndices && m_cols==1)
+      ad_scatter_adjoints(adjoints, m_rhsIndices, Matrix<Scalar,Dynamic,Dynamic>(MapType(m_lhs, m_rows, m_depth).transpose() * g.col(0)));
+    else if(m_rhsIndices)
+      ad_scatter_adjoints(adjoints, m_rhsIndices, Matrix<Scalar,Dynamic,Dynamic>(MapType(m_lhs, m_rows, m_depth).transpose() * g));
+  }
+  Index m_result, m_rows, m_depth, m_cols;
+  const Scalar *m_lhs, *m_rhs;
+  const Index *m_lhsIndices, *m_rhsIndices;
+};
+
+// result = lhs^-1 * rhs, with w = lhs^-T * adj(result), adj(rhs) += w and adj(lhs) -= w * result^T
+template<typename Scalar> struct ad_solve_node : ad_node<Scalar>
+{
+  typedef Map<const Matrix<Scalar,Dynamic,Dynamic> > MapType;
+  void propagate(Scalar* adjoints) const
+  {
+    // same as PartialPivLU::_solve_impl_transposed, from the stored factors
+    const MapType lu(m_lu, m_size, m_size);
+    Matrix<Scalar,Dynamic,Dynamic> w = lu.template triangularView<Upper>().transpose().solve(MapType(adjoints + m_result, m_size, m_cols));
+    lu.template triangularView<UnitLower>().transpose().solveInPlace(w);
+    Matrix<Scalar,Dynamic,Dynamic> pw(m_size, m_cols);
+    for(Index i = 0; i < m_size; ++i)
+      pw.row(i) = w.row(m_permutation[i]);
+    if(m_rhsIndices)
+      ad_scatter_adjoints(adjoints, m_rhsIndices, pw);
+    if(m_lhsIndices)
+      ad_scatter_adjoints(adjoints, m_lhsIndices, Matrix<Scalar,Dynamic,Dynamic>(-pw * MapType(m_solution, m_size, m_cols).transpose()));
+  }
+  Index m_result, m_size, m_cols;
+  const Scalar *m_lu, *m_solution;
+  const int* m_permutation;
+  const Index *m_lhsIndices, *m_rhsIndices;
+};
+
+template<typename Scalar> inline const Scalar& ad_reverse_value(const Scalar& x) { return x; }
+template<typename Scalar> inline const Scalar& ad_reverse_value(const AutoDiffReverseScalar<Scalar>& x) { return x.value(); }
+template<typename Scalar> inline Index ad_reverse_index(const Scalar&) { return -1; }
+template<typename Scalar> inline Index ad_reverse_index(const AutoDiffReverseScalar<Scalar>& x) { return x.index(); }
+template<typename Scalar> inline const void* ad_reverse_tape(const Scalar&) { return 0; }
+template<typename Scalar> inline const void* ad_reverse_tape(const AutoDiffReverseScalar<Scalar>& x) { return x.tape(); }
+
+} // end namespace internal
+
+/** \class AutoDiffTape
+  * \ingroup AutoDiff_Module
+  *
+  * \brief Records the operations on AutoDiffReverseScalar variables and computes their adjoints
+  *
+  * \tparam _Scalar the underlying scalar type, e.g., \c double
+  *
+  * The tape stores, for each operation, the indices of its operands and the partial derivatives of its result with
+  * respect to them. computeAdjoints() then propagates the derivatives of a result backward through the recorded
+  * operations, giving its gradient with respect to all the variables at a small multiple of the cost of the
+  * function itself, whatever the number of variables.
+  *
+  * The scalar operations are stored as two contiguous streams, of statements (the index of the result) and of
+  * operands (an index and a partial derivative), and the matrix-level operations as nodes allocated in an arena.
+  * clear() forgets the recorded operations but keeps all the memory, such that recording again a function of the
+  * same size does not allocate.
+  *
+  * Besides the per-scalar operations of the Matrix and Array objects of AutoDiffReverseScalar, the matrix-level
+  * operations product(), solve(), cwiseProduct(), cwiseQuotient(), unaryExpr(), sum(), dot() and squaredNorm()
+  * record a single node for the whole operation, whose derivatives are propagated with matrix operations. Their
+  * operands can mix variables and constants, and be matrices of \c Scalar.
+  *
+  * Example:
+  * \code
+  * AutoDiffTape<double> tape;
+  * typedef AutoDiffTape<double>::ActiveScalar AD;
+  * Matrix<AD,Dynamic,1> x = tape.variables(x0);
+  * Matrix<AD,Dynamic,1> r = tape.product(A, x);         // A is a MatrixXd, r = A * x
+  * AD f = tape.squaredNorm(r) + tape.sum(tape.unaryExpr(x, internal::scalar_exp_op<double>(), internal::scalar_exp_op<double>()));
+  * VectorXd g = tape.gradient(f, x);
+  * \endcode
+  *
+  * A tape is not thread safe, but independent tapes can be used concurrently.
+  *
+  * \sa AutoDiffReverseScalar
+  */
+template<typename _Scalar>
+class AutoDiffTape
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef AutoDiffReverseScalar<Scalar> ActiveScalar;
+
+    AutoDiffTape() : m_variables(0) {}
+
+    /** \returns a new independent variable of value \a value */
+    ActiveScalar variable(const Scalar& value) { return ActiveScalar(value, this, m_variables++); }
+
+    /** \returns a matrix of new independent variables whose values are \a values */
+    template<typename Derived>
+    Matrix<ActiveScalar,Derived::RowsAtCompileTime,Derived::ColsAtCompileTime> variables(const MatrixBase<Derived>& values)
+    {
+      Matrix<ActiveScalar,Derived::RowsAtCompileTime,Derived::ColsAtCompileTime> res(values.rows(), values.cols());
+      for(Index j = 0; j < values.cols(); ++j)
+        for(Index i = 0; i < values.rows(); ++i)
+          res.coeffRef(i,j) = variable(values.coeff(i,j));
+      return res;
+    }
+
+    /** Forgets all the variables and recorded operations, keeping the memory for the next recording */
+    void clear()
+    {
+      m_results.clear();
+      m_ends.clear();
+      m_operandIndices.clear();
+      m_partials.clear();
+      m_nodes.clear();
+      m_arena.clear();
+      m_variables = 0;
+    }
+
+    /** \returns the number of variables, i.e., the independent variables and the results of the operations */
+    Index variableCount() const { return m_variables; }
+    /** \returns the number of recorded operations */
+    Index nodeCount() const { return Index(m_results.size()); }
+
+    /** Computes the adjoints of all the variables, i.e., the derivatives of \a y with respect to them */
+    void computeAdjoints(const ActiveScalar& y)
+    {
+      m_adjoints.setZero(m_variables);
+      if(y.isConstant())
+        return;
+      eigen_assert(y.tape()==this);
+      m_adjoints(y.index()) = Scalar(1);
+      sweep();
+    }
+
+    /** Computes the adjoints of all the variables for the vector of results \a y and the weights \a w, i.e., the
+      * derivatives of the sum of the w(i) * y(i), giving the product of \a w by the jacobian of \a y */
+    template<typename YDerived, typename WDerived>
+    void computeAdjoints(const MatrixBase<YDerived>& y, const MatrixBase<WDerived>& w)
+    {
+      eigen_assert(y.size()==w.size());
+      m_adjoints.setZero(m_variables);
+      for(Index k = 0; k < y.size(); ++k)
+        if(!y.coeff(k).isConstant())
+        {
+          eigen_assert(y.coeff(k).tape()==this);
+          m_adjoints(y.coeff(k).index()) += w.coeff(k);
+        }
+      sweep();
+    }
+
+    /** \returns the adjoint of the variable \a x computed by the last call to computeAdjoints() */
+    Scalar adjoint(const ActiveScalar& x) const
+    {
+      return x.isConstant() || x.index() >= m_adjoints.size() ? Scalar(0) : m_adjoints(x.index());
+    }
+
+    /** \returns the adjoints of the variables \a x computed by the last call to computeAdjoints() */
+    template<typename Derived>
+    Matrix<Scalar,Derived::RowsAtCompileTime,Derived::ColsAtCompileTime> adjoints(const MatrixBase<Derived>& x) const
+    {
+      Matrix<Scalar,Derived::RowsAtCompileTime,Derived::ColsAtCompileTime> res(x.rows(), x.cols());
+      for(Index j = 0; j < x.cols(); ++j)
+        for(Index i = 0; i < x.rows(); ++i)
+          res.coeffRef(i,j) = adjoint(x.coeff(i,j));
+      return res;
+    }
+
+    /** \returns the gradient of \a y with respect to the variables \a x */
+    template<typename Derived>
+    Matrix<Scalar,Derived::RowsAtCompileTime,Derived::ColsAtCompileTime> gradient(const ActiveScalar& y, const MatrixBase<Derived>& x)
+    {
+      computeAdjoints(y);
+      return adjoints(x);
+    }
+
+    /** \returns the product \a lhs * \a rhs, recorded as a single operation */
+    template<typename Lhs, typename Rhs>
+    Matrix<ActiveScalar,Lhs::RowsAtCompileTime,Rhs::ColsAtCompileTime> product(const MatrixBase<Lhs>& lhs, const MatrixBase<Rhs>& rhs)
+    {
+      eigen_assert(lhs.cols()==rhs.rows());
+      typedef internal::ad_product_node<Scalar> Node;
+      Node* node = new (m_arena.allocate(sizeof(Node))) Node;
+      node->m_rows = lhs.rows();
+      node->m_depth = lhs.cols();
+      node->m_cols = rhs.cols();
+      node->m_lhs = unpack(lhs, node->m_lhsIndices);
+      node->m_rhs = unpack(rhs, node->m_rhsIndices);
+      Matrix<ActiveScalar,Lhs::RowsAtCompileTime,Rhs::ColsAtCompileTime> res(lhs.rows(), rhs.cols());
+      Matrix<Scalar,Dynamic,Dynamic> values(lhs.rows(), rhs.cols());
+      if(rhs.cols()==1)
+        values.col(0).noalias() = ConstMap(node->m_lhs, lhs.rows(), lhs.cols()) * ConstMap(node->m_rhs, rhs.rows(), 1).col(0);
+      else
+        values.noalias() = ConstMap(node->m_lhs, lhs.rows(), lhs.cols()) * ConstMap(node->m_rhs, rhs.rows(), rhs.cols());
+      node->m_result = makeResult(res, values, node->m_lhsIndices || node->m_rhsIndices ? node : 0);
+      return res;
+    }
+
+    /** \returns the solution of \a lhs * X = \a rhs for the square and invertible matrix \a lhs, recorded as a single
+      * operation. The LU factors of \a lhs are kept on the tape to propagate the derivatives. */
+    template<typename Lhs, typename Rhs>
+    Matrix<ActiveScalar,Rhs::RowsAtCompileTime,Rhs::ColsAtCompileTime> solve(const MatrixBase<Lhs>& lhs, const MatrixBase<Rhs>& rhs)
+    {
+      eigen_assert(lhs.rows()==lhs.cols() && lhs.rows()==rhs.rows());
+      typedef internal::ad_solve_node<Scalar> Node;
+      const Index n = lhs.rows();
+      Node* node = new (m_arena.allocate(sizeof(Node))) Node;
+      node->m_size = n;
+      node->m_cols = rhs.cols();
+      Scalar* lu = unpack(lhs, node->m_lhsIndices);
+      const Scalar* b = unpack(rhs, node->m_rhsIndices);
+      PartialPivLU<Matrix<Scalar,Dynamic,Dynamic> > dec(ConstMap(lu, n, n));
+      Matrix<Scalar,Dynamic,Dynamic> values = dec.solve(ConstMap(b, n, rhs.cols()));
+      // the values of lhs are replaced by its factors
+      Map<Matrix<Scalar,Dynamic,Dynamic> >(lu, n, n) = dec.matrixLU();
+      int* perm = m_arena.template allocate<int>(n);
+      for(Index i = 0; i < n; ++i)
+        perm[i] = int(dec.permutationP().indices().coeff(i));
+      Scalar* solution = m_arena.template allocate<Scalar>(values.size());
+      Map<Matrix<Scalar,Dynamic,Dynamic> >(solution, n, rhs.cols()) = values;
+      node->m_lu = lu;
+      node->m_permutation = perm;
+      node->m_solution = solution;
+      Matrix<ActiveScalar,Rhs::RowsAtCompileTime,Rhs::ColsAtCompileTime> res(n, rhs.cols());
+      node->m_result = makeResult(res, values, node->m_lhsIndices || node->m_rhsIndices ? node : 0);
+      return res;
+    }
+
+    /** \returns the coefficient-wise product of \a a and \a b, recorded as a single operation */
+    template<typename ADerived, typename BDerived>
+    Matrix<ActiveScalar,ADerived::RowsAtCompileTime,ADerived::ColsAtCompileTime> cwiseProduct(const MatrixBase<ADerived>& a, const MatrixBase<BDerived>& b)
+    {
+      eigen_assert(a.rows()==b.rows() && a.cols()==b.cols());
+      typedef internal::ad_cwise_node<Scalar> Node;
+      Node* node = new (m_arena.allocate(sizeof(Node))) Node;
+      node->m_size = a.size();
+      const Scalar* av = unpack(a, node->m_indices[0]);
+      const Scalar* bv = unpack(b, node->m_indices[1]);
+      node->m_partials[0] = bv;
+      node->m_partials[1] = av;
+      Matrix<ActiveScalar,ADerived::RowsAtCompileTime,ADerived::ColsAtCompileTime> res(a.rows(), a.cols());
+      node->m_result = makeResult(res, ConstMap(av, a.rows(), a.cols()).cwiseProduct(ConstMap(bv, a.rows(), a.cols())),
+                                  node->m_indices[0] || node->m_indices[1] ? node : 0);
+      return res;
+    }
+
+    /** \returns the coefficient-wise quotient of \a a by \a b, recorded as a single operation */
+    template<typename ADerived, typename BDerived>
+    Matrix<ActiveScalar,ADerived::RowsAtCompileTime,ADerived::ColsAtCompileTime> cwiseQuotient(const MatrixBase<ADerived>& a, const MatrixBase<BDerived>& b)
+    {
+      eigen_assert(a.rows()==b.rows() && a.cols()==b.cols());
+      typedef internal::ad_cwise_node<Scalar> Node;
+      Node* node = new (m_arena.allocate(sizeof(Node))) Node;
+      const Index size = a.size();
+      node->m_size = size;
+      const Scalar* av = unpack(a, node->m_indices[0]);
+      Scalar* bv = unpack(b, node->m_indices[1]);
+      // the partial derivatives are 1/b and -a/b^2, the values of b are replaced by 1/b
+      Map<Array<Scalar,Dynamic,1> > invb(bv, size);
+      invb = invb.inverse();
+      Scalar* q = m_arena.template allocate<Scalar>(size);
+      Map<Array<Scalar,Dynamic,1> >(q, size) = ConstArrayMap(av, size) * invb;
+      Scalar* db = m_arena.template allocate<Scalar>(size);
+      Map<Array<Scalar,Dynamic,1> >(db, size) = -ConstArrayMap(q, size) * invb;
+      node->m_partials[0] = bv;
+      node->m_partials[1] = db;
+      Matrix<ActiveScalar,ADerived::RowsAtCompileTime,ADerived::ColsAtCompileTime> res(a.rows(), a.cols());
+      node->m_result = makeResult(res, ConstMap(q, a.rows(), a.cols()), node->m_indices[0] || node->m_indices[1] ? node : 0);
+      return res;
+    }
+
+    /** \returns the coefficient-wise function \a func of \a a, whose derivative is the coefficient-wise function
+      * \a derivative, recorded as a single operation. Both functors are applied to the values of \a a with
+      * Array::unaryExpr(), and are vectorized if they provide a packetOp(), e.g.:
+      * \code tape.unaryExpr(x, internal::scalar_exp_op<double>(), internal::scalar_exp_op<double>()) \endcode */
+    template<typename Derived, typename Func, typename DerivativeFunc>
+    Matrix<ActiveScalar,Derived::RowsAtCompileTime,Derived::ColsAtCompileTime> unaryExpr(const MatrixBase<Derived>& a, const Func& func,
+                                                                                       const DerivativeFunc& derivative)
+    {
+      typedef internal::ad_cwise_node<Scalar> Node;
+      Node* node = new (m_arena.allocate(sizeof(Node))) Node;
+      const Index size = a.size();
+      node->m_size = size;
+      const Scalar* av = unpack(a, node->m_indices[0]);
+      Scalar* da = m_arena.template allocate<Scalar>(size);
+      Map<Array<Scalar,Dynamic,1> >(da, size) = ConstArrayMap(av, size).unaryExpr(derivative);
+      node->m_partials[0] = da;
+      Matrix<ActiveScalar,Derived::RowsAtCompileTime,Derived::ColsAtCompileTime> res(a.rows(), a.cols());
+      node->m_result = makeResult(res, ConstMap(av, a.rows(), a.cols()).unaryExpr(func), node->m_indices[0] ? node : 0);
+      return res;
+    }
+
+    /** \returns the sum of the coefficients of \a a, recorded as a single operation */
+    template<typename Derived>
+    ActiveScalar sum(const MatrixBase<Derived>& a)
+    {
+      typedef internal::ad_reduction_node<Scalar> Node;
+      Node* node = new (m_arena.allocate(sizeof(Node))) Node;
+      node->m_size = a.size();
+      const Scalar* av = unpack(a, node->m_indices[0]);
+      Scalar* ones = m_arena.template allocate<Scalar>(a.size());
+      Map<Array<Scalar,Dynamic,1> >(ones, a.size()).setOnes();
+      node->m_partials[0] = ones;
+      return makeResult(ConstArrayMap(av, a.size()).sum(), node);
+    }
+
+    /** \returns the dot product of the vectors \a a and \a b, recorded as a single operation */
+    template<typename ADerived, typename BDerived>
+    ActiveScalar dot(const MatrixBase<ADerived>& a, const MatrixBase<BDerived>& b)
+    {
+      eigen_assert(a.size()==b.size());
+      typedef internal::ad_reduction_node<Scalar> Node;
+      Node* node = new (m_arena.allocate(sizeof(Node))) Node;
+      node->m_size = a.size();
+      const Scalar* av = unpack(a, node->m_indices[0]);
+      const Scalar* bv = unpack(b, node->m_indices[1]);
+      node->m_partials[0] = bv;
+      node->m_partials[1] = av;
+      return makeResult((ConstArrayMap(av, a.size()) * ConstArrayMap(bv, a.size())).sum(), node);
+    }
+
+    /** \returns the squared norm of \a a, recorded as a single operation */
+    template<typename Derived>
+    ActiveScalar squaredNorm(const MatrixBase<Derived>& a)
+    {
+      typedef internal::ad_reduction_node<Scalar> Node;
+      Node* node = new (m_arena.allocate(sizeof(Node))) Node;
+      node->m_size = a.size();
+      const Scalar* av = unpack(a, node->m_indices[0]);
+      Scalar* da = m_arena.template allocate<Scalar>(a.size());
+      Map<Array<Scalar,Dynamic,1> >(da, a.size()) = Scalar(2) * ConstArrayMap(av, a.size());
+      node->m_partials[0] = da;
+      return makeResult(ConstArrayMap(av, a.size()).square().sum(), node);
+    }
+
+    /** Records an operation of result \a value depending on the operand \a a, with the partial derivative \a da.
+      * This is the extension point to add new elementary functions of AutoDiffReverseScalar. */
+    static ActiveScalar record(const Scalar& value, const ActiveScalar& a, const Scalar& da)
+    {
+      if(a.isConstant())
+        return ActiveScalar(value);
+      AutoDiffTape* tape = a.tape();
+      const Index res = tape->m_variables++;
+      tape->pushOperand(a.index(), da);
+      tape->pushStatement(res);
+      return ActiveScalar(value, tape, res);
+    }
+
+    /** Records an operation of result \a value depending on the operands \a a and \a b, with the partial
+      * derivatives \a da and \a db. */
+    static ActiveScalar record(const Scalar& value, const ActiveScalar& a, const Scalar& da, const ActiveScalar& b, const Scalar& db)
+    {
+      if(a.isConstant())
+        return record(value, b, db);
+      if(b.isConstant())
+        return record(value, a, da);
+      eigen_assert(a.tape()==b.tape() && "the operands must be variables of the same tape");
+      AutoDiffTape* tape = a.tape();
+      const Index res = tape->m_variables++;
+      tape->pushOperand(a.index(), da);
+      tape->pushOperand(b.index(), db);
+      tape->pushStatement(res);
+      return ActiveScalar(value, tape, res);
+    }
+
+  protected:
+    typedef Map<const Matrix<Scalar,Dynamic,Dynamic> > ConstMap;
+    typedef Map<const Array<Scalar,Dynamic,1> > ConstArrayMap;
+
+    void sweep()
+    {
+      Scalar* adjoints = m_adjoints.data();
+      for(Index k = Index(m_results.size())-1; k >= 0; --k)
+      {
+        const Index res = m_results[k];
+        if(res >= 0)
+        {
+          const Scalar g = adjoints[res];
+          if(g == Scalar(0))
+            continue;
+          for(Index i = k > 0 ? m_ends[k-1] : 0; i < m_ends[k]; ++i)
+            adjoints[m_operandIndices[i]] += m_partials[i] * g;
+        }
+        else
+          m_nodes[-res-1]->propagate(adjoints);
+      }
+    }
+
+    inline void pushOperand(Index index, const Scalar& partial)
+    {
+      m_operandIndices.push_back(index);
+      m_partials.push_back(partial);
+    }
+
+    inline void pushStatement(Index result)
+    {
+      m_results.push_back(result);
+      m_ends.push_back(Index(m_partials.size()));
+    }
+
+    void pushNode(internal::ad_node<Scalar>* node)
+    {
+      m_nodes.push_back(node);
+      pushStatement(-Index(m_nodes.size()));
+    }
+
+    // Copies the values of a, in column-major order, into the arena, and its indices if it has any variable.
+    template<typename Derived>
+    Scalar* unpack(const MatrixBase<Derived>& a, const Index*& indices)
+    {
+      return unpack(a, indices, typename internal::conditional<internal::is_same<typename Derived::Scalar,Scalar>::value,
+                                                               internal::true_type, internal::false_type>::type());
+    }
+
+    template<typename Derived>
+    Scalar* unpack(const MatrixBase<Derived>& a, const Index*& indices, internal::true_type /* constant */)
+    {
+      Scalar* values = m_arena.template allocate<Scalar>(a.size());
+      Map<Matrix<Scalar,Dynamic,Dynamic> >(values, a.rows(), a.cols()) = a;
+      indices = 0;
+      return values;
+    }
+
+    template<typename Derived>
+    Scalar* unpack(const MatrixBase<Derived>& a, const Index*& indices, internal::false_type)
+    {
+      const Index rows = a.rows(), cols = a.cols();
+      Scalar* values = m_arena.template allocate<Scalar>(a.size());
+      Index* idx = 0;
+      for(Index j = 0; j < cols; ++j)
+        for(Index i = 0; i < rows; ++i)
+        {
+          const typename Derived::Scalar x = a.coeff(i,j);
+          values[i+j*rows] = internal::ad_reverse_value(x);
+          const Index k = internal::ad_reverse_index(x);
+          if(k >= 0 && !idx)
+          {
+            idx = m_arena.template allocate<Index>(a.size());
+            std::fill(idx, idx + a.size(), Index(-1));
+          }
+          if(k >= 0)
+          {
+            eigen_assert(internal::ad_reverse_tape(x)==this && "the operands must be variables of this tape");
+            idx[i+j*rows] = k;
+          }
+        }
+      indices = idx;
+      return values;
+    }
+
+    // Sets res to new variables of values values, whose derivatives are propagated by node, or to constants if node
+    // is null. Returns the index of the first variable.
+    template<typename ResultType, typename ValuesType>
+    Index makeResult(ResultType& res, const ValuesType& values, internal::ad_node<Scalar>* node)
+    {
+      const Index rows = res.rows(), first = m_variables;
+      for(Index j = 0; j < res.cols(); ++j)
+        for(Index i = 0; i < rows; ++i)
+          res.coeffRef(i,j) = node ? ActiveScalar(values.coeff(i,j), this, first+i+j*rows) : ActiveScalar(values.coeff(i,j));
+      if(node)
+      {
+        m_variables += res.size();
+        pushNode(node);
+      }
+      return first;
+    }
+
+    template<typename NodeType>
+    ActiveScalar makeResult(const Scalar& value, NodeType* node)
+    {
+      if(!node->m_indices[0] && !node->m_indices[1])
+        return ActiveScalar(value);
+      node->m_result = m_variables++;
+      pushNode(node);
+      return ActiveScalar(value, this, node->m_result);
+    }
+
+    // A scalar operation is recorded as a statement, giving the index of its result and the end of its operands in
+    // the operand stream. The statements of the matrix-level operations have a negative result -k-1 referring to
+    // their node k.
+    std::vector<Index> m_results, m_ends;
+    std::vector<Index> m_operandIndices;
+    std::vector<Scalar> m_partials;
+    std::vector<internal::ad_node<Scalar>*> m_nodes;
+    internal::ad_arena m_arena;
+    Index m_variables;
+    Matrix<Scalar,Dynamic,1> m_adjoints;
+
+  private:
+    AutoDiffTape(const AutoDiffTape&);
+    AutoDiffTape& operator=(const AutoDiffTape&);
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_AUTODIFF_TAPE_H
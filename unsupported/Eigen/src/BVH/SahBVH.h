@@ -0,0 +1,399 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SAHBVH_H
+#define EIGEN_SAHBVH_H
+
+namespace Eigen {
+
+/** \class SahBVH
+ *  \brief An optimized bounding volume hierarchy based on AlignedBox, with wide nodes built with the surface area heuristic
+ *
+ *  \param _Scalar The underlying scalar type of the bounding boxes
+ *  \param _Dim The dimension of the space in which the hierarchy lives
+ *  \param _Object The object type that lives in the hierarchy.  It must have value semantics.  Either bounding_box(_Object) must
+ *                 be defined and return an AlignedBox<_Scalar, _Dim> or bounding boxes must be provided to the tree initializer.
+ *  \param _Width The maximal number of children of a node, typically 4 or 8 to match the packet size
+ *
+ *  This class provides the same interface as KdBVH, and can be used with BVIntersect and BVMinimize, but is optimized for
+ *  large and repeated queries:
+ *   - the binary hierarchy is built with a binned surface area heuristic (SAH) instead of median splits, the leaves holding
+ *     up to MaxLeafSize objects.  When OpenMP 3 is enabled, the large subtrees are built in parallel with tasks;
+ *   - the binary hierarchy is then collapsed into a hierarchy with up to \a _Width children per node, stored in a flat
+ *     array in depth first order.  The boxes of the children of a node are stored as a structure of arrays;
+ *   - intersectBox() traverses the hierarchy without recursion nor callbacks on the volumes, and tests the query box
+ *     against all the children of a node at once, with packets.
+ *
+ *  The nodes are indexed such that the inner nodes come first, followed by the leaves, whose children are objects.
+ */
+template<typename _Scalar, int _Dim, typename _Object, int _Width = 4> class SahBVH
+{
+public:
+  enum { Dim = _Dim, Width = _Width, MaxLeafSize = 4 };
+  typedef _Object Object;
+  typedef std::vector<Object, aligned_allocator<Object> > ObjectList;
+  typedef _Scalar Scalar;
+  typedef AlignedBox<Scalar, Dim> Volume;
+  typedef std::vector<Volume, aligned_allocator<Volume> > VolumeList;
+  typedef int Index;
+  typedef const int *VolumeIterator; //the iterators are just pointers into the tree's vectors
+  typedef const Object *ObjectIterator;
+
+  SahBVH() : m_innerNodes(0) {}
+
+  /** Given an iterator range over \a Object references, constructs the BVH.  Requires that bounding_box(Object) return a Volume. */
+  template<typename Iter> SahBVH(Iter begin, Iter end) { init(begin, end, 0, 0); } //int is recognized by init as not being an iterator type
+
+  /** Given an iterator range over \a Object references and an iterator range over their bounding boxes, constructs the BVH */
+  template<typename OIter, typename BIter> SahBVH(OIter begin, OIter end, BIter boxBegin, BIter boxEnd) { init(begin, end, boxBegin, boxEnd); }
+
+  /** Given an iterator range over \a Object references, constructs the BVH, overwriting whatever is in there currently.
+    * Requires that bounding_box(Object) return a Volume. */
+  template<typename Iter> void init(Iter begin, Iter end) { init(begin, end, 0, 0); }
+
+  /** Given an iterator range over \a Object references and an iterator range over their bounding boxes,
+    * constructs the BVH, overwriting whatever is in there currently. */
+  template<typename OIter, typename BIter> void init(OIter begin, OIter end, BIter boxBegin, BIter boxEnd);
+
+  /** \returns the index of the root of the hierarchy, -1 if it is empty */
+  inline Index getRootIndex() const { return m_volumes.empty() ? -1 : 0; }
+
+  /** Given an \a index of a node, on exit, \a outVBegin and \a outVEnd range over the indices of the volume children of the node
+    * and \a outOBegin and \a outOEnd range over the object children of the node */
+  EIGEN_STRONG_INLINE void getChildren(Index index, VolumeIterator &outVBegin, VolumeIterator &outVEnd,
+                                       ObjectIterator &outOBegin, ObjectIterator &outOEnd) const
+  {
+    if(index >= 0 && index < m_innerNodes) {
+      outVBegin = m_nodes[index].children;
+      outVEnd = outVBegin + m_nodes[index].size;
+      outOBegin = outOEnd = ObjectIterator();
+    }
+    else {
+      outVBegin = outVEnd = VolumeIterator();
+      outOBegin = outOEnd = ObjectIterator();
+      if(index >= 0) {
+        const int leaf = index - m_innerNodes;
+        outOBegin = &(m_objects[0]) + m_leafRanges[2 * leaf];
+        outOEnd = &(m_objects[0]) + m_leafRanges[2 * leaf + 1];
+      }
+    }
+  }
+
+  /** \returns the bounding box of the node at \a index */
+  inline const Volume &getVolume(Index index) const
+  {
+    return m_volumes[index];
+  }
+
+  /** Calls \c intersector.intersectObject(object) for each object of the leaves whose bounding box intersects \a query,
+    * until it returns true, i.e., until the intersector says to stop the query. */
+  template<typename Intersector> void intersectBox(const Volume &query, Intersector &intersector) const;
+
+private:
+  typedef Matrix<Scalar, Dim, 1> VectorType;
+  typedef Matrix<Scalar, Dim, Dynamic> CenterList;
+
+  // wide node: the boxes of the children are stored as a structure of arrays
+  struct Node
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    Matrix<Scalar, Width, Dim> lower, upper;
+    int children[Width];
+    int size;
+  };
+
+  // binary node of the SAH hierarchy, the leaves have left < 0
+  struct BuildNode
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, Dim)
+    Volume box;
+    int left, right;
+    int begin, end;
+  };
+  typedef std::vector<BuildNode, aligned_allocator<BuildNode> > BuildNodeList;
+
+  struct BuildContext
+  {
+    const VolumeList *boxes;
+    const CenterList *centers;
+    std::vector<int> *order;
+    BuildNodeList *nodes;
+  };
+
+  static Scalar surfaceArea(const Volume &box)
+  {
+    //sum over the dimensions of the products of the other extents, the perimeter in 2D and half the area in 3D
+    if(box.isEmpty())
+      return Scalar(0);
+    const VectorType extents = box.sizes();
+    Scalar area(0);
+    for(int d = 0; d < Dim; ++d) {
+      Scalar product(1);
+      for(int e = 0; e < Dim; ++e)
+        if(e != d)
+          product *= extents[e];
+      area += product;
+    }
+    return area;
+  }
+
+  static void build(const BuildContext &ctx, int node, int begin, int end);
+  int flatten(const BuildNodeList &buildNodes, int node, std::vector<int> &leaves);
+
+  std::vector<Node, aligned_allocator<Node> > m_nodes; //inner nodes, in depth first order
+  int m_innerNodes;
+  std::vector<int> m_leafRanges; //objects of the leaf l are m_objects[m_leafRanges[2l]] to m_objects[m_leafRanges[2l+1]-1]
+  VolumeList m_volumes;         //bounding boxes of the inner nodes followed by the ones of the leaves
+  ObjectList m_objects;
+};
+
+template<typename _Scalar, int _Dim, typename _Object, int _Width>
+template<typename OIter, typename BIter>
+void SahBVH<_Scalar, _Dim, _Object, _Width>::init(OIter begin, OIter end, BIter boxBegin, BIter boxEnd)
+{
+  m_nodes.clear();
+  m_leafRanges.clear();
+  m_volumes.clear();
+  m_objects.clear();
+  m_innerNodes = 0;
+
+  ObjectList objects(begin, end);
+  const int n = static_cast<int>(objects.size());
+  if(n == 0)
+    return;
+
+  VolumeList objBoxes;
+  internal::get_boxes_helper<ObjectList, VolumeList, BIter>()(objects, boxBegin, boxEnd, objBoxes);
+  CenterList centers(int(Dim), n);
+  for(int i = 0; i < n; ++i)
+    centers.col(i) = objBoxes[i].center();
+
+  // a binary tree over n objects has at most 2n-1 nodes, the subtree of a range of m objects being stored
+  // in the next 2m-1 nodes such that the subtrees can be built concurrently
+  std::vector<int> order(n);
+  for(int i = 0; i < n; ++i)
+    order[i] = i;
+  BuildNodeList buildNodes(2 * n - 1);
+  BuildContext ctx = { &objBoxes, &centers, &order, &buildNodes };
+
+#if defined(EIGEN_HAS_OPENMP) && _OPENMP >= 200805
+  const int threads = nbThreads();
+  if(threads > 1 && n >= 8192 && omp_get_num_threads() == 1) {
+    #pragma omp parallel num_threads(threads)
+    {
+      #pragma omp single
+      build(ctx, 0, 0, n);
+    }
+  }
+  else
+#endif
+    build(ctx, 0, 0, n);
+
+  m_objects.reserve(n);
+  for(int i = 0; i < n; ++i)
+    m_objects.push_back(objects[order[i]]);
+
+  // collapse into the wide hierarchy, the leaves being numbered after the inner nodes
+  std::vector<int> leaves;
+  if(buildNodes[0].left < 0)
+    leaves.push_back(0);
+  else
+    flatten(buildNodes, 0, leaves);
+  m_innerNodes = static_cast<int>(m_nodes.size());
+  m_leafRanges.reserve(2 * leaves.size());
+  for(size_t l = 0; l < leaves.size(); ++l) {
+    m_leafRanges.push_back(buildNodes[leaves[l]].begin);
+    m_leafRanges.push_back(buildNodes[leaves[l]].end);
+    m_volumes.push_back(buildNodes[leaves[l]].box);
+  }
+  for(int i = 0; i < m_innerNodes; ++i)
+    for(int c = 0; c < m_nodes[i].size; ++c)
+      if(m_nodes[i].children[c] < 0)
+        m_nodes[i].children[c] = m_innerNodes + ~m_nodes[i].children[c];
+}
+
+template<typename _Scalar, int _Dim, typename _Object, int _Width>
+void SahBVH<_Scalar, _Dim, _Object, _Width>::build(const BuildContext &ctx, int node, int begin, int end)
+{
+  enum { Bins = 16 };
+  const VolumeList &boxes = *ctx.boxes;
+  const CenterList &centers = *ctx.centers;
+  std::vector<int> &order = *ctx.order;
+  BuildNode &result = (*ctx.nodes)[node];
+  const int count = end - begin;
+
+  Volume box, centerBox;
+  for(int k = begin; k < end; ++k) {
+    box.extend(boxes[order[k]]);
+    centerBox.extend(centers.col(order[k]));
+  }
+  result.box = box;
+  result.begin = begin;
+  result.end = end;
+  result.left = result.right = -1;
+  if(count == 1)
+    return;
+
+  // binned SAH: evaluate the splits between the bins of the centers along each dimension
+  const VectorType centerExtents = centerBox.sizes();
+  Scalar bestCost = NumTraits<Scalar>::highest();
+  int bestDim = -1, bestBin = 0;
+  for(int d = 0; d < Dim; ++d) {
+    if(!(centerExtents[d] > Scalar(0)))
+      continue;
+    const Scalar scale = Scalar(Bins) / centerExtents[d];
+    Volume binBoxes[Bins];
+    int binCounts[Bins] = { 0 };
+    for(int k = begin; k < end; ++k) {
+      const int b = (std::min)(int(Bins) - 1, int((centers(d, order[k]) - (centerBox.min)()[d]) * scale));
+      binBoxes[b].extend(boxes[order[k]]);
+      ++binCounts[b];
+    }
+    Scalar rightAreas[Bins];
+    Volume right;
+    for(int b = Bins - 1; b > 0; --b) {
+      right.extend(binBoxes[b]);
+      rightAreas[b] = surfaceArea(right);
+    }
+    Volume left;
+    int leftCount = 0;
+    for(int b = 1; b < Bins; ++b) {
+      left.extend(binBoxes[b - 1]);
+      leftCount += binCounts[b - 1];
+      if(leftCount == 0 || leftCount == count)
+        continue;
+      const Scalar cost = surfaceArea(left) * Scalar(leftCount) + rightAreas[b] * Scalar(count - leftCount);
+      if(cost < bestCost) {
+        bestCost = cost;
+        bestDim = d;
+        bestBin = b;
+      }
+    }
+  }
+
+  // with a unit cost for the traversal and for each object, relative to the area of the node
+  const Scalar area = surfaceArea(box);
+  const bool splitIsWorse = bestDim < 0 || area * Scalar(1) + bestCost >= area * Scalar(count);
+  if(count <= MaxLeafSize && splitIsWorse)
+    return;
+
+  int mid;
+  if(bestDim >= 0) {
+    const int d = bestDim;
+    const Scalar lowest = (centerBox.min)()[d], scale = Scalar(Bins) / centerExtents[d];
+    int *first = &order[0] + begin, *last = &order[0] + end;
+    int i = 0;
+    for(int *it = first; it != last; ++it) {
+      const int b = (std::min)(int(Bins) - 1, int((centers(d, *it) - lowest) * scale));
+      if(b < bestBin)
+        std::swap(first[i++], *it);
+    }
+    mid = begin + i;
+  }
+  else {
+    // all the centers are equal: split in the middle
+    mid = begin + count / 2;
+  }
+
+  const int left = node + 1, right = node + 2 * (mid - begin);
+  result.left = left;
+  result.right = right;
+#if defined(EIGEN_HAS_OPENMP) && _OPENMP >= 200805
+  if(count >= 4096 && omp_in_parallel()) {
+    #pragma omp task
+    build(ctx, left, begin, mid);
+    build(ctx, right, mid, end);
+    #pragma omp taskwait
+    return;
+  }
+#endif
+  build(ctx, left, begin, mid);
+  build(ctx, right, mid, end);
+}
+
+template<typename _Scalar, int _Dim, typename _Object, int _Width>
+int SahBVH<_Scalar, _Dim, _Object, _Width>::flatten(const BuildNodeList &buildNodes, int node, std::vector<int> &leaves)
+{
+  // open the largest inner children until there are Width of them
+  int children[Width] = { buildNodes[node].left, buildNodes[node].right };
+  int size = 2;
+  while(size < Width) {
+    int best = -1;
+    Scalar bestArea(-1);
+    for(int c = 0; c < size; ++c) {
+      const BuildNode &child = buildNodes[children[c]];
+      if(child.left >= 0 && surfaceArea(child.box) > bestArea) {
+        bestArea = surfaceArea(child.box);
+        best = c;
+      }
+    }
+    if(best < 0)
+      break;
+    const BuildNode &child = buildNodes[children[best]];
+    children[best] = child.left;
+    children[size++] = child.right;
+  }
+
+  const int index = static_cast<int>(m_nodes.size());
+  m_nodes.push_back(Node());
+  m_volumes.push_back(buildNodes[node].box);
+  m_nodes[index].lower.setConstant(NumTraits<Scalar>::highest());
+  m_nodes[index].upper.setConstant(NumTraits<Scalar>::lowest());
+  m_nodes[index].size = size;
+  for(int c = 0; c < size; ++c) {
+    const BuildNode &child = buildNodes[children[c]];
+    m_nodes[index].lower.row(c) = (child.box.min)().transpose();
+    m_nodes[index].upper.row(c) = (child.box.max)().transpose();
+    int childIndex;
+    if(child.left < 0) {
+      childIndex = ~static_cast<int>(leaves.size()); //leaves are renumbered once the number of inner nodes is known
+      leaves.push_back(children[c]);
+    }
+    else
+      childIndex = flatten(buildNodes, children[c], leaves);
+    m_nodes[index].children[c] = childIndex;
+  }
+  return index;
+}
+
+template<typename _Scalar, int _Dim, typename _Object, int _Width>
+template<typename Intersector>
+void SahBVH<_Scalar, _Dim, _Object, _Width>::intersectBox(const Volume &query, Intersector &intersector) const
+{
+  typedef Array<Scalar, Width, 1> Gaps;
+  if(m_volumes.empty())
+    return;
+
+  std::vector<int> todo;
+  todo.reserve(64);
+  todo.push_back(0);
+  while(!todo.empty()) {
+    const int index = todo.back();
+    todo.pop_back();
+
+    if(index >= m_innerNodes) {
+      const int leaf = index - m_innerNodes;
+      for(int k = m_leafRanges[2 * leaf]; k < m_leafRanges[2 * leaf + 1]; ++k)
+        if(intersector.intersectObject(m_objects[k]))
+          return; //intersector said to stop query
+      continue;
+    }
+
+    // the boxes intersect if the largest gap between them along the dimensions is not positive
+    const Node &node = m_nodes[index];
+    Gaps gaps = ((node.lower.col(0).array() - (query.max)()[0]).max)((query.min)()[0] - node.upper.col(0).array());
+    for(int d = 1; d < Dim; ++d)
+      gaps = (gaps.max)(((node.lower.col(d).array() - (query.max)()[d]).max)((query.min)()[d] - node.upper.col(d).array()));
+    for(int c = node.size - 1; c >= 0; --c)
+      if(gaps[c] <= Scalar(0))
+        todo.push_back(node.children[c]);
+  }
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_SAHBVH_H
@@ -0,0 +1,258 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_LDLT_H
+#define EIGEN_BATCHED_LDLT_H
+
+namespace Eigen {
+
+/** \ingroup Batched_Module
+  *
+  * \class BatchedLDLT
+  *
+  * \brief Robust Cholesky decomposition with pivoting of a batch of small fixed-size matrices
+  *
+  * \tparam _MatrixType the type of the matrices, which must be real and of fixed size
+  *
+  * This class computes the decompositions \f$ A_k = P_k^T L_k D_k L_k^* P_k \f$ of an array of
+  * positive or negative semidefinite matrices. As with LDLT<_MatrixType,Lower>, symmetric pivoting is
+  * used, but since the factorization is right-looking the pivot is chosen as the biggest diagonal
+  * coefficient of the updated remaining corner, so that P, L and D may differ from the ones of LDLT.
+  * Only the lower triangular part of the input matrices is referenced.
+  *
+  * The pivots are searched and exchanged separately for each matrix, while the elimination steps are
+  * performed on groups of as many matrices as there are lanes in a packet.
+  *
+  * \sa class LDLT, class BatchedLLT
+  */
+template<typename _MatrixType> class BatchedLDLT
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef internal::batched_storage<MatrixType> Storage;
+    typedef typename Storage::Packet Packet;
+    enum {
+      Size = MatrixType::RowsAtCompileTime,
+      PacketSize = Storage::PacketSize
+    };
+    typedef Matrix<Scalar, Size, 1> VectorType;
+    typedef Transpositions<Size, Size> TranspositionType;
+
+    BatchedLDLT() : m_isInitialized(false) {}
+
+    /** Computes the decompositions of the \a count matrices starting at \a matrices */
+    BatchedLDLT(const MatrixType* matrices, Index count) : m_isInitialized(false)
+    {
+      compute(matrices, count);
+    }
+
+    BatchedLDLT& compute(const MatrixType* matrices, Index count);
+
+    /** \returns the number of decomposed matrices */
+    Index count() const { return m_storage.count(); }
+
+    /** \returns the unit lower triangular factor L of the \a k -th matrix */
+    MatrixType matrixL(Index k) const
+    {
+      eigen_assert(m_isInitialized && "BatchedLDLT is not initialized.");
+      MatrixType res = MatrixType::Identity();
+      res.template triangularView<StrictlyLower>() = m_storage.matrix(k);
+      return res;
+    }
+
+    /** \returns the coefficients of the diagonal matrix D of the \a k -th matrix */
+    VectorType vectorD(Index k) const
+    {
+      eigen_assert(m_isInitialized && "BatchedLDLT is not initialized.");
+      return m_storage.matrix(k).diagonal();
+    }
+
+    /** \returns the permutation P of the \a k -th matrix as a sequence of transpositions */
+    TranspositionType transpositionsP(Index k) const
+    {
+      eigen_assert(m_isInitialized && "BatchedLDLT is not initialized.");
+      TranspositionType res;
+      for(Index i = 0; i < Size; ++i)
+        res.indices().coeffRef(i) = m_transpositions[k*Size+i];
+      return res;
+    }
+
+    /** \returns \c Success. The decomposition is always computed. */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "BatchedLDLT is not initialized.");
+      return Success;
+    }
+
+    /** Solves \f$ A_k x_k = b_k \f$ for all the matrices. \a b and \a x are arrays of count() vectors
+      * or matrices with Size rows. \a x can be equal to \a b.
+      *
+      * As with LDLT::solve(), the zero pivots of a singular matrix are skipped, so that a
+      * least-squares solution is returned when b is in the image of A.
+      */
+    template<typename RhsType>
+    void solve(const RhsType* b, RhsType* x) const;
+
+  protected:
+
+    static void check_template_parameters()
+    {
+      EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsComplex, NUMERIC_TYPE_MUST_BE_REAL)
+      EIGEN_STATIC_ASSERT(int(MatrixType::RowsAtCompileTime)==int(MatrixType::ColsAtCompileTime), THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+    }
+
+    void computeGroup(Index g);
+
+    Storage m_storage;
+    std::vector<int> m_transpositions;
+    bool m_isInitialized;
+};
+
+template<typename MatrixType>
+BatchedLDLT<MatrixType>& BatchedLDLT<MatrixType>::compute(const MatrixType* matrices, Index count)
+{
+  check_template_parameters();
+
+  m_storage.load(matrices, count, MatrixType::Identity());
+  m_transpositions.resize(count*Size);
+  for(Index g = 0; g < m_storage.groups(); ++g)
+    computeGroup(g);
+
+  m_isInitialized = true;
+  return *this;
+}
+
+template<typename MatrixType>
+void BatchedLDLT<MatrixType>::computeGroup(Index g)
+{
+  using namespace internal;
+  using std::abs;
+  Scalar* a = m_storage.group(g);
+  Scalar pivots[PacketSize];
+  Packet lk[Size];
+
+  for(Index k = 0; k < Size; ++k)
+  {
+    // find and apply the symmetric exchange of each matrix of the group
+    for(Index l = 0; l < PacketSize; ++l)
+    {
+      Index p = k;
+      Scalar biggest = abs(a[Storage::offset(k,k)+l]);
+      for(Index i = k+1; i < Size; ++i)
+      {
+        if(abs(a[Storage::offset(i,i)+l]) > biggest)
+        {
+          biggest = abs(a[Storage::offset(i,i)+l]);
+          p = i;
+        }
+      }
+
+      if(g*PacketSize+l < m_storage.count())
+        m_transpositions[(g*PacketSize+l)*Size+k] = int(p);
+
+      if(p != k)
+      {
+        // only the lower triangular part is up to date
+        for(Index j = 0; j < k; ++j)
+          std::swap(a[Storage::offset(k,j)+l], a[Storage::offset(p,j)+l]);
+        std::swap(a[Storage::offset(k,k)+l], a[Storage::offset(p,p)+l]);
+        for(Index i = k+1; i < p; ++i)
+          std::swap(a[Storage::offset(i,k)+l], a[Storage::offset(p,i)+l]);
+        for(Index i = p+1; i < Size; ++i)
+          std::swap(a[Storage::offset(i,k)+l], a[Storage::offset(i,p)+l]);
+      }
+    }
+
+    // a zero pivot means that the remaining corner is zero, so just set the column of L to zero
+    pstoreu(pivots, pload<Packet>(a+Storage::offset(k,k)));
+    for(Index l = 0; l < PacketSize; ++l)
+      pivots[l] = pivots[l]==Scalar(0) ? Scalar(0) : Scalar(1)/pivots[l];
+    const Packet inv = ploadu<Packet>(pivots);
+
+    for(Index i = k+1; i < Size; ++i)
+      lk[i] = pmul(pload<Packet>(a+Storage::offset(i,k)), inv);
+
+    for(Index j = k+1; j < Size; ++j)
+    {
+      const Packet ajk = pload<Packet>(a+Storage::offset(j,k));
+      for(Index i = j; i < Size; ++i)
+        pstore(a+Storage::offset(i,j), psub(pload<Packet>(a+Storage::offset(i,j)), pmul(lk[i], ajk)));
+    }
+
+    for(Index i = k+1; i < Size; ++i)
+      pstore(a+Storage::offset(i,k), lk[i]);
+  }
+}
+
+template<typename MatrixType>
+template<typename RhsType>
+void BatchedLDLT<MatrixType>::solve(const RhsType* b, RhsType* x) const
+{
+  using namespace internal;
+  using std::abs;
+  typedef batched_storage<RhsType> RhsStorage;
+  EIGEN_STATIC_ASSERT(int(RhsType::RowsAtCompileTime)==int(Size), THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+  eigen_assert(m_isInitialized && "BatchedLDLT is not initialized.");
+
+  const Scalar tolerance = (std::numeric_limits<Scalar>::min)();
+  Scalar lanes[PacketSize];
+  Packet invD[Size];
+
+  RhsStorage rhs;
+  rhs.load(b, count(), RhsType::Zero());
+  for(Index g = 0; g < m_storage.groups(); ++g)
+  {
+    const Scalar* a = m_storage.group(g);
+    Scalar* y = rhs.group(g);
+    const Index lanesInUse = (std::min)(Index(PacketSize), count()-g*PacketSize);
+
+    for(Index i = 0; i < Size; ++i)
+    {
+      pstoreu(lanes, pload<Packet>(a+Storage::offset(i,i)));
+      for(Index l = 0; l < PacketSize; ++l)
+        lanes[l] = abs(lanes[l]) > tolerance ? Scalar(1)/lanes[l] : Scalar(0);
+      invD[i] = ploadu<Packet>(lanes);
+    }
+
+    for(Index c = 0; c < RhsStorage::Cols; ++c)
+    {
+      // y = P b
+      for(Index l = 0; l < lanesInUse; ++l)
+        for(Index k = 0; k < Size; ++k)
+          std::swap(y[RhsStorage::offset(k,c)+l], y[RhsStorage::offset(m_transpositions[(g*PacketSize+l)*Size+k],c)+l]);
+      // L y = y
+      for(Index i = 0; i < Size; ++i)
+      {
+        Packet s = pload<Packet>(y+RhsStorage::offset(i,c));
+        for(Index k = 0; k < i; ++k)
+          s = psub(s, pmul(pload<Packet>(a+Storage::offset(i,k)), pload<Packet>(y+RhsStorage::offset(k,c))));
+        pstore(y+RhsStorage::offset(i,c), s);
+      }
+      // D y = y
+      for(Index i = 0; i < Size; ++i)
+        pstore(y+RhsStorage::offset(i,c), pmul(pload<Packet>(y+RhsStorage::offset(i,c)), invD[i]));
+      // L^T y = y
+      for(Index i = Size-1; i >= 0; --i)
+      {
+        Packet s = pload<Packet>(y+RhsStorage::offset(i,c));
+        for(Index k = i+1; k < Size; ++k)
+          s = psub(s, pmul(pload<Packet>(a+Storage::offset(k,i)), pload<Packet>(y+RhsStorage::offset(k,c))));
+        pstore(y+RhsStorage::offset(i,c), s);
+      }
+      // x = P^T y
+      for(Index l = 0; l < lanesInUse; ++l)
+        for(Index k = Size-1; k >= 0; --k)
+          std::swap(y[RhsStorage::offset(k,c)+l], y[RhsStorage::offset(m_transpositions[(g*PacketSize+l)*Size+k],c)+l]);
+    }
+  }
+  rhs.store(x);
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_LDLT_H
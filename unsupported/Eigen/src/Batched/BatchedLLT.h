@@ -0,0 +1,209 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_LLT_H
+#define EIGEN_BATCHED_LLT_H
+
+namespace Eigen {
+
+/** \ingroup Batched_Module
+  *
+  * \class BatchedLLT
+  *
+  * \brief Standard Cholesky decomposition of a batch of small fixed-size matrices
+  *
+  * \tparam _MatrixType the type of the matrices, which must be real and of fixed size
+  *
+  * This class computes the LLT decompositions \f$ A_k = L_k L_k^* \f$ of an array of
+  * selfadjoint positive definite matrices. As with LLT<_MatrixType,Lower>, only the lower
+  * triangular part of the input matrices is referenced.
+  *
+  * The decompositions are computed by groups of as many matrices as there are lanes in a packet,
+  * so that each packet instruction processes the same coefficient of several matrices.
+  *
+  * \code
+  * std::vector<Matrix6f> A(n);
+  * std::vector<Vector6f> b(n), x(n);
+  * BatchedLLT<Matrix6f> llt(A.data(), n);
+  * llt.solve(b.data(), x.data());
+  * \endcode
+  *
+  * \sa class LLT
+  */
+template<typename _MatrixType> class BatchedLLT
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef internal::batched_storage<MatrixType> Storage;
+    typedef typename Storage::Packet Packet;
+    enum {
+      Size = MatrixType::RowsAtCompileTime,
+      PacketSize = Storage::PacketSize
+    };
+
+    BatchedLLT() : m_isInitialized(false) {}
+
+    /** Computes the decompositions of the \a count matrices starting at \a matrices */
+    BatchedLLT(const MatrixType* matrices, Index count) : m_isInitialized(false)
+    {
+      compute(matrices, count);
+    }
+
+    BatchedLLT& compute(const MatrixType* matrices, Index count);
+
+    /** \returns the number of decomposed matrices */
+    Index count() const { return m_storage.count(); }
+
+    /** \returns the lower triangular factor of the \a k -th matrix */
+    MatrixType matrixL(Index k) const
+    {
+      eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+      MatrixType res = MatrixType::Zero();
+      res.template triangularView<Lower>() = m_storage.matrix(k);
+      return res;
+    }
+
+    /** \returns \c Success if all the matrices were positive definite, \c NumericalIssue otherwise */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+      return m_info;
+    }
+
+    /** \returns \c Success if the \a k -th matrix was positive definite, \c NumericalIssue otherwise.
+      * The factor of a matrix which is not positive definite is meaningless, but does not affect the
+      * other matrices. */
+    ComputationInfo info(Index k) const
+    {
+      eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+      return m_infos[k];
+    }
+
+    /** Solves \f$ A_k x_k = b_k \f$ for all the matrices. \a b and \a x are arrays of count() vectors
+      * or matrices with Size rows. \a x can be equal to \a b.
+      */
+    template<typename RhsType>
+    void solve(const RhsType* b, RhsType* x) const;
+
+  protected:
+
+    static void check_template_parameters()
+    {
+      EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsComplex, NUMERIC_TYPE_MUST_BE_REAL)
+      EIGEN_STATIC_ASSERT(int(MatrixType::RowsAtCompileTime)==int(MatrixType::ColsAtCompileTime), THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+    }
+
+    void computeGroup(Index g);
+
+    Storage m_storage;
+    std::vector<ComputationInfo> m_infos;
+    ComputationInfo m_info;
+    bool m_isInitialized;
+};
+
+template<typename MatrixType>
+BatchedLLT<MatrixType>& BatchedLLT<MatrixType>::compute(const MatrixType* matrices, Index count)
+{
+  check_template_parameters();
+
+  m_storage.load(matrices, count, MatrixType::Identity());
+  m_infos.assign(count, Success);
+  for(Index g = 0; g < m_storage.groups(); ++g)
+    computeGroup(g);
+
+  m_info = Success;
+  for(Index k = 0; k < count; ++k)
+    if(m_infos[k]!=Success)
+      m_info = NumericalIssue;
+  m_isInitialized = true;
+  return *this;
+}
+
+template<typename MatrixType>
+void BatchedLLT<MatrixType>::computeGroup(Index g)
+{
+  using namespace internal;
+  Scalar* a = m_storage.group(g);
+  Scalar pivots[PacketSize];
+
+  for(Index j = 0; j < Size; ++j)
+  {
+    Packet d = pload<Packet>(a+Storage::offset(j,j));
+    for(Index k = 0; k < j; ++k)
+    {
+      Packet ljk = pload<Packet>(a+Storage::offset(j,k));
+      d = psub(d, pmul(ljk, ljk));
+    }
+
+    // flag the lanes having a non positive pivot, and go on with a unit pivot
+    pstoreu(pivots, d);
+    for(Index l = 0; l < PacketSize; ++l)
+    {
+      if(!(pivots[l] > Scalar(0)))
+      {
+        const Index k = g*PacketSize+l;
+        if(k < m_storage.count())
+          m_infos[k] = NumericalIssue;
+        pivots[l] = Scalar(1);
+      }
+    }
+    d = psqrt(ploadu<Packet>(pivots));
+    pstore(a+Storage::offset(j,j), d);
+
+    const Packet inv = pdiv(pset1<Packet>(Scalar(1)), d);
+    for(Index i = j+1; i < Size; ++i)
+    {
+      Packet s = pload<Packet>(a+Storage::offset(i,j));
+      for(Index k = 0; k < j; ++k)
+        s = psub(s, pmul(pload<Packet>(a+Storage::offset(i,k)), pload<Packet>(a+Storage::offset(j,k))));
+      pstore(a+Storage::offset(i,j), pmul(s, inv));
+    }
+  }
+}
+
+template<typename MatrixType>
+template<typename RhsType>
+void BatchedLLT<MatrixType>::solve(const RhsType* b, RhsType* x) const
+{
+  using namespace internal;
+  typedef batched_storage<RhsType> RhsStorage;
+  EIGEN_STATIC_ASSERT(int(RhsType::RowsAtCompileTime)==int(Size), THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+  eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+
+  RhsStorage rhs;
+  rhs.load(b, count(), RhsType::Zero());
+  for(Index g = 0; g < m_storage.groups(); ++g)
+  {
+    const Scalar* a = m_storage.group(g);
+    Scalar* y = rhs.group(g);
+    for(Index c = 0; c < RhsStorage::Cols; ++c)
+    {
+      // L y = b
+      for(Index i = 0; i < Size; ++i)
+      {
+        Packet s = pload<Packet>(y+RhsStorage::offset(i,c));
+        for(Index k = 0; k < i; ++k)
+          s = psub(s, pmul(pload<Packet>(a+Storage::offset(i,k)), pload<Packet>(y+RhsStorage::offset(k,c))));
+        pstore(y+RhsStorage::offset(i,c), pdiv(s, pload<Packet>(a+Storage::offset(i,i))));
+      }
+      // L^T x = y
+      for(Index i = Size-1; i >= 0; --i)
+      {
+        Packet s = pload<Packet>(y+RhsStorage::offset(i,c));
+        for(Index k = i+1; k < Size; ++k)
+          s = psub(s, pmul(pload<Packet>(a+Storage::offset(k,i)), pload<Packet>(y+RhsStorage::offset(k,c))));
+        pstore(y+RhsStorage::offset(i,c), pdiv(s, pload<Packet>(a+Storage::offset(i,i))));
+      }
+    }
+  }
+  rhs.store(x);
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_LLT_H
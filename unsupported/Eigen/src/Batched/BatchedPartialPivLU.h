@@ -0,0 +1,214 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_PARTIALPIVLU_H
+#define EIGEN_BATCHED_PARTIALPIVLU_H
+
+namespace Eigen {
+
+/** \ingroup Batched_Module
+  *
+  * \class BatchedPartialPivLU
+  *
+  * \brief LU decomposition with partial pivoting of a batch of small fixed-size matrices
+  *
+  * \tparam _MatrixType the type of the matrices, which must be real, square and of fixed size
+  *
+  * This class computes the decompositions \f$ A_k = P_k^{-1} L_k U_k \f$ of an array of invertible
+  * matrices, with the same row pivoting strategy as PartialPivLU. The pivots are searched and the rows
+  * exchanged separately for each matrix, while the elimination steps are performed on groups of as many
+  * matrices as there are lanes in a packet.
+  *
+  * As for PartialPivLU, the matrices are assumed to be invertible.
+  *
+  * \sa class PartialPivLU
+  */
+template<typename _MatrixType> class BatchedPartialPivLU
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef internal::batched_storage<MatrixType> Storage;
+    typedef typename Storage::Packet Packet;
+    enum {
+      Size = MatrixType::RowsAtCompileTime,
+      PacketSize = Storage::PacketSize
+    };
+    typedef PermutationMatrix<Size, Size> PermutationType;
+    typedef Transpositions<Size, Size> TranspositionType;
+
+    BatchedPartialPivLU() : m_isInitialized(false) {}
+
+    /** Computes the decompositions of the \a count matrices starting at \a matrices */
+    BatchedPartialPivLU(const MatrixType* matrices, Index count) : m_isInitialized(false)
+    {
+      compute(matrices, count);
+    }
+
+    BatchedPartialPivLU& compute(const MatrixType* matrices, Index count);
+
+    /** \returns the number of decomposed matrices */
+    Index count() const { return m_storage.count(); }
+
+    /** \returns the LU decomposition matrix of the \a k -th matrix: the upper-triangular part is U,
+      * the unit-lower-triangular part is L.
+      */
+    MatrixType matrixLU(Index k) const
+    {
+      eigen_assert(m_isInitialized && "BatchedPartialPivLU is not initialized.");
+      return m_storage.matrix(k);
+    }
+
+    /** \returns the permutation matrix P of the \a k -th matrix */
+    PermutationType permutationP(Index k) const
+    {
+      eigen_assert(m_isInitialized && "BatchedPartialPivLU is not initialized.");
+      TranspositionType tr;
+      for(Index i = 0; i < Size; ++i)
+        tr.indices().coeffRef(i) = m_transpositions[k*Size+i];
+      PermutationType res;
+      res = tr;
+      return res;
+    }
+
+    /** \returns the determinant of the \a k -th matrix */
+    Scalar determinant(Index k) const
+    {
+      eigen_assert(m_isInitialized && "BatchedPartialPivLU is not initialized.");
+      Scalar det = m_storage.matrix(k).diagonal().prod();
+      for(Index i = 0; i < Size; ++i)
+        if(m_transpositions[k*Size+i]!=i)
+          det = -det;
+      return det;
+    }
+
+    /** Solves \f$ A_k x_k = b_k \f$ for all the matrices. \a b and \a x are arrays of count() vectors
+      * or matrices with Size rows. \a x can be equal to \a b.
+      */
+    template<typename RhsType>
+    void solve(const RhsType* b, RhsType* x) const;
+
+  protected:
+
+    static void check_template_parameters()
+    {
+      EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsComplex, NUMERIC_TYPE_MUST_BE_REAL)
+      EIGEN_STATIC_ASSERT(int(MatrixType::RowsAtCompileTime)==int(MatrixType::ColsAtCompileTime), THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+    }
+
+    void computeGroup(Index g);
+
+    Storage m_storage;
+    std::vector<int> m_transpositions;
+    bool m_isInitialized;
+};
+
+template<typename MatrixType>
+BatchedPartialPivLU<MatrixType>& BatchedPartialPivLU<MatrixType>::compute(const MatrixType* matrices, Index count)
+{
+  check_template_parameters();
+
+  m_storage.load(matrices, count, MatrixType::Identity());
+  m_transpositions.resize(count*Size);
+  for(Index g = 0; g < m_storage.groups(); ++g)
+    computeGroup(g);
+
+  m_isInitialized = true;
+  return *this;
+}
+
+template<typename MatrixType>
+void BatchedPartialPivLU<MatrixType>::computeGroup(Index g)
+{
+  using namespace internal;
+  using std::abs;
+  Scalar* a = m_storage.group(g);
+
+  for(Index k = 0; k < Size; ++k)
+  {
+    // find and apply the row exchange of each matrix of the group
+    for(Index l = 0; l < PacketSize; ++l)
+    {
+      Index p = k;
+      Scalar biggest = abs(a[Storage::offset(k,k)+l]);
+      for(Index i = k+1; i < Size; ++i)
+      {
+        if(abs(a[Storage::offset(i,k)+l]) > biggest)
+        {
+          biggest = abs(a[Storage::offset(i,k)+l]);
+          p = i;
+        }
+      }
+
+      if(g*PacketSize+l < m_storage.count())
+        m_transpositions[(g*PacketSize+l)*Size+k] = int(p);
+
+      if(p != k)
+        for(Index j = 0; j < Size; ++j)
+          std::swap(a[Storage::offset(k,j)+l], a[Storage::offset(p,j)+l]);
+    }
+
+    const Packet inv = pdiv(pset1<Packet>(Scalar(1)), pload<Packet>(a+Storage::offset(k,k)));
+    for(Index i = k+1; i < Size; ++i)
+      pstore(a+Storage::offset(i,k), pmul(pload<Packet>(a+Storage::offset(i,k)), inv));
+
+    for(Index j = k+1; j < Size; ++j)
+    {
+      const Packet akj = pload<Packet>(a+Storage::offset(k,j));
+      for(Index i = k+1; i < Size; ++i)
+        pstore(a+Storage::offset(i,j), psub(pload<Packet>(a+Storage::offset(i,j)), pmul(pload<Packet>(a+Storage::offset(i,k)), akj)));
+    }
+  }
+}
+
+template<typename MatrixType>
+template<typename RhsType>
+void BatchedPartialPivLU<MatrixType>::solve(const RhsType* b, RhsType* x) const
+{
+  using namespace internal;
+  typedef batched_storage<RhsType> RhsStorage;
+  EIGEN_STATIC_ASSERT(int(RhsType::RowsAtCompileTime)==int(Size), THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+  eigen_assert(m_isInitialized && "BatchedPartialPivLU is not initialized.");
+
+  RhsStorage rhs;
+  rhs.load(b, count(), RhsType::Zero());
+  for(Index g = 0; g < m_storage.groups(); ++g)
+  {
+    const Scalar* a = m_storage.group(g);
+    Scalar* y = rhs.group(g);
+    const Index lanesInUse = (std::min)(Index(PacketSize), count()-g*PacketSize);
+
+    for(Index c = 0; c < RhsStorage::Cols; ++c)
+    {
+      // y = P b
+      for(Index l = 0; l < lanesInUse; ++l)
+        for(Index k = 0; k < Size; ++k)
+          std::swap(y[RhsStorage::offset(k,c)+l], y[RhsStorage::offset(m_transpositions[(g*PacketSize+l)*Size+k],c)+l]);
+      // L y = y
+      for(Index i = 0; i < Size; ++i)
+      {
+        Packet s = pload<Packet>(y+RhsStorage::offset(i,c));
+        for(Index k = 0; k < i; ++k)
+          s = psub(s, pmul(pload<Packet>(a+Storage::offset(i,k)), pload<Packet>(y+RhsStorage::offset(k,c))));
+        pstore(y+RhsStorage::offset(i,c), s);
+      }
+      // U x = y
+      for(Index i = Size-1; i >= 0; --i)
+      {
+        Packet s = pload<Packet>(y+RhsStorage::offset(i,c));
+        for(Index k = i+1; k < Size; ++k)
+          s = psub(s, pmul(pload<Packet>(a+Storage::offset(i,k)), pload<Packet>(y+RhsStorage::offset(k,c))));
+        pstore(y+RhsStorage::offset(i,c), pdiv(s, pload<Packet>(a+Storage::offset(i,i))));
+      }
+    }
+  }
+  rhs.store(x);
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_PARTIALPIVLU_H
@@ -0,0 +1,225 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_PRODUCT_H
+#define EIGEN_BATCHED_PRODUCT_H
+
+namespace Eigen {
+
+namespace internal {
+
+// gives access to the operands of a batch given as arrays of matrices, or of Map
+template<typename _LhsType, typename _RhsType, typename _DstType>
+struct batched_array_accessor
+{
+  typedef _LhsType LhsType;
+  typedef _RhsType RhsType;
+  typedef _DstType DstType;
+  typedef const LhsType& LhsReturnType;
+  typedef const RhsType& RhsReturnType;
+  typedef DstType& DstReturnType;
+
+  batched_array_accessor(const LhsType* lhs, const RhsType* rhs, DstType* dst)
+    : m_lhs(lhs), m_rhs(rhs), m_dst(dst)
+  {}
+
+  LhsReturnType lhs(Index i) const { return m_lhs[i]; }
+  RhsReturnType rhs(Index i) const { return m_rhs[i]; }
+  DstReturnType dst(Index i) const { return m_dst[i]; }
+
+  const LhsType* m_lhs;
+  const RhsType* m_rhs;
+  DstType* m_dst;
+};
+
+// gives access to the operands of a batch of column-major matrices stored at a constant distance from each other
+template<typename Scalar>
+struct batched_strided_accessor
+{
+  typedef Map<const Matrix<Scalar,Dynamic,Dynamic> > LhsType;
+  typedef Map<const Matrix<Scalar,Dynamic,Dynamic> > RhsType;
+  typedef Map<Matrix<Scalar,Dynamic,Dynamic> > DstType;
+  typedef LhsType LhsReturnType;
+  typedef RhsType RhsReturnType;
+  typedef DstType DstReturnType;
+
+  LhsReturnType lhs(Index i) const { return LhsType(m_lhs + i*m_lhsStride, m_rows, m_depth); }
+  RhsReturnType rhs(Index i) const { return RhsType(m_rhs + i*m_rhsStride, m_depth, m_cols); }
+  DstReturnType dst(Index i) const { return DstType(m_dst + i*m_dstStride, m_rows, m_cols); }
+
+  Index m_rows, m_cols, m_depth;
+  const Scalar* m_lhs;
+  Index m_lhsStride;
+  const Scalar* m_rhs;
+  Index m_rhsStride;
+  Scalar* m_dst;
+  Index m_dstStride;
+};
+
+/** \internal Computes the products [begin,end) of the batch, sharing the same blocking sizes and
+  * packing buffers for all the products going through the GEBP kernel. */
+template<typename Accessor>
+void batched_gemm_run(const Accessor& batch, Index begin, Index end,
+                      const typename Accessor::DstType::Scalar& alpha,
+                      const typename Accessor::DstType::Scalar& beta)
+{
+  typedef typename Accessor::LhsType LhsType;
+  typedef typename Accessor::RhsType RhsType;
+  typedef typename Accessor::DstType DstType;
+  typedef typename LhsType::Scalar LhsScalar;
+  typedef typename RhsType::Scalar RhsScalar;
+  typedef typename DstType::Scalar Scalar;
+
+  EIGEN_STATIC_ASSERT((internal::is_same<LhsScalar,Scalar>::value && internal::is_same<RhsScalar,Scalar>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  EIGEN_STATIC_ASSERT(int(LhsType::InnerStrideAtCompileTime)==1 && int(RhsType::InnerStrideAtCompileTime)==1 && int(DstType::InnerStrideAtCompileTime)==1,
+                      THIS_METHOD_IS_ONLY_FOR_EXPRESSIONS_WITH_DIRECT_MEMORY_ACCESS_SUCH_AS_MAP_OR_PLAIN_MATRICES)
+
+  enum {
+    LhsOrder = (int(LhsType::Flags)&RowMajorBit) ? RowMajor : ColMajor,
+    RhsOrder = (int(RhsType::Flags)&RowMajorBit) ? RowMajor : ColMajor,
+    DstOrder = (int(DstType::Flags)&RowMajorBit) ? RowMajor : ColMajor
+  };
+  typedef general_matrix_matrix_product<Index,LhsScalar,LhsOrder,false,RhsScalar,RhsOrder,false,DstOrder> Gemm;
+  typedef gemm_blocking_space<DstOrder,LhsScalar,RhsScalar,Dynamic,Dynamic,Dynamic> BlockingType;
+
+  // the blocking sizes are computed once for the biggest product of the batch
+  Index maxRows = 0, maxCols = 0, maxDepth = 0;
+  for(Index i = begin; i < end; ++i)
+  {
+    maxRows = (std::max)(maxRows, batch.lhs(i).rows());
+    maxCols = (std::max)(maxCols, batch.rhs(i).cols());
+    maxDepth = (std::max)(maxDepth, batch.lhs(i).cols());
+  }
+  BlockingType blocking(maxRows, maxCols, maxDepth, 1, true);
+  bool allocated = false;
+
+  for(Index i = begin; i < end; ++i)
+  {
+    typename Accessor::LhsReturnType lhs = batch.lhs(i);
+    typename Accessor::RhsReturnType rhs = batch.rhs(i);
+    typename Accessor::DstReturnType dst = batch.dst(i);
+    eigen_assert(lhs.cols()==rhs.rows() && "invalid matrix product");
+    if(beta==Scalar(0))
+    {
+      dst.resize(lhs.rows(), rhs.cols());
+      dst.setZero();
+    }
+    else
+    {
+      eigen_assert(dst.rows()==lhs.rows() && dst.cols()==rhs.cols() && "the destination of a batched product with a non zero beta must have the size of the product");
+      if(beta!=Scalar(1))
+        dst *= beta;
+    }
+
+    const Index rows = dst.rows(), cols = dst.cols(), depth = lhs.cols();
+    if(rows==0 || cols==0 || depth==0)
+      continue;
+
+    // same threshold as in generic_product_impl<...,GemmProduct>
+    if(rows+cols+depth < 20)
+    {
+      dst.noalias() += alpha * lhs.lazyProduct(rhs);
+    }
+    else
+    {
+      if(!allocated)
+      {
+        blocking.allocateAll();
+        allocated = true;
+      }
+      Gemm::run(rows, cols, depth,
+                lhs.data(), lhs.outerStride(),
+                rhs.data(), rhs.outerStride(),
+                dst.data(), dst.outerStride(),
+                alpha, blocking);
+    }
+  }
+}
+
+template<typename Accessor>
+void batched_gemm(const Accessor& batch, Index count,
+                  const typename Accessor::DstType::Scalar& alpha,
+                  const typename Accessor::DstType::Scalar& beta)
+{
+#ifdef EIGEN_HAS_OPENMP
+  Index threads = (std::min)(Index(nbThreads()), count);
+  if(threads>1 && omp_get_num_threads()==1)
+  {
+    // each thread works on a contiguous range of the batch with its own packing buffers
+    #pragma omp parallel num_threads(threads)
+    {
+      Index tid = omp_get_thread_num();
+      Index actual_threads = omp_get_num_threads();
+      batched_gemm_run(batch, (count*tid)/actual_threads, (count*(tid+1))/actual_threads, alpha, beta);
+    }
+    return;
+  }
+#endif
+  batched_gemm_run(batch, 0, count, alpha, beta);
+}
+
+} // end namespace internal
+
+/** \ingroup Batched_Module
+  *
+  * Computes the \a count matrix products \f$ C_i = \alpha A_i B_i + \beta C_i \f$.
+  *
+  * \param lhs, rhs, dst arrays of \a count matrices. They can be plain matrices, or Map and Ref objects
+  *                      referencing matrices scattered in memory (pointer arrays). The products can have
+  *                      different sizes. If \a beta is zero, \a dst is resized if needed, otherwise it must
+  *                      already have the size of the products.
+  *
+  * Compared to a loop over \c dst[i].noalias() \c += \c lhs[i]*rhs[i], the cache blocking sizes and the
+  * packing buffers of the GEBP kernel are computed and allocated once for the whole batch, and the very
+  * small products go directly to the coefficient based (lazy) product.
+  * If OpenMP is enabled, the batch is split into contiguous ranges processed by nbThreads() threads,
+  * each single product being computed sequentially.
+  *
+  * \sa Eigen::setNbThreads()
+  */
+template<typename LhsType, typename RhsType, typename DstType>
+void batchedGemm(Index count, const LhsType* lhs, const RhsType* rhs, DstType* dst,
+                 const typename DstType::Scalar& alpha = typename DstType::Scalar(1),
+                 const typename DstType::Scalar& beta = typename DstType::Scalar(0))
+{
+  internal::batched_array_accessor<LhsType,RhsType,DstType> batch(lhs, rhs, dst);
+  internal::batched_gemm(batch, count, alpha, beta);
+}
+
+/** \ingroup Batched_Module
+  *
+  * Computes the \a count matrix products \f$ C_i = \alpha A_i B_i + \beta C_i \f$ of a strided batch:
+  * \f$ A_i \f$ is the \a rows x \a depth column-major matrix starting at <tt>lhs+i*lhsStride</tt>,
+  * \f$ B_i \f$ the \a depth x \a cols one at <tt>rhs+i*rhsStride</tt>, and \f$ C_i \f$ the
+  * \a rows x \a cols one at <tt>dst+i*dstStride</tt>.
+  *
+  * \sa batchedGemm(Index, const LhsType*, const RhsType*, DstType*, const typename DstType::Scalar&, const typename DstType::Scalar&)
+  */
+template<typename Scalar>
+void batchedGemm(Index count, Index rows, Index cols, Index depth,
+                 const Scalar* lhs, Index lhsStride,
+                 const Scalar* rhs, Index rhsStride,
+                 Scalar* dst, Index dstStride,
+                 const Scalar& alpha = Scalar(1), const Scalar& beta = Scalar(0))
+{
+  internal::batched_strided_accessor<Scalar> batch;
+  batch.m_rows = rows;
+  batch.m_cols = cols;
+  batch.m_depth = depth;
+  batch.m_lhs = lhs;
+  batch.m_lhsStride = lhsStride;
+  batch.m_rhs = rhs;
+  batch.m_rhsStride = rhsStride;
+  batch.m_dst = dst;
+  batch.m_dstStride = dstStride;
+  internal::batched_gemm(batch, count, alpha, beta);
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_PRODUCT_H
@@ -0,0 +1,349 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_SELFADJOINTEIGENSOLVER_H
+#define EIGEN_BATCHED_SELFADJOINTEIGENSOLVER_H
+
+namespace Eigen {
+
+namespace internal {
+
+// 3-vector whose coefficients are packets of the same coefficient of several vectors
+template<typename Packet> struct batched_vector3
+{
+  Packet v[3];
+
+  batched_vector3() {}
+  batched_vector3(const Packet& x, const Packet& y, const Packet& z) { v[0] = x; v[1] = y; v[2] = z; }
+
+  batched_vector3 cross(const batched_vector3& o) const
+  {
+    return batched_vector3(psub(pmul(v[1],o.v[2]), pmul(v[2],o.v[1])),
+                           psub(pmul(v[2],o.v[0]), pmul(v[0],o.v[2])),
+                           psub(pmul(v[0],o.v[1]), pmul(v[1],o.v[0])));
+  }
+  Packet dot(const batched_vector3& o) const
+  {
+    return padd(padd(pmul(v[0],o.v[0]), pmul(v[1],o.v[1])), pmul(v[2],o.v[2]));
+  }
+  batched_vector3 operator*(const Packet& s) const
+  {
+    return batched_vector3(pmul(v[0],s), pmul(v[1],s), pmul(v[2],s));
+  }
+  batched_vector3 operator-(const batched_vector3& o) const
+  {
+    return batched_vector3(psub(v[0],o.v[0]), psub(v[1],o.v[1]), psub(v[2],o.v[2]));
+  }
+  batched_vector3 normalized() const
+  {
+    return *this * pdiv(pset1<Packet>(typename unpacket_traits<Packet>::type(1)), psqrt(dot(*this)));
+  }
+  static batched_vector3 select(const bool* mask, const batched_vector3& a, const batched_vector3& b)
+  {
+    return batched_vector3(batched_select(mask,a.v[0],b.v[0]), batched_select(mask,a.v[1],b.v[1]), batched_select(mask,a.v[2],b.v[2]));
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup Batched_Module
+  *
+  * \class BatchedSelfAdjointEigenSolver
+  *
+  * \brief Closed-form eigendecomposition of a batch of 3x3 selfadjoint matrices
+  *
+  * \tparam _MatrixType the type of the matrices, which must be a real 3x3 matrix type
+  *
+  * This class computes the eigenvalues and eigenvectors of an array of real symmetric 3x3 matrices
+  * with the same closed-form algorithm as SelfAdjointEigenSolver::computeDirect(). The arithmetic is
+  * performed on groups of as many matrices as there are lanes in a packet, and the data dependent
+  * branches of the scalar algorithm are replaced by selections between the lanes.
+  *
+  * Only the lower triangular part of the input matrices is referenced. The eigenvalues are sorted in
+  * increasing order.
+  *
+  * \sa SelfAdjointEigenSolver::computeDirect()
+  */
+template<typename _MatrixType> class BatchedSelfAdjointEigenSolver
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef Matrix<Scalar,3,1> VectorType;
+    typedef internal::batched_storage<MatrixType> Storage;
+    typedef internal::batched_storage<VectorType> VectorStorage;
+    typedef typename Storage::Packet Packet;
+    typedef internal::batched_vector3<Packet> Vector3Packet;
+    enum {
+      PacketSize = Storage::PacketSize
+    };
+
+    BatchedSelfAdjointEigenSolver() : m_isInitialized(false), m_eigenvectorsOk(false) {}
+
+    /** Computes the eigendecompositions of the \a count matrices starting at \a matrices.
+      * \a options can be ComputeEigenvectors (default) or EigenvaluesOnly. */
+    BatchedSelfAdjointEigenSolver(const MatrixType* matrices, Index count, int options = ComputeEigenvectors)
+      : m_isInitialized(false), m_eigenvectorsOk(false)
+    {
+      compute(matrices, count, options);
+    }
+
+    BatchedSelfAdjointEigenSolver& compute(const MatrixType* matrices, Index count, int options = ComputeEigenvectors);
+
+    /** \returns the number of decomposed matrices */
+    Index count() const { return m_eivalues.count(); }
+
+    /** \returns the eigenvalues of the \a k -th matrix, sorted in increasing order */
+    VectorType eigenvalues(Index k) const
+    {
+      eigen_assert(m_isInitialized && "BatchedSelfAdjointEigenSolver is not initialized.");
+      return m_eivalues.matrix(k);
+    }
+
+    /** \returns the normalized eigenvectors of the \a k -th matrix, stored as columns */
+    MatrixType eigenvectors(Index k) const
+    {
+      eigen_assert(m_isInitialized && "BatchedSelfAdjointEigenSolver is not initialized.");
+      eigen_assert(m_eigenvectorsOk && "The eigenvectors have not been computed together with the eigenvalues.");
+      return m_eivec.matrix(k);
+    }
+
+    /** \returns \c Success */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "BatchedSelfAdjointEigenSolver is not initialized.");
+      return Success;
+    }
+
+  protected:
+
+    static void check_template_parameters()
+    {
+      EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsComplex, NUMERIC_TYPE_MUST_BE_REAL)
+      EIGEN_STATIC_ASSERT_MATRIX_SPECIFIC_SIZE(MatrixType,3,3)
+    }
+
+    static Vector3Packet extractKernel(const Packet tmp[3][3], Vector3Packet& representative);
+    void computeGroup(Index g, bool computeEigenvectors);
+
+    VectorStorage m_eivalues;
+    Storage m_eivec;
+    bool m_isInitialized;
+    bool m_eigenvectorsOk;
+};
+
+template<typename MatrixType>
+BatchedSelfAdjointEigenSolver<MatrixType>&
+BatchedSelfAdjointEigenSolver<MatrixType>::compute(const MatrixType* matrices, Index count, int options)
+{
+  check_template_parameters();
+  eigen_assert((options&~(EigVecMask|GenEigMask))==0
+          && (options&EigVecMask)!=EigVecMask
+          && "invalid option parameter");
+  bool computeEigenvectors = (options&ComputeEigenvectors)==ComputeEigenvectors;
+
+  // the input matrices are first loaded in the storage of the eigenvectors
+  m_eivec.load(matrices, count, MatrixType::Identity());
+  m_eivalues.resize(count);
+  for(Index g = 0; g < m_eivec.groups(); ++g)
+    computeGroup(g, computeEigenvectors);
+
+  m_isInitialized = true;
+  m_eigenvectorsOk = computeEigenvectors;
+  return *this;
+}
+
+/* Branch free version of direct_selfadjoint_eigenvalues<SolverType,3,false>::extract_kernel:
+ * by construction tmp is of rank 2, its kernel is given by the biggest cross product
+ * of its column having the biggest diagonal entry with the two other ones.
+ */
+template<typename MatrixType>
+typename BatchedSelfAdjointEigenSolver<MatrixType>::Vector3Packet
+BatchedSelfAdjointEigenSolver<MatrixType>::extractKernel(const Packet tmp[3][3], Vector3Packet& representative)
+{
+  using namespace internal;
+  Scalar lanes0[PacketSize], lanes1[PacketSize];
+  bool mask[PacketSize];
+
+  Vector3Packet cols[3];
+  for(Index j = 0; j < 3; ++j)
+    cols[j] = Vector3Packet(tmp[0][j], tmp[1][j], tmp[2][j]);
+
+  // i0 is the index of the biggest diagonal entry
+  Index i0[PacketSize];
+  for(Index l = 0; l < PacketSize; ++l)
+    i0[l] = 0;
+  Packet biggest = pabs(tmp[0][0]);
+  for(Index i = 1; i < 3; ++i)
+  {
+    pstoreu(lanes0, pabs(tmp[i][i]));
+    pstoreu(lanes1, biggest);
+    for(Index l = 0; l < PacketSize; ++l)
+      if(lanes0[l] > lanes1[l])
+        i0[l] = i;
+    biggest = pmax(biggest, pabs(tmp[i][i]));
+  }
+
+  Vector3Packet others[2];
+  representative = cols[0];
+  others[0] = cols[1];
+  others[1] = cols[2];
+  for(Index i = 1; i < 3; ++i)
+  {
+    for(Index l = 0; l < PacketSize; ++l)
+      mask[l] = i0[l]==i;
+    representative = Vector3Packet::select(mask, cols[i], representative);
+    others[0] = Vector3Packet::select(mask, cols[(i+1)%3], others[0]);
+    others[1] = Vector3Packet::select(mask, cols[(i+2)%3], others[1]);
+  }
+
+  Vector3Packet c0 = representative.cross(others[0]);
+  Vector3Packet c1 = representative.cross(others[1]);
+  Packet n0 = c0.dot(c0), n1 = c1.dot(c1);
+  pstoreu(lanes0, n0);
+  pstoreu(lanes1, n1);
+  for(Index l = 0; l < PacketSize; ++l)
+    mask[l] = lanes0[l] > lanes1[l];
+  Packet n = batched_select(mask, n0, n1);
+  return Vector3Packet::select(mask, c0, c1) * pdiv(pset1<Packet>(Scalar(1)), psqrt(n));
+}
+
+template<typename MatrixType>
+void BatchedSelfAdjointEigenSolver<MatrixType>::computeGroup(Index g, bool computeEigenvectors)
+{
+  using namespace internal;
+  using std::atan2;
+  using std::cos;
+  using std::sin;
+  using std::sqrt;
+
+  const Scalar s_inv3 = Scalar(1)/Scalar(3);
+  const Scalar s_sqrt3 = sqrt(Scalar(3));
+  const Packet p_inv3 = pset1<Packet>(s_inv3);
+  const Packet p_zero = pset1<Packet>(Scalar(0));
+  const Packet p_one = pset1<Packet>(Scalar(1));
+  const Packet p_two = pset1<Packet>(Scalar(2));
+  const Scalar eps = NumTraits<Scalar>::epsilon();
+
+  Scalar lanes0[PacketSize], lanes1[PacketSize], lanes2[PacketSize];
+  bool mask[PacketSize];
+
+  Scalar* a = m_eivec.group(g);
+  Packet m[3][3];
+  for(Index j = 0; j < 3; ++j)
+    for(Index i = j; i < 3; ++i)
+      m[j][i] = m[i][j] = pload<Packet>(a+Storage::offset(i,j));
+
+  // Shift the matrix to the mean eigenvalue and map the matrix coefficients to [-1:1] to avoid over- and underflow.
+  const Packet shift = pmul(padd(padd(m[0][0], m[1][1]), m[2][2]), p_inv3);
+  for(Index i = 0; i < 3; ++i)
+    m[i][i] = psub(m[i][i], shift);
+  Packet scale = p_zero;
+  for(Index j = 0; j < 3; ++j)
+    for(Index i = j; i < 3; ++i)
+      scale = pmax(scale, pabs(m[i][j]));
+  pstoreu(lanes0, scale);
+  for(Index l = 0; l < PacketSize; ++l)
+    lanes0[l] = lanes0[l] > Scalar(0) ? Scalar(1)/lanes0[l] : Scalar(1);
+  const Packet inv_scale = ploadu<Packet>(lanes0);
+  for(Index j = 0; j < 3; ++j)
+    for(Index i = 0; i < 3; ++i)
+      m[i][j] = pmul(m[i][j], inv_scale);
+
+  // The characteristic equation is x^3 - c2*x^2 + c1*x - c0 = 0, see
+  // direct_selfadjoint_eigenvalues<SolverType,3,false>::computeRoots
+  Packet c0 = padd(pmul(pmul(m[0][0],m[1][1]),m[2][2]), pmul(p_two,pmul(pmul(m[1][0],m[2][0]),m[2][1])));
+  c0 = psub(c0, pmul(pmul(m[0][0],m[2][1]),m[2][1]));
+  c0 = psub(c0, pmul(pmul(m[1][1],m[2][0]),m[2][0]));
+  c0 = psub(c0, pmul(pmul(m[2][2],m[1][0]),m[1][0]));
+  Packet c1 = psub(pmul(m[0][0],m[1][1]), pmul(m[1][0],m[1][0]));
+  c1 = padd(c1, psub(pmul(m[0][0],m[2][2]), pmul(m[2][0],m[2][0])));
+  c1 = padd(c1, psub(pmul(m[1][1],m[2][2]), pmul(m[2][1],m[2][1])));
+  Packet c2 = padd(padd(m[0][0], m[1][1]), m[2][2]);
+
+  Packet c2_over_3 = pmul(c2, p_inv3);
+  Packet a_over_3 = pmax(pmul(psub(pmul(c2,c2_over_3), c1), p_inv3), p_zero);
+  Packet half_b = pmul(pset1<Packet>(Scalar(0.5)), padd(c0, pmul(c2_over_3, psub(pmul(p_two,pmul(c2_over_3,c2_over_3)), c1))));
+  Packet q = pmax(psub(pmul(a_over_3,pmul(a_over_3,a_over_3)), pmul(half_b,half_b)), p_zero);
+
+  Packet rho = psqrt(a_over_3);
+  pstoreu(lanes0, psqrt(q));
+  pstoreu(lanes1, half_b);
+  for(Index l = 0; l < PacketSize; ++l)
+  {
+    Scalar theta = atan2(lanes0[l], lanes1[l])*s_inv3;
+    lanes0[l] = cos(theta);
+    lanes1[l] = sin(theta);
+  }
+  const Packet cos_theta = ploadu<Packet>(lanes0);
+  const Packet sqrt3_sin_theta = pmul(pset1<Packet>(s_sqrt3), ploadu<Packet>(lanes1));
+
+  Packet eivals[3];
+  eivals[0] = psub(c2_over_3, pmul(rho, padd(cos_theta, sqrt3_sin_theta)));
+  eivals[1] = psub(c2_over_3, pmul(rho, psub(cos_theta, sqrt3_sin_theta)));
+  eivals[2] = padd(c2_over_3, pmul(p_two, pmul(rho, cos_theta)));
+
+  if(computeEigenvectors)
+  {
+    Packet tmp[3][3];
+
+    // Compute the eigenvector of the most distinct eigenvalue, k, and then the one of l
+    Packet d0 = psub(eivals[2], eivals[1]);
+    Packet d1 = psub(eivals[1], eivals[0]);
+    pstoreu(lanes0, d0);
+    pstoreu(lanes1, d1);
+    bool swapped[PacketSize];
+    for(Index l = 0; l < PacketSize; ++l)
+      swapped[l] = lanes0[l] > lanes1[l];
+    d0 = batched_select(swapped, d1, d0);
+    const Packet eival_k = batched_select(swapped, eivals[2], eivals[0]);
+    const Packet eival_l = batched_select(swapped, eivals[0], eivals[2]);
+
+    Vector3Packet representative, dummy;
+    for(Index j = 0; j < 3; ++j)
+      for(Index i = 0; i < 3; ++i)
+        tmp[i][j] = i==j ? psub(m[i][j], eival_k) : m[i][j];
+    Vector3Packet eivec_k = extractKernel(tmp, representative);
+
+    // If d0 is too small, then the two other eigenvalues are numerically the same,
+    // and thus we only have to ortho-normalize the near orthogonal vector we saved above.
+    Vector3Packet eivec_l_close = (representative - eivec_k * eivec_k.dot(representative)).normalized();
+    for(Index j = 0; j < 3; ++j)
+      for(Index i = 0; i < 3; ++i)
+        tmp[i][j] = i==j ? psub(m[i][j], eival_l) : m[i][j];
+    Vector3Packet eivec_l = extractKernel(tmp, dummy);
+
+    pstoreu(lanes0, d0);
+    pstoreu(lanes1, d1);
+    for(Index l = 0; l < PacketSize; ++l)
+      mask[l] = lanes0[l] <= Scalar(2)*eps*lanes1[l];
+    eivec_l = Vector3Packet::select(mask, eivec_l_close, eivec_l);
+
+    Vector3Packet eivecs[3];
+    eivecs[0] = Vector3Packet::select(swapped, eivec_l, eivec_k);
+    eivecs[2] = Vector3Packet::select(swapped, eivec_k, eivec_l);
+    // Compute last eigenvector from the other two
+    eivecs[1] = eivecs[2].cross(eivecs[0]).normalized();
+
+    // All three eigenvalues are numerically the same
+    pstoreu(lanes2, psub(eivals[2], eivals[0]));
+    for(Index l = 0; l < PacketSize; ++l)
+      mask[l] = lanes2[l] <= eps;
+    for(Index j = 0; j < 3; ++j)
+      for(Index i = 0; i < 3; ++i)
+        pstore(a+Storage::offset(i,j), batched_select(mask, i==j ? p_one : p_zero, eivecs[j].v[i]));
+  }
+
+  // Rescale back to the original size.
+  Scalar* eivalues = m_eivalues.group(g);
+  for(Index i = 0; i < 3; ++i)
+    pstore(eivalues+VectorStorage::offset(i,0), padd(pmul(eivals[i], scale), shift));
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_SELFADJOINTEIGENSOLVER_H
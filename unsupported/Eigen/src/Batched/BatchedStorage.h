@@ -0,0 +1,119 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_STORAGE_H
+#define EIGEN_BATCHED_STORAGE_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal
+  * \ingroup Batched_Module
+  *
+  * \brief Interleaved storage of a batch of fixed-size matrices
+  *
+  * The matrices are stored by groups of PacketSize matrices. Within a group, the coefficient (i,j)
+  * of the PacketSize matrices are consecutive in memory, so that they can be loaded as a single
+  * aligned packet. The last group is padded with copies of a user provided matrix (typically the
+  * identity) so that the padding lanes never produce non finite values.
+  */
+template<typename MatrixType>
+class batched_storage
+{
+  public:
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename packet_traits<Scalar>::type Packet;
+    enum {
+      PacketSize = unpacket_traits<Packet>::size,
+      Rows = MatrixType::RowsAtCompileTime,
+      Cols = MatrixType::ColsAtCompileTime,
+      GroupSize = Rows*Cols*PacketSize
+    };
+
+    batched_storage() : m_count(0)
+    {
+      EIGEN_STATIC_ASSERT(Rows!=Dynamic && Cols!=Dynamic, THIS_METHOD_IS_ONLY_FOR_FIXED_SIZE)
+    }
+
+    /** \returns the number of matrices */
+    Index count() const { return m_count; }
+
+    /** \returns the number of groups of PacketSize matrices */
+    Index groups() const { return (m_count+PacketSize-1)/PacketSize; }
+
+    void resize(Index count)
+    {
+      m_count = count;
+      m_data.resize(groups()*GroupSize);
+    }
+
+    /** \returns the offset of the packet holding the coefficient (i,j) within a group */
+    static Index offset(Index i, Index j) { return (i + j*Rows)*PacketSize; }
+
+    Scalar* group(Index g) { return m_data.data() + g*GroupSize; }
+    const Scalar* group(Index g) const { return m_data.data() + g*GroupSize; }
+
+    /** Copies the \a count matrices \a matrices into the interleaved storage,
+      * the unused lanes of the last group being filled with \a pad. */
+    void load(const MatrixType* matrices, Index count, const MatrixType& pad)
+    {
+      resize(count);
+      for(Index g = 0; g < groups(); ++g)
+      {
+        Scalar* data = group(g);
+        for(Index l = 0; l < PacketSize; ++l)
+        {
+          const Index k = g*PacketSize+l;
+          const MatrixType& m = k < count ? matrices[k] : pad;
+          for(Index j = 0; j < Cols; ++j)
+            for(Index i = 0; i < Rows; ++i)
+              data[offset(i,j)+l] = m.coeff(i,j);
+        }
+      }
+    }
+
+    /** Copies back the interleaved matrices to \a matrices */
+    void store(MatrixType* matrices) const
+    {
+      for(Index k = 0; k < m_count; ++k)
+        matrices[k] = matrix(k);
+    }
+
+    /** \returns a copy of the \a k -th matrix */
+    MatrixType matrix(Index k) const
+    {
+      eigen_assert(k>=0 && k<m_count);
+      const Scalar* data = group(k/PacketSize);
+      const Index l = k%PacketSize;
+      MatrixType res;
+      for(Index j = 0; j < Cols; ++j)
+        for(Index i = 0; i < Rows; ++i)
+          res.coeffRef(i,j) = data[offset(i,j)+l];
+      return res;
+    }
+
+  protected:
+    Matrix<Scalar,Dynamic,1> m_data;
+    Index m_count;
+};
+
+/** \internal \returns the packet made of \a then where \a mask is true and of \a other elsewhere */
+template<typename Packet>
+inline Packet batched_select(const bool* mask, const Packet& then, const Packet& other)
+{
+  Selector<unpacket_traits<Packet>::size> selector;
+  for(Index l = 0; l < unpacket_traits<Packet>::size; ++l)
+    selector.select[l] = mask[l];
+  return pblend(selector, then, other);
+}
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_STORAGE_H
@@ -0,0 +1,71 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_CPU_DISPATCHER_H
+#define EIGEN_CPU_DISPATCHER_H
+
+namespace Eigen {
+
+/** \ingroup CpuDispatch_Module
+  *
+  * \class CpuDispatcher
+  *
+  * \brief Selects the version of a function compiled for the best instruction set supported by the CPU
+  *
+  * \tparam Function the type of the functions, typically a function pointer
+  *
+  * The versions are registered with add() together with the CpuFeature flags they have been compiled for,
+  * from the least to the most demanding one. get() returns the last registered version whose features
+  * are all supported by the CPU and the OS, or the generic version if none is.
+  *
+  * The selection only costs a few comparisons, but the result is meant to be kept, e.g. in a static
+  * function pointer initialized at startup.
+  *
+  * \sa cpuFeatures(), \ref CpuDispatch_Module
+  */
+template<typename Function>
+class CpuDispatcher
+{
+  public:
+    /** Constructs a dispatcher which falls back to \a generic, using the features of the running CPU */
+    explicit CpuDispatcher(Function generic)
+      : m_function(generic), m_features(0), m_available(cpuFeatures())
+    {}
+
+    /** Constructs a dispatcher which falls back to \a generic, as if the CPU supported the \a available
+      * features only. This is useful to test or to restrict the dispatching. */
+    CpuDispatcher(Function generic, int available)
+      : m_function(generic), m_features(0), m_available(available)
+    {}
+
+    /** Registers the version \a f requiring the CpuFeature flags \a required. It replaces the
+      * currently selected version if all the \a required features are available. */
+    CpuDispatcher& add(int required, Function f)
+    {
+      if((m_available & required) == required)
+      {
+        m_function = f;
+        m_features = required;
+      }
+      return *this;
+    }
+
+    /** \returns the selected version */
+    Function get() const { return m_function; }
+
+    /** \returns the features required by the selected version, 0 for the generic one */
+    int features() const { return m_features; }
+
+  protected:
+    Function m_function;
+    int m_features;
+    int m_available;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_CPU_DISPATCHER_H
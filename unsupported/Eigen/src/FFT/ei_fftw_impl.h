@@ -227,8 +227,67 @@ namespace internal {
         get_plan(n0,n1,true,dst,src).inv2(fftw_cast(dst), fftw_cast(src) ,n0,n1);
       }
 
+      // howmany complex-to-complex FFTs of size nfft, the k-th element of the i-th one being at i*dist+k*stride
+      inline
+      void fwd(Complex * dst,const Complex *src,int nfft,int howmany,int stride,int dist)
+      {
+        batch(dst,src,nfft,howmany,stride,dist,false);
+      }
+
+      inline
+      void inv(Complex * dst,const Complex *src,int nfft,int howmany,int stride,int dist)
+      {
+        batch(dst,src,nfft,howmany,stride,dist,true);
+      }
+
+      // n-d complex-to-complex of a row-major array of dimensions dims
+      inline
+      void fwd(Complex * dst,const Complex *src,const std::vector<int> & dims)
+      {
+        transform(dst,src,dims,false);
+      }
+
+      inline
+      void inv(Complex * dst,const Complex *src,const std::vector<int> & dims)
+      {
+        transform(dst,src,dims,true);
+      }
+
 
   protected:
+      // the batched transforms go through contiguous buffers, such that one 1-d plan serves all of them
+      inline
+      void batch(Complex * dst,const Complex *src,int nfft,int howmany,int stride,int dist,bool inverse)
+      {
+        std::vector<Complex> in(nfft), out(nfft);
+        for (int i=0;i<howmany;++i) {
+          for (int k=0;k<nfft;++k)
+            in[k] = src[Index(i)*dist+Index(k)*stride];
+          if (inverse)
+            inv(&out[0],&in[0],nfft);
+          else
+            fwd(&out[0],&in[0],nfft);
+          for (int k=0;k<nfft;++k)
+            dst[Index(i)*dist+Index(k)*stride] = out[k];
+        }
+      }
+
+      inline
+      void transform(Complex * dst,const Complex *src,const std::vector<int> & dims,bool inverse)
+      {
+        int total = 1;
+        for (size_t d=0;d<dims.size();++d)
+          total *= dims[d];
+        int stride = 1;
+        for (int d=int(dims.size())-1;d>=0;--d) {
+          const int n = dims[d];
+          for (int o=0;o<total;o+=stride*n)
+            batch(dst+o,src+o,n,stride,stride,1,inverse);
+          stride *= n;
+          src = dst;
+        }
+      }
+
       typedef fftw_plan<Scalar> PlanData;
 
       typedef std::map<int64_t,PlanData> PlanMap;
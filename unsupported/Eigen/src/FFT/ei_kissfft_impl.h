@@ -14,15 +14,34 @@ namespace internal {
   // This FFT implementation was derived from kissfft http:sourceforge.net/projects/kissfft
   // Copyright 2003-2009 Mark Borgerding
 
+// the packet of reals of the same size as the packet of complexes P
+template <typename Scalar, typename P>
+struct kiss_real_packet
+{
+  typedef typename packet_traits<Scalar>::type FullPacket;
+  typedef typename conditional<is_same<P,std::complex<Scalar> >::value, Scalar,
+          typename conditional<int(unpacket_traits<P>::size)==int(packet_traits<std::complex<Scalar> >::size),
+                               FullPacket, typename unpacket_traits<FullPacket>::half>::type>::type type;
+};
+
 template <typename _Scalar>
 struct kiss_cpx_fft
 {
   typedef _Scalar Scalar;
   typedef std::complex<Scalar> Complex;
+  // The butterflies of radix 2, 3, 4, 5 and 8 process PacketSize consecutive butterflies at once with the packet
+  // math of Core, then the remaining ones by half packets and one by one with the same kernels.
+  typedef typename packet_traits<Complex>::type Packet;
+  typedef typename unpacket_traits<Packet>::half HalfPacket;
+  enum {
+    PacketSize = unpacket_traits<Packet>::size,
+    HalfPacketSize = unpacket_traits<HalfPacket>::size
+  };
   std::vector<Complex> m_twiddles;
   std::vector<int> m_stageRadix;
   std::vector<int> m_stageRemainder;
-  std::vector<Complex> m_scratchBuf;
+  std::vector<Complex> m_stageTwiddles;
+  std::vector<size_t> m_stageTwiddlesStart;
   bool m_inverse;
 
   inline
@@ -38,12 +57,24 @@ struct kiss_cpx_fft
 
   void factorize(int nfft)
   {
-    //start factoring out 4's, then 2's, then 3,5,7,9,...
+    //start factoring out 8's, then 4's, then 2's, then 3,5,7,9,...
     int n= nfft;
-    int p=4;
+    int p=8;
+    // a 2 or a 4 left over by the 8's is factored out first, such that the innermost stages,
+    // which are done by the most calls with the smallest m, keep the radix 8
+    int twos=0;
+    for (int r=n;r>0 && r%2==0;r/=2)
+      ++twos;
+    if (twos>3 && twos%3) {
+      int q = 1<<(twos%3);
+      n /= q;
+      m_stageRadix.push_back(q);
+      m_stageRemainder.push_back(n);
+    }
     do {
       while (n % p) {
         switch (p) {
+          case 8: p = 4; break;
           case 4: p = 2; break;
           case 2: p = 3; break;
           default: p += 2; break;
@@ -54,14 +85,34 @@ struct kiss_cpx_fft
       n /= p;
       m_stageRadix.push_back(p);
       m_stageRemainder.push_back(n);
-      if ( p > 5 )
-        m_scratchBuf.resize(p); // scratchbuf will be needed in bfly_generic
     }while(n>1);
+    make_stage_twiddles();
+  }
+
+  // returns whether the radix p has a vectorized butterfly, the other ones using bfly_generic
+  static bool has_kernel(int p) { return (p>=2 && p<=5) || p==8; }
+
+  // For each stage, gathers the twiddles m_twiddles[q*k*fstride] of the q-th input of the k-th butterfly at
+  // position (q-1)*m+k, such that the twiddles of consecutive butterflies are contiguous.
+  void make_stage_twiddles()
+  {
+    size_t fstride = 1;
+    m_stageTwiddlesStart.resize(m_stageRadix.size());
+    for (size_t stage=0;stage<m_stageRadix.size();++stage) {
+      int p = m_stageRadix[stage];
+      int m = m_stageRemainder[stage];
+      m_stageTwiddlesStart[stage] = m_stageTwiddles.size();
+      if ( has_kernel(p) )
+        for (int q=1;q<p;++q)
+          for (int k=0;k<m;++k)
+            m_stageTwiddles.push_back( m_twiddles[q*k*fstride] );
+      fstride *= p;
+    }
   }
 
   template <typename _Src>
     inline
-    void work( int stage,Complex * xout, const _Src * xin, size_t fstride,size_t in_stride)
+    void work( int stage,Complex * xout, const _Src * xin, size_t fstride,size_t in_stride) const
     {
       int p = m_stageRadix[stage];
       int m = m_stageRemainder[stage];
@@ -86,141 +137,182 @@ struct kiss_cpx_fft
       xout=Fout_beg;
 
       // recombine the p smaller DFTs 
+      const Complex * tw = has_kernel(p) ? &m_stageTwiddles[m_stageTwiddlesStart[stage]] : 0;
       switch (p) {
-        case 2: bfly2(xout,fstride,m); break;
-        case 3: bfly3(xout,fstride,m); break;
-        case 4: bfly4(xout,fstride,m); break;
-        case 5: bfly5(xout,fstride,m); break;
+        case 2: bfly<2>(xout,tw,m); break;
+        case 3: bfly<3>(xout,tw,m); break;
+        case 4: bfly<4>(xout,tw,m); break;
+        case 5: bfly<5>(xout,tw,m); break;
+        case 8: bfly<8>(xout,tw,m); break;
         default: bfly_generic(xout,fstride,m,p); break;
       }
     }
 
-  inline
-    void bfly2( Complex * Fout, const size_t fstride, int m)
+  // returns x*s for a packet x of complexes and a real s
+  template <typename P>
+    static EIGEN_STRONG_INLINE
+    P pscale(const P& x, const Scalar& s)
     {
-      for (int k=0;k<m;++k) {
-        Complex t = Fout[m+k] * m_twiddles[k*fstride];
-        Fout[m+k] = Fout[k] - t;
-        Fout[k] += t;
-      }
+      typedef typename kiss_real_packet<Scalar,P>::type RealPacket;
+      return conj_helper<RealPacket,P,false,false>().pmul(pset1<RealPacket>(s), x);
     }
 
-  inline
-    void bfly4( Complex * Fout, const size_t fstride, const size_t m)
+  // returns -i*x for the forward transform and i*x for the inverse one
+  template <typename P>
+    EIGEN_STRONG_INLINE
+    P protate(const P& x) const
     {
-      Complex scratch[6];
-      int negative_if_inverse = m_inverse * -2 +1;
-      for (size_t k=0;k<m;++k) {
-        scratch[0] = Fout[k+m] * m_twiddles[k*fstride];
-        scratch[1] = Fout[k+2*m] * m_twiddles[k*fstride*2];
-        scratch[2] = Fout[k+3*m] * m_twiddles[k*fstride*3];
-        scratch[5] = Fout[k] - scratch[1];
-
-        Fout[k] += scratch[1];
-        scratch[3] = scratch[0] + scratch[2];
-        scratch[4] = scratch[0] - scratch[2];
-        scratch[4] = Complex( scratch[4].imag()*negative_if_inverse , -scratch[4].real()* negative_if_inverse );
-
-        Fout[k+2*m]  = Fout[k] - scratch[3];
-        Fout[k] += scratch[3];
-        Fout[k+m] = scratch[5] + scratch[4];
-        Fout[k+3*m] = scratch[5] - scratch[4];
-      }
+      return m_inverse ? pcplxflip(pconj(x)) : pconj(pcplxflip(x));
     }
 
-  inline
-    void bfly3( Complex * Fout, const size_t fstride, const size_t m)
+  // returns the q-th input of the butterfly at Fout, multiplied by its twiddle
+  template <typename P>
+    static EIGEN_STRONG_INLINE
+    P ptwiddled(const Complex * Fout, const Complex * tw, size_t m, int q)
     {
-      size_t k=m;
-      const size_t m2 = 2*m;
-      Complex *tw1,*tw2;
-      Complex scratch[5];
-      Complex epi3;
-      epi3 = m_twiddles[fstride*m];
-
-      tw1=tw2=&m_twiddles[0];
-
-      do{
-        scratch[1]=Fout[m] * *tw1;
-        scratch[2]=Fout[m2] * *tw2;
-
-        scratch[3]=scratch[1]+scratch[2];
-        scratch[0]=scratch[1]-scratch[2];
-        tw1 += fstride;
-        tw2 += fstride*2;
-        Fout[m] = Complex( Fout->real() - Scalar(.5)*scratch[3].real() , Fout->imag() - Scalar(.5)*scratch[3].imag() );
-        scratch[0] *= epi3.imag();
-        *Fout += scratch[3];
-        Fout[m2] = Complex(  Fout[m].real() + scratch[0].imag() , Fout[m].imag() - scratch[0].real() );
-        Fout[m] += Complex( -scratch[0].imag(),scratch[0].real() );
-        ++Fout;
-      }while(--k);
+      return pmul(ploadu<P>(Fout + q*m), ploadu<P>(tw + (q-1)*m));
     }
 
-  inline
-    void bfly5( Complex * Fout, const size_t fstride, const size_t m)
+  template <typename P>
+    EIGEN_STRONG_INLINE
+    void bfly2_kernel( Complex * Fout, const Complex * tw, size_t m) const
     {
-      Complex *Fout0,*Fout1,*Fout2,*Fout3,*Fout4;
-      size_t u;
-      Complex scratch[13];
-      Complex * twiddles = &m_twiddles[0];
-      Complex *tw;
-      Complex ya,yb;
-      ya = twiddles[fstride*m];
-      yb = twiddles[fstride*2*m];
-
-      Fout0=Fout;
-      Fout1=Fout0+m;
-      Fout2=Fout0+2*m;
-      Fout3=Fout0+3*m;
-      Fout4=Fout0+4*m;
-
-      tw=twiddles;
-      for ( u=0; u<m; ++u ) {
-        scratch[0] = *Fout0;
-
-        scratch[1]  = *Fout1 * tw[u*fstride];
-        scratch[2]  = *Fout2 * tw[2*u*fstride];
-        scratch[3]  = *Fout3 * tw[3*u*fstride];
-        scratch[4]  = *Fout4 * tw[4*u*fstride];
-
-        scratch[7] = scratch[1] + scratch[4];
-        scratch[10] = scratch[1] - scratch[4];
-        scratch[8] = scratch[2] + scratch[3];
-        scratch[9] = scratch[2] - scratch[3];
-
-        *Fout0 +=  scratch[7];
-        *Fout0 +=  scratch[8];
-
-        scratch[5] = scratch[0] + Complex(
-            (scratch[7].real()*ya.real() ) + (scratch[8].real() *yb.real() ),
-            (scratch[7].imag()*ya.real()) + (scratch[8].imag()*yb.real())
-            );
+      P f0 = ploadu<P>(Fout);
+      P t = ptwiddled<P>(Fout,tw,m,1);
+      pstoreu(Fout+m, psub(f0,t));
+      pstoreu(Fout, padd(f0,t));
+    }
 
-        scratch[6] = Complex(
-            (scratch[10].imag()*ya.imag()) + (scratch[9].imag()*yb.imag()),
-            -(scratch[10].real()*ya.imag()) - (scratch[9].real()*yb.imag())
-            );
+  template <typename P>
+    EIGEN_STRONG_INLINE
+    void bfly3_kernel( Complex * Fout, const Complex * tw, size_t m, const Complex & epi3) const
+    {
+      P f0 = ploadu<P>(Fout);
+      P s1 = ptwiddled<P>(Fout,tw,m,1);
+      P s2 = ptwiddled<P>(Fout,tw,m,2);
+      P s3 = padd(s1,s2);
+      P s0 = pscale(psub(s1,s2), epi3.imag());
+      P f1 = psub(f0, pscale(s3,Scalar(.5)));
+      // s0 is multiplied by -i whatever the direction, the sign of the transform being in epi3
+      P r = pconj(pcplxflip(s0));
+      pstoreu(Fout, padd(f0,s3));
+      pstoreu(Fout+m, psub(f1,r));
+      pstoreu(Fout+2*m, padd(f1,r));
+    }
 
-        *Fout1 = scratch[5] - scratch[6];
-        *Fout4 = scratch[5] + scratch[6];
+  template <typename P>
+    EIGEN_STRONG_INLINE
+    void bfly4_kernel( Complex * Fout, const Complex * tw, size_t m) const
+    {
+      P f0 = ploadu<P>(Fout);
+      P s0 = ptwiddled<P>(Fout,tw,m,1);
+      P s1 = ptwiddled<P>(Fout,tw,m,2);
+      P s2 = ptwiddled<P>(Fout,tw,m,3);
+      P s5 = psub(f0,s1);
+      P s6 = padd(f0,s1);
+      P s3 = padd(s0,s2);
+      P s4 = protate(psub(s0,s2));
+      pstoreu(Fout, padd(s6,s3));
+      pstoreu(Fout+m, padd(s5,s4));
+      pstoreu(Fout+2*m, psub(s6,s3));
+      pstoreu(Fout+3*m, psub(s5,s4));
+    }
 
-        scratch[11] = scratch[0] +
-          Complex(
-              (scratch[7].real()*yb.real()) + (scratch[8].real()*ya.real()),
-              (scratch[7].imag()*yb.real()) + (scratch[8].imag()*ya.real())
-              );
+  template <typename P>
+    EIGEN_STRONG_INLINE
+    void bfly5_kernel( Complex * Fout, const Complex * tw, size_t m, const Complex & ya, const Complex & yb) const
+    {
+      P s0 = ploadu<P>(Fout);
+      P s1 = ptwiddled<P>(Fout,tw,m,1);
+      P s2 = ptwiddled<P>(Fout,tw,m,2);
+      P s3 = ptwiddled<P>(Fout,tw,m,3);
+      P s4 = ptwiddled<P>(Fout,tw,m,4);
+
+      P s7 = padd(s1,s4);
+      P s10 = psub(s1,s4);
+      P s8 = padd(s2,s3);
+      P s9 = psub(s2,s3);
+
+      pstoreu(Fout, padd(s0, padd(s7,s8)));
+
+      // the imaginary parts are multiplied by -i, the sign of the transform being in ya and yb
+      P s5 = padd(s0, padd(pscale(s7,ya.real()), pscale(s8,yb.real())));
+      P s6 = padd(pscale(s10,ya.imag()), pscale(s9,yb.imag()));
+      s6 = pconj(pcplxflip(s6));
+      pstoreu(Fout+m, psub(s5,s6));
+      pstoreu(Fout+4*m, padd(s5,s6));
+
+      P s11 = padd(s0, padd(pscale(s7,yb.real()), pscale(s8,ya.real())));
+      P s12 = psub(pscale(s9,ya.imag()), pscale(s10,yb.imag()));
+      s12 = pconj(pcplxflip(s12));
+      pstoreu(Fout+2*m, padd(s11,s12));
+      pstoreu(Fout+3*m, psub(s11,s12));
+    }
 
-        scratch[12] = Complex(
-            -(scratch[10].imag()*yb.imag()) + (scratch[9].imag()*ya.imag()),
-            (scratch[10].real()*yb.imag()) - (scratch[9].real()*ya.imag())
-            );
+  // radix 8 as two radix 4 butterflies on the even and odd inputs
+  template <typename P>
+    EIGEN_STRONG_INLINE
+    void bfly8_kernel( Complex * Fout, const Complex * tw, size_t m) const
+    {
+      const Scalar sqrt1_2 = Scalar(0.707106781186547524400844362104849039L);
+      P a0 = ploadu<P>(Fout);
+      P a1 = ptwiddled<P>(Fout,tw,m,1);
+      P a2 = ptwiddled<P>(Fout,tw,m,2);
+      P a3 = ptwiddled<P>(Fout,tw,m,3);
+      P a4 = ptwiddled<P>(Fout,tw,m,4);
+      P a5 = ptwiddled<P>(Fout,tw,m,5);
+      P a6 = ptwiddled<P>(Fout,tw,m,6);
+      P a7 = ptwiddled<P>(Fout,tw,m,7);
+
+      P t0 = padd(a0,a4), t1 = psub(a0,a4), t2 = padd(a2,a6), t3 = protate(psub(a2,a6));
+      P e0 = padd(t0,t2), e2 = psub(t0,t2), e1 = padd(t1,t3), e3 = psub(t1,t3);
+      t0 = padd(a1,a5); t1 = psub(a1,a5); t2 = padd(a3,a7); t3 = protate(psub(a3,a7));
+      P o0 = padd(t0,t2), o2 = psub(t0,t2), o1 = padd(t1,t3), o3 = psub(t1,t3);
+
+      // multiply the odd outputs by the twiddles of the 8-th roots of unity
+      o1 = pscale(padd(o1,protate(o1)), sqrt1_2);
+      o2 = protate(o2);
+      o3 = pscale(psub(protate(o3),o3), sqrt1_2);
+
+      pstoreu(Fout,     padd(e0,o0));
+      pstoreu(Fout+m,   padd(e1,o1));
+      pstoreu(Fout+2*m, padd(e2,o2));
+      pstoreu(Fout+3*m, padd(e3,o3));
+      pstoreu(Fout+4*m, psub(e0,o0));
+      pstoreu(Fout+5*m, psub(e1,o1));
+      pstoreu(Fout+6*m, psub(e2,o2));
+      pstoreu(Fout+7*m, psub(e3,o3));
+    }
 
-        *Fout2=scratch[11]+scratch[12];
-        *Fout3=scratch[11]-scratch[12];
+  template <typename P>
+    EIGEN_STRONG_INLINE
+    void bfly_kernel( int p, Complex * Fout, const Complex * tw, size_t m, const Complex * roots) const
+    {
+      switch (p) {
+        case 2: bfly2_kernel<P>(Fout,tw,m); break;
+        case 3: bfly3_kernel<P>(Fout,tw,m,roots[0]); break;
+        case 4: bfly4_kernel<P>(Fout,tw,m); break;
+        case 5: bfly5_kernel<P>(Fout,tw,m,roots[0],roots[1]); break;
+        case 8: bfly8_kernel<P>(Fout,tw,m); break;
+      }
+    }
 
-        ++Fout0;++Fout1;++Fout2;++Fout3;++Fout4;
+  // performs the m butterflies of radix p of a stage, tw being the twiddles of the stage
+  template <int p>
+    inline
+    void bfly( Complex * Fout, const Complex * tw, size_t m) const
+    {
+      const size_t nfft = m_twiddles.size();
+      const Complex roots[2] = { m_twiddles[nfft/p], m_twiddles[(2*nfft/p)%nfft] };
+      size_t k=0;
+      for (;k+PacketSize<=m;k+=PacketSize)
+        bfly_kernel<Packet>(p,Fout+k,tw+k,m,roots);
+      if (HalfPacketSize<PacketSize && k+HalfPacketSize<=m) {
+        bfly_kernel<HalfPacket>(p,Fout+k,tw+k,m,roots);
+        k+=HalfPacketSize;
       }
+      for (;k<m;++k)
+        bfly_kernel<Complex>(p,Fout+k,tw+k,m,roots);
     }
 
   /* perform the butterfly for one stage of a mixed radix FFT */
@@ -230,13 +322,14 @@ struct kiss_cpx_fft
         const size_t fstride,
         int m,
         int p
-        )
+        ) const
     {
       int u,k,q1,q;
-      Complex * twiddles = &m_twiddles[0];
+      const Complex * twiddles = &m_twiddles[0];
       Complex t;
       int Norig = static_cast<int>(m_twiddles.size());
-      Complex * scratchbuf = &m_scratchBuf[0];
+      // the scratch buffer is local such that a plan can be used by several threads
+      ei_declare_aligned_stack_constructed_variable(Complex,scratchbuf,p,0);
 
       for ( u=0; u<m; ++u ) {
         k=u;
@@ -279,22 +372,46 @@ struct kissfft_impl
       get_plan(nfft,false).work(0, dst, src, 1,1);
     }
 
+  // howmany complex-to-complex FFTs of size nfft, the k-th element of the i-th one being at i*dist+k*stride,
+  // both in src and in dst, which can be the same
+  inline
+    void fwd( Complex * dst,const Complex *src,int nfft,int howmany,int stride,int dist)
+    {
+      batch(dst,src,nfft,howmany,stride,dist,1,0,false);
+    }
+
+  inline
+    void inv( Complex * dst,const Complex *src,int nfft,int howmany,int stride,int dist)
+    {
+      batch(dst,src,nfft,howmany,stride,dist,1,0,true);
+    }
+
+  // n-d complex-to-complex of a row-major array of dimensions dims, the last one being contiguous
+  inline
+    void fwd( Complex * dst,const Complex *src,const std::vector<int> & dims)
+    {
+      transform(dst,src,&dims[0],int(dims.size()),false);
+    }
+
+  inline
+    void inv( Complex * dst,const Complex *src,const std::vector<int> & dims)
+    {
+      transform(dst,src,&dims[0],int(dims.size()),true);
+    }
+
+  // 2-d complex-to-complex of a n0 x n1 row-major array
   inline
     void fwd2( Complex * dst,const Complex *src,int n0,int n1)
     {
-        EIGEN_UNUSED_VARIABLE(dst);
-        EIGEN_UNUSED_VARIABLE(src);
-        EIGEN_UNUSED_VARIABLE(n0);
-        EIGEN_UNUSED_VARIABLE(n1);
+      int dims[2] = {n0,n1};
+      transform(dst,src,dims,2,false);
     }
 
   inline
     void inv2( Complex * dst,const Complex *src,int n0,int n1)
     {
-        EIGEN_UNUSED_VARIABLE(dst);
-        EIGEN_UNUSED_VARIABLE(src);
-        EIGEN_UNUSED_VARIABLE(n0);
-        EIGEN_UNUSED_VARIABLE(n1);
+      int dims[2] = {n0,n1};
+      transform(dst,src,dims,2,true);
     }
 
   // real-to-complex forward FFT
@@ -318,16 +435,12 @@ struct kissfft_impl
         fwd( dst, reinterpret_cast<const Complex*> (src), ncfft);
         Complex dc = dst[0].real() +  dst[0].imag();
         Complex nyquist = dst[0].real() -  dst[0].imag();
-        int k;
-        for ( k=1;k <= ncfft2 ; ++k ) {
-          Complex fpk = dst[k];
-          Complex fpnk = conj(dst[ncfft-k]);
-          Complex f1k = fpk + fpnk;
-          Complex f2k = fpk - fpnk;
-          Complex tw= f2k * rtw[k-1];
-          dst[k] =  (f1k + tw) * Scalar(.5);
-          dst[ncfft-k] =  conj(f1k -tw)*Scalar(.5);
-        }
+        // the packets of bins k and ncfft-k must not overlap
+        int k=1;
+        for ( ;2*(k+PacketSize-1) < ncfft ; k+=PacketSize )
+          fwd_split<Packet>(dst,rtw,ncfft,k);
+        for ( ;k <= ncfft2 ; ++k )
+          fwd_split<Complex>(dst,rtw,ncfft,k);
         dst[0] = dc;
         dst[ncfft] = nyquist;
       }
@@ -360,15 +473,11 @@ struct kissfft_impl
         Complex * rtw = real_twiddles(ncfft2);
         m_tmpBuf1.resize(ncfft);
         m_tmpBuf1[0] = Complex( src[0].real() + src[ncfft].real(), src[0].real() - src[ncfft].real() );
-        for (int k = 1; k <= ncfft / 2; ++k) {
-          Complex fk = src[k];
-          Complex fnkc = conj(src[ncfft-k]);
-          Complex fek = fk + fnkc;
-          Complex tmp = fk - fnkc;
-          Complex fok = tmp * conj(rtw[k-1]);
-          m_tmpBuf1[k] = fek + fok;
-          m_tmpBuf1[ncfft-k] = conj(fek - fok);
-        }
+        int k=1;
+        for ( ;2*(k+PacketSize-1) < ncfft ; k+=PacketSize )
+          inv_split<Packet>(&m_tmpBuf1[0],src,rtw,ncfft,k);
+        for ( ;k <= ncfft2 ; ++k )
+          inv_split<Complex>(&m_tmpBuf1[0],src,rtw,ncfft,k);
         get_plan(ncfft,true).work(0, reinterpret_cast<Complex*>(dst), &m_tmpBuf1[0], 1,1);
       }
     }
@@ -376,6 +485,36 @@ struct kissfft_impl
   protected:
   typedef kiss_cpx_fft<Scalar> PlanData;
   typedef std::map<int,PlanData> PlanMap;
+  typedef typename PlanData::Packet Packet;
+  enum { PacketSize = PlanData::PacketSize };
+
+  // Split steps of the real FFTs of size 2*ncfft, for the bins k to k+size-1 and their mirrors ncfft-k-size+1 to
+  // ncfft-k, which are loaded and stored reversed.
+  template <typename P>
+    static EIGEN_STRONG_INLINE
+    void fwd_split(Complex * dst, const Complex * rtw, int ncfft, int k)
+    {
+      const int size = unpacket_traits<P>::size;
+      P fpk = ploadu<P>(dst+k);
+      P fpnk = pconj(preverse(ploadu<P>(dst+ncfft-k-size+1)));
+      P f1k = padd(fpk,fpnk);
+      P tw = pmul(psub(fpk,fpnk), ploadu<P>(rtw+k-1));
+      pstoreu(dst+k, PlanData::pscale(padd(f1k,tw), Scalar(.5)));
+      pstoreu(dst+ncfft-k-size+1, preverse(pconj(PlanData::pscale(psub(f1k,tw), Scalar(.5)))));
+    }
+
+  template <typename P>
+    static EIGEN_STRONG_INLINE
+    void inv_split(Complex * dst, const Complex * src, const Complex * rtw, int ncfft, int k)
+    {
+      const int size = unpacket_traits<P>::size;
+      P fk = ploadu<P>(src+k);
+      P fnkc = pconj(preverse(ploadu<P>(src+ncfft-k-size+1)));
+      P fek = padd(fk,fnkc);
+      P fok = conj_helper<P,P,false,true>().pmul(psub(fk,fnkc), ploadu<P>(rtw+k-1));
+      pstoreu(dst+k, padd(fek,fok));
+      pstoreu(dst+ncfft-k-size+1, preverse(pconj(psub(fek,fok))));
+    }
 
   PlanMap m_plans;
   std::map<int, std::vector<Complex> > m_realTwiddles;
@@ -385,6 +524,88 @@ struct kissfft_impl
   inline
     int PlanKey(int nfft, bool isinverse) const { return (nfft<<1) | int(isinverse); }
 
+  // Batched transforms, with one plan shared by all the transforms and the threads. The i-th transform of the
+  // o-th batch starts at o*outerDist+i*dist. The transforms with strided elements are done by tiles of TileSize
+  // transforms gathered into a contiguous buffer, such that adjacent transforms (e.g., the rows of a column-major
+  // matrix) are read and written by runs of TileSize elements.
+  enum { TileSize = 16 };
+
+  inline
+    void batch( Complex * dst,const Complex *src,int nfft,int howmany,int stride,int dist,
+                int outer,int outerDist,bool inverse)
+    {
+      const PlanData & plan = get_plan(nfft,inverse);
+      const int tile = stride==1 ? 1 : int(TileSize);
+      const int tilesPerBatch = (howmany+tile-1)/tile;
+      const int ntiles = tilesPerBatch*outer;
+      Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+      // each thread must get enough work to pay for the parallel region
+      if (omp_get_num_threads()==1)
+        threads = (std::min)(Index(nbThreads()), Index(nfft)*howmany*outer/(32*1024)+1);
+#endif
+      EIGEN_UNUSED_VARIABLE(threads);
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp parallel num_threads(threads) if(threads>1)
+#endif
+      {
+        std::vector<Complex> in, out;
+        if (stride!=1)
+          in.resize(tile*nfft);
+        if (stride!=1 || dst==src)
+          out.resize(tile*nfft);
+#ifdef EIGEN_HAS_OPENMP
+        #pragma omp for schedule(static)
+#endif
+        for (int t=0;t<ntiles;++t) {
+          const int first = (t%tilesPerBatch)*tile;
+          const int count = (std::min)(tile,howmany-first);
+          const Index offset = Index(t/tilesPerBatch)*outerDist + Index(first)*dist;
+          if (stride==1) {
+            if (dst!=src) {
+              plan.work(0, dst+offset, src+offset, 1,1);
+            }else{
+              plan.work(0, &out[0], src+offset, 1,1);
+              std::copy(out.begin(),out.end(),dst+offset);
+            }
+            continue;
+          }
+          for (int k=0;k<nfft;++k) {
+            const Complex * s = src + offset + Index(k)*stride;
+            for (int i=0;i<count;++i)
+              in[i*nfft+k] = s[Index(i)*dist];
+          }
+          for (int i=0;i<count;++i)
+            plan.work(0, &out[i*nfft], &in[i*nfft], 1,1);
+          for (int k=0;k<nfft;++k) {
+            Complex * d = dst + offset + Index(k)*stride;
+            for (int i=0;i<count;++i)
+              d[Index(i)*dist] = out[i*nfft+k];
+          }
+        }
+      }
+    }
+
+  // n-d transform as a batch of 1-d transforms along each dimension, the first one from src to dst, the next ones
+  // in place
+  inline
+    void transform( Complex * dst,const Complex *src,const int * dims,int rank,bool inverse)
+    {
+      int total = 1;
+      for (int d=0;d<rank;++d)
+        total *= dims[d];
+      int stride = 1;
+      for (int d=rank-1;d>=0;--d) {
+        const int n = dims[d];
+        if (stride==1)
+          batch(dst,src,n,total/n,1,n,1,0,inverse);
+        else
+          batch(dst,src,n,stride,stride,1,total/(stride*n),stride*n,inverse);
+        stride *= n;
+        src = dst;
+      }
+    }
+
   inline
     PlanData & get_plan(int nfft, bool inverse)
     {
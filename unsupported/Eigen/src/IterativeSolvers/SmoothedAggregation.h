@@ -0,0 +1,395 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SMOOTHED_AGGREGATION_H
+#define EIGEN_SMOOTHED_AGGREGATION_H
+
+#include <vector>
+
+namespace Eigen {
+
+/** \ingroup IterativeSolvers_Module
+  * \brief Smoothed aggregation algebraic multigrid preconditioner
+  *
+  * This class implements a V-cycle of an algebraic multigrid method whose hierarchy of coarse levels is built
+  * by smoothed aggregation, as described in:
+  * P. Vanek, J. Mandel and M. Brezina, Algebraic multigrid by smoothed aggregation for second and fourth order
+  * elliptic problems, Computing 56, pp. 179-196, 1996.
+  *
+  * On each level, the nodes are grouped into aggregates of strongly connected neighbors, a node \c j being
+  * strongly connected to \c i if \f$ |a_{ij}| \geq \theta \sqrt{|a_{ii} a_{jj}|} \f$. The piecewise constant
+  * tentative prolongator of these aggregates is smoothed by a damped Jacobi step, and the coarse matrix is the
+  * Galerkin product \f$ P^* A P \f$. The coarsest matrix is factorized by SparseLU.
+  *
+  * One application of the preconditioner performs one V-cycle with a zero initial guess, using damped Jacobi
+  * pre- and post-smoothing. The preconditioner is therefore symmetric positive definite when the matrix is, and
+  * can be used with ConjugateGradient as well as with BiCGSTAB or GMRES. For Poisson-like problems the number
+  * of iterations stays roughly constant as the mesh is refined.
+  *
+  * Both the setup and the V-cycle are built on sparse matrix products with row-major matrices, which are
+  * parallelized when OpenMP is enabled.
+  *
+  * \tparam _Scalar the scalar type of the matrices
+  *
+  * \implsparsesolverconcept
+  *
+  * \warning The full matrix must be stored, even when only one triangular part is referenced by the solver.
+  *
+  * \code
+  * ConjugateGradient<SparseMatrix<double>, Lower|Upper, SmoothedAggregationPreconditioner<double> > cg;
+  * cg.compute(A);
+  * x = cg.solve(b);
+  * \endcode
+  *
+  * \sa class ConjugateGradient, class BiCGSTAB, class GMRES
+  */
+template <typename _Scalar>
+class SmoothedAggregationPreconditioner : public SparseSolverBase<SmoothedAggregationPreconditioner<_Scalar> >
+{
+  protected:
+    typedef SparseSolverBase<SmoothedAggregationPreconditioner<_Scalar> > Base;
+    using Base::m_isInitialized;
+  public:
+    typedef _Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef int StorageIndex;
+    typedef SparseMatrix<Scalar,RowMajor,StorageIndex> LevelMatrixType;
+    typedef SparseMatrix<Scalar,ColMajor,StorageIndex> ProlongatorType;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+    enum {
+      ColsAtCompileTime = Dynamic,
+      MaxColsAtCompileTime = Dynamic
+    };
+
+    SmoothedAggregationPreconditioner()
+    {
+      init();
+    }
+
+    template<typename MatrixType>
+    explicit SmoothedAggregationPreconditioner(const MatrixType& mat)
+    {
+      init();
+      compute(mat);
+    }
+
+    Index rows() const { return m_levels.empty() ? 0 : m_levels[0].A.rows(); }
+    Index cols() const { return m_levels.empty() ? 0 : m_levels[0].A.cols(); }
+
+    /** Sets the strength of connection threshold \f$ \theta \f$ used to build the aggregates (default 0.08) */
+    SmoothedAggregationPreconditioner& setStrengthThreshold(const RealScalar& threshold)
+    {
+      m_threshold = threshold;
+      return *this;
+    }
+
+    /** Sets the size below which a level is not coarsened anymore, and directly factorized (default 200) */
+    SmoothedAggregationPreconditioner& setMaxCoarseSize(Index size)
+    {
+      m_maxCoarseSize = size;
+      return *this;
+    }
+
+    /** Sets the maximal number of levels, including the finest one (default 10) */
+    SmoothedAggregationPreconditioner& setMaxLevels(Index levels)
+    {
+      eigen_assert(levels>=1);
+      m_maxLevels = levels;
+      return *this;
+    }
+
+    /** Sets the number of damped Jacobi iterations of both the pre- and the post-smoothing (default 1) */
+    SmoothedAggregationPreconditioner& setSmoothingSteps(Index steps)
+    {
+      m_smoothingSteps = steps;
+      return *this;
+    }
+
+    /** \returns the number of levels of the hierarchy, including the finest one */
+    Index levels() const
+    {
+      eigen_assert(m_isInitialized && "SmoothedAggregationPreconditioner is not initialized.");
+      return Index(m_levels.size());
+    }
+
+    /** \returns the matrix of the level \a l, 0 being the input matrix */
+    const LevelMatrixType& levelMatrix(Index l) const
+    {
+      eigen_assert(m_isInitialized && "SmoothedAggregationPreconditioner is not initialized.");
+      return m_levels[l].A;
+    }
+
+    /** \returns the ratio of the number of nonzeros of all the levels to the one of the input matrix */
+    RealScalar operatorComplexity() const
+    {
+      eigen_assert(m_isInitialized && "SmoothedAggregationPreconditioner is not initialized.");
+      RealScalar nnz = 0;
+      for(std::size_t l = 0; l < m_levels.size(); ++l)
+        nnz += RealScalar(m_levels[l].A.nonZeros());
+      return nnz / RealScalar((std::max)(Index(1), m_levels[0].A.nonZeros()));
+    }
+
+    /** Does nothing since the hierarchy depends on the values of the matrix, see factorize() */
+    template<typename MatrixType>
+    SmoothedAggregationPreconditioner& analyzePattern(const MatrixType&)
+    {
+      m_isInitialized = true;
+      m_info = Success;
+      return *this;
+    }
+
+    /** Builds the hierarchy of coarse levels of \a mat */
+    template<typename MatrixType>
+    SmoothedAggregationPreconditioner& factorize(const MatrixType& mat);
+
+    /** Builds the hierarchy of coarse levels of \a mat */
+    template<typename MatrixType>
+    SmoothedAggregationPreconditioner& compute(const MatrixType& mat)
+    {
+      analyzePattern(mat);
+      return factorize(mat);
+    }
+
+    /** \returns \c Success, or \c NumericalIssue if the coarsest matrix is singular, in which case it is
+      * only smoothed */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "SmoothedAggregationPreconditioner is not initialized.");
+      return m_info;
+    }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    void _solve_impl(const Rhs& b, Dest& x) const
+    {
+      VectorType bj, xj;
+      for(Index j = 0; j < b.cols(); ++j)
+      {
+        bj = b.col(j);
+        vcycle(0, bj, xj);
+        x.col(j) = xj;
+      }
+    }
+
+  protected:
+
+    struct Level
+    {
+      LevelMatrixType A;
+      VectorType invDiag;
+      RealScalar omega;       // damping of the Jacobi smoother and of the prolongator
+      ProlongatorType P;      // prolongator from this level to the next finer one
+    };
+
+    void init()
+    {
+      m_threshold = RealScalar(0.08);
+      m_maxCoarseSize = 200;
+      m_maxLevels = 10;
+      m_smoothingSteps = 1;
+      m_coarseIsFactorized = false;
+      m_info = Success;
+    }
+
+    static void setupSmoother(Level& level);
+    static bool isStrong(Index i, const typename LevelMatrixType::InnerIterator& it,
+                         const Matrix<RealScalar,Dynamic,1>& diag, const RealScalar& threshold2)
+    {
+      return it.index()!=i && numext::abs2(it.value()) >= threshold2 * diag(i) * diag(it.index());
+    }
+    Index aggregate(const LevelMatrixType& A, std::vector<StorageIndex>& aggregates) const;
+    void smooth(const Level& level, const VectorType& b, VectorType& x, Index steps) const;
+    void vcycle(Index l, const VectorType& b, VectorType& x) const;
+
+    std::vector<Level> m_levels;
+    SparseLU<SparseMatrix<Scalar,ColMajor,StorageIndex> > m_coarseSolver;
+    RealScalar m_threshold;
+    Index m_maxCoarseSize;
+    Index m_maxLevels;
+    Index m_smoothingSteps;
+    bool m_coarseIsFactorized;
+    ComputationInfo m_info;
+};
+
+namespace internal {
+template<typename Scalar>
+struct preconditioner_solves_blocks<SmoothedAggregationPreconditioner<Scalar> > { enum { value = true }; };
+}
+
+template<typename Scalar>
+template<typename MatrixType>
+SmoothedAggregationPreconditioner<Scalar>& SmoothedAggregationPreconditioner<Scalar>::factorize(const MatrixType& mat)
+{
+  eigen_assert(mat.rows()==mat.cols() && "SmoothedAggregationPreconditioner requires a square matrix");
+  m_levels.clear();
+  m_levels.push_back(Level());
+  m_levels.back().A = mat;
+  setupSmoother(m_levels.back());
+
+  std::vector<StorageIndex> aggregates;
+  while(m_levels.back().A.rows() > m_maxCoarseSize && Index(m_levels.size()) < m_maxLevels)
+  {
+    const Level& fine = m_levels.back();
+    const Index n = fine.A.rows();
+    const Index nc = aggregate(fine.A, aggregates);
+    if(nc==0 || nc==n)
+      break;
+
+    // tentative prolongator, interpolating the constant vector within each aggregate
+    std::vector<StorageIndex> sizes(nc, 0);
+    for(Index i = 0; i < n; ++i)
+      ++sizes[aggregates[i]];
+    ProlongatorType T(n, nc);
+    T.reserve(Map<const Matrix<StorageIndex,Dynamic,1> >(&sizes[0], nc));
+    for(Index i = 0; i < n; ++i)
+      T.insert(i, aggregates[i]) = Scalar(RealScalar(1) / std::sqrt(RealScalar(sizes[aggregates[i]])));
+    T.makeCompressed();
+
+    // smoothed prolongator P = (I - omega D^-1 A) T, and Galerkin coarse matrix P^* A P
+    Level coarse;
+    ProlongatorType AT = fine.A * T;
+    coarse.P = T - (fine.omega * fine.invDiag).asDiagonal() * AT;
+    ProlongatorType AP = fine.A * coarse.P;
+    coarse.A = coarse.P.adjoint() * AP;
+    setupSmoother(coarse);
+    m_levels.push_back(coarse);
+  }
+
+  m_coarseSolver.compute(SparseMatrix<Scalar,ColMajor,StorageIndex>(m_levels.back().A));
+  m_coarseIsFactorized = m_coarseSolver.info()==Success;
+  m_info = m_coarseIsFactorized ? Success : NumericalIssue;
+  m_isInitialized = true;
+  return *this;
+}
+
+template<typename Scalar>
+void SmoothedAggregationPreconditioner<Scalar>::setupSmoother(Level& level)
+{
+  using std::abs;
+  // Gershgorin bound of the spectral radius of D^-1 A, so that the Jacobi smoother is convergent
+  const Index n = level.A.rows();
+  level.invDiag.setOnes(n);
+  RealScalar rho = 0;
+  for(Index i = 0; i < n; ++i)
+  {
+    RealScalar rowSum = 0, diag = 0;
+    for(typename LevelMatrixType::InnerIterator it(level.A, i); it; ++it)
+    {
+      rowSum += abs(it.value());
+      if(it.index()==i)
+        diag = abs(it.value());
+    }
+    if(diag != RealScalar(0))
+    {
+      level.invDiag(i) = Scalar(1) / level.A.coeff(i,i);
+      rho = (std::max)(rho, rowSum/diag);
+    }
+  }
+  level.omega = RealScalar(4) / (RealScalar(3) * (rho > RealScalar(0) ? rho : RealScalar(1)));
+}
+
+template<typename Scalar>
+Index SmoothedAggregationPreconditioner<Scalar>::aggregate(const LevelMatrixType& A, std::vector<StorageIndex>& aggregates) const
+{
+  using std::abs;
+  const Index n = A.rows();
+  const RealScalar threshold2 = m_threshold * m_threshold;
+  Matrix<RealScalar,Dynamic,1> diag(n);
+  for(Index i = 0; i < n; ++i)
+    diag(i) = abs(A.coeff(i,i));
+
+  aggregates.assign(n, -1);
+  StorageIndex count = 0;
+
+  // 1. aggregates made of a node and all its strong neighbors, which are not aggregated yet
+  for(Index i = 0; i < n; ++i)
+  {
+    if(aggregates[i] != -1)
+      continue;
+    bool free = true;
+    for(typename LevelMatrixType::InnerIterator it(A, i); it && free; ++it)
+      if(isStrong(i, it, diag, threshold2) && aggregates[it.index()] != -1)
+        free = false;
+    if(!free)
+      continue;
+    aggregates[i] = count;
+    for(typename LevelMatrixType::InnerIterator it(A, i); it; ++it)
+      if(isStrong(i, it, diag, threshold2))
+        aggregates[it.index()] = count;
+    ++count;
+  }
+
+  // 2. the remaining nodes join the aggregate of their strongest neighbor from step 1
+  std::vector<StorageIndex> first(aggregates);
+  for(Index i = 0; i < n; ++i)
+  {
+    if(first[i] != -1)
+      continue;
+    RealScalar best = -1;
+    for(typename LevelMatrixType::InnerIterator it(A, i); it; ++it)
+    {
+      if(isStrong(i, it, diag, threshold2) && first[it.index()] != -1 && numext::abs2(it.value()) > best)
+      {
+        best = numext::abs2(it.value());
+        aggregates[i] = first[it.index()];
+      }
+    }
+  }
+
+  // 3. the nodes left form new aggregates with their strong neighbors left
+  for(Index i = 0; i < n; ++i)
+  {
+    if(aggregates[i] != -1)
+      continue;
+    aggregates[i] = count;
+    for(typename LevelMatrixType::InnerIterator it(A, i); it; ++it)
+      if(isStrong(i, it, diag, threshold2) && aggregates[it.index()] == -1)
+        aggregates[it.index()] = count;
+    ++count;
+  }
+
+  return count;
+}
+
+template<typename Scalar>
+void SmoothedAggregationPreconditioner<Scalar>::smooth(const Level& level, const VectorType& b, VectorType& x, Index steps) const
+{
+  VectorType r;
+  for(Index s = 0; s < steps; ++s)
+  {
+    r.noalias() = b - level.A * x;
+    x += level.omega * level.invDiag.cwiseProduct(r);
+  }
+}
+
+template<typename Scalar>
+void SmoothedAggregationPreconditioner<Scalar>::vcycle(Index l, const VectorType& b, VectorType& x) const
+{
+  const Level& level = m_levels[l];
+  x.setZero(b.size());
+
+  if(l+1 == Index(m_levels.size()))
+  {
+    if(m_coarseIsFactorized)
+      x = m_coarseSolver.solve(b);
+    else
+      smooth(level, b, x, 10*(std::max)(Index(1),m_smoothingSteps));
+    return;
+  }
+
+  const Level& coarse = m_levels[l+1];
+  smooth(level, b, x, m_smoothingSteps);
+  VectorType r = b - level.A * x;
+  VectorType bc = coarse.P.adjoint() * r, xc;
+  vcycle(l+1, bc, xc);
+  x += coarse.P * xc;
+  smooth(level, b, x, m_smoothingSteps);
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_SMOOTHED_AGGREGATION_H
@@ -47,6 +47,7 @@ LevenbergMarquardt<FunctorType>::minimizeOneStep(FVectorType  &x)
   }
   // Make a copy of the first factor with the associated permutation
   m_rfactor = qrfac.matrixR();
+  internal::lm_sort_factor(m_rfactor);
   m_permutation = (qrfac.colsPermutation());
 
   /* on the first iteration and if external scaling is not used, scale according */
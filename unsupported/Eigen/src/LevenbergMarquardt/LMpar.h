@@ -45,6 +45,7 @@ namespace internal {
     // This copy is modified during call the qrsolv
     MatrixType s;
     s = qr.matrixR();
+    lm_sort_factor(s);
 
     /* Function Body */
     const Scalar dwarf = (std::numeric_limits<Scalar>::min)();
@@ -134,8 +135,7 @@ namespace internal {
       for (j = 0; j < n; ++j) {
         wa1[j] /= sdiag[j];
         temp = wa1[j];
-        for (Index i = j+1; i < n; ++i)
-          wa1[i] -= s.coeff(i,j) * temp;
+        wa1.tail(n-j-1) -= s.col(j).segment(j+1,n-j-1) * temp;
       }
       temp = wa1.blueNorm();
       parc = fp / m_delta / temp / temp;
@@ -98,89 +98,80 @@ void lmqrsolv(
     x = iPerm * wa; 
 }
 
-template <typename Scalar, int _Options, typename Index>
+template <typename Scalar, int _Options, typename Index, typename PermIndex>
 void lmqrsolv(
   SparseMatrix<Scalar,_Options,Index> &s,
-  const PermutationMatrix<Dynamic,Dynamic> &iPerm,
+  const PermutationMatrix<Dynamic,Dynamic,PermIndex> &iPerm,
   const Matrix<Scalar,Dynamic,1> &diag,
   const Matrix<Scalar,Dynamic,1> &qtb,
   Matrix<Scalar,Dynamic,1> &x,
   Matrix<Scalar,Dynamic,1> &sdiag)
 {
   /* Local variables */
-  typedef SparseMatrix<Scalar,RowMajor,Index> FactorType;
-    Index i, j, k, l;
-    Scalar temp;
+  typedef SparseMatrix<Scalar,ColMajor,Index> FactorType;
+  typedef Triplet<Scalar,Index> TripletType;
+    Index j;
     Index n = s.cols();
     Matrix<Scalar,Dynamic,1>  wa(n);
-    JacobiRotation<Scalar> givens;
 
     /* Function Body */
-    // the following will only change the lower triangular part of s, including
-    // the diagonal, though the diagonal is restored afterward
-
-    /*     copy r and (q transpose)*b to preserve input and initialize R. */
-    wa = qtb;
-    FactorType R(s);
-    // Eliminate the diagonal matrix d using a givens rotation
+    // As in the dense case, only the upper triangular part of s is read, and on output the strictly lower part
+    // holds the transpose of the triangular factor S of (R, D).
+    // Eliminating the rows of d one at a time with givens rotations would visit, for each row, the whole path of the
+    // elimination tree of R above it, which is quadratic for a banded R. Instead S is obtained as the Cholesky factor
+    // of R^T R + D^2 in the natural ordering, whose cost is the one of its fill. Since lmpar2 only calls this function
+    // with a positive diagonal D, the condition number of this matrix is bounded by the regularization.
+    // the inner indices of R might not be sorted, e.g., when it comes from SparseQR
+    std::vector<TripletType> triplets;
+    triplets.reserve(2*s.nonZeros());
+    for (j = 0; j < s.outerSize(); ++j)
+      for (typename SparseMatrix<Scalar,_Options,Index>::InnerIterator it(s,j); it; ++it)
+        if (it.row() <= it.col())
+          triplets.push_back(TripletType(it.row(), it.col(), it.value()));
+    FactorType R(n, n);
+    R.setFromTriplets(triplets.begin(), triplets.end());
+    FactorType dd(n, n);
+    dd.setIdentity();
     for (j = 0; j < n; ++j)
+      dd.valuePtr()[j] = numext::abs2(diag(iPerm.indices()(j)));
+    FactorType normal = FactorType(R.adjoint() * R) + dd;
+
+    SimplicialLLT<FactorType, Lower, NaturalOrdering<Index> > llt(normal);
+    if (llt.info() != Success)
     {
-      // Prepare the row of d to be eliminated, locating the 
-      // diagonal element using p from the qr factorization
-      l = iPerm.indices()(j);
-      if (diag(l) == Scalar(0)) 
-        break; 
-      sdiag.tail(n-j).setZero();
-      sdiag[j] = diag[l];
-      // the transformations to eliminate the row of d
-      // modify only a single element of (q transpose)*b
-      // beyond the first n, which is initially zero. 
-      
-      Scalar qtbpj = 0; 
-      // Browse the nonzero elements of row j of the upper triangular s
-      for (k = j; k < n; ++k)
-      {
-        typename FactorType::InnerIterator itk(R,k);
-        for (; itk; ++itk){
-          if (itk.index() < k) continue;
-          else break;
-        }
-        //At this point, we have the diagonal element R(k,k)
-        // Determine a givens rotation which eliminates 
-        // the appropriate element in the current row of d
-        givens.makeGivens(-itk.value(), sdiag(k));
-        
-        // Compute the modified diagonal element of r and 
-        // the modified element of ((q transpose)*b,0).
-        itk.valueRef() = givens.c() * itk.value() + givens.s() * sdiag(k);
-        temp = givens.c() * wa(k) + givens.s() * qtbpj; 
-        qtbpj = -givens.s() * wa(k) + givens.c() * qtbpj;
-        wa(k) = temp;
-        
-        // Accumulate the transformation in the remaining k row/column of R
-        for (++itk; itk; ++itk)
-        {
-          i = itk.index();
-          temp = givens.c() *  itk.value() + givens.s() * sdiag(i);
-          sdiag(i) = -givens.s() * itk.value() + givens.c() * sdiag(i);
-          itk.valueRef() = temp;
-        }
-      }
+      // D is singular along a null direction of R
+      x.setZero();
+      sdiag.setOnes();
+      return;
     }
-    
-    // Solve the triangular system for z. If the system is 
-    // singular, then obtain a least squares solution
-    Index nsing;
-    for(nsing = 0; nsing<n && sdiag(nsing) !=0; nsing++) {}
-    
-    wa.tail(n-nsing).setZero();
-//     x = wa; 
-    wa.head(nsing) = R.topLeftCorner(nsing,nsing).template triangularView<Upper>().solve/*InPlace*/(wa.head(nsing));
-    
-    sdiag = R.diagonal();
+
+    // Solve the triangular systems for z
+    wa = llt.solve(R.adjoint() * qtb);
+    FactorType L = llt.matrixL();
+    sdiag = L.diagonal();
+
+    // Store the strictly lower part of L = S^T below the diagonal of s, keeping R in its upper part
+    for (j = 0; j < n; ++j)
+      for (typename FactorType::InnerIterator it(L,j); it; ++it)
+        if (it.row() > j)
+          triplets.push_back(TripletType(it.row(), j, it.value()));
+    s.setFromTriplets(triplets.begin(), triplets.end());
+
     // Permute the components of z back to components of x
     x = iPerm * wa; 
 }
+
+// The triangular factor of SparseQR is not sorted, while its columns are accessed by segments.
+template <typename Derived>
+void lm_sort_factor(MatrixBase<Derived> &) {}
+
+template <typename Scalar, int _Options, typename Index>
+void lm_sort_factor(SparseMatrix<Scalar,_Options,Index> &r)
+{
+  SparseMatrix<Scalar,(_Options&RowMajorBit) ? ColMajor : RowMajor,Index> sorted(r);
+  r = sorted;
+}
+
 } // end namespace internal
 
 } // end namespace Eigen
@@ -0,0 +1,186 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_NORMAL_CHOLESKY_H
+#define EIGEN_SPARSE_NORMAL_CHOLESKY_H
+
+namespace Eigen {
+
+template<typename SolverType> struct SparseNormalCholeskyMatrixQReturnType;
+template<typename SolverType> struct SparseNormalCholeskyMatrixQTransposeReturnType;
+
+/** \ingroup NonLinearOptimization_Module
+  * \class SparseNormalCholesky
+  * \brief QR-like factorization of a sparse jacobian computed from the Cholesky factorization of its normal equations
+  *
+  * \tparam _MatrixType the type of the sparse jacobian J, a column-major SparseMatrix
+  * \tparam _OrderingType the fill-reducing ordering of J^T J, AMDOrdering by default
+  *
+  * This class computes the sparse Cholesky factorization \f$ P J^T J P^{-1} = L L^T \f$ and exposes it as the QR
+  * factorization \f$ J \Pi = Q R \f$ with \f$ R = L^T \f$, \f$ \Pi = P^{-1} \f$, and the implicit orthogonal factor
+  * \f$ Q = J \Pi R^{-1} \f$. This is the subset of the SparseQR interface used by LevenbergMarquardt, which thus
+  * solves its inner least squares problems with a sparse Cholesky factorization when the functor declares:
+  * \code
+  * struct MyFunctor : SparseFunctor<double,int>
+  * {
+  *   typedef SparseNormalCholesky<JacobianType> QRSolver;
+  *   ...
+  * };
+  * \endcode
+  *
+  * For large and very sparse least squares problems, such as bundle adjustment, this is much cheaper than SparseQR
+  * in both time and memory, at the price of squaring the condition number of J. The jacobian must have a full column
+  * rank, otherwise info() returns NumericalIssue.
+  *
+  * \warning The factorized matrix is referenced by the products with matrixQ(), so it must remain alive.
+  *
+  * \sa SparseQR, SimplicialLLT
+  */
+template<typename _MatrixType, typename _OrderingType = AMDOrdering<typename _MatrixType::StorageIndex> >
+class SparseNormalCholesky
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef _OrderingType OrderingType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::StorageIndex StorageIndex;
+    typedef SparseMatrix<Scalar,ColMajor,StorageIndex> FactorType;
+    typedef Matrix<Scalar,Dynamic,1> ScalarVector;
+    typedef PermutationMatrix<Dynamic,Dynamic,StorageIndex> PermutationType;
+
+    SparseNormalCholesky() : m_matrix(0), m_info(InvalidInput), m_isInitialized(false) {}
+
+    /** Computes the factorization of the jacobian \a mat, \sa compute() */
+    explicit SparseNormalCholesky(const MatrixType& mat) : m_matrix(0), m_info(InvalidInput), m_isInitialized(false)
+    {
+      compute(mat);
+    }
+
+    /** Computes the Cholesky factorization of the normal matrix of \a mat, which must remain alive as long as
+      * matrixQ() is used. */
+    SparseNormalCholesky& compute(const MatrixType& mat)
+    {
+      m_matrix = &mat;
+      m_normal = FactorType(mat.adjoint() * mat);
+      m_cholesky.compute(m_normal);
+      m_info = m_cholesky.info();
+      m_isInitialized = true;
+      if(m_info != Success)
+        return *this;
+
+      FactorType L = m_cholesky.matrixL();
+      m_R = L.adjoint();
+      if(m_cholesky.permutationPinv().size() == mat.cols())
+        m_permutation = m_cholesky.permutationPinv();
+      else
+      {
+        m_permutation.resize(mat.cols());
+        m_permutation.setIdentity();
+      }
+      return *this;
+    }
+
+    /** \returns the number of rows of the factorized jacobian */
+    Index rows() const { return m_matrix ? m_matrix->rows() : 0; }
+    /** \returns the number of columns of the factorized jacobian */
+    Index cols() const { return m_matrix ? m_matrix->cols() : 0; }
+
+    /** \returns the upper triangular factor R, i.e., the transposed Cholesky factor of the permuted normal matrix */
+    const MatrixType& matrixR() const
+    {
+      eigen_assert(m_isInitialized && "The factorization is not computed yet");
+      return m_R;
+    }
+
+    /** \returns the column permutation \f$ \Pi \f$ such that \f$ \Pi^T J^T J \Pi = R^T R \f$ */
+    const PermutationType& colsPermutation() const
+    {
+      eigen_assert(m_isInitialized && "The factorization is not computed yet");
+      return m_permutation;
+    }
+
+    /** \returns the rank of the jacobian, which is assumed to have a full column rank when the factorization
+      * succeeds */
+    Index rank() const
+    {
+      eigen_assert(m_isInitialized && "The factorization is not computed yet");
+      return m_info == Success ? cols() : 0;
+    }
+
+    /** \returns an expression of the implicit orthogonal factor \f$ Q = J \Pi R^{-1} \f$. Only the product of its
+      * adjoint with a vector is supported. */
+    SparseNormalCholeskyMatrixQReturnType<SparseNormalCholesky> matrixQ() const
+    {
+      eigen_assert(m_isInitialized && "The factorization is not computed yet");
+      return SparseNormalCholeskyMatrixQReturnType<SparseNormalCholesky>(*this);
+    }
+
+    /** \returns the least squares solution of J x = b */
+    template<typename Rhs>
+    ScalarVector solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "The factorization is not computed yet");
+      return m_cholesky.solve(m_matrix->adjoint() * b);
+    }
+
+    /** \returns \c Success if the factorization succeeded, \c NumericalIssue if the normal matrix is not positive
+      * definite, that is, if the jacobian does not have a full column rank */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "The factorization is not computed yet");
+      return m_info;
+    }
+
+    /** \internal \returns the first cols() coefficients of \f$ Q^T f \f$, the remaining ones being set to zero */
+    template<typename Rhs>
+    ScalarVector applyQAdjoint(const MatrixBase<Rhs>& f) const
+    {
+      eigen_assert(f.rows() == rows());
+      ScalarVector y = m_permutation.inverse() * (m_matrix->adjoint() * f);
+      m_R.adjoint().template triangularView<Lower>().solveInPlace(y);
+      ScalarVector res = ScalarVector::Zero(rows());
+      res.head(cols()) = y;
+      return res;
+    }
+
+  protected:
+    const MatrixType* m_matrix;
+    FactorType m_normal;
+    SimplicialLLT<FactorType, Lower, OrderingType> m_cholesky;
+    MatrixType m_R;
+    PermutationType m_permutation;
+    ComputationInfo m_info;
+    bool m_isInitialized;
+};
+
+template<typename SolverType>
+struct SparseNormalCholeskyMatrixQReturnType
+{
+  explicit SparseNormalCholeskyMatrixQReturnType(const SolverType& solver) : m_solver(solver) {}
+  SparseNormalCholeskyMatrixQTransposeReturnType<SolverType> adjoint() const
+  {
+    return SparseNormalCholeskyMatrixQTransposeReturnType<SolverType>(m_solver);
+  }
+  const SolverType& m_solver;
+};
+
+template<typename SolverType>
+struct SparseNormalCholeskyMatrixQTransposeReturnType
+{
+  explicit SparseNormalCholeskyMatrixQTransposeReturnType(const SolverType& solver) : m_solver(solver) {}
+  template<typename Rhs>
+  typename SolverType::ScalarVector operator*(const MatrixBase<Rhs>& other) const
+  {
+    return m_solver.applyQAdjoint(other);
+  }
+  const SolverType& m_solver;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_NORMAL_CHOLESKY_H
@@ -334,6 +334,101 @@ struct matrix_exp_computeUV<MatrixType, long double>
 };
 
 
+/** \brief Coefficients of the Rodrigues formula.
+ *
+ * Computes \f$ a = \sin\theta / \theta \f$, \f$ b = (1-\cos\theta) / \theta^2 \f$ and
+ * \f$ c = (\theta-\sin\theta) / \theta^3 \f$ from \f$ \theta^2 \f$, such that the exponential of the
+ * skew-symmetric matrix \f$ W \f$ of a rotation vector of norm \f$ \theta \f$ is
+ * \f$ I + aW + bW^2 \f$, and \f$ I + bW + cW^2 \f$ is its left jacobian. Taylor expansions are used
+ * for small angles, where the closed forms cancel.
+ */
+template <typename RealScalar>
+void matrix_exp_rodrigues_coeffs(const RealScalar& theta2, RealScalar& a, RealScalar& b, RealScalar& c)
+{
+  using std::sqrt;
+  using std::sin;
+  using std::cos;
+  // below this angle, the truncation errors of the expansions are below the round-off error
+  const RealScalar small = sqrt(NumTraits<RealScalar>::epsilon());
+  if (theta2 < small) {
+    a = RealScalar(1) - theta2 / RealScalar(6);
+    b = RealScalar(0.5) - theta2 / RealScalar(24);
+    c = RealScalar(1) / RealScalar(6) - theta2 / RealScalar(120);
+  } else {
+    const RealScalar theta = sqrt(theta2);
+    const RealScalar halfSinc = sin(theta / 2) / theta;
+    a = sin(theta) / theta;
+    b = 2 * halfSinc * halfSinc;
+    c = (RealScalar(1) - a) / theta2;
+  }
+}
+
+/** \brief Closed forms of the exponential of some fixed-size matrices.
+ *
+ * The run() function returns false if no closed form applies to \c arg, otherwise it stores the
+ * exponential of \c arg in \c result and returns true.
+ */
+template <typename MatrixType,
+          int Size = traits<MatrixType>::RowsAtCompileTime,
+          bool IsComplex = NumTraits<typename traits<MatrixType>::Scalar>::IsComplex>
+struct matrix_exp_closed_form
+{
+  template <typename ResultType>
+  static bool run(const MatrixType&, ResultType&) { return false; }
+};
+
+/* Rodrigues formula for the skew-symmetric 3-by-3 matrices, that is, the rotation generators of so(3). */
+template <typename MatrixType>
+struct matrix_exp_closed_form<MatrixType, 3, false>
+{
+  typedef typename traits<MatrixType>::Scalar Scalar;
+
+  static bool isSkew(const MatrixType& arg)
+  {
+    return arg(0,0) == Scalar(0) && arg(1,1) == Scalar(0) && arg(2,2) == Scalar(0)
+        && arg(1,0) == -arg(0,1) && arg(2,0) == -arg(0,2) && arg(2,1) == -arg(1,2);
+  }
+
+  template <typename ResultType>
+  static bool run(const MatrixType& arg, ResultType& result)
+  {
+    if (!isSkew(arg))
+      return false;
+    Matrix<Scalar,3,1> w(arg(2,1), arg(0,2), arg(1,0));
+    Scalar a, b, c;
+    matrix_exp_rodrigues_coeffs(w.squaredNorm(), a, b, c);
+    result = Matrix<Scalar,3,3>::Identity() + a * arg + b * (arg * arg);
+    return true;
+  }
+};
+
+/* Closed form for the 4-by-4 twists of se(3), whose top-left 3-by-3 block is skew-symmetric and whose
+ * last row is zero. */
+template <typename MatrixType>
+struct matrix_exp_closed_form<MatrixType, 4, false>
+{
+  typedef typename traits<MatrixType>::Scalar Scalar;
+
+  template <typename ResultType>
+  static bool run(const MatrixType& arg, ResultType& result)
+  {
+    const Matrix<Scalar,3,3> W = arg.template topLeftCorner<3,3>();
+    if (!arg.template bottomRows<1>().isZero(Scalar(0)) || !matrix_exp_closed_form<Matrix<Scalar,3,3> >::isSkew(W))
+      return false;
+    Matrix<Scalar,3,1> w(W(2,1), W(0,2), W(1,0));
+    Scalar a, b, c;
+    matrix_exp_rodrigues_coeffs(w.squaredNorm(), a, b, c);
+    const Matrix<Scalar,3,3> W2 = W * W;
+    Matrix<Scalar,4,4> res;
+    res.template topLeftCorner<3,3>() = Matrix<Scalar,3,3>::Identity() + a * W + b * W2;
+    res.template topRightCorner<3,1>() = arg.template topRightCorner<3,1>()
+                                       + (b * W + c * W2) * arg.template topRightCorner<3,1>();
+    res.template bottomRows<1>() << 0, 0, 0, 1;
+    result = res;
+    return true;
+  }
+};
+
 /* Computes the matrix exponential
  *
  * \param arg    argument of matrix exponential (should be plain object)
@@ -351,6 +446,8 @@ void matrix_exp_compute(const MatrixType& arg, ResultType &result)
     return;
   }
 #endif
+  if (matrix_exp_closed_form<MatrixType>::run(arg, result))
+    return;
   MatrixType U, V;
   int squarings; 
   matrix_exp_computeUV<MatrixType>::run(arg, U, V, squarings); // Pade approximant is (U+V) / (-U+V)
@@ -417,6 +514,197 @@ const MatrixExponentialReturnValue<Derived> MatrixBase<Derived>::exp() const
   return MatrixExponentialReturnValue<Derived>(derived());
 }
 
+namespace internal {
+
+/* Lane-wise product C = A * B of batches of k-by-k matrices, stored with one matrix per row and one
+ * coefficient, in column-major order, per column. */
+template <typename ArrayType>
+void matrix_exp_batch_product(const ArrayType& A, const ArrayType& B, ArrayType& C, Index k)
+{
+  typedef Array<typename ArrayType::Scalar, ArrayType::RowsAtCompileTime, 1> LaneVector;
+  LaneVector acc;
+  for (Index j = 0; j < k; ++j)
+    for (Index i = 0; i < k; ++i) {
+      acc = A.col(i) * B.col(j*k);
+      for (Index l = 1; l < k; ++l)
+        acc += A.col(i+l*k) * B.col(l+j*k);
+      C.col(i+j*k) = acc;
+    }
+}
+
+/* Exponentials of a batch of k-by-k matrices by scaling and squaring, the exponential of each scaled
+ * matrix being a truncated Taylor series. Unlike a Pade approximant, the Taylor series does not
+ * require any solve, so that all the operations are performed on fixed-size packets of matrices. */
+template <typename ArgDerived, typename ResultDerived>
+void matrix_exp_batch(const DenseBase<ArgDerived>& args, DenseBase<ResultDerived>& result, Index k)
+{
+  typedef typename ArgDerived::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  enum { Lanes = 16 };
+  typedef Array<Scalar,Lanes,Dynamic> WorkArray;
+  using std::frexp;
+
+  // The scaled matrices have a 1-norm below 2, where the truncation error of the Taylor series of
+  // degree m is below about 2^(m+1)/(m+1)!. The series is evaluated by blocks of 4 terms with the
+  // Paterson-Stockmeyer scheme, with enough blocks to reach the round-off error.
+  const RealScalar maxnorm = RealScalar(2);
+  Index blocks = 0;
+  RealScalar bound = 1;
+  std::vector<RealScalar> coeffs(1, RealScalar(1));
+  while (bound > NumTraits<RealScalar>::epsilon() / 2) {
+    for (int i = 0; i < 4; ++i) {
+      const RealScalar n = RealScalar(coeffs.size());
+      coeffs.push_back(coeffs.back() / n);
+      bound *= maxnorm / n;
+    }
+    ++blocks;
+  }
+  // the terms of degree 4*blocks are the last ones of the truncation error
+  coeffs.pop_back();
+
+  const Index size = args.rows(), kk = k*k;
+  const Index packets = (size + Lanes - 1) / Lanes;
+  Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+  if (omp_get_num_threads() == 1)
+    threads = (std::min)(Index(nbThreads()), packets / 16 + 1);
+#endif
+  EIGEN_UNUSED_VARIABLE(threads);
+
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel num_threads(threads) if(threads>1)
+#endif
+  {
+    WorkArray X(int(Lanes), kk), X2(int(Lanes), kk), X3(int(Lanes), kk), X4(int(Lanes), kk);
+    WorkArray T(int(Lanes), kk), tmp(int(Lanes), kk);
+    Array<int,Lanes,1> squarings;
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (Index c = 0; c < packets; ++c) {
+      // the missing matrices of the last packet are zero
+      const Index start = c * Lanes, lanes = (std::min)(Index(Lanes), size - start);
+      X.topRows(lanes) = args.middleRows(start, lanes).array();
+      X.bottomRows(Lanes - lanes).setZero();
+
+      // scaling, with the number of squarings of each matrix
+      for (Index lane = 0; lane < Lanes; ++lane) {
+        RealScalar l1norm = 0;
+        for (Index j = 0; j < k; ++j)
+          l1norm = (std::max)(l1norm, X.row(lane).segment(j*k, k).abs().sum());
+        int e = 0;
+        if (l1norm > maxnorm)
+          frexp(l1norm / maxnorm, &e);
+        squarings(lane) = e;
+        if (e > 0)
+          X.row(lane) = X.row(lane).unaryExpr(MatrixExponentialScalingOp<RealScalar>(e));
+      }
+
+      // Paterson-Stockmeyer evaluation of the Taylor series
+      matrix_exp_batch_product(X, X, X2, k);
+      matrix_exp_batch_product(X2, X, X3, k);
+      matrix_exp_batch_product(X2, X2, X4, k);
+      for (Index b = blocks - 1; b >= 0; --b) {
+        if (b == blocks - 1) {
+          T.setZero();
+        } else {
+          matrix_exp_batch_product(X4, T, tmp, k);
+          T.swap(tmp);
+        }
+        T += coeffs[4*b+1] * X + coeffs[4*b+2] * X2 + coeffs[4*b+3] * X3;
+        for (Index i = 0; i < k; ++i)
+          T.col(i*(k+1)) += coeffs[4*b];
+      }
+
+      // undo the scaling of each matrix by repeated squaring
+      for (int q = 0; q < squarings.maxCoeff(); ++q) {
+        matrix_exp_batch_product(T, T, tmp, k);
+        for (Index i = 0; i < kk; ++i)
+          T.col(i) = (squarings > q).select(tmp.col(i), T.col(i));
+      }
+      result.middleRows(start, lanes).array() = T.topRows(lanes);
+    }
+  }
+}
+
+} // end namespace Eigen::internal
+
+/** \ingroup MatrixFunctions_Module
+  *
+  * \brief Computes the exponentials of a batch of small square matrices.
+  *
+  * \param[in]  args    array whose rows are the matrices, each row storing the \f$ k^2 \f$ coefficients of a
+  *                     \f$ k \times k \f$ matrix in column-major order.
+  * \param[out] result  array with the same layout, whose rows are the exponentials of the rows of \p args.
+  *
+  * The batch is processed by packets of 16 matrices, with the operations on a coefficient performed for
+  * all the matrices of a packet at once, so that they are vectorized across the matrices. Each matrix is scaled
+  * by its own power of two, the exponential of the scaled matrix is a truncated Taylor series evaluated by
+  * the Paterson-Stockmeyer scheme, and the scaling is undone by repeated squaring. When OpenMP is enabled,
+  * the packets are processed in parallel.
+  *
+  * This is much faster than calling MatrixBase::exp() on each matrix of a large batch, and the accuracy is
+  * similar for matrices of moderate norm. Use so3ExpBatch() for rotation vectors.
+  *
+  * \sa MatrixBase::exp(), so3ExpBatch()
+  */
+template <typename ArgDerived, typename ResultDerived>
+void matrixExpBatch(const DenseBase<ArgDerived>& args, DenseBase<ResultDerived>& result)
+{
+  using std::sqrt;
+  const Index k = Index(sqrt(double(args.cols())) + 0.5);
+  eigen_assert(k*k == args.cols() && "each row of the batch must store a square matrix");
+  result.derived().resize(args.rows(), args.cols());
+  if (args.rows() > 0)
+    internal::matrix_exp_batch(args, result, k);
+}
+
+/** \ingroup MatrixFunctions_Module
+  *
+  * \brief Computes the rotation matrices of a batch of rotation vectors.
+  *
+  * \param[in]  omegas  array whose rows are the rotation vectors \f$ \omega \f$.
+  * \param[out] result  array whose rows are the rotation matrices \f$ \exp([\omega]_\times) \f$, with their 9
+  *                     coefficients in column-major order.
+  *
+  * The rotation matrices are the exponentials of the skew-symmetric matrices \f$ [\omega]_\times \f$,
+  * computed by the Rodrigues formula, with all the operations vectorized across the rotation vectors.
+  *
+  * \sa matrixExpBatch(), MatrixBase::exp()
+  */
+template <typename ArgDerived, typename ResultDerived>
+void so3ExpBatch(const DenseBase<ArgDerived>& omegas, DenseBase<ResultDerived>& result)
+{
+  typedef typename ArgDerived::Scalar Scalar;
+  typedef Array<Scalar,Dynamic,1> VectorType;
+  eigen_assert(omegas.cols() == 3 && "the rotation vectors must be stored as rows of 3 coefficients");
+
+  const Index size = omegas.rows();
+  const VectorType x = omegas.derived().col(0).array();
+  const VectorType y = omegas.derived().col(1).array();
+  const VectorType z = omegas.derived().col(2).array();
+  const VectorType theta2 = x.square() + y.square() + z.square();
+  const VectorType theta = theta2.sqrt();
+  const VectorType halfSinc = (theta / 2).sin() / theta;
+
+  // Taylor expansions below the same angle as internal::matrix_exp_rodrigues_coeffs()
+  const Scalar small = numext::sqrt(NumTraits<Scalar>::epsilon());
+  const VectorType a = (theta2 < small).select(1 - theta2 / 6, theta.sin() / theta);
+  const VectorType b = (theta2 < small).select(Scalar(0.5) - theta2 / 24, 2 * halfSinc.square());
+
+  ResultDerived& res = result.derived();
+  res.resize(size, 9);
+  res.col(0).array() = 1 + b * (x.square() - theta2);
+  res.col(1).array() = a * z + b * x * y;
+  res.col(2).array() = -a * y + b * x * z;
+  res.col(3).array() = -a * z + b * x * y;
+  res.col(4).array() = 1 + b * (y.square() - theta2);
+  res.col(5).array() = a * x + b * y * z;
+  res.col(6).array() = a * y + b * x * z;
+  res.col(7).array() = -a * x + b * y * z;
+  res.col(8).array() = 1 + b * (z.square() - theta2);
+}
+
 } // end namespace Eigen
 
 #endif // EIGEN_MATRIX_EXPONENTIAL
@@ -31,6 +31,15 @@ enum NumericalDiffMode {
   * http://en.wikipedia.org/wiki/Numerical_differentiation
   *
   * Currently only "Forward" and "Central" scheme are implemented.
+  *
+  * When the sparsity pattern of the jacobian is given by setSparsityPattern(),
+  * the columns which do not share any nonzero row are perturbed together, so
+  * that a single evaluation of the functor estimates a whole group of columns.
+  * The jacobian can then also be a column-major SparseMatrix, which gets the
+  * given pattern.
+  *
+  * The evaluations of the functor can be distributed over several threads
+  * with setThreads(), in which case the functor must be thread safe.
   */
 template<typename _Functor, NumericalDiffMode mode=Forward>
 class NumericalDiff : public _Functor
@@ -41,23 +50,61 @@ public:
     typedef typename Functor::InputType InputType;
     typedef typename Functor::ValueType ValueType;
     typedef typename Functor::JacobianType JacobianType;
+    typedef SparseMatrix<Scalar,ColMajor,int> PatternType;
 
-    NumericalDiff(Scalar _epsfcn=0.) : Functor(), epsfcn(_epsfcn) {}
-    NumericalDiff(const Functor& f, Scalar _epsfcn=0.) : Functor(f), epsfcn(_epsfcn) {}
+    NumericalDiff(Scalar _epsfcn=0.) : Functor(), epsfcn(_epsfcn), m_threads(1) {}
+    NumericalDiff(const Functor& f, Scalar _epsfcn=0.) : Functor(f), epsfcn(_epsfcn), m_threads(1) {}
 
     // forward constructors
     template<typename T0>
-        NumericalDiff(const T0& a0) : Functor(a0), epsfcn(0) {}
+        NumericalDiff(const T0& a0) : Functor(a0), epsfcn(0), m_threads(1) {}
     template<typename T0, typename T1>
-        NumericalDiff(const T0& a0, const T1& a1) : Functor(a0, a1), epsfcn(0) {}
+        NumericalDiff(const T0& a0, const T1& a1) : Functor(a0, a1), epsfcn(0), m_threads(1) {}
     template<typename T0, typename T1, typename T2>
-        NumericalDiff(const T0& a0, const T1& a1, const T2& a2) : Functor(a0, a1, a2), epsfcn(0) {}
+        NumericalDiff(const T0& a0, const T1& a1, const T2& a2) : Functor(a0, a1, a2), epsfcn(0), m_threads(1) {}
 
     enum {
         InputsAtCompileTime = Functor::InputsAtCompileTime,
         ValuesAtCompileTime = Functor::ValuesAtCompileTime
     };
 
+    /**
+      * Sets the sparsity pattern of the jacobian, only the positions of the
+      * nonzeros of \a pattern matter. The columns are then grouped by a greedy
+      * coloring, the columns of a group having no nonzero row in common.
+      */
+    template<typename Derived>
+    void setSparsityPattern(const SparseMatrixBase<Derived>& pattern)
+    {
+        m_pattern = pattern.derived().template cast<Scalar>();
+        m_pattern.makeCompressed();
+        computeColoring();
+    }
+
+    /** Removes the sparsity pattern, each column being estimated by its own evaluations */
+    void clearSparsityPattern()
+    {
+        m_pattern.resize(0, 0);
+        m_colorPtr.clear();
+        m_colorColumns.clear();
+    }
+
+    /** \returns the sparsity pattern of the jacobian, empty if not set */
+    const PatternType& sparsityPattern() const { return m_pattern; }
+
+    /** \returns the number of groups of columns estimated together, 0 if no sparsity pattern is set */
+    Index colors() const { return m_colorPtr.empty() ? 0 : Index(m_colorPtr.size())-1; }
+
+    /**
+      * Sets the number of threads evaluating the functor concurrently when
+      * OpenMP is enabled, 0 meaning Eigen::nbThreads(). The default is 1, as
+      * the functor must be thread safe to use several threads.
+      */
+    void setThreads(Index threads) { m_threads = threads; }
+
+    /** \returns the number of threads set by setThreads() */
+    Index threads() const { return m_threads; }
+
     /**
       * return the number of evaluation of functor
      */
@@ -65,22 +112,22 @@ public:
     {
         using std::sqrt;
         using std::abs;
-        /* Local variables */
-        Scalar h;
-        int nfev=0;
-        const typename InputType::Index n = _x.size();
+        const Index n = _x.size();
+        const Index groups = m_pattern.size() ? colors() : n;
         const Scalar eps = sqrt(((std::max)(epsfcn,NumTraits<Scalar>::epsilon() )));
-        ValueType val1, val2;
-        InputType x = _x;
-        // TODO : we should do this only if the size is not already known
-        val1.resize(Functor::values());
-        val2.resize(Functor::values());
+        eigen_assert((m_pattern.size()==0 || m_pattern.cols()==n) && "the sparsity pattern does not match the input size");
+        int nfev=0;
+        ValueType val0;
 
         // initialization
         switch(mode) {
             case Forward:
                 // compute f(x)
-                Functor::operator()(x, val1); nfev++;
+                {
+                    InputType x = _x;
+                    val0.resize(Functor::values());
+                    Functor::operator()(x, val0); nfev++;
+                }
                 break;
             case Central:
                 // do nothing
@@ -89,36 +136,122 @@ public:
                 eigen_assert(false);
         };
 
+        // the steps, which do not depend on the grouping of the columns
+        Matrix<Scalar,Dynamic,1> h(n);
+        for (Index j = 0; j < n; ++j) {
+            h[j] = eps * abs(_x[j]);
+            if (h[j] == 0.) {
+                h[j] = eps;
+            }
+        }
+
+        initJacobian(jac, typename internal::traits<JacobianType>::StorageKind());
+
+        Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+        if(omp_get_num_threads()==1)
+            threads = m_threads==0 ? Index(nbThreads()) : m_threads;
+#endif
+        EIGEN_UNUSED_VARIABLE(threads);
+
         // Function Body
-        for (int j = 0; j < n; ++j) {
-            h = eps * abs(x[j]);
-            if (h == 0.) {
-                h = eps;
+#ifdef EIGEN_HAS_OPENMP
+        #pragma omp parallel num_threads(threads) if(threads>1)
+#endif
+        {
+            // TODO : we should do this only if the size is not already known
+            ValueType val1, val2;
+            InputType x = _x;
+            val1.resize(Functor::values());
+            val2.resize(Functor::values());
+
+#ifdef EIGEN_HAS_OPENMP
+            #pragma omp for schedule(dynamic)
+#endif
+            for (Index g = 0; g < groups; ++g) {
+                const Index begin = m_pattern.size() ? Index(m_colorPtr[g]) : g;
+                const Index end = m_pattern.size() ? Index(m_colorPtr[g+1]) : g+1;
+                switch(mode) {
+                    case Forward:
+                        for (Index k = begin; k < end; ++k)
+                            x[column(k)] += h[column(k)];
+                        Functor::operator()(x, val2);
+                        for (Index k = begin; k < end; ++k) {
+                            const Index j = column(k);
+                            x[j] = _x[j];
+                            setJacobianColumn(jac, j, val2, val0, h[j],
+                                              typename internal::traits<JacobianType>::StorageKind());
+                        }
+                        break;
+                    case Central:
+                        for (Index k = begin; k < end; ++k)
+                            x[column(k)] += h[column(k)];
+                        Functor::operator()(x, val2);
+                        for (Index k = begin; k < end; ++k)
+                            x[column(k)] -= 2*h[column(k)];
+                        Functor::operator()(x, val1);
+                        for (Index k = begin; k < end; ++k) {
+                            const Index j = column(k);
+                            x[j] = _x[j];
+                            setJacobianColumn(jac, j, val2, val1, 2*h[j],
+                                              typename internal::traits<JacobianType>::StorageKind());
+                        }
+                        break;
+                    default:
+                        eigen_assert(false);
+                };
             }
-            switch(mode) {
-                case Forward:
-                    x[j] += h;
-                    Functor::operator()(x, val2);
-                    nfev++;
-                    x[j] = _x[j];
-                    jac.col(j) = (val2-val1)/h;
-                    break;
-                case Central:
-                    x[j] += h;
-                    Functor::operator()(x, val2); nfev++;
-                    x[j] -= 2*h;
-                    Functor::operator()(x, val1); nfev++;
-                    x[j] = _x[j];
-                    jac.col(j) = (val2-val1)/(2*h);
-                    break;
-                default:
-                    eigen_assert(false);
-            };
         }
-        return nfev;
+        return nfev + int(mode==Central ? 2*groups : groups);
     }
 private:
+    // the k-th column sorted by color, or simply the k-th column without sparsity pattern
+    Index column(Index k) const { return m_pattern.size() ? Index(m_colorColumns[k]) : k; }
+
+    void initJacobian(JacobianType &jac, Dense) const
+    {
+        // with a sparsity pattern, the coefficients which are not estimated are zero
+        if (m_pattern.size())
+            jac.setZero(m_pattern.rows(), m_pattern.cols());
+    }
+
+    void initJacobian(JacobianType &jac, Sparse) const
+    {
+        EIGEN_STATIC_ASSERT(!JacobianType::IsRowMajor, THIS_METHOD_IS_ONLY_FOR_COLUMN_MAJOR_MATRICES);
+        eigen_assert(m_pattern.size() && "a sparse jacobian requires a sparsity pattern");
+        jac = m_pattern;
+    }
+
+    void setJacobianColumn(JacobianType &jac, Index j, const ValueType &val2, const ValueType &val1, Scalar h,
+                           Dense) const
+    {
+        if (m_pattern.size()) {
+            for (typename PatternType::InnerIterator it(m_pattern, j); it; ++it)
+                jac(it.index(), j) = (val2[it.index()]-val1[it.index()])/h;
+        }
+        else
+            jac.col(j) = (val2-val1)/h;
+    }
+
+    void setJacobianColumn(JacobianType &jac, Index j, const ValueType &val2, const ValueType &val1, Scalar h,
+                           Sparse) const
+    {
+        for (typename JacobianType::InnerIterator it(jac, j); it; ++it)
+            it.valueRef() = (val2[it.index()]-val1[it.index()])/h;
+    }
+
+    void computeColoring()
+    {
+        // two columns of the same color have no nonzero row in common
+        internal::greedy_coloring(m_pattern.cols(), m_pattern.rows(), m_pattern.innerIndexPtr(), m_pattern.outerIndexPtr(), 0,
+                                  m_colorPtr, m_colorColumns);
+    }
+
     Scalar epsfcn;
+    PatternType m_pattern;
+    std::vector<int> m_colorPtr;       // start of each color in m_colorColumns
+    std::vector<int> m_colorColumns;   // the columns sorted by color
+    Index m_threads;
 
     NumericalDiff& operator=(const NumericalDiff&);
 };
@@ -0,0 +1,212 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_TALL_SKINNY_QR_H
+#define EIGEN_TALL_SKINNY_QR_H
+
+namespace Eigen {
+
+namespace internal {
+
+// Updates, tile by tile, the triangular factor R of the QR factorization of [mat rhs]: the rows of each tile are
+// stacked below the current R, which is replaced by the triangular factor of the stack.
+template<typename WorkMatrixType, typename MatType, typename RhsType>
+struct tall_skinny_qr_kernel
+{
+  tall_skinny_qr_kernel(const MatType& mat, const RhsType& rhs, Index rhsCols, Index tileRows)
+    : m_mat(mat), m_rhs(rhs), m_rhsCols(rhsCols), m_tileRows(tileRows)
+  {}
+
+  void init(Index threads)
+  {
+    const Index cols = m_mat.cols() + m_rhsCols;
+    m_work.assign(threads, WorkMatrixType(cols + m_tileRows, cols));
+    m_qr.resize(threads);
+    m_rows.assign(threads, 0);
+  }
+
+  void prefetch(Index start, Index size) const
+  {
+    tile_stream_prefetch_rows(m_mat, start, size);
+    if(m_rhsCols > 0)
+      tile_stream_prefetch_rows(m_rhs, start, size);
+  }
+
+  void process(Index tid, Index start, Index size)
+  {
+    WorkMatrixType& work = m_work[tid];
+    const Index r = m_rows[tid], cols = work.cols();
+    work.block(r, 0, size, m_mat.cols()) = m_mat.middleRows(start, size);
+    if(m_rhsCols > 0)
+      work.block(r, m_mat.cols(), size, m_rhsCols) = m_rhs.middleRows(start, size);
+    m_qr[tid].compute(work.topRows(r + size));
+    m_rows[tid] = (std::min)(r + size, cols);
+    work.topRows(m_rows[tid]) = m_qr[tid].matrixQR().topRows(m_rows[tid]).template triangularView<Upper>();
+  }
+
+  const MatType& m_mat;
+  const RhsType& m_rhs;
+  Index m_rhsCols;
+  Index m_tileRows;
+  std::vector<WorkMatrixType> m_work;
+  std::vector<HouseholderQR<WorkMatrixType> > m_qr;
+  std::vector<Index> m_rows;
+};
+
+} // end namespace internal
+
+/** \ingroup OutOfCore_Module
+  * \class TallSkinnyQR
+  * \brief Single pass QR factorization of a tall matrix streamed by tiles of rows (TSQR)
+  *
+  * \tparam _MatrixType the type of the matrix of which we are computing the QR decomposition, which is also the
+  *                     type of the computed factors
+  *
+  * This class computes the triangular factor \f$ R \f$ of the QR factorization \f$ A = QR \f$ of a tall matrix
+  * \f$ A \f$ with many more rows than columns, reading \f$ A \f$ once through a TileStream. Each tile of rows is
+  * stacked below the current triangular factor and factorized by HouseholderQR. If OpenMP is enabled, each
+  * thread factorizes its own subset of the tiles, and the triangular factors of the threads are combined at the
+  * end by a last HouseholderQR.
+  *
+  * The orthogonal factor \f$ Q \f$, which has the size of \f$ A \f$, is not stored. Instead, right hand sides
+  * \f$ B \f$ can be passed to compute(), which then returns \f$ Q^* B \f$ and the least squares solution of
+  * \f$ A X = B \f$ from the same pass. This is the factorization \f$ [A\ B] = Q [R\ Q^*B; 0\ S] \f$ of the
+  * augmented matrix, where the columns of the triangular matrix \f$ S \f$ have the norms of the residuals.
+  *
+  * Unlike the normal equations computed by TileStream::normalEquations(), this does not square the condition
+  * number of \f$ A \f$.
+  *
+  * Example:
+  * \code
+  * MappedBinaryFile file("A.bin");
+  * Map<const MatrixXd> A = file.denseMap<MatrixXd>();
+  * TallSkinnyQR<MatrixXd> qr;
+  * qr.stream().setTileRows(1<<16);
+  * qr.compute(A, b);
+  * MatrixXd x = qr.leastSquaresSolution();
+  * \endcode
+  *
+  * \sa TileStream, HouseholderQR
+  */
+template<typename _MatrixType> class TallSkinnyQR
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef Matrix<Scalar,Dynamic,Dynamic,MatrixType::Options&~RowMajor> WorkMatrixType;
+    typedef Matrix<RealScalar,Dynamic,1> RealVectorType;
+
+    TallSkinnyQR() : m_rows(0), m_isInitialized(false) {}
+
+    /** Computes the factorization of \a matrix, \sa compute() */
+    template<typename InputType>
+    explicit TallSkinnyQR(const MatrixBase<InputType>& matrix) : m_rows(0), m_isInitialized(false)
+    {
+      compute(matrix);
+    }
+
+    /** \returns the settings of the tiles used by compute(), which can be modified */
+    TileStream& stream() { return m_stream; }
+    const TileStream& stream() const { return m_stream; }
+
+    /** Computes the triangular factor of \a matrix in a single pass. */
+    template<typename InputType>
+    TallSkinnyQR& compute(const MatrixBase<InputType>& matrix)
+    {
+      return computeImpl(matrix.derived(), matrix.derived(), 0);
+    }
+
+    /** Computes the triangular factor of \a matrix, and the projection \f$ Q^* B \f$ of the right hand sides
+      * \a b, in a single pass over \a matrix and \a b. */
+    template<typename InputType, typename RhsType>
+    TallSkinnyQR& compute(const MatrixBase<InputType>& matrix, const MatrixBase<RhsType>& b)
+    {
+      eigen_assert(matrix.rows() == b.rows());
+      return computeImpl(matrix.derived(), b.derived(), b.cols());
+    }
+
+    Index rows() const { return m_rows; }
+    Index cols() const { return m_matrixR.cols(); }
+
+    /** \returns the upper triangular factor \f$ R \f$, a square matrix whose last rows are zero if the matrix
+      * has less rows than columns */
+    const WorkMatrixType& matrixR() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_matrixR;
+    }
+
+    /** \returns the first cols() rows of \f$ Q^* B \f$, for the right hand sides \f$ B \f$ passed to compute() */
+    const WorkMatrixType& rhsProjection() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_rhsProjection;
+    }
+
+    /** \returns the norms of the residuals \f$ \| A x_j - b_j \| \f$ of the least squares solutions */
+    RealVectorType residualNorms() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_residual.colwise().norm().transpose();
+    }
+
+    /** \returns the least squares solution of \f$ A X = B \f$, for the right hand sides \f$ B \f$ passed to
+      * compute(). The matrix must have full column rank. */
+    WorkMatrixType leastSquaresSolution() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_matrixR.template triangularView<Upper>().solve(m_rhsProjection);
+    }
+
+  protected:
+    template<typename InputType, typename RhsType>
+    TallSkinnyQR& computeImpl(const InputType& matrix, const RhsType& b, Index rhsCols)
+    {
+      const Index cols = matrix.cols() + rhsCols;
+      const Index tileRows = m_stream.template actualTileRows<Scalar>(cols);
+      internal::tall_skinny_qr_kernel<WorkMatrixType,InputType,RhsType> kernel(matrix, b, rhsCols, tileRows);
+      const Index threads = m_stream.run(matrix.rows(), tileRows, kernel);
+
+      // combine the triangular factors of the threads
+      WorkMatrixType R;
+      if(threads == 1)
+        R = kernel.m_work[0].topRows(kernel.m_rows[0]);
+      else
+      {
+        Index stacked = 0;
+        for(Index t = 0; t < threads; ++t)
+          stacked += kernel.m_rows[t];
+        R.resize(stacked, cols);
+        for(Index t = 0, r = 0; t < threads; r += kernel.m_rows[t], ++t)
+          R.middleRows(r, kernel.m_rows[t]) = kernel.m_work[t].topRows(kernel.m_rows[t]);
+        HouseholderQR<WorkMatrixType> qr(R);
+        R = qr.matrixQR().topRows((std::min)(stacked, cols)).template triangularView<Upper>();
+      }
+      WorkMatrixType full = WorkMatrixType::Zero(cols, cols);
+      full.topRows(R.rows()) = R;
+
+      const Index n = matrix.cols();
+      m_matrixR = full.topLeftCorner(n, n);
+      m_rhsProjection = full.topRightCorner(n, rhsCols);
+      m_residual = full.bottomRightCorner(rhsCols, rhsCols);
+      m_rows = matrix.rows();
+      m_isInitialized = true;
+      return *this;
+    }
+
+    TileStream m_stream;
+    WorkMatrixType m_matrixR;
+    WorkMatrixType m_rhsProjection;
+    WorkMatrixType m_residual;
+    Index m_rows;
+    bool m_isInitialized;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_TALL_SKINNY_QR_H
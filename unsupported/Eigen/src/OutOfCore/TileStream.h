@@ -0,0 +1,349 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_TILE_STREAM_H
+#define EIGEN_TILE_STREAM_H
+
+namespace Eigen {
+
+namespace internal {
+
+// Asks the operating system to start loading the pages of the memory range [begin,end), without waiting for them.
+// This is only a hint: it has no effect on memory which is already resident, and is ignored where madvise is missing.
+inline void tile_stream_will_need(const void* begin, const void* end)
+{
+#if !defined(_WIN32) && defined(MADV_WILLNEED)
+  const std::size_t page = std::size_t(::sysconf(_SC_PAGESIZE));
+  const std::size_t first = reinterpret_cast<std::size_t>(begin) & ~(page-1);
+  const std::size_t last = reinterpret_cast<std::size_t>(end);
+  if(last > first)
+    ::madvise(reinterpret_cast<void*>(first), last - first, MADV_WILLNEED);
+#else
+  EIGEN_UNUSED_VARIABLE(begin);
+  EIGEN_UNUSED_VARIABLE(end);
+#endif
+}
+
+// Requests the rows [start,start+size) of a matrix in advance, if its coefficients are stored in memory.
+template<typename Derived, bool HasDirectAccess = bool(traits<Derived>::Flags & DirectAccessBit)>
+struct tile_stream_prefetch
+{
+  static void run(const Derived&, Index, Index) {}
+};
+
+template<typename Derived>
+struct tile_stream_prefetch<Derived, true>
+{
+  static void run(const Derived& mat, Index start, Index size)
+  {
+    typedef typename Derived::Scalar Scalar;
+    if(size <= 0 || mat.cols() == 0)
+      return;
+    const Scalar* data = mat.data();
+    if(Derived::IsRowMajor)
+    {
+      // the rows of the tile are a single range of memory
+      const Scalar* first = data + start*mat.outerStride();
+      tile_stream_will_need(first, first + (size-1)*mat.outerStride() + (mat.cols()-1)*mat.innerStride() + 1);
+    }
+    else
+    {
+      // one range of memory per column
+      for(Index j = 0; j < mat.cols(); ++j)
+      {
+        const Scalar* first = data + j*mat.outerStride() + start*mat.innerStride();
+        tile_stream_will_need(first, first + (size-1)*mat.innerStride() + 1);
+      }
+    }
+  }
+};
+
+template<typename Derived>
+void tile_stream_prefetch_rows(const MatrixBase<Derived>& mat, Index start, Index size)
+{
+  tile_stream_prefetch<Derived>::run(mat.derived(), start, size);
+}
+
+// accumulates lhs^* rhs, tile by tile
+template<typename Lhs, typename Rhs>
+struct tile_stream_adjoint_product_kernel
+{
+  typedef typename scalar_product_traits<typename Lhs::Scalar, typename Rhs::Scalar>::ReturnType Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> ResultType;
+
+  tile_stream_adjoint_product_kernel(const Lhs& lhs, const Rhs& rhs) : m_lhs(lhs), m_rhs(rhs) {}
+
+  void init(Index threads)
+  {
+    m_result.assign(threads, ResultType::Zero(m_lhs.cols(), m_rhs.cols()));
+  }
+
+  void prefetch(Index start, Index size) const
+  {
+    tile_stream_prefetch_rows(m_lhs, start, size);
+    tile_stream_prefetch_rows(m_rhs, start, size);
+  }
+
+  void process(Index tid, Index start, Index size)
+  {
+    m_result[tid].noalias() += m_lhs.middleRows(start, size).adjoint() * m_rhs.middleRows(start, size);
+  }
+
+  const Lhs& m_lhs;
+  const Rhs& m_rhs;
+  std::vector<ResultType> m_result;
+};
+
+// accumulates the lower triangular part of mat^* mat and, if withRhs is true, mat^* rhs, tile by tile
+template<typename MatType, typename Rhs>
+struct tile_stream_normal_equations_kernel
+{
+  typedef typename MatType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> ResultType;
+
+  tile_stream_normal_equations_kernel(const MatType& mat, const Rhs& rhs, bool withRhs)
+    : m_mat(mat), m_rhs(rhs), m_withRhs(withRhs)
+  {}
+
+  void init(Index threads)
+  {
+    m_gram.assign(threads, ResultType::Zero(m_mat.cols(), m_mat.cols()));
+    m_result.assign(threads, ResultType::Zero(m_mat.cols(), m_withRhs ? m_rhs.cols() : 0));
+  }
+
+  void prefetch(Index start, Index size) const
+  {
+    tile_stream_prefetch_rows(m_mat, start, size);
+    if(m_withRhs)
+      tile_stream_prefetch_rows(m_rhs, start, size);
+  }
+
+  void process(Index tid, Index start, Index size)
+  {
+    m_gram[tid].template selfadjointView<Lower>().rankUpdate(m_mat.middleRows(start, size).adjoint());
+    if(m_withRhs)
+      m_result[tid].noalias() += m_mat.middleRows(start, size).adjoint() * m_rhs.middleRows(start, size);
+  }
+
+  const MatType& m_mat;
+  const Rhs& m_rhs;
+  bool m_withRhs;
+  std::vector<ResultType> m_gram;
+  std::vector<ResultType> m_result;
+};
+
+// computes the rows of dst = lhs * rhs, tile by tile
+template<typename Lhs, typename Rhs, typename Dest>
+struct tile_stream_product_kernel
+{
+  tile_stream_product_kernel(const Lhs& lhs, const Rhs& rhs, Dest& dst) : m_lhs(lhs), m_rhs(rhs), m_dst(dst) {}
+
+  void init(Index) {}
+
+  void prefetch(Index start, Index size) const
+  {
+    tile_stream_prefetch_rows(m_lhs, start, size);
+  }
+
+  void process(Index, Index start, Index size)
+  {
+    m_dst.middleRows(start, size).noalias() = m_lhs.middleRows(start, size) * m_rhs;
+  }
+
+  const Lhs& m_lhs;
+  const Rhs& m_rhs;
+  Dest& m_dst;
+};
+
+} // end namespace internal
+
+/** \ingroup OutOfCore_Module
+  * \class TileStream
+  * \brief Single pass products of tall matrices streamed by tiles of rows
+  *
+  * This class computes products involving a tall matrix \f$ A \f$, such as the normal equations
+  * \f$ A^* A \f$ and \f$ A^* b \f$ of a least squares problem, by reading \f$ A \f$ once, tile after tile.
+  * Each tile is a block of tileRows() consecutive rows, and the products of the tiles are computed by the
+  * usual matrix product kernels.
+  *
+  * When the operands are stored in memory, e.g., Map objects of memory-mapped files, the pages of the
+  * next readAhead() tiles are requested from the operating system (madvise) before a tile is processed,
+  * so that reading the storage overlaps with the computations instead of page-faulting at each tile.
+  * If OpenMP is enabled, the tiles are distributed over threads() threads in a round robin fashion,
+  * each thread accumulating its own partial products, such that the storage is still read in order.
+  *
+  * Example:
+  * \code
+  * MappedBinaryFile file("A.bin");
+  * Map<const MatrixXd> A = file.denseMap<MatrixXd>();
+  * MatrixXd AtA;
+  * VectorXd Atb;
+  * TileStream().setTileRows(1<<16).normalEquations(A, b, AtA, Atb);
+  * VectorXd x = AtA.ldlt().solve(Atb);
+  * \endcode
+  *
+  * \sa TallSkinnyQR, MappedBinaryFile
+  */
+class TileStream
+{
+  public:
+    TileStream() : m_tileRows(0), m_readAhead(2), m_threads(0) {}
+
+    /** Sets the number of rows of the tiles. The default value 0 chooses tiles of about 4MB. */
+    TileStream& setTileRows(Index rows)
+    {
+      eigen_assert(rows >= 0);
+      m_tileRows = rows;
+      return *this;
+    }
+
+    /** \returns the number of rows of the tiles set by setTileRows() */
+    Index tileRows() const { return m_tileRows; }
+
+    /** Sets the number of tiles requested in advance by each thread. The default is 2, and 0 disables the
+      * read-ahead. */
+    TileStream& setReadAhead(Index tiles)
+    {
+      eigen_assert(tiles >= 0);
+      m_readAhead = tiles;
+      return *this;
+    }
+
+    /** \returns the number of tiles requested in advance by each thread */
+    Index readAhead() const { return m_readAhead; }
+
+    /** Sets the number of threads processing the tiles concurrently. The default value 0 uses nbThreads(). */
+    TileStream& setThreads(Index threads)
+    {
+      eigen_assert(threads >= 0);
+      m_threads = threads;
+      return *this;
+    }
+
+    /** \returns the number of threads set by setThreads() */
+    Index threads() const { return m_threads; }
+
+    /** \returns the number of rows of the tiles of a matrix of \a cols columns of type \a Scalar */
+    template<typename Scalar>
+    Index actualTileRows(Index cols) const
+    {
+      if(m_tileRows > 0)
+        return m_tileRows;
+      return (std::max)(Index(1), Index(4<<20) / (Index(sizeof(Scalar)) * (std::max)(cols, Index(1))));
+    }
+
+    /** Computes \f$ dst = lhs^* rhs \f$, where \a lhs and \a rhs have the same number of rows. */
+    template<typename Lhs, typename Rhs, typename Dest>
+    void adjointProduct(const MatrixBase<Lhs>& lhs, const MatrixBase<Rhs>& rhs, MatrixBase<Dest>& dst) const
+    {
+      eigen_assert(lhs.rows() == rhs.rows());
+      typedef typename Lhs::Scalar Scalar;
+      internal::tile_stream_adjoint_product_kernel<Lhs,Rhs> kernel(lhs.derived(), rhs.derived());
+      Index threads = run(lhs.rows(), actualTileRows<Scalar>(lhs.cols() + rhs.cols()), kernel);
+      dst.derived().resize(lhs.cols(), rhs.cols());
+      dst = kernel.m_result[0];
+      for(Index t = 1; t < threads; ++t)
+        dst += kernel.m_result[t];
+    }
+
+    /** Computes the Gram matrix \f$ dst = mat^* mat \f$. Only its lower triangular part is computed,
+      * the strictly upper part being filled by symmetry. */
+    template<typename MatType, typename Dest>
+    void gram(const MatrixBase<MatType>& mat, MatrixBase<Dest>& dst) const
+    {
+      typedef typename MatType::Scalar Scalar;
+      internal::tile_stream_normal_equations_kernel<MatType,MatType> kernel(mat.derived(), mat.derived(), false);
+      Index threads = run(mat.rows(), actualTileRows<Scalar>(mat.cols()), kernel);
+      reduceGram(kernel, threads, dst);
+    }
+
+    /** Computes the normal equations \f$ gram = mat^* mat \f$ and \f$ rhs = mat^* b \f$ of the least squares
+      * problem \f$ \min \| mat\, x - b \| \f$ in a single pass over \a mat and \a b. */
+    template<typename MatType, typename RhsType, typename GramType, typename Dest>
+    void normalEquations(const MatrixBase<MatType>& mat, const MatrixBase<RhsType>& b,
+                         MatrixBase<GramType>& gram, MatrixBase<Dest>& rhs) const
+    {
+      eigen_assert(mat.rows() == b.rows());
+      typedef typename MatType::Scalar Scalar;
+      internal::tile_stream_normal_equations_kernel<MatType,RhsType> kernel(mat.derived(), b.derived(), true);
+      Index threads = run(mat.rows(), actualTileRows<Scalar>(mat.cols() + b.cols()), kernel);
+      reduceGram(kernel, threads, gram);
+      rhs.derived().resize(mat.cols(), b.cols());
+      rhs = kernel.m_result[0];
+      for(Index t = 1; t < threads; ++t)
+        rhs += kernel.m_result[t];
+    }
+
+    /** Computes \f$ dst = lhs\, rhs \f$ for a tall \a lhs, tile by tile. The tiles of \a dst are written once,
+      * so that \a dst can also be a Map of a writable memory-mapped file. */
+    template<typename Lhs, typename Rhs, typename Dest>
+    void product(const MatrixBase<Lhs>& lhs, const MatrixBase<Rhs>& rhs, MatrixBase<Dest>& dst) const
+    {
+      eigen_assert(lhs.cols() == rhs.rows());
+      typedef typename Lhs::Scalar Scalar;
+      dst.derived().resize(lhs.rows(), rhs.cols());
+      internal::tile_stream_product_kernel<Lhs,Rhs,Dest> kernel(lhs.derived(), rhs.derived(), dst.derived());
+      run(lhs.rows(), actualTileRows<Scalar>(lhs.cols() + rhs.cols()), kernel);
+    }
+
+    /** \internal
+      * Calls \c kernel.process(tid,start,size) for the consecutive tiles of \a tileRows rows covering \a rows rows,
+      * and \c kernel.prefetch(start,size) for the tiles to read in advance.
+      * \returns the number of threads, for which \c kernel.init(threads) is called first. */
+    template<typename Kernel>
+    Index run(Index rows, Index tileRows, Kernel& kernel) const
+    {
+      eigen_assert(tileRows > 0);
+      const Index tiles = (rows + tileRows - 1) / tileRows;
+      Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+      if(omp_get_num_threads()==1)
+        threads = (std::max)(Index(1), (std::min)(m_threads==0 ? Index(nbThreads()) : m_threads, tiles));
+#endif
+      kernel.init(threads);
+
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp parallel num_threads(threads) if(threads>1)
+#endif
+      {
+        Index tid = 0, actual_threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+        tid = omp_get_thread_num();
+        actual_threads = omp_get_num_threads();
+#endif
+        const Index distance = actual_threads * m_readAhead;
+        for(Index t = tid; t < (std::min)(distance, tiles); t += actual_threads)
+          kernel.prefetch(t*tileRows, (std::min)(tileRows, rows - t*tileRows));
+        for(Index t = tid; t < tiles; t += actual_threads)
+        {
+          if(m_readAhead > 0 && t + distance < tiles)
+            kernel.prefetch((t+distance)*tileRows, (std::min)(tileRows, rows - (t+distance)*tileRows));
+          kernel.process(tid, t*tileRows, (std::min)(tileRows, rows - t*tileRows));
+        }
+      }
+      return threads;
+    }
+
+  protected:
+    template<typename Kernel, typename Dest>
+    static void reduceGram(const Kernel& kernel, Index threads, MatrixBase<Dest>& dst)
+    {
+      typename Kernel::ResultType gram = kernel.m_gram[0];
+      for(Index t = 1; t < threads; ++t)
+        gram.template triangularView<Lower>() += kernel.m_gram[t];
+      dst.derived().resize(gram.rows(), gram.cols());
+      dst = gram.template selfadjointView<Lower>();
+    }
+
+    Index m_tileRows;
+    Index m_readAhead;
+    Index m_threads;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_TILE_STREAM_H
@@ -0,0 +1,485 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_BINARY_IO_H
+#define EIGEN_SPARSE_BINARY_IO_H
+
+namespace Eigen {
+
+namespace internal
+{
+  // Layout of the binary files (version 1):
+  //  - a binary_io_header of 256 bytes,
+  //  - for dense matrices and tensors, the coefficients in storage order,
+  //  - for sparse matrices, the outer index (outerSize+1 entries), the inner indices and the values of the
+  //    compressed storage.
+  // Each array starts at an offset multiple of 64 bytes, all the data are in the native byte order.
+  enum {
+    BinaryIOVersion = 1,
+    BinaryIODense = 0,
+    BinaryIOSparse = 1,
+    BinaryIOTensor = 2,
+    BinaryIOMaxRank = 16,
+    BinaryIOAlignment = 64
+  };
+
+  struct binary_io_header
+  {
+    char magic[8];             // "EIGENBIN"
+    uint32_t byteOrder;        // 0x01020304 written in the native byte order
+    uint32_t version;
+    uint32_t kind;             // BinaryIODense, BinaryIOSparse or BinaryIOTensor
+    uint32_t scalarType;       // binary_io_scalar<Scalar>::Code, 0 for other types
+    uint32_t scalarSize;
+    uint32_t indexSize;        // size of the StorageIndex of sparse matrices
+    uint32_t rowMajor;
+    uint32_t rank;             // 2 for matrices
+    int64_t dims[BinaryIOMaxRank];
+    int64_t nonZeros;          // number of stored coefficients
+    char reserved[256 - 40 - 8*BinaryIOMaxRank - 8];
+  };
+
+  template<typename Scalar> struct binary_io_scalar { enum { Code = 0 }; };
+  template<> struct binary_io_scalar<float> { enum { Code = 1 }; };
+  template<> struct binary_io_scalar<double> { enum { Code = 2 }; };
+  template<> struct binary_io_scalar<std::complex<float> > { enum { Code = 3 }; };
+  template<> struct binary_io_scalar<std::complex<double> > { enum { Code = 4 }; };
+  template<> struct binary_io_scalar<int> { enum { Code = 5 }; };
+  template<> struct binary_io_scalar<long double> { enum { Code = 6 }; };
+
+  inline std::streamoff binary_io_align(std::streamoff offset)
+  {
+    return (offset + BinaryIOAlignment - 1) / BinaryIOAlignment * BinaryIOAlignment;
+  }
+
+  template<typename Scalar>
+  inline void binary_io_init_header(binary_io_header& header, int kind, int rank, bool rowMajor, int indexSize)
+  {
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "EIGENBIN", 8);
+    header.byteOrder = 0x01020304;
+    header.version = BinaryIOVersion;
+    header.kind = kind;
+    header.scalarType = binary_io_scalar<Scalar>::Code;
+    header.scalarSize = sizeof(Scalar);
+    header.indexSize = indexSize;
+    header.rowMajor = rowMajor ? 1 : 0;
+    header.rank = rank;
+  }
+
+  /** \internal \returns whether \a header is a valid header of the given kind for coefficients of type \a Scalar */
+  template<typename Scalar>
+  inline bool binary_io_check_header(const binary_io_header& header, int kind)
+  {
+    return std::memcmp(header.magic, "EIGENBIN", 8) == 0
+        && header.byteOrder == 0x01020304
+        && header.version == BinaryIOVersion
+        && int(header.kind) == kind
+        && int(header.scalarType) == int(binary_io_scalar<Scalar>::Code)
+        && header.scalarSize == sizeof(Scalar)
+        && header.rank <= BinaryIOMaxRank;
+  }
+
+  /** \internal Writes the array \a data of \a size elements at the next aligned offset of \a out */
+  template<typename T>
+  inline void binary_io_write_array(std::ofstream& out, const T* data, Index size)
+  {
+    static const char padding[BinaryIOAlignment] = {0};
+    std::streamoff pos = out.tellp();
+    out.write(padding, binary_io_align(pos) - pos);
+    if(size > 0)
+      out.write(reinterpret_cast<const char*>(data), std::streamsize(size * sizeof(T)));
+  }
+
+  /** \internal Reads the array \a data of \a size elements at the next aligned offset of \a in */
+  template<typename T>
+  inline void binary_io_read_array(std::ifstream& in, T* data, Index size)
+  {
+    in.seekg(binary_io_align(in.tellg()));
+    if(size > 0)
+      in.read(reinterpret_cast<char*>(data), std::streamsize(size * sizeof(T)));
+  }
+
+  template<typename Scalar>
+  inline bool binary_io_write_dense(const std::string& filename, const Scalar* data, int kind, int rank, const Index* dims, bool rowMajor)
+  {
+    binary_io_header header;
+    binary_io_init_header<Scalar>(header, kind, rank, rowMajor, 0);
+    Index size = 1;
+    for(int i = 0; i < rank; ++i)
+    {
+      header.dims[i] = dims[i];
+      size *= dims[i];
+    }
+    header.nonZeros = size;
+
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+    if(!out)
+      return false;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    binary_io_write_array(out, data, size);
+    return bool(out);
+  }
+
+  /** \internal Reads the header of the file \a filename, and leaves \a in at the end of the header */
+  template<typename Scalar>
+  inline bool binary_io_read_header(std::ifstream& in, const std::string& filename, binary_io_header& header, int kind)
+  {
+    in.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if(!in)
+      return false;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    return bool(in) && binary_io_check_header<Scalar>(header, kind);
+  }
+}
+
+/** \ingroup SparseExtra_Module
+  * Saves the dense matrix or array \a mat to the file \a filename in the Eigen binary format.
+  *
+  * The file starts with a versioned header describing the scalar type, storage order and dimensions, followed by
+  * the raw coefficients. Such a file is read back by loadBinary(), or mapped in memory without any copy with
+  * MappedBinaryFile.
+  *
+  * \returns true on success
+  */
+template<typename Derived>
+bool saveBinary(const PlainObjectBase<Derived>& mat, const std::string& filename)
+{
+  Index dims[2] = { mat.rows(), mat.cols() };
+  return internal::binary_io_write_dense(filename, mat.data(), internal::BinaryIODense, 2, dims, Derived::IsRowMajor);
+}
+
+/** \ingroup SparseExtra_Module
+  * Loads the dense matrix or array \a mat from the file \a filename written by saveBinary().
+  *
+  * \returns false if the file cannot be read, or if its scalar type, storage order or fixed sizes do not match the ones
+  * of \a mat (the storage order and orientation of vectors do not matter)
+  */
+template<typename Derived>
+bool loadBinary(PlainObjectBase<Derived>& mat, const std::string& filename)
+{
+  std::ifstream in;
+  internal::binary_io_header header;
+  if(!internal::binary_io_read_header<typename Derived::Scalar>(in, filename, header, internal::BinaryIODense)
+     || header.rank != 2
+     || (bool(header.rowMajor) != bool(Derived::IsRowMajor) && header.dims[0] != 1 && header.dims[1] != 1))
+    return false;
+  Index rows = Index(header.dims[0]), cols = Index(header.dims[1]);
+  if(Derived::IsVectorAtCompileTime && (rows==1 || cols==1))
+  {
+    if(Derived::SizeAtCompileTime!=Dynamic && Derived::SizeAtCompileTime!=rows*cols)
+      return false;
+    if(Derived::RowsAtCompileTime==1)
+      mat.resize(1, rows*cols);
+    else
+      mat.resize(rows*cols, 1);
+  }
+  else
+  {
+    if((Derived::RowsAtCompileTime!=Dynamic && Derived::RowsAtCompileTime!=rows)
+       || (Derived::ColsAtCompileTime!=Dynamic && Derived::ColsAtCompileTime!=cols))
+      return false;
+    mat.resize(rows, cols);
+  }
+  internal::binary_io_read_array(in, mat.data(), mat.size());
+  return bool(in);
+}
+
+/** \ingroup SparseExtra_Module
+  * Saves the sparse matrix \a mat to the file \a filename in the Eigen binary format: the arrays of its compressed
+  * storage are written as is, after a versioned header describing the scalar and index types, the storage order,
+  * the dimensions and the number of nonzeros.
+  *
+  * \returns true on success
+  */
+template<typename Scalar, int Options, typename StorageIndex>
+bool saveBinary(const SparseMatrix<Scalar,Options,StorageIndex>& mat, const std::string& filename)
+{
+  typedef SparseMatrix<Scalar,Options,StorageIndex> SparseMatrixType;
+  if(!mat.isCompressed())
+  {
+    SparseMatrixType compressed(mat);
+    compressed.makeCompressed();
+    return saveBinary(compressed, filename);
+  }
+
+  internal::binary_io_header header;
+  internal::binary_io_init_header<Scalar>(header, internal::BinaryIOSparse, 2, SparseMatrixType::IsRowMajor, sizeof(StorageIndex));
+  header.dims[0] = mat.rows();
+  header.dims[1] = mat.cols();
+  header.nonZeros = mat.nonZeros();
+
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+  if(!out)
+    return false;
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  internal::binary_io_write_array(out, mat.outerIndexPtr(), mat.outerSize()+1);
+  internal::binary_io_write_array(out, mat.innerIndexPtr(), mat.nonZeros());
+  internal::binary_io_write_array(out, mat.valuePtr(), mat.nonZeros());
+  return bool(out);
+}
+
+/** \ingroup SparseExtra_Module
+  * Loads the sparse matrix \a mat from the file \a filename written by saveBinary(). The arrays of the compressed
+  * storage are directly read in the ones of \a mat if its storage order is the one of the file, and transposed
+  * otherwise.
+  *
+  * \returns false if the file cannot be read, or if its scalar or index types do not match the ones of \a mat
+  */
+template<typename Scalar, int Options, typename StorageIndex>
+bool loadBinary(SparseMatrix<Scalar,Options,StorageIndex>& mat, const std::string& filename)
+{
+  typedef SparseMatrix<Scalar,Options,StorageIndex> SparseMatrixType;
+  std::ifstream in;
+  internal::binary_io_header header;
+  if(!internal::binary_io_read_header<Scalar>(in, filename, header, internal::BinaryIOSparse)
+     || header.rank != 2 || header.indexSize != sizeof(StorageIndex))
+    return false;
+
+  if(bool(header.rowMajor) != bool(SparseMatrixType::IsRowMajor))
+  {
+    SparseMatrix<Scalar,SparseMatrixType::IsRowMajor ? ColMajor : RowMajor,StorageIndex> tmp;
+    if(!loadBinary(tmp, filename))
+      return false;
+    mat = tmp;
+    return true;
+  }
+
+  mat.resize(Index(header.dims[0]), Index(header.dims[1]));
+  mat.resizeNonZeros(Index(header.nonZeros));
+  internal::binary_io_read_array(in, mat.outerIndexPtr(), mat.outerSize()+1);
+  internal::binary_io_read_array(in, mat.innerIndexPtr(), mat.nonZeros());
+  internal::binary_io_read_array(in, mat.valuePtr(), mat.nonZeros());
+  return bool(in);
+}
+
+/** \ingroup SparseExtra_Module
+  * Saves the tensor \a tensor of the Tensor module to the file \a filename in the Eigen binary format.
+  *
+  * \returns true on success
+  */
+template<typename TensorType>
+bool saveTensorBinary(const TensorType& tensor, const std::string& filename)
+{
+  enum { Rank = TensorType::NumIndices };
+  EIGEN_STATIC_ASSERT(Rank <= int(internal::BinaryIOMaxRank), YOU_MADE_A_PROGRAMMING_MISTAKE)
+  Index dims[Rank > 0 ? Rank : 1];
+  for(int i = 0; i < Rank; ++i)
+    dims[i] = tensor.dimension(i);
+  return internal::binary_io_write_dense(filename, tensor.data(), internal::BinaryIOTensor, Rank, dims,
+                                         int(TensorType::Layout)==RowMajor);
+}
+
+/** \ingroup SparseExtra_Module
+  * Loads the tensor \a tensor of the Tensor module from the file \a filename written by saveTensorBinary().
+  *
+  * \returns false if the file cannot be read, or if its scalar type, rank or layout do not match the ones of \a tensor
+  */
+template<typename TensorType>
+bool loadTensorBinary(TensorType& tensor, const std::string& filename)
+{
+  enum { Rank = TensorType::NumIndices };
+  std::ifstream in;
+  internal::binary_io_header header;
+  if(!internal::binary_io_read_header<typename TensorType::Scalar>(in, filename, header, internal::BinaryIOTensor)
+     || int(header.rank) != int(Rank) || bool(header.rowMajor) != (int(TensorType::Layout)==RowMajor))
+    return false;
+  typename TensorType::Dimensions dims;
+  for(int i = 0; i < Rank; ++i)
+    dims[i] = Index(header.dims[i]);
+  tensor.resize(dims);
+  internal::binary_io_read_array(in, tensor.data(), tensor.size());
+  return bool(in);
+}
+
+#if !defined(_WIN32)
+
+/** \ingroup SparseExtra_Module
+  * \brief A read-only memory mapping of a file in the Eigen binary format
+  *
+  * This class maps a file written by saveBinary() or saveTensorBinary() in memory, and gives access to its content
+  * through Map, Map<SparseMatrix> (aka MappedSparseMatrix) and TensorMap objects referencing the mapped data without
+  * any copy. The pages are loaded by the operating system on demand, such that opening the file is immediate
+  * whatever its size. The maps are valid as long as the MappedBinaryFile object is open.
+  *
+  * Example:
+  * \code
+  * saveBinary(A, "A.bin");
+  * MappedBinaryFile file("A.bin");
+  * Map<const SparseMatrix<double> > Am = file.sparseMap<SparseMatrix<double> >();
+  * VectorXd y = Am * x;
+  * \endcode
+  *
+  * This class is only available on POSIX systems.
+  */
+class MappedBinaryFile
+{
+  public:
+    MappedBinaryFile() : m_data(0), m_size(0), m_header(0) {}
+
+    /** Maps the file \a filename, see isOpen() */
+    explicit MappedBinaryFile(const std::string& filename) : m_data(0), m_size(0), m_header(0)
+    {
+      open(filename);
+    }
+
+    ~MappedBinaryFile() { close(); }
+
+    /** Maps the file \a filename.
+      * \returns false if the file cannot be mapped or is not a valid file in the Eigen binary format */
+    bool open(const std::string& filename)
+    {
+      close();
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if(fd < 0)
+        return false;
+      struct stat st;
+      if(::fstat(fd, &st) == 0 && std::size_t(st.st_size) >= sizeof(internal::binary_io_header))
+      {
+        void* data = ::mmap(0, std::size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if(data != MAP_FAILED)
+        {
+          m_data = static_cast<const char*>(data);
+          m_size = std::size_t(st.st_size);
+          m_header = reinterpret_cast<const internal::binary_io_header*>(m_data);
+        }
+      }
+      ::close(fd);
+      if(m_header && (std::memcmp(m_header->magic, "EIGENBIN", 8) != 0 || m_header->byteOrder != 0x01020304
+                      || m_header->version != internal::BinaryIOVersion || m_header->rank > internal::BinaryIOMaxRank))
+        close();
+      return isOpen();
+    }
+
+    /** Unmaps the file, invalidating all the maps of its content */
+    void close()
+    {
+      if(m_data)
+        ::munmap(const_cast<char*>(m_data), m_size);
+      m_data = 0;
+      m_size = 0;
+      m_header = 0;
+    }
+
+    bool isOpen() const { return m_header != 0; }
+
+    /** \returns true if the file contains a sparse matrix */
+    bool isSparse() const { eigen_assert(isOpen()); return m_header->kind == internal::BinaryIOSparse; }
+    /** \returns true if the file contains a tensor */
+    bool isTensor() const { eigen_assert(isOpen()); return m_header->kind == internal::BinaryIOTensor; }
+    bool isRowMajor() const { eigen_assert(isOpen()); return m_header->rowMajor != 0; }
+    /** \returns the number of dimensions, which is 2 for matrices */
+    Index rank() const { eigen_assert(isOpen()); return Index(m_header->rank); }
+    Index dimension(Index i) const { eigen_assert(isOpen() && i < rank()); return Index(m_header->dims[i]); }
+    Index rows() const { return dimension(0); }
+    Index cols() const { return dimension(1); }
+    /** \returns the number of stored coefficients */
+    Index nonZeros() const { eigen_assert(isOpen()); return Index(m_header->nonZeros); }
+
+    /** \returns whether the file contains a dense matrix which can be mapped as a \a MatrixType */
+    template<typename MatrixType>
+    bool isDenseOf() const
+    {
+      return isOpen() && internal::binary_io_check_header<typename MatrixType::Scalar>(*m_header, internal::BinaryIODense)
+          && rank()==2 && (isRowMajor()==bool(MatrixType::IsRowMajor) || rows()==1 || cols()==1)
+          && (MatrixType::RowsAtCompileTime==Dynamic || MatrixType::RowsAtCompileTime==rows())
+          && (MatrixType::ColsAtCompileTime==Dynamic || MatrixType::ColsAtCompileTime==cols())
+          && fits(dataOffset() + nonZeros()*Index(sizeof(typename MatrixType::Scalar)));
+    }
+
+    /** \returns whether the file contains a sparse matrix which can be mapped as a \a SparseMatrixType */
+    template<typename SparseMatrixType>
+    bool isSparseOf() const
+    {
+      typedef typename SparseMatrixType::Scalar Scalar;
+      typedef typename SparseMatrixType::StorageIndex StorageIndex;
+      return isOpen() && internal::binary_io_check_header<Scalar>(*m_header, internal::BinaryIOSparse)
+          && rank()==2 && isRowMajor()==bool(SparseMatrixType::IsRowMajor) && m_header->indexSize==sizeof(StorageIndex)
+          && fits(sparseOffsets<Scalar,StorageIndex>(2) + nonZeros()*Index(sizeof(Scalar)));
+    }
+
+    /** \returns whether the file contains a tensor which can be mapped as a \a TensorMapType */
+    template<typename TensorMapType>
+    bool isTensorOf() const
+    {
+      typedef typename TensorMapType::Scalar Scalar;
+      return isOpen() && internal::binary_io_check_header<typename internal::remove_const<Scalar>::type>(*m_header, internal::BinaryIOTensor)
+          && rank()==Index(TensorMapType::NumIndices) && isRowMajor()==(int(TensorMapType::Layout)==RowMajor)
+          && fits(dataOffset() + nonZeros()*Index(sizeof(Scalar)));
+    }
+
+    /** \returns a read-only Map of the dense matrix stored in the file
+      * \sa isDenseOf() */
+    template<typename MatrixType>
+    Map<const MatrixType> denseMap() const
+    {
+      eigen_assert(isDenseOf<MatrixType>() && "MappedBinaryFile::denseMap(): the file does not contain such a matrix");
+      return Map<const MatrixType>(reinterpret_cast<const typename MatrixType::Scalar*>(m_data + dataOffset()), rows(), cols());
+    }
+
+    /** \returns a read-only Map of the compressed sparse matrix stored in the file
+      * \sa isSparseOf() */
+    template<typename SparseMatrixType>
+    Map<const SparseMatrixType> sparseMap() const
+    {
+      typedef typename SparseMatrixType::Scalar Scalar;
+      typedef typename SparseMatrixType::StorageIndex StorageIndex;
+      eigen_assert(isSparseOf<SparseMatrixType>() && "MappedBinaryFile::sparseMap(): the file does not contain such a matrix");
+      return Map<const SparseMatrixType>(rows(), cols(), nonZeros(),
+                                         reinterpret_cast<const StorageIndex*>(m_data + sparseOffsets<Scalar,StorageIndex>(0)),
+                                         reinterpret_cast<const StorageIndex*>(m_data + sparseOffsets<Scalar,StorageIndex>(1)),
+                                         reinterpret_cast<const Scalar*>(m_data + sparseOffsets<Scalar,StorageIndex>(2)));
+    }
+
+    /** \returns a TensorMap of the tensor stored in the file. The \a TensorMapType must reference constant
+      * coefficients, e.g., TensorMap<const Tensor<float,3> >.
+      * \sa isTensorOf() */
+    template<typename TensorMapType>
+    TensorMapType tensorMap() const
+    {
+      eigen_assert(isTensorOf<TensorMapType>() && "MappedBinaryFile::tensorMap(): the file does not contain such a tensor");
+      typename TensorMapType::Dimensions dims;
+      for(Index i = 0; i < rank(); ++i)
+        dims[i] = dimension(i);
+      // TensorMap takes a non-const pointer even for constant tensors
+      const typename TensorMapType::Scalar* data = reinterpret_cast<const typename TensorMapType::Scalar*>(m_data + dataOffset());
+      return TensorMapType(const_cast<typename TensorMapType::PointerArgType>(data), dims);
+    }
+
+  protected:
+    // offset of the first array following the header
+    static Index dataOffset() { return Index(internal::binary_io_align(sizeof(internal::binary_io_header))); }
+
+    // offsets of the outer index, inner indices and values of a sparse matrix
+    template<typename Scalar, typename StorageIndex>
+    Index sparseOffsets(int array) const
+    {
+      Index outerSize = isRowMajor() ? rows() : cols();
+      Index offset = dataOffset();
+      if(array > 0)
+        offset = Index(internal::binary_io_align(offset + (outerSize+1)*Index(sizeof(StorageIndex))));
+      if(array > 1)
+        offset = Index(internal::binary_io_align(offset + nonZeros()*Index(sizeof(StorageIndex))));
+      return offset;
+    }
+
+    bool fits(Index end) const { return end >= 0 && std::size_t(end) <= m_size; }
+
+    const char* m_data;
+    std::size_t m_size;
+    const internal::binary_io_header* m_header;
+
+  private:
+    MappedBinaryFile(const MappedBinaryFile&);
+    MappedBinaryFile& operator=(const MappedBinaryFile&);
+};
+
+#endif // !defined(_WIN32)
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_BINARY_IO_H
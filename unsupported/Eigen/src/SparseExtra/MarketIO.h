@@ -104,6 +104,309 @@ namespace internal
     out << value.real << " " << value.imag()<< "\n"; 
   }
 
+
+  // Fast parsers of the numbers of the Matrix Market files. They advance p after the parsed number and return false
+  // if no number is found before the end of the line.
+
+  inline void market_skip_blanks(const char*& p, const char* end)
+  {
+    while(p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+      ++p;
+  }
+
+  inline bool market_parse_integer(const char*& p, const char* end, Index& value)
+  {
+    market_skip_blanks(p, end);
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+'))
+      negative = (*p++ == '-');
+    if(p == end || *p < '0' || *p > '9')
+      return false;
+    Index v = 0;
+    while(p < end && *p >= '0' && *p <= '9')
+      v = v*10 + (*p++ - '0');
+    value = negative ? -v : v;
+    return true;
+  }
+
+  inline bool market_parse_real(const char*& p, const char* end, double& value)
+  {
+    static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    market_skip_blanks(p, end);
+    const char* start = p;
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+'))
+      negative = (*p++ == '-');
+
+    // the decimal digits are accumulated in an integer mantissa as long as it is exact
+    unsigned long long mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool valid = false;
+    for(; p < end && *p >= '0' && *p <= '9'; ++p, valid = true)
+    {
+      if(digits < 19) { mantissa = mantissa*10 + (*p - '0'); digits += mantissa != 0; }
+      else            ++exponent;
+    }
+    if(p < end && *p == '.')
+    {
+      for(++p; p < end && *p >= '0' && *p <= '9'; ++p, valid = true)
+      {
+        if(digits < 19) { mantissa = mantissa*10 + (*p - '0'); digits += mantissa != 0; --exponent; }
+      }
+    }
+    if(valid && p < end && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D'))
+    {
+      ++p;
+      Index e;
+      if(!market_parse_integer(p, end, e))
+        valid = false;
+      else
+        exponent += int((std::max)(Index(-9999), (std::min)(e, Index(9999))));
+    }
+
+    if(valid && p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+      valid = false;
+    if(valid && mantissa < (1ULL << 53) && exponent >= -22 && exponent <= 22)
+    {
+      // both the mantissa and the power of ten are exact, so is the correctly rounded result of their product
+      double v = double(mantissa);
+      v = exponent < 0 ? v / pow10[-exponent] : v * pow10[exponent];
+      value = negative ? -v : v;
+      return true;
+    }
+
+    // slow path for the long mantissas, large exponents, and special values
+    p = start;
+    char buffer[128];
+    int size = 0;
+    while(p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' && size < 127)
+    {
+      buffer[size++] = (*p == 'd' || *p == 'D') ? 'e' : *p;
+      ++p;
+    }
+    buffer[size] = '\0';
+    char* parsed;
+    value = std::strtod(buffer, &parsed);
+    return size > 0 && parsed == buffer + size;
+  }
+
+  template<typename Scalar>
+  inline bool market_parse_value(const char*& p, const char* end, Scalar& value)
+  {
+    double v;
+    if(!market_parse_real(p, end, v))
+      return false;
+    value = Scalar(v);
+    return true;
+  }
+
+  template<typename RealScalar>
+  inline bool market_parse_value(const char*& p, const char* end, std::complex<RealScalar>& value)
+  {
+    double re, im;
+    if(!market_parse_real(p, end, re) || !market_parse_real(p, end, im))
+      return false;
+    value = std::complex<RealScalar>(RealScalar(re), RealScalar(im));
+    return true;
+  }
+
+  // the data lines are the non empty lines which are not comments
+  inline bool market_is_data_line(const char* p, const char* end)
+  {
+    market_skip_blanks(p, end);
+    return p < end && *p != '\n' && *p != '%';
+  }
+
+  inline Index market_count_lines(const char* begin, const char* end)
+  {
+    Index count = 0;
+    for(const char* p = begin; p < end; )
+    {
+      const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+      if(eol == 0)
+        eol = end;
+      count += market_is_data_line(p, eol);
+      p = eol + 1;
+    }
+    return count;
+  }
+
+  /** \internal Parses the entries of the lines [begin,end) into the arrays starting at \a first.
+    * The invalid entries get a negative row index. */
+  template<typename Scalar, typename StorageIndex>
+  void market_parse_lines(const char* begin, const char* end, Index rows, Index cols, bool pattern,
+                          StorageIndex* rowIndices, StorageIndex* colIndices, Scalar* values, Index first)
+  {
+    Index k = first;
+    for(const char* p = begin; p < end; )
+    {
+      const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+      if(eol == 0)
+        eol = end;
+      if(market_is_data_line(p, eol))
+      {
+        Index i, j;
+        Scalar value(1);
+        bool ok = market_parse_integer(p, eol, i) && market_parse_integer(p, eol, j)
+               && (pattern || market_parse_value(p, eol, value))
+               && i >= 1 && j >= 1 && i <= rows && j <= cols;
+        rowIndices[k] = ok ? StorageIndex(i-1) : StorageIndex(-1);
+        colIndices[k] = ok ? StorageIndex(j-1) : StorageIndex(-1);
+        values[k] = value;
+        ++k;
+      }
+      p = eol + 1;
+    }
+  }
+
+  /** \internal Parses the block of complete lines [begin,end) into the arrays, from the entry \a count which is
+    * updated. The block is split into ranges of lines parsed in parallel if OpenMP is enabled. The arrays, sized from
+    * the header, grow if the file has more entries. */
+  template<typename Scalar, typename StorageIndex>
+  void market_parse_block(const char* begin, const char* end, Index rows, Index cols, bool pattern,
+                          std::vector<StorageIndex>& rowIndices, std::vector<StorageIndex>& colIndices,
+                          std::vector<Scalar>& values, Index& count)
+  {
+    Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+    if(omp_get_num_threads()==1)
+      threads = (std::min)(Index(nbThreads()), Index((end-begin) >> 20) + 1);
+#endif
+    // split at line boundaries
+    std::vector<const char*> bounds(threads+1);
+    bounds[0] = begin;
+    bounds[threads] = end;
+    for(Index t = 1; t < threads; ++t)
+    {
+      const char* p = begin + ((end-begin)*t)/threads;
+      if(p < bounds[t-1])
+        p = bounds[t-1];
+      const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+      bounds[t] = eol ? eol+1 : end;
+    }
+
+    // first pass counting the entries of each range, second pass parsing them at their final position
+    std::vector<Index> offsets(threads+1, 0);
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for schedule(static,1) num_threads(threads) if(threads>1)
+#endif
+    for(Index t = 0; t < threads; ++t)
+      offsets[t+1] = market_count_lines(bounds[t], bounds[t+1]);
+    offsets[0] = count;
+    for(Index t = 0; t < threads; ++t)
+      offsets[t+1] += offsets[t];
+    if(offsets[threads] == count)
+      return;
+    if(offsets[threads] > Index(rowIndices.size()))
+    {
+      const Index capacity = (std::max)(offsets[threads], 2*Index(rowIndices.size()));
+      rowIndices.resize(capacity);
+      colIndices.resize(capacity);
+      values.resize(capacity);
+    }
+
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for schedule(static,1) num_threads(threads) if(threads>1)
+#endif
+    for(Index t = 0; t < threads; ++t)
+      market_parse_lines(bounds[t], bounds[t+1], rows, cols, pattern, &rowIndices[0], &colIndices[0], &values[0], offsets[t]);
+    count = offsets[threads];
+  }
+
+  template<typename SparseMatrixType, typename OtherSparseMatrixType>
+  void market_assign(SparseMatrixType& dst, OtherSparseMatrixType& src) { dst = src; }
+
+  template<typename Scalar, int Options, typename StorageIndex>
+  void market_assign(SparseMatrix<Scalar,Options,StorageIndex>& dst, SparseMatrix<Scalar,Options,StorageIndex>& src) { dst.swap(src); }
+
+  /** \internal Implementation of loadMarket(), reading the file by blocks of \a blockSize bytes */
+  template<typename SparseMatrixType>
+  bool load_market(SparseMatrixType& mat, const std::string& filename, Index blockSize)
+  {
+    typedef typename SparseMatrixType::Scalar Scalar;
+    typedef typename SparseMatrixType::StorageIndex StorageIndex;
+    enum { IsRowMajor = SparseMatrixType::IsRowMajor };
+    std::ifstream input(filename.c_str(), std::ios::in | std::ios::binary);
+    if(!input)
+      return false;
+
+    // header: the banner, comments, and the sizes
+    std::string line;
+    bool pattern = false;
+    Index M(-1), N(-1), NNZ(-1);
+    while(std::getline(input, line))
+    {
+      if(line.compare(0, 14, "%%MatrixMarket") == 0)
+        pattern = line.find("pattern") != std::string::npos;
+      if(line.empty() || line[0] == '%')
+        continue;
+      const char* p = line.c_str();
+      const char* end = p + line.size();
+      if(market_parse_integer(p, end, M) && market_parse_integer(p, end, N) && market_parse_integer(p, end, NNZ))
+        break;
+      return false;
+    }
+    if(M < 0 || N < 0 || NNZ < 0)
+      return false;
+
+    // the entries are parsed into preallocated arrays, by blocks of complete lines
+    std::vector<StorageIndex> rowIndices(NNZ), colIndices(NNZ);
+    std::vector<Scalar> values(NNZ);
+    std::vector<char> buffer;
+    Index count = 0, pending = 0;
+    while(input)
+    {
+      buffer.resize(pending + blockSize);
+      input.read(&buffer[pending], blockSize);
+      Index size = pending + Index(input.gcount());
+      if(size == 0)
+        break;
+      // keep the last incomplete line for the next block
+      const char* begin = &buffer[0];
+      const char* end = begin + size;
+      if(input)
+      {
+        while(end > begin && end[-1] != '\n')
+          --end;
+      }
+      market_parse_block(begin, end, M, N, pattern, rowIndices, colIndices, values, count);
+      pending = size - Index(end - begin);
+      std::memmove(&buffer[0], end, pending);
+    }
+    if(count != NNZ)
+      std::cerr << count << "!=" << NNZ << "\n";
+
+    // counting pass on the transposed storage order, then transposition, which sorts the inner indices, as in setFromTriplets()
+    SparseMatrix<Scalar,IsRowMajor?ColMajor:RowMajor,StorageIndex> trMat(M, N);
+    Index invalid = 0;
+    {
+      Matrix<StorageIndex,Dynamic,1> wi(trMat.outerSize());
+      wi.setZero();
+      for(Index k = 0; k < count; ++k)
+      {
+        if(rowIndices[k] < 0)
+          ++invalid;
+        else
+          wi(IsRowMajor ? colIndices[k] : rowIndices[k])++;
+      }
+      trMat.reserve(wi);
+    }
+    for(Index k = 0; k < count; ++k)
+      if(rowIndices[k] >= 0)
+        trMat.insertBackUncompressed(rowIndices[k], colIndices[k]) = values[k];
+    if(invalid > 0)
+      std::cerr << "Invalid read: " << invalid << " entries\n";
+    std::vector<StorageIndex>().swap(rowIndices);
+    std::vector<StorageIndex>().swap(colIndices);
+    std::vector<Scalar>().swap(values);
+
+    trMat.sumupDuplicates();
+    SparseMatrix<Scalar,IsRowMajor?RowMajor:ColMajor,StorageIndex> result(trMat);
+    market_assign(mat, result);
+    return true;
+  }
+
 } // end namepsace internal
 
 inline bool getMarketHeader(const std::string& filename, int& sym, bool& iscomplex, bool& isvector)
@@ -132,61 +435,7 @@ inline bool getMarketHeader(const std::string& filename, int& sym, bool& iscompl
 template<typename SparseMatrixType>
 bool loadMarket(SparseMatrixType& mat, const std::string& filename)
 {
-  typedef typename SparseMatrixType::Scalar Scalar;
-  typedef typename SparseMatrixType::Index Index;
-  std::ifstream input(filename.c_str(),std::ios::in);
-  if(!input)
-    return false;
-  
-  const int maxBuffersize = 2048;
-  char buffer[maxBuffersize];
-  
-  bool readsizes = false;
-
-  typedef Triplet<Scalar,Index> T;
-  std::vector<T> elements;
-  
-  Index M(-1), N(-1), NNZ(-1);
-  Index count = 0;
-  while(input.getline(buffer, maxBuffersize))
-  {
-    // skip comments   
-    //NOTE An appropriate test should be done on the header to get the  symmetry
-    if(buffer[0]=='%')
-      continue;
-    
-    std::stringstream line(buffer);
-    
-    if(!readsizes)
-    {
-      line >> M >> N >> NNZ;
-      if(M > 0 && N > 0 && NNZ > 0) 
-      {
-        readsizes = true;
-        //std::cout << "sizes: " << M << "," << N << "," << NNZ << "\n";
-        mat.resize(M,N);
-        mat.reserve(NNZ);
-      }
-    }
-    else
-    { 
-      Index i(-1), j(-1);
-      Scalar value; 
-      if( internal::GetMarketLine(line, M, N, i, j, value) ) 
-      {
-        ++ count;
-        elements.push_back(T(i,j,value));
-      }
-      else 
-        std::cerr << "Invalid read: " << i << "," << j << "\n";        
-    }
-  }
-  mat.setFromTriplets(elements.begin(), elements.end());
-  if(count!=NNZ)
-    std::cerr << count << "!=" << NNZ << "\n";
-  
-  input.close();
-  return true;
+  return internal::load_market(mat, filename, Index(1) << 25);
 }
 
 template<typename VectorType>
@@ -0,0 +1,200 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_ASSEMBLER_H
+#define EIGEN_SPARSE_ASSEMBLER_H
+
+namespace Eigen {
+
+/** \class SparseAssembler
+  * \ingroup SparseExtra_Module
+  *
+  * \brief Repeated assembly of a sparse matrix from element matrices with a frozen pattern
+  *
+  * \tparam SparseMatrixType the type of the assembled matrix, a SparseMatrix
+  *
+  * In finite element like applications, the matrix is the sum of small dense element matrices, each of them coupling
+  * the degrees of freedom of one element. The pattern of the matrix only depends on the element to degrees of freedom
+  * map, while the values are assembled many times (nonlinear iterations, time steps, ...).
+  *
+  * analyzePattern() computes once the pattern of the matrix and, for each coefficient of each element matrix, its
+  * offset in the valuePtr() of the matrix, so that the assembly becomes a streaming pass without any search nor
+  * reallocation. The elements are also colored such that the elements of a given color do not share any degree of
+  * freedom, allowing assemble() to add the element matrices of a color concurrently when OpenMP is enabled.
+  *
+  * The element to degrees of freedom map is given as an integer matrix with one column per element. A negative
+  * degree of freedom is ignored, which conveniently removes the constrained ones.
+  *
+  * Example:
+  * \code
+  * struct ElementMatrix {
+  *   void operator()(Index e, MatrixXd& Ke) const { Ke = ...; } // Ke is already resized
+  * };
+  *
+  * SparseAssembler<SparseMatrix<double> > assembler;
+  * assembler.analyzePattern(elementDofs, nbDofs);   // elementDofs is a MatrixXi of size dofs per element x elements
+  * for(...)
+  * {
+  *   assembler.setZero();
+  *   assembler.assemble(ElementMatrix());            // or assembler.addElement(e, Ke) for each element e
+  *   solver.factorize(assembler.matrix());
+  *   ...
+  * }
+  * \endcode
+  */
+template<typename SparseMatrixType>
+class SparseAssembler
+{
+  public:
+    typedef typename SparseMatrixType::Scalar Scalar;
+    typedef typename SparseMatrixType::StorageIndex StorageIndex;
+    typedef Matrix<Scalar,Dynamic,Dynamic> ElementMatrix;
+
+    SparseAssembler() : m_dofsPerElement(0) {}
+
+    /** Computes the pattern of the \a size x \a size matrix assembled from the elements whose degrees of freedom
+      * are given by the columns of \a elementDofs, the offsets of the element matrices, and the coloring of the
+      * elements. The values of the matrix are set to zero. */
+    template<typename Derived>
+    void analyzePattern(const MatrixBase<Derived>& elementDofs, Index size);
+
+    /** Sets the values of the matrix to zero, keeping the pattern */
+    void setZero()
+    {
+      Map<Matrix<Scalar,Dynamic,1> >(m_matrix.valuePtr(), m_matrix.nonZeros()).setZero();
+    }
+
+    /** Adds the element matrix \a Ke of the element \a e to the matrix. The elements of a given color can be
+      * added concurrently. */
+    template<typename Derived>
+    void addElement(Index e, const MatrixBase<Derived>& Ke)
+    {
+      eigen_assert(e >= 0 && e < elements() && Ke.rows() == m_dofsPerElement && Ke.cols() == m_dofsPerElement);
+      const StorageIndex* offsets = &m_offsets[e*m_dofsPerElement*m_dofsPerElement];
+      Scalar* values = m_matrix.valuePtr();
+      for(Index b = 0; b < m_dofsPerElement; ++b)
+        for(Index a = 0; a < m_dofsPerElement; ++a, ++offsets)
+          if(*offsets >= 0)
+            values[*offsets] += Ke.coeff(a,b);
+    }
+
+    /** Assembles the element matrices computed by \a func, called as func(e, Ke) for each element e with an
+      * element matrix Ke of the right size, to add to the matrix. When OpenMP is enabled the elements of each color
+      * are processed in parallel, and \a func must then be thread safe. */
+    template<typename ElementFunctor>
+    void assemble(const ElementFunctor& func);
+
+    /** \returns the assembled matrix */
+    const SparseMatrixType& matrix() const { return m_matrix; }
+    /** \returns the assembled matrix, whose values can be modified but not its pattern */
+    SparseMatrixType& matrix() { return m_matrix; }
+
+    /** \returns the number of elements */
+    Index elements() const { return m_dofs.cols(); }
+
+    /** \returns the number of colors, such that the elements of a color do not share any degree of freedom */
+    Index colors() const { return m_colorPtr.empty() ? 0 : Index(m_colorPtr.size())-1; }
+    /** \returns the number of elements of the color \a c */
+    Index colorSize(Index c) const { return m_colorPtr[c+1] - m_colorPtr[c]; }
+    /** \returns the \a i-th element of the color \a c */
+    Index colorElement(Index c, Index i) const { return m_colorElements[m_colorPtr[c]+i]; }
+
+  protected:
+    void computeColoring();
+
+    SparseMatrixType m_matrix;
+    Matrix<StorageIndex,Dynamic,Dynamic> m_dofs;
+    Index m_dofsPerElement;
+    std::vector<StorageIndex> m_offsets;        // offset in valuePtr() of each coefficient of each element matrix
+    std::vector<StorageIndex> m_colorPtr;       // start of each color in m_colorElements
+    std::vector<StorageIndex> m_colorElements;  // the elements sorted by color
+};
+
+template<typename SparseMatrixType>
+template<typename Derived>
+void SparseAssembler<SparseMatrixType>::analyzePattern(const MatrixBase<Derived>& elementDofs, Index size)
+{
+  m_dofs = elementDofs.template cast<StorageIndex>();
+  m_dofsPerElement = m_dofs.rows();
+  const Index k = m_dofsPerElement, nbElements = m_dofs.cols();
+
+  // the pattern is computed from the triplets of all the element matrices, the positions of the triplets being
+  // the offsets of the coefficients of the element matrices
+  typedef Triplet<Scalar,StorageIndex> TripletType;
+  std::vector<TripletType> triplets;
+  triplets.reserve(nbElements*k*k);
+  m_offsets.assign(nbElements*k*k, -1);
+  for(Index e = 0; e < nbElements; ++e)
+    for(Index b = 0; b < k; ++b)
+      for(Index a = 0; a < k; ++a)
+      {
+        const StorageIndex i = m_dofs(a,e), j = m_dofs(b,e);
+        eigen_assert(i < size && j < size);
+        if(i >= 0 && j >= 0)
+          triplets.push_back(TripletType(i, j, Scalar(0)));
+      }
+  typename SparseMatrixType::IndexVector positions;
+  m_matrix.resize(size, size);
+  m_matrix.setFromTriplets(triplets.begin(), triplets.end(), positions);
+
+  Index t = 0;
+  for(Index e = 0; e < nbElements; ++e)
+    for(Index b = 0; b < k; ++b)
+      for(Index a = 0; a < k; ++a)
+        if(m_dofs(a,e) >= 0 && m_dofs(b,e) >= 0)
+        {
+          const StorageIndex p = positions(t++);
+          m_offsets[(e*k+b)*k+a] = p >= 0 ? p : -p-1;
+        }
+
+  computeColoring();
+}
+
+template<typename SparseMatrixType>
+void SparseAssembler<SparseMatrixType>::computeColoring()
+{
+  // two elements of the same color share no degree of freedom
+  internal::greedy_coloring(m_dofs.cols(), m_matrix.rows(), m_dofs.data(), static_cast<const StorageIndex*>(0), m_dofsPerElement,
+                            m_colorPtr, m_colorElements);
+}
+
+template<typename SparseMatrixType>
+template<typename ElementFunctor>
+void SparseAssembler<SparseMatrixType>::assemble(const ElementFunctor& func)
+{
+  const Index nbColors = colors();
+  Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+  if(omp_get_num_threads()==1)
+    threads = nbThreads();
+#endif
+  EIGEN_UNUSED_VARIABLE(threads);
+
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel num_threads(threads) if(threads>1)
+#endif
+  {
+    ElementMatrix Ke(m_dofsPerElement, m_dofsPerElement);
+    for(Index c = 0; c < nbColors; ++c)
+    {
+      // the implicit barrier at the end of the loop separates the colors
+      const Index begin = m_colorPtr[c], end = m_colorPtr[c+1];
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp for schedule(dynamic,64)
+#endif
+      for(Index i = begin; i < end; ++i)
+      {
+        func(Index(m_colorElements[i]), Ke);
+        addElement(m_colorElements[i], Ke);
+      }
+    }
+  }
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_ASSEMBLER_H
@@ -111,6 +111,23 @@ namespace Eigen
      **/
     PointType operator()(Scalar u) const;
 
+    /**
+     * \brief Returns the spline values at several sites.
+     *
+     * The column k of the returned array is the spline value at the site
+     * \f$u_k\f$. The sites are processed by batches whose basis functions are
+     * computed simultaneously. When the sites are sorted in increasing order,
+     * which is the fastest case, the knot span of each site is found by walking
+     * the knot vector from the span of the previous site instead of a binary
+     * search. When OpenMP is enabled, large sets of sites are split across
+     * threads.
+     *
+     * \param u Parameter values \f$u_k \in [0;1]\f$ at which the spline is evaluated.
+     * \return The spline values, a Dimension x u.size() array.
+     **/
+    template <typename Derived>
+    ControlPointVectorType operator()(const DenseBase<Derived>& u) const;
+
     /**
      * \brief Evaluation of spline derivatives of up-to given order.
      *
@@ -135,6 +152,22 @@ namespace Eigen
     typename SplineTraits<Spline,DerivativeOrder>::DerivativeType
       derivatives(Scalar u, DenseIndex order = DerivativeOrder) const;
 
+    /**
+     * \brief Evaluation of spline derivatives of up-to given order at several sites.
+     *
+     * The derivatives at the site \f$u_k\f$ are stored in the columns
+     * k*(n+1) to k*(n+1)+n of the returned array, in the same order as
+     * derivatives(Scalar,DenseIndex) does, with n the minimum of \a order and
+     * of the spline degree. As for operator()(const DenseBase<Derived>&), the
+     * knot spans of sorted sites are walked incrementally and large sets of
+     * sites are split across threads.
+     *
+     * \param u Parameter values \f$u_k \in [0;1]\f$ at which the spline derivatives are evaluated.
+     * \param order The order up to which the derivatives are computed.
+     **/
+    template <typename Derived>
+    ControlPointVectorType derivatives(const DenseBase<Derived>& u, DenseIndex order) const;
+
     /**
      * \brief Computes the non-zero basis functions at the given site.
      *
@@ -224,6 +257,7 @@ namespace Eigen
     template <typename DerivativeType>
     static void BasisFunctionDerivativesImpl(
       const typename Spline<_Scalar, _Dim, _Degree>::Scalar u,
+      const DenseIndex span,
       const DenseIndex order,
       const DenseIndex p, 
       const typename Spline<_Scalar, _Dim, _Degree>::KnotVectorType& U,
@@ -293,6 +327,124 @@ namespace Eigen
     return Spline::Span(u, degree(), knots());
   }
 
+  namespace internal
+  {
+    /**
+     * \internal
+     * \brief Computes the knot spans and the non-zero basis functions of a spline
+     * at consecutive sites, by batches of BatchSize sites.
+     *
+     * The basis functions of the sites of a batch are computed simultaneously,
+     * each step of the recurrence being an array operation over the batch. The
+     * span of a site is found by walking the knot vector from the span of the
+     * previous site when the sites are sorted, and by a binary search otherwise.
+     **/
+    template <typename SplineType>
+    class spline_basis_batch
+    {
+    public:
+      typedef typename SplineType::Scalar Scalar;
+      typedef typename SplineType::KnotVectorType KnotVectorType;
+      enum { BatchSize = 16 };
+      enum { Order = SplineTraits<SplineType>::OrderAtCompileTime };
+      typedef Array<Scalar,BatchSize,Order> BatchBasisType;
+
+      spline_basis_batch(DenseIndex degree, const KnotVectorType& knots)
+        : m_degree(degree), m_knots(knots), m_span(-1), m_u(0),
+          m_left(DenseIndex(BatchSize),degree+1), m_right(DenseIndex(BatchSize),degree+1),
+          m_basis(DenseIndex(BatchSize),degree+1)
+      {}
+
+      /** Computes the spans and the basis functions of the sites u(start), ..., u(start+count-1), with count at
+        * most BatchSize */
+      template <typename SitesType>
+      void compute(const SitesType& u, DenseIndex start, DenseIndex count)
+      {
+        eigen_assert(count > 0 && count <= BatchSize);
+        const DenseIndex p = m_degree;
+        const KnotVectorType& U = m_knots;
+        for (DenseIndex k=0; k<count; ++k)
+        {
+          const Scalar uk = u.coeff(start+k);
+          const DenseIndex i = m_spans[k] = nextSpan(uk);
+          for (DenseIndex j=1; j<=p; ++j)
+          {
+            m_left(k,j) = uk - U(i+1-j);
+            m_right(k,j) = U(i+j) - uk;
+          }
+        }
+        // the unused rows of an incomplete batch repeat the last site
+        for (DenseIndex k=count; k<BatchSize; ++k)
+        {
+          m_left.row(k) = m_left.row(count-1);
+          m_right.row(k) = m_right.row(count-1);
+        }
+
+        // Piegl & Tiller, "The NURBS Book", A2.2 (p. 70), as in Spline::BasisFunctions
+        Array<Scalar,BatchSize,1> saved, tmp;
+        m_basis.col(0).setOnes();
+        for (DenseIndex j=1; j<=p; ++j)
+        {
+          saved.setZero();
+          for (DenseIndex r=0; r<j; ++r)
+          {
+            tmp = m_basis.col(r) / (m_right.col(r+1) + m_left.col(j-r));
+            m_basis.col(r) = saved + m_right.col(r+1) * tmp;
+            saved = m_left.col(j-r) * tmp;
+          }
+          m_basis.col(j) = saved;
+        }
+      }
+
+      /** \returns the knot span of the k-th site of the last batch */
+      DenseIndex span(DenseIndex k) const { return m_spans[k]; }
+
+      /** \returns the non-zero basis functions of the sites of the last batch, one site per row */
+      const BatchBasisType& basis() const { return m_basis; }
+
+      /** \returns the knot span of \a u, walked from the one of the previous site when u is not smaller */
+      DenseIndex nextSpan(Scalar u)
+      {
+        const DenseIndex p = m_degree;
+        const KnotVectorType& U = m_knots;
+        if (m_span < 0 || u < m_u || !(m_u > U(0)))
+          m_span = SplineType::Span(u, p, U);
+        else
+        {
+          const DenseIndex last = U.size()-p-2;
+          while (m_span < last && U(m_span+1) <= u)
+            ++m_span;
+        }
+        m_u = u;
+        return m_span;
+      }
+
+    private:
+      DenseIndex m_degree;
+      const KnotVectorType& m_knots;
+      DenseIndex m_span;  // span of the previous site, -1 before the first one
+      Scalar m_u;         // previous site
+      DenseIndex m_spans[BatchSize];
+      BatchBasisType m_left, m_right, m_basis;
+    };
+
+    /** \internal \returns the number of threads among which \a size spline sites are split */
+    inline DenseIndex spline_batch_threads(DenseIndex size)
+    {
+      // below this number of sites per thread, the threads are not worth it
+      const DenseIndex minSitesPerThread = 4096;
+      DenseIndex threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+      if (omp_get_num_threads()==1)
+        threads = (std::max)(DenseIndex(1), (std::min)(DenseIndex(nbThreads()), size/minSitesPerThread));
+#else
+      EIGEN_UNUSED_VARIABLE(size);
+      EIGEN_UNUSED_VARIABLE(minSitesPerThread);
+#endif
+      return threads;
+    }
+  }
+
   template <typename _Scalar, int _Dim, int _Degree>
   typename Spline<_Scalar, _Dim, _Degree>::PointType Spline<_Scalar, _Dim, _Degree>::operator()(Scalar u) const
   {
@@ -358,6 +510,94 @@ namespace Eigen
     return res;
   }
 
+  template <typename _Scalar, int _Dim, int _Degree>
+  template <typename Derived>
+  typename Spline<_Scalar, _Dim, _Degree>::ControlPointVectorType
+    Spline<_Scalar, _Dim, _Degree>::operator()(const DenseBase<Derived>& u) const
+  {
+    typedef internal::spline_basis_batch<Spline> BatchType;
+    typedef typename internal::nested_eval<Derived,1>::type SitesNested;
+
+    SitesNested sites(u.derived());
+    const DenseIndex size = sites.size();
+    const DenseIndex p = degree();
+    const DenseIndex threads = internal::spline_batch_threads(size);
+    ControlPointVectorType res(DenseIndex(Dimension), size);
+
+    // each thread evaluates a contiguous range of sites, so that the knot spans are walked within the range
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel num_threads(threads) if(threads>1)
+#endif
+    {
+      BatchType batch(p, knots());
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for (DenseIndex t=0; t<threads; ++t)
+      {
+        const DenseIndex end = size*(t+1)/threads;
+        for (DenseIndex start=size*t/threads; start<end; start+=BatchType::BatchSize)
+        {
+          const DenseIndex count = (std::min)(DenseIndex(BatchType::BatchSize), end-start);
+          batch.compute(sites, start, count);
+          for (DenseIndex k=0; k<count; ++k)
+          {
+            const DenseIndex first = batch.span(k)-p;
+            PointType pt = batch.basis()(k,0) * ctrls().col(first);
+            for (DenseIndex r=1; r<=p; ++r)
+              pt += batch.basis()(k,r) * ctrls().col(first+r);
+            res.col(start+k) = pt;
+          }
+        }
+      }
+    }
+    return res;
+  }
+
+  template <typename _Scalar, int _Dim, int _Degree>
+  template <typename Derived>
+  typename Spline<_Scalar, _Dim, _Degree>::ControlPointVectorType
+    Spline<_Scalar, _Dim, _Degree>::derivatives(const DenseBase<Derived>& u, DenseIndex order) const
+  {
+    typedef internal::spline_basis_batch<Spline> BatchType;
+    typedef typename internal::nested_eval<Derived,1>::type SitesNested;
+
+    SitesNested sites(u.derived());
+    const DenseIndex size = sites.size();
+    const DenseIndex p = degree();
+    const DenseIndex n = (std::min)(p, order);
+    const DenseIndex threads = internal::spline_batch_threads(size);
+    ControlPointVectorType res(DenseIndex(Dimension), size*(n+1));
+
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel num_threads(threads) if(threads>1)
+#endif
+    {
+      BatchType batch(p, knots());
+      BasisDerivativeType basis_func_ders;
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for (DenseIndex t=0; t<threads; ++t)
+      {
+        for (DenseIndex i=size*t/threads; i<size*(t+1)/threads; ++i)
+        {
+          const Scalar ui = sites.coeff(i);
+          const DenseIndex span = batch.nextSpan(ui);
+          BasisFunctionDerivativesImpl(ui, span, n, p, knots(), basis_func_ders);
+          for (DenseIndex der_order=0; der_order<=n; ++der_order)
+          {
+            PointType pt = basis_func_ders(der_order,0) * ctrls().col(span-p);
+            for (DenseIndex r=1; r<=p; ++r)
+              pt += basis_func_ders(der_order,r) * ctrls().col(span-p+r);
+            res.col(i*(n+1)+der_order) = pt;
+          }
+        }
+      }
+    }
+    return res;
+  }
+
   template <typename _Scalar, int _Dim, int _Degree>
   typename SplineTraits< Spline<_Scalar, _Dim, _Degree> >::BasisVectorType
     Spline<_Scalar, _Dim, _Degree>::basisFunctions(Scalar u) const
@@ -372,6 +612,7 @@ namespace Eigen
   template <typename DerivativeType>
   void Spline<_Scalar, _Dim, _Degree>::BasisFunctionDerivativesImpl(
     const typename Spline<_Scalar, _Dim, _Degree>::Scalar u,
+    const DenseIndex span,
     const DenseIndex order,
     const DenseIndex p, 
     const typename Spline<_Scalar, _Dim, _Degree>::KnotVectorType& U,
@@ -382,8 +623,6 @@ namespace Eigen
 
     typedef typename SplineTraits<SplineType>::Scalar Scalar;
     typedef typename SplineTraits<SplineType>::BasisVectorType BasisVectorType;
-  
-    const DenseIndex span = SplineType::Span(u, p, U);
 
     const DenseIndex n = (std::min)(p, order);
 
@@ -481,7 +720,7 @@ namespace Eigen
     Spline<_Scalar, _Dim, _Degree>::basisFunctionDerivatives(Scalar u, DenseIndex order) const
   {
     typename SplineTraits<Spline<_Scalar, _Dim, _Degree> >::BasisDerivativeType der;
-    BasisFunctionDerivativesImpl(u, order, degree(), knots(), der);
+    BasisFunctionDerivativesImpl(u, span(u), order, degree(), knots(), der);
     return der;
   }
 
@@ -491,7 +730,7 @@ namespace Eigen
     Spline<_Scalar, _Dim, _Degree>::basisFunctionDerivatives(Scalar u, DenseIndex order) const
   {
     typename SplineTraits< Spline<_Scalar, _Dim, _Degree>, DerivativeOrder >::BasisDerivativeType der;
-    BasisFunctionDerivativesImpl(u, order, degree(), knots(), der);
+    BasisFunctionDerivativesImpl(u, span(u), order, degree(), knots(), der);
     return der;
   }
 
@@ -504,7 +743,7 @@ namespace Eigen
     const typename Spline<_Scalar, _Dim, _Degree>::KnotVectorType& knots)
   {
     typename SplineTraits<Spline>::BasisDerivativeType der;
-    BasisFunctionDerivativesImpl(u, order, degree, knots, der);
+    BasisFunctionDerivativesImpl(u, Span(u, degree, knots), order, degree, knots, der);
     return der;
   }
 }
@@ -299,12 +299,19 @@ namespace Eigen
 
     DenseIndex n = pts.cols();
     MatrixType A = MatrixType::Zero(n,n);
-    for (DenseIndex i=1; i<n-1; ++i)
-    {
-      const DenseIndex span = SplineType::Span(knot_parameters[i], degree, knots);
 
-      // The segment call should somehow be told the spline order at compile time.
-      A.row(i).segment(span-degree, degree+1) = SplineType::BasisFunctions(knot_parameters[i], degree, knots);
+    // The knot parameters are sorted, so that their spans are walked by the batches.
+    typedef internal::spline_basis_batch<SplineType> BatchType;
+    BatchType batch(degree, knots);
+    for (DenseIndex start=1; start<n-1; start+=BatchType::BatchSize)
+    {
+      const DenseIndex count = (std::min)(DenseIndex(BatchType::BatchSize), n-1-start);
+      batch.compute(knot_parameters, start, count);
+      for (DenseIndex k=0; k<count; ++k)
+      {
+        // The segment call should somehow be told the spline order at compile time.
+        A.row(start+k).segment(batch.span(k)-degree, degree+1) = batch.basis().row(k).head(degree+1);
+      }
     }
     A(0,0) = 1.0;
     A(n-1,n-1) = 1.0;
@@ -189,6 +189,71 @@ struct TreeTest
 
     VERIFY_IS_APPROX(m1, m2);
   }
+
+  template<int Width> void testSah()
+  {
+    BallTypeList b;
+    VectorTypeList v;
+    const int n = internal::random<int>(0, 2000);
+    for(int i = 0; i < n; ++i) {
+      //some duplicated balls, whose centers cannot be split
+      if(i > 0 && internal::random<int>(0, 9) == 0)
+        b.push_back(b.back());
+      else
+        b.push_back(BallType(VectorType::Random(), 0.1 * internal::random(0., 1.)));
+    }
+    for(int j = 0; j < 30; ++j)
+      v.push_back(VectorType::Random());
+    SahBVH<double, Dim, BallType, Width> tree(b.begin(), b.end());
+    SahBVH<double, Dim, VectorType, Width> vTree(v.begin(), v.end());
+
+    //generic algorithms
+    VectorType pt = VectorType::Random();
+    BallPointStuff<Dim> i1(pt), i2(pt);
+    for(int i = 0; i < (int)b.size(); ++i)
+      i1.intersectObject(b[i]);
+    BVIntersect(tree, i2);
+    VERIFY(i1.count == i2.count);
+
+    double m1 = (std::numeric_limits<double>::max)(), m2 = m1;
+    for(int i = 0; i < (int)b.size(); ++i)
+      m1 = (std::min)(m1, i1.minimumOnObject(b[i]));
+    if(n > 0) {
+      m2 = BVMinimize(tree, i2);
+      VERIFY_IS_APPROX(m1, m2);
+    }
+
+    BallPointStuff<Dim> i3, i4;
+    for(int i = 0; i < (int)b.size(); ++i)
+      for(int j = 0; j < (int)v.size(); ++j)
+        i3.intersectObjectObject(b[i], v[j]);
+    BVIntersect(tree, vTree, i4);
+    VERIFY(i3.count == i4.count);
+
+    //box queries
+    BoxType query(pt);
+    query.extend(VectorType::Random());
+    BoxCounter counter(query), counter2(query);
+    for(int i = 0; i < (int)b.size(); ++i)
+      counter.intersectObject(b[i]);
+    tree.intersectBox(query, counter2);
+    VERIFY(counter.count == counter2.count);
+    VERIFY(counter2.calls <= (int)b.size());
+  }
+
+  struct BoxCounter
+  {
+    BoxCounter(const BoxType &q) : query(q), calls(0), count(0) {}
+    bool intersectObject(const BallType &b) {
+      ++calls;
+      if(!query.intersection(bounding_box(b)).isEmpty())
+        ++count;
+      return false;
+    }
+    BoxType query;
+    int calls;
+    int count;
+  };
 };
 
 
@@ -201,6 +266,8 @@ void test_BVH()
     CALL_SUBTEST(test2.testMinimize1());
     CALL_SUBTEST(test2.testIntersect2());
     CALL_SUBTEST(test2.testMinimize2());
+    CALL_SUBTEST(test2.template testSah<4>());
+    CALL_SUBTEST(test2.template testSah<8>());
 #endif
 
 #ifdef EIGEN_TEST_PART_2
@@ -209,6 +276,8 @@ void test_BVH()
     CALL_SUBTEST(test3.testMinimize1());
     CALL_SUBTEST(test3.testIntersect2());
     CALL_SUBTEST(test3.testMinimize2());
+    CALL_SUBTEST(test3.template testSah<4>());
+    CALL_SUBTEST(test3.template testSah<8>());
 #endif
 
 #ifdef EIGEN_TEST_PART_3
@@ -217,6 +286,8 @@ void test_BVH()
     CALL_SUBTEST(test4.testMinimize1());
     CALL_SUBTEST(test4.testIntersect2());
     CALL_SUBTEST(test4.testMinimize2());
+    CALL_SUBTEST(test4.template testSah<4>());
+    CALL_SUBTEST(test4.template testSah<8>());
 #endif
   }
 }
@@ -177,36 +177,94 @@ void test_complex(int nfft)
   test_complex_generic<StdVectorContainer,T>(nfft);
   test_complex_generic<EigenVectorContainer,T>(nfft);
 }
-/*
-template <typename T,int nrows,int ncols>
-void test_complex2d()
+template <typename T>
+void test_complex2d(int nrows, int ncols)
 {
     typedef typename Eigen::FFT<T>::Complex Complex;
+    typedef Eigen::Matrix<Complex,Dynamic,Dynamic> ComplexMatrix;
     FFT<T> fft;
-    Eigen::Matrix<Complex,nrows,ncols> src,src2,dst,dst2;
+    ComplexMatrix src,src2,dst,dst2;
 
-    src = Eigen::Matrix<Complex,nrows,ncols>::Random();
-    //src =  Eigen::Matrix<Complex,nrows,ncols>::Identity();
+    src = ComplexMatrix::Random(nrows,ncols);
+    dst2.resize(nrows,ncols);
 
     for (int k=0;k<ncols;k++) {
-        Eigen::Matrix<Complex,nrows,1> tmpOut;
+        Eigen::Matrix<Complex,Dynamic,1> tmpOut;
         fft.fwd( tmpOut,src.col(k) );
         dst2.col(k) = tmpOut;
     }
+    ComplexMatrix colwise = dst2;
 
     for (int k=0;k<nrows;k++) {
-        Eigen::Matrix<Complex,1,ncols> tmpOut;
+        Eigen::Matrix<Complex,1,Dynamic> tmpOut;
         fft.fwd( tmpOut,  dst2.row(k) );
         dst2.row(k) = tmpOut;
     }
 
-    fft.fwd2(dst.data(),src.data(),ncols,nrows);
-    fft.inv2(src2.data(),dst.data(),ncols,nrows);
-    VERIFY( (src-src2).norm() < test_precision<T>() );
-    VERIFY( (dst-dst2).norm() < test_precision<T>() );
+    fft.fwd2(dst,src);
+    fft.inv2(src2,dst);
+    VERIFY( (src-src2).norm() < test_precision<T>()*src.norm() );
+    VERIFY( (dst-dst2).norm() < test_precision<T>()*dst2.norm() );
+
+    // in place, and with the other storage order
+    src2 = src;
+    fft.fwd2(src2,src2);
+    VERIFY( (src2-dst2).norm() < test_precision<T>()*dst2.norm() );
+    Eigen::Matrix<Complex,Dynamic,Dynamic,RowMajor> rowMajor;
+    fft.fwd2(rowMajor,src);
+    VERIFY( (rowMajor-dst2).norm() < test_precision<T>()*dst2.norm() );
+
+    // the transforms of the columns, then of the rows
+    fft.fwdColwise(dst,src);
+    VERIFY( (dst-colwise).norm() < test_precision<T>()*colwise.norm() );
+    fft.fwdRowwise(dst,dst);
+    VERIFY( (dst-dst2).norm() < test_precision<T>()*dst2.norm() );
+    fft.invRowwise(rowMajor,dst);
+    fft.invColwise(src2,rowMajor);
+    VERIFY( (src-src2).norm() < test_precision<T>()*src.norm() );
+
+    // raw batched transforms of the rows of the column-major matrix
+    src2.resize(nrows,ncols);
+    fft.fwd(src2.data(),colwise.data(),ncols,nrows,nrows,1);
+    VERIFY( (src2-dst2).norm() < test_precision<T>()*dst2.norm() );
+    fft.inv(src2.data(),src2.data(),ncols,nrows,nrows,1);
+    VERIFY( (src2-colwise).norm() < test_precision<T>()*colwise.norm() );
 }
-*/
 
+template <typename T>
+void test_complex_nd(int n0, int n1, int n2)
+{
+    typedef typename Eigen::FFT<T>::Complex Complex;
+    typedef Eigen::Matrix<Complex,Dynamic,1> ComplexVector;
+    FFT<T> fft;
+    const int n = n0*n1*n2;
+    ComplexVector src = ComplexVector::Random(n), ref = src, dst(n), src2(n);
+
+    // reference: the 1-d transforms along each dimension of the column-major array
+    const int dims[3] = {n0,n1,n2};
+    int stride = 1;
+    for (int d=0;d<3;++d) {
+        for (int start=0;start<n;++start) {
+            if ( (start/stride)%dims[d] != 0 )
+                continue;
+            ComplexVector line(dims[d]), out;
+            for (int k=0;k<dims[d];++k)
+                line[k] = ref[start+k*stride];
+            fft.fwd(out,line);
+            for (int k=0;k<dims[d];++k)
+                ref[start+k*stride] = out[k];
+        }
+        stride *= dims[d];
+    }
+
+    std::vector<DenseIndex> sizes(dims,dims+3);
+    fft.fwd(dst.data(),src.data(),sizes);
+    VERIFY( (dst-ref).norm() < test_precision<T>()*ref.norm() );
+    fft.inv(src2.data(),dst.data(),sizes);
+    VERIFY( (src2-src).norm() < test_precision<T>()*src.norm() );
+    fft.fwd(src2.data(),src2.data(),sizes);
+    VERIFY( (src2-ref).norm() < test_precision<T>()*ref.norm() );
+}
 
 void test_return_by_value(int len)
 {
@@ -228,8 +286,10 @@ void test_return_by_value(int len)
 void test_FFTW()
 {
   CALL_SUBTEST( test_return_by_value(32) );
-  //CALL_SUBTEST( ( test_complex2d<float,4,8> () ) ); CALL_SUBTEST( ( test_complex2d<double,4,8> () ) );
-  //CALL_SUBTEST( ( test_complex2d<long double,4,8> () ) );
+  CALL_SUBTEST( test_complex2d<float>(4,8) ); CALL_SUBTEST( test_complex2d<double>(4,8) );
+  CALL_SUBTEST( test_complex2d<float>(40,21) ); CALL_SUBTEST( test_complex2d<double>(40,21) );
+  CALL_SUBTEST( test_complex_nd<float>(8,6,5) ); CALL_SUBTEST( test_complex_nd<double>(8,6,5) );
+  CALL_SUBTEST( test_complex_nd<float>(1,20,3) ); CALL_SUBTEST( test_complex_nd<double>(1,20,3) );
   CALL_SUBTEST( test_complex<float>(32) ); CALL_SUBTEST( test_complex<double>(32) ); 
   CALL_SUBTEST( test_complex<float>(256) ); CALL_SUBTEST( test_complex<double>(256) ); 
   CALL_SUBTEST( test_complex<float>(3*8) ); CALL_SUBTEST( test_complex<double>(3*8) ); 
@@ -237,12 +297,16 @@ void test_FFTW()
   CALL_SUBTEST( test_complex<float>(2*3*4) ); CALL_SUBTEST( test_complex<double>(2*3*4) ); 
   CALL_SUBTEST( test_complex<float>(2*3*4*5) ); CALL_SUBTEST( test_complex<double>(2*3*4*5) ); 
   CALL_SUBTEST( test_complex<float>(2*3*4*5*7) ); CALL_SUBTEST( test_complex<double>(2*3*4*5*7) ); 
+  CALL_SUBTEST( test_complex<float>(8*8*2) ); CALL_SUBTEST( test_complex<double>(8*8*2) ); 
+  CALL_SUBTEST( test_complex<float>(8*3*5*5) ); CALL_SUBTEST( test_complex<double>(8*3*5*5) ); 
 
   CALL_SUBTEST( test_scalar<float>(32) ); CALL_SUBTEST( test_scalar<double>(32) ); 
   CALL_SUBTEST( test_scalar<float>(45) ); CALL_SUBTEST( test_scalar<double>(45) ); 
   CALL_SUBTEST( test_scalar<float>(50) ); CALL_SUBTEST( test_scalar<double>(50) ); 
   CALL_SUBTEST( test_scalar<float>(256) ); CALL_SUBTEST( test_scalar<double>(256) ); 
   CALL_SUBTEST( test_scalar<float>(2*3*4*5*7) ); CALL_SUBTEST( test_scalar<double>(2*3*4*5*7) ); 
+  CALL_SUBTEST( test_scalar<float>(8*8*2) ); CALL_SUBTEST( test_scalar<double>(8*8*2) ); 
+  CALL_SUBTEST( test_scalar<float>(4*3*5*7) ); CALL_SUBTEST( test_scalar<double>(4*3*5*7) ); 
   
   #ifdef EIGEN_HAS_FFTWL
   CALL_SUBTEST( test_complex<long double>(32) );
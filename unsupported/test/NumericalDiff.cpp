@@ -107,8 +107,70 @@ void test_central()
     VERIFY_IS_APPROX(jac, actual_jac);
 }
 
+// Broyden tridiagonal function, whose jacobian is tridiagonal
+template<typename JacobianType_>
+struct broyden_functor : Functor<double>
+{
+    typedef JacobianType_ JacobianType;
+    broyden_functor(int n) : Functor<double>(n,n) {}
+    int operator()(const VectorXd &x, VectorXd &fvec) const
+    {
+        const int n = values();
+        for (int i = 0; i < n; i++)
+        {
+            fvec[i] = (3-2*x[i])*x[i] + 1;
+            if (i > 0) fvec[i] -= x[i-1];
+            if (i+1 < n) fvec[i] -= 2*x[i+1];
+        }
+        return 0;
+    }
+
+    int actual_df(const VectorXd &x, MatrixXd &fjac) const
+    {
+        const int n = values();
+        fjac.setZero(n, n);
+        for (int i = 0; i < n; i++)
+        {
+            fjac(i,i) = 3-4*x[i];
+            if (i > 0) fjac(i,i-1) = -1;
+            if (i+1 < n) fjac(i,i+1) = -2;
+        }
+        return 0;
+    }
+};
+
+template<typename JacobianType, NumericalDiffMode mode>
+void test_sparsity_pattern()
+{
+    const int n = 50;
+    broyden_functor<JacobianType> functor(n);
+    VectorXd x = VectorXd::Random(n);
+    MatrixXd actual_jac;
+    functor.actual_df(x, actual_jac);
+
+    NumericalDiff<broyden_functor<JacobianType>,mode> numDiff(functor);
+    numDiff.setSparsityPattern(actual_jac.sparseView());
+    // the columns j, j+3, j+6, ... do not share any row
+    VERIFY_IS_EQUAL(numDiff.colors(), 3);
+
+    JacobianType jac;
+    int nfev = numDiff.df(x, jac);
+    VERIFY_IS_EQUAL(nfev, mode==Forward ? 4 : 6);
+    VERIFY_IS_EQUAL(MatrixXd(jac).rows(), n);
+    VERIFY_IS_APPROX(MatrixXd(jac), actual_jac);
+
+    // concurrent evaluations of the functor
+    numDiff.setThreads(0);
+    VERIFY_IS_EQUAL(numDiff.df(x, jac), nfev);
+    VERIFY_IS_APPROX(MatrixXd(jac), actual_jac);
+}
+
 void test_NumericalDiff()
 {
     CALL_SUBTEST(test_forward());
     CALL_SUBTEST(test_central());
+    CALL_SUBTEST(( test_sparsity_pattern<MatrixXd,Forward>() ));
+    CALL_SUBTEST(( test_sparsity_pattern<MatrixXd,Central>() ));
+    CALL_SUBTEST(( test_sparsity_pattern<SparseMatrix<double>,Forward>() ));
+    CALL_SUBTEST(( test_sparsity_pattern<SparseMatrix<double>,Central>() ));
 }
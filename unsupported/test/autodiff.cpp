@@ -105,7 +105,7 @@ struct TestFunc1
   }
 };
 
-template<typename Func> void forward_jacobian(const Func& f)
+template<int MaxInputs, typename Func> void forward_jacobian(const Func& f)
 {
     typename Func::InputType x = Func::InputType::Random(f.inputs());
     typename Func::ValueType y(f.values()), yref(f.values());
@@ -119,7 +119,7 @@ template<typename Func> void forward_jacobian(const Func& f)
 
     j.setZero();
     y.setZero();
-    AutoDiffJacobian<Func> autoj(f);
+    AutoDiffJacobian<Func,MaxInputs> autoj(f);
     autoj(x, &y, &j);
 //     std::cerr << y.transpose() << "\n\n";;
 //     std::cerr << j << "\n\n";;
@@ -128,6 +128,11 @@ template<typename Func> void forward_jacobian(const Func& f)
     VERIFY_IS_APPROX(j, jref);
 }
 
+template<typename Func> void forward_jacobian(const Func& f)
+{
+  forward_jacobian<Func::InputsAtCompileTime>(f);
+}
+
 
 // TODO also check actual derivatives!
 template <int>
@@ -141,6 +146,72 @@ void test_autodiff_scalar()
   VERIFY_IS_APPROX(res.value(), foo(p.x(),p.y()));
 }
 
+template<typename DerType>
+void autodiff_compound_assignments(const DerType& dx, const DerType& dy)
+{
+  typedef AutoDiffScalar<DerType> AD;
+  typedef typename DerType::Scalar Scalar;
+  Scalar x = internal::random<Scalar>(1,2), y = internal::random<Scalar>(1,2), s = internal::random<Scalar>(1,2);
+  const AD ax(x,dx), ay(y,dy);
+
+  AD r = ax;
+  r += ay;
+  VERIFY_IS_APPROX(r.value(), x+y);
+  VERIFY_IS_APPROX(r.derivatives(), dx+dy);
+  r -= ay;
+  r -= ay;
+  VERIFY_IS_APPROX(r.value(), x-y);
+  VERIFY_IS_APPROX(r.derivatives(), dx-dy);
+  r = ax;
+  r *= ay;
+  VERIFY_IS_APPROX(r.value(), x*y);
+  VERIFY_IS_APPROX(r.derivatives(), y*dx+x*dy);
+  r = ax;
+  r /= ay;
+  VERIFY_IS_APPROX(r.value(), x/y);
+  VERIFY_IS_APPROX(r.derivatives(), (y*dx-x*dy)/(y*y));
+  r = ax;
+  r *= s;
+  VERIFY_IS_APPROX(r.derivatives(), s*dx);
+  r /= s;
+  VERIFY_IS_APPROX(r.value(), x);
+  VERIFY_IS_APPROX(r.derivatives(), dx);
+
+  // self aliasing
+  r = ax;
+  r *= r;
+  VERIFY_IS_APPROX(r.value(), x*x);
+  VERIFY_IS_APPROX(r.derivatives(), 2*x*dx);
+  r = ax;
+  r /= r;
+  VERIFY_IS_APPROX(r.value(), Scalar(1));
+  VERIFY_IS_MUCH_SMALLER_THAN(r.derivatives().norm(), Scalar(1));
+  r = ax;
+  r += r;
+  VERIFY_IS_APPROX(r.derivatives(), 2*dx);
+
+  // a constant without derivatives on the left hand side
+  if(DerType::SizeAtCompileTime==Dynamic)
+  {
+    AD c(s);
+    c *= ax;
+    VERIFY_IS_APPROX(c.value(), s*x);
+    VERIFY_IS_APPROX(c.derivatives(), s*dx);
+    AD d(s);
+    d += ax;
+    VERIFY_IS_APPROX(d.derivatives(), dx);
+  }
+}
+
+template <int>
+void test_autodiff_compound_assignments()
+{
+  typedef Matrix<double,Dynamic,1,0,6,1> BoundedVector;
+  CALL_SUBTEST(( autodiff_compound_assignments<Vector3f>(Vector3f::Random(), Vector3f::Random()) ));
+  CALL_SUBTEST(( autodiff_compound_assignments<VectorXd>(VectorXd::Random(5), VectorXd::Random(5)) ));
+  CALL_SUBTEST(( autodiff_compound_assignments<BoundedVector>(BoundedVector::Random(4), BoundedVector::Random(4)) ));
+}
+
 // TODO also check actual derivatives!
 template <int>
 void test_autodiff_vector()
@@ -164,6 +235,8 @@ void test_autodiff_jacobian()
   CALL_SUBTEST(( forward_jacobian(TestFunc1<double,3,2>()) ));
   CALL_SUBTEST(( forward_jacobian(TestFunc1<double,3,3>()) ));
   CALL_SUBTEST(( forward_jacobian(TestFunc1<double>(3,3)) ));
+  CALL_SUBTEST(( forward_jacobian<8>(TestFunc1<double>(3,3)) ));
+  CALL_SUBTEST(( forward_jacobian<3>(TestFunc1<double>(3,2)) ));
 }
 
 
@@ -238,6 +311,7 @@ void test_autodiff()
 {
   for(int i = 0; i < g_repeat; i++) {
     CALL_SUBTEST_1( test_autodiff_scalar<1>() );
+    CALL_SUBTEST_1( test_autodiff_compound_assignments<1>() );
     CALL_SUBTEST_2( test_autodiff_vector<1>() );
     CALL_SUBTEST_3( test_autodiff_jacobian<1>() );
     CALL_SUBTEST_4( test_autodiff_hessian<1>() );
@@ -0,0 +1,166 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <unsupported/Eigen/AutoDiff>
+
+template<typename T>
+T scalar_function(const T& x, const T& y)
+{
+  using std::sin; using std::cos; using std::exp; using std::log; using std::sqrt; using std::atan2;
+  using std::tan; using std::pow; using std::abs;
+  T r = x*2 - 1 + sin(x)*cos(y) + exp(-x*y) / (2 + y*y) + sqrt(x*x + y*y) + log(1 + x*x);
+  r += tan(y) * atan2(y, x + 3);
+  r *= 0.5;
+  r -= pow(abs(x) + 1, 2.5) - y*y;
+  return r;
+}
+
+template<typename Scalar>
+void reverse_scalar()
+{
+  typedef AutoDiffTape<Scalar> Tape;
+  typedef typename Tape::ActiveScalar AD;
+  typedef AutoDiffScalar<Matrix<Scalar,2,1> > FAD;
+
+  Scalar x = internal::random<Scalar>(-1,1), y = internal::random<Scalar>(-1,1);
+  Tape tape;
+  AD ax = tape.variable(x), ay = tape.variable(y);
+  AD r = scalar_function(ax, ay);
+
+  FAD fx(x, Matrix<Scalar,2,1>::UnitX()), fy(y, Matrix<Scalar,2,1>::UnitY());
+  FAD fr = scalar_function(fx, fy);
+
+  VERIFY_IS_APPROX(r.value(), fr.value());
+  tape.computeAdjoints(r);
+  VERIFY_IS_APPROX(tape.adjoint(ax), fr.derivatives()(0));
+  VERIFY_IS_APPROX(tape.adjoint(ay), fr.derivatives()(1));
+
+  // constants are not recorded
+  Index nodes = tape.nodeCount();
+  AD c = AD(x) * AD(y) + 2;
+  VERIFY(c.isConstant());
+  VERIFY_IS_EQUAL(tape.nodeCount(), nodes);
+  VERIFY_IS_EQUAL(tape.adjoint(c), Scalar(0));
+
+  // the functions not supported by AutoDiffScalar
+  Scalar z = x/2;
+  AD az = tape.variable(z);
+  r = tanh(az) + sinh(az) * cosh(az) + atan(az) + asin(az) - acos(az) + pow(az + 2, ax + 2);
+  tape.computeAdjoints(r);
+  VERIFY_IS_APPROX(tape.adjoint(az), 1 - numext::abs2(std::tanh(z)) + std::cosh(2*z) + 1/(1+z*z) + 2/std::sqrt(1-z*z)
+                                     + (x+2) * std::pow(z+2, x+1));
+  VERIFY_IS_APPROX(tape.adjoint(ax), std::pow(z+2, x+2) * std::log(z+2));
+
+  // a variable used several times
+  r = ax * ax * ax - ax;
+  tape.computeAdjoints(r);
+  VERIFY_IS_APPROX(tape.adjoint(ax), 3*x*x - 1);
+  VERIFY_IS_EQUAL(tape.adjoint(ay), Scalar(0));
+}
+
+template<typename Scalar>
+void reverse_matrix(Index rows, Index cols)
+{
+  typedef AutoDiffTape<Scalar> Tape;
+  typedef typename Tape::ActiveScalar AD;
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<AD,Dynamic,Dynamic> ADMatrix;
+  typedef Matrix<AD,Dynamic,1> ADVector;
+
+  MatrixType A = MatrixType::Random(rows, cols);
+  VectorType x = VectorType::Random(cols);
+  // because of the scalar_product_traits<Matrix<S>,S> specialization of AutoDiffScalar.h, a product
+  // whose right hand side is a plain matrix is taken for a product by a scalar, hence the lazyProduct() calls
+  VectorType Ax = A.lazyProduct(x);
+  VectorType gref = 2 * A.transpose().lazyProduct(Ax) + x.array().exp().matrix();
+  Scalar fref = Ax.squaredNorm() + x.array().exp().sum();
+
+  Tape tape;
+
+  // per scalar operations through Matrix and Array expressions
+  {
+    ADVector ax = tape.variables(x);
+    ADMatrix aA = A.template cast<AD>();
+    AD f = aA.lazyProduct(ax).squaredNorm() + ax.array().exp().sum();
+    VERIFY_IS_APPROX(f.value(), fref);
+    VERIFY_IS_APPROX(tape.gradient(f, ax), gref);
+  }
+
+  // matrix-level operations, recorded as one node each
+  tape.clear();
+  {
+    ADVector ax = tape.variables(x);
+    ADVector r = tape.product(A, ax);
+    AD f = tape.squaredNorm(r) + tape.sum(tape.unaryExpr(ax, internal::scalar_exp_op<Scalar>(), internal::scalar_exp_op<Scalar>()));
+    VERIFY_IS_EQUAL(tape.nodeCount(), 5);
+    VERIFY_IS_APPROX(f.value(), fref);
+    VERIFY_IS_APPROX(tape.gradient(f, ax), gref);
+
+    // derivatives with respect to both operands of a product
+    ADMatrix aA = tape.variables(A);
+    AD g = tape.sum(tape.product(aA, ax));
+    tape.computeAdjoints(g);
+    VERIFY_IS_APPROX(tape.adjoints(aA), VectorType::Ones(rows) * x.transpose());
+    VERIFY_IS_APPROX(tape.adjoints(ax), A.transpose() * VectorType::Ones(rows));
+
+    // vector-jacobian product
+    VectorType w = VectorType::Random(rows);
+    tape.computeAdjoints(r, w);
+    VERIFY_IS_APPROX(tape.adjoints(ax), A.transpose().lazyProduct(w));
+  }
+
+  // cwise operations and reductions mixing constants and variables
+  tape.clear();
+  {
+    VectorType y = VectorType::Random(cols).array() + Scalar(3);
+    ADVector ax = tape.variables(x), ay = tape.variables(y);
+    ADVector q = tape.cwiseQuotient(ax, ay);
+    AD f = tape.dot(q, x) + tape.sum(tape.cwiseProduct(ax, y));  // x is a constant in the dot product
+    VERIFY_IS_APPROX(f.value(), (x.array().square() / y.array() + x.array() * y.array()).sum());
+    tape.computeAdjoints(f);
+    VERIFY_IS_APPROX(tape.adjoints(ax), (x.array() / y.array() + y.array()).matrix());
+    VERIFY_IS_APPROX(tape.adjoints(ay), (-x.array().square() / y.array().square()).matrix());
+
+    // with constant operands only, the result is a constant
+    Index nodes = tape.nodeCount();
+    VERIFY(tape.dot(x, y).isConstant());
+    VERIFY(tape.product(A, x)(0).isConstant());
+    VERIFY_IS_EQUAL(tape.nodeCount(), nodes);
+  }
+
+  // solve
+  tape.clear();
+  {
+    MatrixType S = MatrixType::Random(rows, rows) + MatrixType::Identity(rows, rows) * Scalar(rows);
+    MatrixType B = MatrixType::Random(rows, 2);
+    MatrixType W = MatrixType::Random(rows, 2);
+    ADMatrix aS = tape.variables(S), aB = tape.variables(B);
+    ADMatrix X = tape.solve(aS, aB);
+    MatrixType Xref = S.lu().solve(B);
+    MatrixType Xval(rows, 2);
+    for(Index k = 0; k < X.size(); ++k)
+      Xval(k) = X(k).value();
+    VERIFY_IS_APPROX(Xval, Xref);
+    AD f = tape.sum(tape.cwiseProduct(X, W));
+    tape.computeAdjoints(f);
+    MatrixType G = S.transpose().lu().solve(W);
+    VERIFY_IS_APPROX(tape.adjoints(aB), G);
+    VERIFY_IS_APPROX(tape.adjoints(aS), -G * Xref.transpose());
+  }
+}
+
+void test_autodiff_reverse()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( reverse_scalar<double>() );
+    CALL_SUBTEST_1( reverse_scalar<float>() );
+    CALL_SUBTEST_2( reverse_matrix<double>(internal::random<int>(1,30), internal::random<int>(1,30)) );
+    CALL_SUBTEST_3( reverse_matrix<float>(internal::random<int>(1,10), internal::random<int>(1,10)) );
+  }
+}
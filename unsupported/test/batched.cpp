@@ -0,0 +1,194 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/Cholesky>
+#include <Eigen/LU>
+#include <Eigen/Eigenvalues>
+#include <unsupported/Eigen/Batched>
+
+template<typename MatrixType> void batched_decompositions()
+{
+  typedef typename MatrixType::Scalar Scalar;
+  enum { Size = MatrixType::RowsAtCompileTime };
+  typedef Matrix<Scalar, Size, 1> VectorType;
+  typedef Matrix<Scalar, Size, 2> RhsType;
+
+  const Index count = internal::random<Index>(1,100);
+  std::vector<MatrixType, aligned_allocator<MatrixType> > spd(count), sym(count), gen(count);
+  std::vector<VectorType, aligned_allocator<VectorType> > b(count), x(count);
+  std::vector<RhsType, aligned_allocator<RhsType> > B(count), X(count);
+  for(Index k = 0; k < count; ++k)
+  {
+    MatrixType a = MatrixType::Random();
+    spd[k] = a * a.adjoint() + MatrixType::Identity();
+    // semidefinite matrix of rank Size-1 (not for all k, so that both paths are covered)
+    a.col(0).setZero();
+    sym[k] = (k%2) ? MatrixType(a * a.adjoint()) : spd[k];
+    gen[k] = MatrixType::Random();
+    b[k] = VectorType::Random();
+    B[k] = RhsType::Random();
+  }
+
+  // LLT
+  BatchedLLT<MatrixType> llt(&spd[0], count);
+  VERIFY(llt.info() == Success);
+  VERIFY_IS_EQUAL(llt.count(), count);
+  llt.solve(&b[0], &x[0]);
+  llt.solve(&B[0], &X[0]);
+  for(Index k = 0; k < count; ++k)
+  {
+    VERIFY(llt.info(k) == Success);
+    VERIFY_IS_APPROX(llt.matrixL(k), spd[k].llt().matrixL().toDenseMatrix());
+    VERIFY_IS_APPROX(spd[k] * x[k], b[k]);
+    VERIFY_IS_APPROX(spd[k] * X[k], B[k]);
+  }
+  // in-place solve, and failure of a single matrix
+  if(count > 1)
+  {
+    std::vector<MatrixType, aligned_allocator<MatrixType> > bad(spd);
+    bad[1] = -spd[1];
+    llt.compute(&bad[0], count);
+    VERIFY(llt.info() == NumericalIssue);
+    VERIFY(llt.info(1) == NumericalIssue);
+    VERIFY(llt.info(0) == Success);
+    x = b;
+    llt.solve(&x[0], &x[0]);
+    VERIFY_IS_APPROX(spd[0] * x[0], b[0]);
+  }
+
+  // LDLT
+  BatchedLDLT<MatrixType> ldlt(&sym[0], count);
+  ldlt.solve(&b[0], &x[0]);
+  for(Index k = 0; k < count; ++k)
+  {
+    MatrixType l = ldlt.matrixL(k);
+    MatrixType p = ldlt.transpositionsP(k) * MatrixType::Identity();
+    MatrixType rec = p.transpose() * l * ldlt.vectorD(k).asDiagonal() * l.adjoint() * p;
+    VERIFY_IS_APPROX(rec, sym[k]);
+    if(k%2==0)
+      VERIFY_IS_APPROX(sym[k] * x[k], b[k]);
+  }
+
+  // PartialPivLU
+  BatchedPartialPivLU<MatrixType> lu(&gen[0], count);
+  lu.solve(&b[0], &x[0]);
+  lu.solve(&B[0], &X[0]);
+  for(Index k = 0; k < count; ++k)
+  {
+    PartialPivLU<MatrixType> ref(gen[k]);
+    VERIFY_IS_APPROX(lu.matrixLU(k), ref.matrixLU());
+    VERIFY_IS_EQUAL(lu.permutationP(k).indices(), ref.permutationP().indices());
+    VERIFY_IS_APPROX(lu.determinant(k), ref.determinant());
+    VERIFY_IS_APPROX(gen[k] * x[k], b[k]);
+    VERIFY_IS_APPROX(gen[k] * X[k], B[k]);
+  }
+}
+
+template<typename MatrixType> void batched_eigensolver()
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  const Index count = internal::random<Index>(1,100);
+  std::vector<MatrixType, aligned_allocator<MatrixType> > mats(count);
+  for(Index k = 0; k < count; ++k)
+  {
+    MatrixType a = MatrixType::Random();
+    switch(k%5)
+    {
+      case 0: mats[k] = a + a.transpose(); break;
+      case 1: mats[k] = MatrixType::Identity() * internal::random<Scalar>(); break;    // triple eigenvalue
+      case 2: mats[k] = a.col(0) * a.col(0).transpose() + MatrixType::Identity(); break; // double eigenvalue
+      case 3: mats[k].setZero(); break;
+      default: mats[k] = a * a.transpose();
+    }
+  }
+
+  BatchedSelfAdjointEigenSolver<MatrixType> eig(&mats[0], count);
+  BatchedSelfAdjointEigenSolver<MatrixType> eigvals(&mats[0], count, EigenvaluesOnly);
+  VERIFY(eig.info() == Success);
+  for(Index k = 0; k < count; ++k)
+  {
+    SelfAdjointEigenSolver<MatrixType> ref;
+    ref.computeDirect(mats[k]);
+    RealScalar scale = (std::max)(mats[k].cwiseAbs().maxCoeff(), RealScalar(1));
+    VERIFY_IS_APPROX(eig.eigenvalues(k) / scale, ref.eigenvalues() / scale);
+    VERIFY_IS_APPROX(eigvals.eigenvalues(k) / scale, ref.eigenvalues() / scale);
+    MatrixType v = eig.eigenvectors(k);
+    VERIFY(v.isUnitary(test_precision<Scalar>()*10));
+    VERIFY((mats[k] * v - v * eig.eigenvalues(k).asDiagonal()).isMuchSmallerThan(scale, test_precision<Scalar>()*10));
+  }
+  VERIFY_RAISES_ASSERT(eigvals.eigenvectors(0));
+}
+
+template<typename MatrixType> void batched_gemm()
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RowMajorMatrixType;
+  typedef Map<MatrixType> MapType;
+
+  const Index count = internal::random<Index>(1,40);
+  const Index maxSize = internal::random<int>(0,1) ? 8 : 80;
+  std::vector<MatrixType> lhs(count), rhs(count), dst(count), ref(count);
+  std::vector<RowMajorMatrixType> rdst(count);
+  for(Index i = 0; i < count; ++i)
+  {
+    // products of different sizes, some of them going to the lazy product
+    Index rows = internal::random<Index>(1,maxSize), cols = internal::random<Index>(1,maxSize), depth = internal::random<Index>(0,maxSize);
+    lhs[i] = MatrixType::Random(rows, depth);
+    rhs[i] = MatrixType::Random(depth, cols);
+    dst[i] = MatrixType::Random(rows, cols);
+    ref[i] = dst[i];
+  }
+
+  Scalar alpha = internal::random<Scalar>(), beta = internal::random<Scalar>();
+  batchedGemm(count, &lhs[0], &rhs[0], &dst[0], alpha, beta);
+  batchedGemm(count, &lhs[0], &rhs[0], &rdst[0]);
+  for(Index i = 0; i < count; ++i)
+  {
+    VERIFY_IS_APPROX(dst[i], (alpha * lhs[i] * rhs[i] + beta * ref[i]).eval());
+    VERIFY_IS_APPROX(rdst[i], (lhs[i] * rhs[i]).eval());
+  }
+  // only a zero beta allows to resize the destination (a single product is never run in parallel)
+  MatrixType wrongDst = MatrixType::Random(lhs[0].rows()+1, rhs[0].cols());
+  VERIFY_RAISES_ASSERT(batchedGemm(1, &lhs[0], &rhs[0], &wrongDst, alpha, Scalar(1)));
+
+  // strided batch, and pointer arrays through Map
+  const Index rows = internal::random<Index>(1,maxSize), cols = internal::random<Index>(1,maxSize), depth = internal::random<Index>(1,maxSize);
+  MatrixType A = MatrixType::Random(rows, depth*count), B = MatrixType::Random(depth, cols*count), C(rows, cols*count);
+  batchedGemm(count, rows, cols, depth, A.data(), rows*depth, B.data(), depth*cols, C.data(), rows*cols);
+  std::vector<MapType> mapped;
+  for(Index i = 0; i < count; ++i)
+  {
+    VERIFY_IS_APPROX(C.middleCols(i*cols, cols), (A.middleCols(i*depth, depth) * B.middleCols(i*cols, cols)).eval());
+    mapped.push_back(MapType(C.data()+i*rows*cols, rows, cols));
+  }
+  ref.assign(count, MatrixType());
+  for(Index i = 0; i < count; ++i)
+    ref[i] = mapped[i];
+  std::vector<MatrixType> lhs2(count, A.leftCols(depth)), rhs2(count, B.leftCols(cols));
+  batchedGemm(count, &lhs2[0], &rhs2[0], &mapped[0], Scalar(1), Scalar(1));
+  for(Index i = 0; i < count; ++i)
+    VERIFY_IS_APPROX(mapped[i].eval(), (ref[i] + A.leftCols(depth) * B.leftCols(cols)).eval());
+}
+
+void test_batched()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( batched_decompositions<Matrix3f>() );
+    CALL_SUBTEST_1( batched_eigensolver<Matrix3f>() );
+    CALL_SUBTEST_2( batched_decompositions<Matrix3d>() );
+    CALL_SUBTEST_2( batched_eigensolver<Matrix3d>() );
+    CALL_SUBTEST_3(( batched_decompositions<Matrix<float,6,6> >() ));
+    CALL_SUBTEST_4(( batched_decompositions<Matrix<double,12,12,RowMajor> >() ));
+    CALL_SUBTEST_5( batched_decompositions<Matrix4f>() );
+    CALL_SUBTEST_6( batched_gemm<MatrixXf>() );
+    CALL_SUBTEST_7( batched_gemm<MatrixXd>() );
+    CALL_SUBTEST_8( batched_gemm<MatrixXcf>() );
+  }
+}
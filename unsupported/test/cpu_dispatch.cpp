@@ -0,0 +1,66 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// This test is compiled with EIGEN_DISPATCH_NAMESPACE. Since main.h declares things in the Eigen namespace
+// before including Eigen, the nesting done by Eigen/Core is declared here first.
+inline namespace EIGEN_DISPATCH_NAMESPACE { namespace Eigen {} }
+#include "main.h"
+#include <Eigen/LU>
+#include <unsupported/Eigen/CpuDispatch>
+#include <typeinfo>
+
+static int generic_version() { return 0; }
+static int avx_version() { return 1; }
+static int avx2_version() { return 2; }
+
+void cpu_features()
+{
+  // what this test has been compiled for must be supported by the CPU running it
+  int compiled = compiledCpuFeatures();
+  int available = cpuFeatures();
+  VERIFY_IS_EQUAL(available & compiled, compiled);
+  VERIFY_IS_EQUAL(available, cpuFeatures());
+  if(available & CpuAVX2)
+    VERIFY(available & CpuAVX);
+  if(available & CpuAVX)
+    VERIFY(available & CpuSSE4_2);
+}
+
+void cpu_dispatcher()
+{
+  typedef int (*Function)();
+  VERIFY_IS_EQUAL(CpuDispatcher<Function>(generic_version, 0).add(CpuAVX, avx_version).add(CpuAVX2|CpuFMA, avx2_version).get()(), 0);
+  VERIFY_IS_EQUAL(CpuDispatcher<Function>(generic_version, CpuSSE2|CpuAVX).add(CpuAVX, avx_version).add(CpuAVX2|CpuFMA, avx2_version).get()(), 1);
+  VERIFY_IS_EQUAL(CpuDispatcher<Function>(generic_version, CpuSSE2|CpuAVX|CpuAVX2).add(CpuAVX, avx_version).add(CpuAVX2|CpuFMA, avx2_version).get()(), 1);
+
+  CpuDispatcher<Function> best(generic_version, CpuAVX|CpuAVX2|CpuFMA);
+  best.add(CpuAVX, avx_version).add(CpuAVX2|CpuFMA, avx2_version);
+  VERIFY_IS_EQUAL(best.get()(), 2);
+  VERIFY_IS_EQUAL(best.features(), int(CpuAVX2|CpuFMA));
+
+  // with the features of the running CPU
+  CpuDispatcher<Function> actual(generic_version);
+  actual.add(CpuAVX2|CpuFMA, avx2_version);
+  VERIFY_IS_EQUAL(actual.get()(), (cpuFeatures() & (CpuAVX2|CpuFMA)) == (CpuAVX2|CpuFMA) ? 2 : 0);
+}
+
+void dispatch_namespace()
+{
+  // the library lives in its own namespace, and still works
+  std::string name = typeid(MatrixXd).name();
+  VERIFY(name.find(EIGEN_MAKESTRING(EIGEN_DISPATCH_NAMESPACE)) != std::string::npos);
+  MatrixXd a = MatrixXd::Random(40,40);
+  VectorXd b = VectorXd::Random(40);
+  VERIFY_IS_APPROX(a * a.partialPivLu().solve(b), b);
+}
+
+void test_cpu_dispatch()
+{
+  CALL_SUBTEST_1( cpu_features() );
+  CALL_SUBTEST_1( cpu_dispatcher() );
+  CALL_SUBTEST_2( dispatch_namespace() );
+}
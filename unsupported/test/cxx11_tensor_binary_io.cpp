@@ -0,0 +1,59 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/CXX11/Tensor>
+#include <Eigen/SparseExtra>
+
+using Eigen::Tensor;
+using Eigen::TensorMap;
+
+template<int DataLayout>
+static void test_binary_io()
+{
+  const std::string filename = "cxx11_tensor_io.bin";
+  Tensor<float, 3, DataLayout> tensor(3, 4, 5);
+  tensor.setRandom();
+  VERIFY(saveTensorBinary(tensor, filename));
+
+  Tensor<float, 3, DataLayout> tensor2;
+  VERIFY(loadTensorBinary(tensor2, filename));
+  VERIFY_IS_EQUAL(tensor2.dimension(0), 3);
+  VERIFY_IS_EQUAL(tensor2.dimension(1), 4);
+  VERIFY_IS_EQUAL(tensor2.dimension(2), 5);
+  for (int i = 0; i < tensor.size(); ++i) {
+    VERIFY_IS_EQUAL(tensor2.data()[i], tensor.data()[i]);
+  }
+  Tensor<float, 2, DataLayout> wrong_rank;
+  VERIFY(!loadTensorBinary(wrong_rank, filename));
+  Tensor<double, 3, DataLayout> wrong_type;
+  VERIFY(!loadTensorBinary(wrong_type, filename));
+
+#if !defined(_WIN32)
+  MappedBinaryFile file(filename);
+  VERIFY(file.isOpen() && file.isTensor());
+  VERIFY_IS_EQUAL(file.rank(), 3);
+  typedef TensorMap<const Tensor<float, 3, DataLayout> > MapType;
+  VERIFY(file.isTensorOf<MapType>());
+  VERIFY((!file.isTensorOf<TensorMap<const Tensor<float, 2, DataLayout> > >()));
+  MapType map = file.tensorMap<MapType>();
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      for (int k = 0; k < 5; ++k) {
+        VERIFY_IS_EQUAL(map(i,j,k), tensor(i,j,k));
+      }
+    }
+  }
+#endif
+  std::remove(filename.c_str());
+}
+
+void test_cxx11_tensor_binary_io()
+{
+  CALL_SUBTEST(test_binary_io<ColMajor>());
+  CALL_SUBTEST(test_binary_io<RowMajor>());
+}
@@ -1445,6 +1445,93 @@ void testNistEckerle4(void)
   VERIFY_IS_APPROX(x[2], 4.5154121844E+02);
 }
 
+// Broyden tridiagonal function, with a dense or sparse jacobian
+template<typename BaseFunctor>
+struct broyden_functor : BaseFunctor
+{
+    broyden_functor(int n) : BaseFunctor(n,n) {}
+    int operator()(const VectorXd &x, VectorXd &fvec) const
+    {
+        const int n = this->values();
+        for (int i = 0; i < n; i++)
+        {
+            fvec[i] = (3-2*x[i])*x[i] + 1;
+            if (i > 0) fvec[i] -= x[i-1];
+            if (i+1 < n) fvec[i] -= 2*x[i+1];
+        }
+        return 0;
+    }
+};
+
+template<typename BaseFunctor>
+struct broyden_df_functor : broyden_functor<BaseFunctor>
+{
+    typedef typename BaseFunctor::JacobianType JacobianType;
+    broyden_df_functor(int n) : broyden_functor<BaseFunctor>(n) {}
+    int df(const VectorXd &x, JacobianType &fjac) const
+    {
+        const int n = this->values();
+        std::vector<Triplet<double> > triplets;
+        for (int i = 0; i < n; i++)
+        {
+            triplets.push_back(Triplet<double>(i, i, 3-4*x[i]));
+            if (i > 0) triplets.push_back(Triplet<double>(i, i-1, -1));
+            if (i+1 < n) triplets.push_back(Triplet<double>(i, i+1, -2));
+        }
+        SparseMatrix<double> jac(n, n);
+        jac.setFromTriplets(triplets.begin(), triplets.end());
+        fjac = jac;
+        return 0;
+    }
+};
+
+struct broyden_cholesky_functor : broyden_df_functor<SparseFunctor<double,int> >
+{
+    typedef SparseNormalCholesky<JacobianType> QRSolver;
+    broyden_cholesky_functor(int n) : broyden_df_functor<SparseFunctor<double,int> >(n) {}
+};
+
+template<typename FunctorType>
+void check_broyden(FunctorType &functor, const VectorXd &x_ref)
+{
+    const int n = functor.values();
+    VectorXd x = VectorXd::Constant(n, -1.), fvec(n);
+    LevenbergMarquardt<FunctorType> lm(functor);
+    LevenbergMarquardtSpace::Status info = lm.minimize(x);
+    VERIFY(info==LevenbergMarquardtSpace::RelativeErrorTooSmall || info==LevenbergMarquardtSpace::RelativeReductionTooSmall
+           || info==LevenbergMarquardtSpace::RelativeErrorAndReductionTooSmall);
+    functor(x, fvec);
+    VERIFY(fvec.norm() < 1e-10);
+    VERIFY_IS_APPROX(x, x_ref);
+}
+
+void testSparseBroyden()
+{
+    const int n = 300;
+
+    // reference solution, with a dense jacobian
+    broyden_df_functor<DenseFunctor<double> > dense_functor(n);
+    VectorXd x_ref = VectorXd::Constant(n, -1.), fvec(n);
+    LevenbergMarquardt<broyden_df_functor<DenseFunctor<double> > > lm(dense_functor);
+    lm.minimize(x_ref);
+    dense_functor(x_ref, fvec);
+    VERIFY(fvec.norm() < 1e-10);
+
+    // sparse jacobian, with SparseQR and with the Cholesky factorization of the normal equations
+    broyden_df_functor<SparseFunctor<double,int> > qr_functor(n);
+    check_broyden(qr_functor, x_ref);
+    broyden_cholesky_functor cholesky_functor(n);
+    check_broyden(cholesky_functor, x_ref);
+
+    // sparse jacobian estimated by finite differences, three columns of the tridiagonal jacobian at a time
+    SparseFunctor<double,int>::JacobianType pattern;
+    qr_functor.df(x_ref, pattern);
+    NumericalDiff<broyden_functor<SparseFunctor<double,int> > > numdiff_functor(n);
+    numdiff_functor.setSparsityPattern(pattern);
+    VERIFY_IS_EQUAL(numdiff_functor.colors(), 3);
+    check_broyden(numdiff_functor, x_ref);
+}
+
 void test_levenberg_marquardt()
 {
     // Tests using the examples provided by (c)minpack
@@ -1454,6 +1541,7 @@ void test_levenberg_marquardt()
 //     CALL_SUBTEST(testLmstr1());
 //     CALL_SUBTEST(testLmstr());
     CALL_SUBTEST(testLmdif());
+    CALL_SUBTEST(testSparseBroyden());
 
     // NIST tests, level of difficulty = "Lower"
     CALL_SUBTEST(testNistMisra1a());
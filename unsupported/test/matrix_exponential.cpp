@@ -8,6 +8,7 @@
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include "matrix_functions.h"
+#include <Eigen/Geometry>
 
 double binom(int n, int k)
 {
@@ -119,6 +120,82 @@ void randomTest(const MatrixType& m, double tol)
   }
 }
 
+template <typename T>
+void testClosedForms(double tol)
+{
+  typedef Matrix<T,3,3> Matrix3;
+  typedef Matrix<T,4,4> Matrix4;
+  typedef Matrix<T,Dynamic,Dynamic> MatrixX;
+  typedef Matrix<T,3,1> Vector3;
+
+  for (int i=0; i<=20; i++)
+  {
+    // rotation vectors from tiny to large angles, including zero
+    const T angle = i == 0 ? T(0) : static_cast<T>(pow(10, i / 4. - 4));
+    const Vector3 axis = Vector3::Random().normalized();
+    Matrix3 W;
+    W << 0, -axis(2), axis(1), axis(2), 0, -axis(0), -axis(1), axis(0), 0;
+    W *= angle;
+
+    // Rodrigues formula, compared with the rotation and with the generic algorithm
+    Matrix3 R = W.exp();
+    VERIFY(R.isApprox(AngleAxis<T>(angle, axis).toRotationMatrix(), static_cast<T>(tol)));
+    VERIFY(R.isApprox(MatrixX(MatrixX(W).exp()), static_cast<T>(tol)));
+
+    // twist of a rigid motion
+    Matrix4 S = Matrix4::Zero();
+    S.template topLeftCorner<3,3>() = W;
+    S.template topRightCorner<3,1>() = Vector3::Random();
+    Matrix4 M = S.exp();
+    VERIFY(M.isApprox(MatrixX(MatrixX(S).exp()), static_cast<T>(tol)));
+    VERIFY(M.template bottomRows<1>().isApprox(Matrix<T,1,4>::UnitW()));
+  }
+
+  // matrices without closed form
+  Matrix3 A = Matrix3::Random();
+  VERIFY(A.exp().isApprox(MatrixX(MatrixX(A).exp()), static_cast<T>(tol)));
+  Matrix4 B = Matrix4::Zero();
+  B.template topLeftCorner<3,3>() = A - A.transpose();
+  B(3,0) = 1;
+  VERIFY(B.exp().isApprox(MatrixX(MatrixX(B).exp()), static_cast<T>(tol)));
+}
+
+template <typename T, int Size>
+void testBatch(double tol)
+{
+  typedef Matrix<T,Size,Size> MatrixType;
+  typedef Array<T,Dynamic,Dynamic> BatchType;
+
+  // more than one chunk, with norms from tiny to large
+  const Index count = 150;
+  BatchType args(count, Size*Size), result;
+  for (Index i=0; i<count; i++)
+    args.row(i) = BatchType::Random(1, Size*Size) * static_cast<T>(pow(10, (i % 7) / 2. - 2));
+  matrixExpBatch(args, result);
+  VERIFY_IS_EQUAL(result.rows(), count);
+  for (Index i=0; i<count; i++)
+  {
+    const MatrixType A = Map<const MatrixType>(BatchType(args.row(i)).data());
+    const MatrixType E = Map<const MatrixType>(BatchType(result.row(i)).data());
+    VERIFY(E.isApprox(Matrix<T,Dynamic,Dynamic>(A).exp(), static_cast<T>(tol)));
+  }
+
+  // rotation vectors, from a matrix
+  Matrix<T,Dynamic,3> omegas = Matrix<T,Dynamic,3>::Random(count, 3);
+  omegas.row(0).setZero();
+  omegas.row(1) *= NumTraits<T>::epsilon();
+  Matrix<T,Dynamic,Dynamic> rotations;
+  so3ExpBatch(omegas, rotations);
+  for (Index i=0; i<count; i++)
+  {
+    const Matrix<T,3,1> w = omegas.row(i).transpose();
+    Matrix<T,3,3> W, R;
+    W << 0, -w(2), w(1), w(2), 0, -w(0), -w(1), w(0), 0;
+    R = Map<const Matrix<T,3,3> >(Matrix<T,1,9>(rotations.row(i)).data());
+    VERIFY(R.isApprox(W.exp(), static_cast<T>(tol)));
+  }
+}
+
 void test_matrix_exponential()
 {
   CALL_SUBTEST_2(test2dRotation<double>(1e-13));
@@ -138,4 +215,10 @@ void test_matrix_exponential()
   CALL_SUBTEST_1(randomTest(Matrix4f(), 1e-4));
   CALL_SUBTEST_6(randomTest(MatrixXf(8,8), 1e-4));
   CALL_SUBTEST_9(randomTest(Matrix<long double,Dynamic,Dynamic>(7,7), 1e-13));
+  CALL_SUBTEST_2(testClosedForms<double>(1e-13));
+  CALL_SUBTEST_1(testClosedForms<float>(1e-5));
+  CALL_SUBTEST_7((testBatch<double,3>(1e-13)));
+  CALL_SUBTEST_7((testBatch<double,6>(1e-13)));
+  CALL_SUBTEST_4((testBatch<double,4>(1e-13)));
+  CALL_SUBTEST_6((testBatch<float,4>(1e-4)));
 }
@@ -0,0 +1,123 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <unsupported/Eigen/OutOfCore>
+#include <unsupported/Eigen/SparseExtra>
+
+template<typename MatrixType>
+void tile_stream(Index rows, Index cols)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+
+  MatrixType A = MatrixType::Random(rows, cols);
+  DenseType B = DenseType::Random(rows, 2);
+  DenseType X = DenseType::Random(cols, 3);
+
+  TileStream stream;
+  stream.setTileRows(internal::random<Index>(1, rows)).setThreads(internal::random<Index>(0, 3))
+        .setReadAhead(internal::random<Index>(0, 3));
+
+  DenseType AtB, AtA, AtA2, AX;
+  stream.adjointProduct(A, B, AtB);
+  VERIFY_IS_APPROX(AtB, A.adjoint() * B);
+  stream.gram(A, AtA);
+  VERIFY_IS_APPROX(AtA, A.adjoint() * A);
+  stream.normalEquations(A, B, AtA2, AtB);
+  VERIFY_IS_APPROX(AtA2, A.adjoint() * A);
+  VERIFY_IS_APPROX(AtB, A.adjoint() * B);
+  stream.product(A, X, AX);
+  VERIFY_IS_APPROX(AX, A * X);
+
+  // expressions without direct access, Map and blocks, with the default tile size
+  TileStream defaultStream;
+  defaultStream.adjointProduct(A * Scalar(2), B.col(1), AtB);
+  VERIFY_IS_APPROX(AtB, Scalar(2) * A.adjoint() * B.col(1));
+  Map<const MatrixType> Am(A.data(), rows, cols);
+  defaultStream.gram(Am.leftCols(cols/2), AtA);
+  VERIFY_IS_APPROX(AtA, A.leftCols(cols/2).adjoint() * A.leftCols(cols/2));
+  DenseType AX2(rows, 3);
+  Map<DenseType> AXm(AX2.data(), rows, 3);
+  stream.product(Am, X, AXm);
+  VERIFY_IS_APPROX(AX2, A * X);
+}
+
+template<typename MatrixType>
+void tall_skinny_qr(Index rows, Index cols)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+
+  MatrixType A = MatrixType::Random(rows, cols);
+  DenseType B = DenseType::Random(rows, 2);
+
+  TallSkinnyQR<MatrixType> qr;
+  qr.stream().setTileRows(internal::random<Index>(1, rows)).setThreads(internal::random<Index>(0, 3));
+  qr.compute(A, B);
+  VERIFY_IS_EQUAL(qr.rows(), rows);
+  VERIFY_IS_EQUAL(qr.cols(), cols);
+
+  DenseType R = qr.matrixR();
+  VERIFY(R.isUpperTriangular());
+  VERIFY_IS_APPROX(R.adjoint() * R, A.adjoint() * A);
+
+  DenseType X = qr.leastSquaresSolution();
+  DenseType Xref = A.householderQr().solve(B);
+  VERIFY_IS_APPROX(X, Xref);
+  for(Index j = 0; j < B.cols(); ++j)
+    VERIFY_IS_APPROX(qr.residualNorms()(j), (A * Xref.col(j) - B.col(j)).norm());
+  VERIFY_IS_APPROX(R.adjoint() * qr.rhsProjection(), A.adjoint() * B);
+
+  // without right hand side, and with less rows than columns
+  Index fewRows = internal::random<Index>(1, cols);
+  DenseType W = A.topRows(fewRows);
+  qr.compute(W);
+  R = qr.matrixR();
+  VERIFY(R.isUpperTriangular());
+  VERIFY(R.bottomRows(cols - fewRows).isZero());
+  VERIFY_IS_APPROX(R.adjoint() * R, W.adjoint() * W);
+}
+
+void memory_mapped()
+{
+#if !defined(_WIN32)
+  std::string filename = "out_of_core.bin";
+  MatrixXd A = MatrixXd::Random(5000, 20);
+  VectorXd b = VectorXd::Random(5000);
+  VERIFY(saveBinary(A, filename));
+  {
+    MappedBinaryFile file(filename);
+    VERIFY(file.isDenseOf<MatrixXd>());
+    Map<const MatrixXd> Am = file.denseMap<MatrixXd>();
+
+    TallSkinnyQR<MatrixXd> qr;
+    qr.stream().setTileRows(512);
+    qr.compute(Am, b);
+    VERIFY_IS_APPROX(qr.leastSquaresSolution(), A.householderQr().solve(b));
+
+    MatrixXd AtA;
+    VectorXd Atb;
+    TileStream().setTileRows(700).normalEquations(Am, b, AtA, Atb);
+    VERIFY_IS_APPROX(AtA, A.transpose() * A);
+    VERIFY_IS_APPROX(Atb, A.transpose() * b);
+  }
+  std::remove(filename.c_str());
+#endif
+}
+
+void test_out_of_core()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( tile_stream<MatrixXd>(internal::random<int>(1,500), internal::random<int>(2,20)) );
+    CALL_SUBTEST_2( (tile_stream<Matrix<float,Dynamic,Dynamic,RowMajor> >(internal::random<int>(1,500), internal::random<int>(2,20))) );
+    CALL_SUBTEST_3( tile_stream<MatrixXcd>(internal::random<int>(1,200), internal::random<int>(2,10)) );
+    CALL_SUBTEST_4( tall_skinny_qr<MatrixXd>(internal::random<int>(30,500), internal::random<int>(1,20)) );
+    CALL_SUBTEST_5( tall_skinny_qr<MatrixXcf>(internal::random<int>(30,300), internal::random<int>(1,10)) );
+  }
+  CALL_SUBTEST_6( memory_mapped() );
+}
@@ -0,0 +1,81 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "../../test/sparse_solver.h"
+#include <Eigen/IterativeSolvers>
+
+// 5-point finite difference laplacian on a n x n grid
+template<typename Scalar>
+SparseMatrix<Scalar> laplacian_2d(int n)
+{
+  std::vector<Triplet<Scalar> > triplets;
+  for(int j = 0; j < n; ++j)
+  {
+    for(int i = 0; i < n; ++i)
+    {
+      int k = i + j*n;
+      triplets.push_back(Triplet<Scalar>(k, k, Scalar(4)));
+      if(i>0)   triplets.push_back(Triplet<Scalar>(k, k-1, Scalar(-1)));
+      if(i<n-1) triplets.push_back(Triplet<Scalar>(k, k+1, Scalar(-1)));
+      if(j>0)   triplets.push_back(Triplet<Scalar>(k, k-n, Scalar(-1)));
+      if(j<n-1) triplets.push_back(Triplet<Scalar>(k, k+n, Scalar(-1)));
+    }
+  }
+  SparseMatrix<Scalar> A(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  return A;
+}
+
+template<typename T> void test_smoothed_aggregation_T()
+{
+  typedef SmoothedAggregationPreconditioner<T> AMG;
+  ConjugateGradient<SparseMatrix<T>, Lower|Upper, AMG> cg;
+  BiCGSTAB<SparseMatrix<T>, AMG> bicgstab;
+  GMRES<SparseMatrix<T>, AMG> gmres;
+
+  CALL_SUBTEST( check_sparse_spd_solving(cg) );
+  CALL_SUBTEST( check_sparse_square_solving(bicgstab) );
+  CALL_SUBTEST( check_sparse_square_solving(gmres) );
+}
+
+template<typename T> void test_smoothed_aggregation_poisson()
+{
+  typedef Matrix<T,Dynamic,1> VectorType;
+  ConjugateGradient<SparseMatrix<T>, Lower|Upper, SmoothedAggregationPreconditioner<T> > cg;
+  ConjugateGradient<SparseMatrix<T>, Lower|Upper, DiagonalPreconditioner<T> > cg_diag;
+  cg.setTolerance(1e-8);
+  cg_diag.setTolerance(1e-8);
+
+  Index iterations[2];
+  const int sizes[2] = { 32, 128 };
+  for(int s = 0; s < 2; ++s)
+  {
+    SparseMatrix<T> A = laplacian_2d<T>(sizes[s]);
+    VectorType b = VectorType::Random(A.rows());
+    cg.compute(A);
+    VERIFY_IS_EQUAL(cg.info(), Success);
+    VERIFY(cg.preconditioner().levels() > 1);
+    VERIFY(cg.preconditioner().operatorComplexity() < 2);
+    VectorType x = cg.solve(b);
+    VERIFY_IS_EQUAL(cg.info(), Success);
+    VERIFY((A*x - b).norm() <= 1e-7 * b.norm());
+    iterations[s] = cg.iterations();
+
+    cg_diag.compute(A);
+    VectorType x_diag = cg_diag.solve(b);
+    VERIFY(cg.iterations() < cg_diag.iterations());
+  }
+  // 16 times more unknowns, but about as many iterations
+  VERIFY(iterations[1] <= 2*iterations[0]);
+}
+
+void test_smoothed_aggregation()
+{
+  CALL_SUBTEST_1(test_smoothed_aggregation_T<double>());
+  CALL_SUBTEST_2(test_smoothed_aggregation_T<std::complex<double> >());
+  CALL_SUBTEST_3(test_smoothed_aggregation_poisson<double>());
+}
@@ -129,6 +129,270 @@ template<typename SparseMatrixType> void sparse_extra(const SparseMatrixType& re
 
 }
 
+template<typename Scalar, int Options, typename StorageIndex> void sparse_binary_io(Index rows, Index cols)
+{
+  typedef SparseMatrix<Scalar,Options,StorageIndex> SparseMatrixType;
+  typedef SparseMatrix<Scalar,(Options&RowMajor) ? ColMajor : RowMajor,StorageIndex> OtherSparseMatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic,Options> DenseMatrix;
+  const std::string filename = "sparse_extra_binary_io.bin";
+
+  // sparse matrices
+  DenseMatrix refMat = DenseMatrix::Zero(rows, cols);
+  SparseMatrixType m(rows, cols);
+  initSparse<Scalar>(0.2, refMat, m);
+  VERIFY(saveBinary(m, filename));
+  SparseMatrixType m2;
+  VERIFY(loadBinary(m2, filename));
+  VERIFY(m2.isCompressed());
+  VERIFY_IS_EQUAL(m2.nonZeros(), m.nonZeros());
+  VERIFY_IS_EQUAL(m2.toDense(), refMat);
+  OtherSparseMatrixType m3;
+  VERIFY(loadBinary(m3, filename));
+  VERIFY_IS_EQUAL(m3.toDense(), refMat);
+  SparseMatrix<Scalar,Options,short> m4;
+  VERIFY(!loadBinary(m4, filename));
+  DenseMatrix d;
+  VERIFY(!loadBinary(d, filename));
+
+  // an uncompressed matrix is saved as compressed
+  m.uncompress();
+  VERIFY(saveBinary(m, filename));
+  VERIFY(loadBinary(m2, filename));
+  VERIFY_IS_EQUAL(m2.toDense(), refMat);
+
+#if !defined(_WIN32)
+  {
+    MappedBinaryFile file(filename);
+    VERIFY(file.isOpen() && file.isSparse() && !file.isTensor());
+    VERIFY_IS_EQUAL(file.rows(), rows);
+    VERIFY_IS_EQUAL(file.cols(), cols);
+    VERIFY(file.template isSparseOf<SparseMatrixType>());
+    VERIFY(!file.template isSparseOf<OtherSparseMatrixType>());
+    VERIFY(!file.template isDenseOf<DenseMatrix>());
+    Map<const SparseMatrixType> mm = file.template sparseMap<SparseMatrixType>();
+    VERIFY_IS_EQUAL(mm.toDense(), refMat);
+  }
+#endif
+
+  // dense matrices and vectors
+  DenseMatrix dm = DenseMatrix::Random(rows, cols);
+  VERIFY(saveBinary(dm, filename));
+  VERIFY(loadBinary(d, filename));
+  VERIFY_IS_EQUAL(d, dm);
+  Matrix<Scalar,Dynamic,Dynamic,(Options&RowMajor) ? ColMajor : RowMajor> od;
+  VERIFY(rows==1 || cols==1 || !loadBinary(od, filename));
+  VERIFY(!loadBinary(m2, filename));
+
+  Matrix<Scalar,Dynamic,1> v = Matrix<Scalar,Dynamic,1>::Random(rows), v2;
+  Matrix<Scalar,1,Dynamic> rv;
+  VERIFY(saveBinary(v, filename));
+  VERIFY(loadBinary(v2, filename));
+  VERIFY_IS_EQUAL(v2, v);
+  VERIFY(loadBinary(rv, filename));
+  VERIFY_IS_EQUAL(rv, v.transpose());
+
+#if !defined(_WIN32)
+  {
+    VERIFY(saveBinary(dm, filename));
+    MappedBinaryFile file(filename);
+    VERIFY(file.isOpen() && !file.isSparse());
+    VERIFY(file.template isDenseOf<DenseMatrix>());
+    VERIFY((!file.template isDenseOf<Matrix<std::complex<long double>,Dynamic,Dynamic,Options> >()));
+    Map<const DenseMatrix> mm = file.template denseMap<DenseMatrix>();
+    VERIFY_IS_EQUAL(mm, dm);
+    file.close();
+    VERIFY(!file.isOpen());
+  }
+  {
+    std::ofstream out(filename.c_str());
+    out << "%%MatrixMarket matrix coordinate real general\n";
+  }
+  MappedBinaryFile file(filename);
+  VERIFY(!file.isOpen());
+#endif
+
+  std::remove(filename.c_str());
+}
+
+template<typename SparseMatrixType> void sparse_market_io(Index rows, Index cols)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  const std::string filename = "sparse_extra_market_io.mtx";
+
+  DenseMatrix refMat = DenseMatrix::Zero(rows, cols);
+  SparseMatrixType m(rows, cols), m2;
+  initSparse<Scalar>(0.2, refMat, m);
+  VERIFY(saveMarket(m, filename));
+  VERIFY(loadMarket(m2, filename));
+  VERIFY(m2.isCompressed());
+  VERIFY_IS_EQUAL(m2.toDense(), refMat);
+  // small blocks to split the lines across the blocks
+  VERIFY(internal::load_market(m2, filename, internal::random<Index>(1,100)));
+  VERIFY_IS_EQUAL(m2.toDense(), refMat);
+  std::remove(filename.c_str());
+}
+
+void sparse_market_io_formats()
+{
+  const std::string filename = "sparse_extra_market_io.mtx";
+  {
+    std::ofstream out(filename.c_str());
+    out << "%%MatrixMarket matrix coordinate real general\n% comment\n%\n3 4 8\n"
+        << "1 1 1.5\n\n2 3 -2e2\n% inner comment\n3 4 .25E-1\n  1 2\t+7\r\n"
+        << "2 3 1d1\n3 1 1.00000000000000000001\n1 4 1e-300\n3 2 -0.";
+  }
+  SparseMatrix<double> m;
+  VERIFY(loadMarket(m, filename));
+  VERIFY_IS_EQUAL(m.rows(), 3);
+  VERIFY_IS_EQUAL(m.cols(), 4);
+  VERIFY_IS_EQUAL(m.nonZeros(), 7);
+  VERIFY_IS_EQUAL(m.coeff(0,0), 1.5);
+  VERIFY_IS_EQUAL(m.coeff(1,2), -190.);   // duplicates are summed
+  VERIFY_IS_EQUAL(m.coeff(2,3), 0.025);
+  VERIFY_IS_EQUAL(m.coeff(0,1), 7.);
+  VERIFY_IS_EQUAL(m.coeff(2,0), 1.);
+  VERIFY_IS_EQUAL(m.coeff(0,3), 1e-300);
+
+  {
+    std::ofstream out(filename.c_str());
+    out << "%%MatrixMarket matrix coordinate pattern general\n2 2 2\n1 1\n2 1\n";
+  }
+  SparseMatrix<float,RowMajor> p;
+  VERIFY(loadMarket(p, filename));
+  VERIFY_IS_EQUAL(p.nonZeros(), 2);
+  VERIFY_IS_EQUAL(p.coeff(1,0), 1.f);
+
+  {
+    std::ofstream out(filename.c_str());
+    out << "%%MatrixMarket matrix coordinate complex general\n2 2 1\n2 2 1.5 -2\n";
+  }
+  SparseMatrix<std::complex<double> > c;
+  VERIFY(loadMarket(c, filename));
+  VERIFY_IS_EQUAL(c.coeff(1,1), std::complex<double>(1.5,-2));
+
+  // as before, a wrong number of entries in the header only produces a warning
+  {
+    std::ofstream out(filename.c_str());
+    out << "%%MatrixMarket matrix coordinate real general\n3 3 1\n1 1 1\n2 2 2\n3 3 3\n3 1 4\n";
+  }
+  VERIFY(loadMarket(m, filename));
+  VERIFY_IS_EQUAL(m.nonZeros(), 4);
+  VERIFY_IS_EQUAL(m.coeff(2,2), 3.);
+  VERIFY_IS_EQUAL(m.coeff(2,0), 4.);
+  VERIFY(internal::load_market(m, filename, 5));
+  VERIFY_IS_EQUAL(m.nonZeros(), 4);
+  VERIFY_IS_EQUAL(m.coeff(2,0), 4.);
+  {
+    std::ofstream out(filename.c_str());
+    out << "%%MatrixMarket matrix coordinate real general\n2 2 3\n2 1 5\n";
+  }
+  VERIFY(loadMarket(m, filename));
+  VERIFY_IS_EQUAL(m.nonZeros(), 1);
+  VERIFY_IS_EQUAL(m.coeff(1,0), 5.);
+
+  VERIFY(!loadMarket(m, "sparse_extra_market_io_missing.mtx"));
+  std::remove(filename.c_str());
+}
+
+struct sparse_assembler_element
+{
+  sparse_assembler_element(const MatrixXd& coeffs) : m_coeffs(coeffs) {}
+  void operator()(Index e, MatrixXd& Ke) const
+  {
+    Ke = (m_coeffs.col(e) * m_coeffs.col(e).transpose()).array() + double(e);
+  }
+  const MatrixXd& m_coeffs;
+};
+
+void sparse_assembler(Index elements, Index dofsPerElement)
+{
+  const Index size = internal::random<Index>(dofsPerElement, 3*elements+dofsPerElement);
+  MatrixXi dofs(dofsPerElement, elements);
+  for(Index e = 0; e < elements; ++e)
+    for(Index a = 0; a < dofsPerElement; ++a)
+      dofs(a,e) = internal::random<int>(0,5) == 0 ? -1 : internal::random<int>(0,int(size-1));
+  MatrixXd coeffs = MatrixXd::Random(dofsPerElement, elements);
+  sparse_assembler_element func(coeffs);
+
+  MatrixXd ref = MatrixXd::Zero(size, size);
+  MatrixXd Ke;
+  for(Index e = 0; e < elements; ++e)
+  {
+    func(e, Ke);
+    for(Index b = 0; b < dofsPerElement; ++b)
+      for(Index a = 0; a < dofsPerElement; ++a)
+        if(dofs(a,e) >= 0 && dofs(b,e) >= 0)
+          ref(dofs(a,e), dofs(b,e)) += Ke(a,b);
+  }
+
+  SparseAssembler<SparseMatrix<double> > assembler;
+  assembler.analyzePattern(dofs, size);
+  VERIFY_IS_EQUAL(assembler.matrix().rows(), size);
+  VERIFY_IS_EQUAL(assembler.matrix().norm(), 0.);
+
+  // the elements of a color do not share any degree of freedom
+  Index colored = 0;
+  for(Index c = 0; c < assembler.colors(); ++c)
+  {
+    std::vector<bool> used(size, false);
+    for(Index i = 0; i < assembler.colorSize(c); ++i, ++colored)
+    {
+      const Index e = assembler.colorElement(c, i);
+      for(Index a = 0; a < dofsPerElement; ++a)
+        VERIFY(dofs(a,e) < 0 || !used[dofs(a,e)]);
+      for(Index a = 0; a < dofsPerElement; ++a)
+        if(dofs(a,e) >= 0)
+          used[dofs(a,e)] = true;
+    }
+  }
+  VERIFY_IS_EQUAL(colored, elements);
+
+  for(int k = 0; k < 2; ++k)
+  {
+    assembler.setZero();
+    assembler.assemble(func);
+    VERIFY_IS_APPROX(MatrixXd(assembler.matrix()), ref);
+  }
+
+  assembler.setZero();
+  for(Index e = 0; e < elements; ++e)
+  {
+    func(e, Ke);
+    assembler.addElement(e, Ke);
+  }
+  VERIFY_IS_APPROX(MatrixXd(assembler.matrix()), ref);
+}
+
+// elements without any common degree of freedom, so that the pattern has no duplicate
+void sparse_assembler_disjoint()
+{
+  SparseAssembler<SparseMatrix<double> > assembler;
+  Matrix2i dofs;
+  dofs << 0, 3,
+          2, 1;
+  Matrix2d Ke;
+  Ke << 1, 2,
+        3, 4;
+  assembler.analyzePattern(dofs.leftCols(1), 3);
+  assembler.addElement(0, Ke);
+  Matrix3d ref;
+  ref << 1, 0, 2,
+         0, 0, 0,
+         3, 0, 4;
+  VERIFY_IS_EQUAL(MatrixXd(assembler.matrix()), MatrixXd(ref));
+
+  assembler.analyzePattern(dofs, 4);
+  assembler.addElement(0, Ke);
+  assembler.addElement(1, 10*Ke);
+  Matrix4d ref2;
+  ref2 << 1,  0, 2,  0,
+          0, 40, 0, 30,
+          3,  0, 4,  0,
+          0, 20, 0, 10;
+  VERIFY_IS_EQUAL(MatrixXd(assembler.matrix()), MatrixXd(ref2));
+}
+
 void test_sparse_extra()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -143,5 +407,17 @@ void test_sparse_extra()
 
     CALL_SUBTEST_3( (sparse_product<DynamicSparseMatrix<float, ColMajor> >()) );
     CALL_SUBTEST_3( (sparse_product<DynamicSparseMatrix<float, RowMajor> >()) );
+
+    CALL_SUBTEST_4(( sparse_binary_io<double,ColMajor,int>(s, internal::random<int>(1,50)) ));
+    CALL_SUBTEST_4(( sparse_binary_io<std::complex<float>,RowMajor,int>(s, internal::random<int>(1,50)) ));
+    CALL_SUBTEST_4(( sparse_binary_io<float,ColMajor,long>(s, 1) ));
+
+    CALL_SUBTEST_5( sparse_market_io<SparseMatrix<double> >(s, internal::random<int>(1,50)) );
+    CALL_SUBTEST_5(( sparse_market_io<SparseMatrix<std::complex<float>,RowMajor> >(s, s) ));
+    CALL_SUBTEST_5( sparse_market_io_formats() );
+
+    CALL_SUBTEST_6( sparse_assembler(internal::random<int>(1,200), internal::random<int>(1,8)) );
+    CALL_SUBTEST_6( sparse_assembler(1, 1) );
   }
+  CALL_SUBTEST_6( sparse_assembler_disjoint() );
 }
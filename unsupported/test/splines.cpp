@@ -268,6 +268,52 @@ void check_global_interpolation_with_derivatives2d()
   }
 }
 
+template <typename SplineType>
+void check_batch_evaluation(const SplineType& spline)
+{
+  typedef typename SplineType::PointType PointType;
+  typedef typename SplineType::KnotVectorType KnotVectorType;
+  typedef typename SplineType::ControlPointVectorType ControlPointVectorType;
+
+  const KnotVectorType& knots = spline.knots();
+  const double a = knots(0), b = knots(knots.size()-1);
+  const DenseIndex p = spline.degree();
+
+  // sorted sites, including the knots, and random sites
+  KnotVectorType sorted(1000 + knots.size());
+  sorted << KnotVectorType::LinSpaced(1000, a, b), knots;
+  std::sort(sorted.data(), sorted.data()+sorted.size());
+  const KnotVectorType random = (KnotVectorType::Random(77) + 1) * (b-a)/2 + a;
+
+  for (int s=0; s<2; ++s)
+  {
+    const KnotVectorType& u = s==0 ? sorted : random;
+    const ControlPointVectorType pts = spline(u);
+    const ControlPointVectorType ders = spline.derivatives(u, 2);
+    VERIFY_IS_EQUAL(pts.cols(), u.size());
+    VERIFY_IS_EQUAL(ders.cols(), u.size()*3);
+    for (DenseIndex i=0; i<u.size(); ++i)
+    {
+      PointType pt = spline(u(i));
+      VERIFY( (pts.col(i) - pt).matrix().norm() < 1e-14 );
+      typename SplineTraits<SplineType>::DerivativeType der = spline.derivatives(u(i), 2);
+      VERIFY( (ders.block(0, 3*i, ders.rows(), 3) - der).matrix().norm() < 1e-10 * (1 + der.matrix().norm()) );
+    }
+  }
+
+  // expressions as sites, and orders above the degree
+  const ControlPointVectorType ders = spline.derivatives(sorted.head(10).matrix().transpose(), p+2);
+  VERIFY_IS_EQUAL(ders.cols(), 10*(p+1));
+  VERIFY_IS_APPROX(ders.leftCols(p+1), spline.derivatives(sorted(0), p+2));
+}
+
+void eval_batch()
+{
+  CALL_SUBTEST( check_batch_evaluation(spline3d()) );
+  CALL_SUBTEST( check_batch_evaluation(closed_spline2d()) );
+  CALL_SUBTEST( check_batch_evaluation(Spline<double,2,3>(closed_spline2d())) );
+}
+
 void test_splines()
 {
   for (int i = 0; i < g_repeat; ++i)
@@ -277,5 +323,6 @@ void test_splines()
     CALL_SUBTEST( eval_closed_spline2d() );
     CALL_SUBTEST( check_global_interpolation2d() );
     CALL_SUBTEST( check_global_interpolation_with_derivatives2d() );
+    CALL_SUBTEST( eval_batch() );
   }
 }